@@ -0,0 +1,1448 @@
+/**
+ * @file main.cpp
+ * @brief phone-linkc-bench 基准测试程序
+ *
+ * 在模拟设备后端上无界面地驱动 core/ 下的各个管理器，测量与设备交互的热点路径：
+ * - FileManager::listDirectory（1 万个目录项）
+ * - PhotoManager::getAllPhotos（多层嵌套的 DCIM 目录）
+ * - PhotoManager::scanPhotosStreaming（流式扫描产出首批照片的延迟）
+ * - PhotoScanner（扫描耗时随 AFC 连接数 1/2/4/8 的变化曲线）
+ * - ScaledDecoder（1200 万像素 JPEG 生成 100px 缩略图：完整解码 + 平滑缩放 vs IDCT 缩放 + 面积平均）
+ * - ThumbnailCache::find（从本地缓存读取一个相册的缩略图，无设备 I/O）
+ * - ThumbnailPipeline（读取线程 + 并行解码生成一个相册的缩略图；跳到末尾时可见项的到达耗时；
+ *   读取设备预生成的缩略图）
+ * - PhotoCatalog 增量刷新（图库未变化 / 只有一个目录新增文件）
+ * - PhotoLibrary（图库数据库未变化时的同步；相簿切换的本地查询）
+ * - PhotoIndex（10 万张照片的按列索引 vs PhotoInfo 列表加路径哈希表：构建、按路径查找和内存）
+ * - PhotoManager::readPhotoData / FileManager::readFile（多种文件大小）
+ * - PhotoManager::readEmbeddedThumbnail（EXIF 缩略图 / HEIF 缩略图项 vs 读取整个文件）
+ * - PhotoManager::readVideoThumbnail（只读取 moov；HEVC 视频有 HEIF 插件时再读取第一个关键帧）
+ * - PhotoPreviewLoader（全尺寸预览：每次读取并解码 vs 命中解码图片缓存）
+ * - PhotoExporter（多个 AFC 连接按块流式导出 vs 逐个读取整个文件再写入）
+ * - AppManager::listApps（500 个应用）
+ * - ContactManager::parseContactEntities（2 万个联系人）
+ * - DeviceInfoManager::getDeviceInfo（按域批量查询 vs 逐键查询）
+ * - DeviceFleet::listAppsOnAll（多台设备逐台串行 vs 每台设备独立线程并行）
+ *
+ * 每个场景输出 ops/sec、p50/p99 延迟和场景前后的常驻内存差值（进程峰值内存只在顶层输出一次），
+ * 结果以 JSON 格式写入标准输出或 --output 指定的文件，便于跨版本追踪性能回归。
+ *
+ * 用法示例：
+ * @code
+ * phone-linkc-bench --iterations 20 --latency-us 500 --output bench.json
+ * phone-linkc-bench --scenario photo   # 只运行名称包含 photo 的场景
+ * @endcode
+ */
+
+#include "platform/libimobiledevice_dynamic.h"
+#include "platform/simulated_backend.h"
+#include "core/file/filemanager.h"
+#include "core/photo/photomanager.h"
+#include "core/photo/thumbnailcache.h"
+#include "core/photo/photocatalog.h"
+#include "core/photo/photolibrary.h"
+#include "core/photo/photoindex.h"
+#include "core/photo/thumbnailpipeline.h"
+#include "core/photo/photoexporter.h"
+#include "core/photo/photopreviewloader.h"
+#include "core/photo/scaleddecoder.h"
+#include "core/app/appmanager.h"
+#include "core/contact/contactmanager.h"
+#include "core/device/deviceinfo.h"
+#include "core/device/devicesession.h"
+#include "core/device/devicefleet.h"
+
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QImageReader>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QLoggingCategory>
+#include <QSysInfo>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <memory>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+namespace {
+
+/* ============================================================================
+ * 测量工具
+ * ============================================================================ */
+
+/**
+ * @brief 获取进程峰值常驻内存（字节）
+ */
+qint64 peakRssBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<qint64>(counters.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<qint64>(usage.ru_maxrss);            // macOS 单位为字节
+#else
+    return static_cast<qint64>(usage.ru_maxrss) * 1024;     // Linux 单位为 KB
+#endif
+#endif
+}
+
+/**
+ * @brief 获取进程当前常驻内存（字节）
+ *
+ * 峰值是整个进程的高水位，前面场景的占用会掩盖后面的场景，因此每个场景只报告自身前后的差值。
+ */
+qint64 currentRssBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<qint64>(counters.WorkingSetSize);
+    }
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return static_cast<qint64>(info.resident_size);
+#else
+    // /proc/self/statm 第二列为常驻页数
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2) {
+        return 0;
+    }
+    return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+#endif
+}
+
+/**
+ * @brief 单次操作的结果
+ */
+struct OpResult {
+    qint64 items = 0;   ///< 处理的条目数（目录项、照片、应用、联系人）
+    qint64 bytes = 0;   ///< 传输的字节数
+    qint64 memory = 0;  ///< 操作产出的数据结构占用的内存（字节），0 表示不统计
+};
+
+/**
+ * @brief 基准测试场景
+ */
+struct Scenario {
+    QString name;                       ///< 场景名称（JSON 中的 name 字段）
+    QString description;                ///< 场景说明
+    std::function<bool()> setUp;        ///< 准备数据和连接，失败时跳过该场景
+    std::function<OpResult()> run;      ///< 被测操作
+    std::function<void()> tearDown;     ///< 释放资源
+};
+
+double percentile(const QVector<qint64> &sorted, double p)
+{
+    if (sorted.isEmpty()) {
+        return 0.0;
+    }
+    const int index = qBound(0, static_cast<int>(p * (sorted.size() - 1) + 0.5), sorted.size() - 1);
+    return sorted[index] / 1e6;
+}
+
+QJsonObject runScenario(const Scenario &scenario, int iterations, int warmup)
+{
+    QJsonObject result;
+    result["name"] = scenario.name;
+    result["description"] = scenario.description;
+
+    const qint64 rssBefore = currentRssBytes();
+    if (scenario.setUp && !scenario.setUp()) {
+        result["skipped"] = true;
+        if (scenario.tearDown) {
+            scenario.tearDown();
+        }
+        return result;
+    }
+
+    for (int i = 0; i < warmup; ++i) {
+        scenario.run();
+    }
+
+    SimulatedBackend::resetStats();
+    QVector<qint64> samples;
+    samples.reserve(iterations);
+    OpResult last;
+    qint64 totalBytes = 0;
+    qint64 totalNs = 0;
+
+    for (int i = 0; i < iterations; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        last = scenario.run();
+        const qint64 ns = timer.nsecsElapsed();
+        samples.append(ns);
+        totalNs += ns;
+        totalBytes += last.bytes;
+    }
+
+    const SimulatedBackend::Stats stats = SimulatedBackend::stats();
+    // 在释放资源之前采样，包含场景准备的数据和测量期间保留的内存
+    const qint64 rssAfter = currentRssBytes();
+    if (scenario.tearDown) {
+        scenario.tearDown();
+    }
+
+    QVector<qint64> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    const double totalSec = totalNs / 1e9;
+
+    result["iterations"] = iterations;
+    result["opsPerSec"] = totalSec > 0 ? iterations / totalSec : 0.0;
+    result["p50Ms"] = percentile(sorted, 0.50);
+    result["p99Ms"] = percentile(sorted, 0.99);
+    result["meanMs"] = iterations > 0 ? totalNs / 1e6 / iterations : 0.0;
+    result["minMs"] = sorted.isEmpty() ? 0.0 : sorted.first() / 1e6;
+    result["maxMs"] = sorted.isEmpty() ? 0.0 : sorted.last() / 1e6;
+    result["itemsPerOp"] = last.items;
+    if (last.items > 0 && totalSec > 0) {
+        result["itemsPerSec"] = last.items * static_cast<double>(iterations) / totalSec;
+    }
+    if (totalBytes > 0 && totalSec > 0) {
+        result["bytesPerOp"] = last.bytes;
+        result["throughputMBps"] = totalBytes / totalSec / (1024.0 * 1024.0);
+    }
+    if (last.memory > 0) {
+        result["memoryBytesPerOp"] = last.memory;
+    }
+    result["roundTripsPerOp"] = iterations > 0 ? static_cast<double>(stats.roundTrips) / iterations : 0.0;
+    result["handshakesPerOp"] = iterations > 0 ? static_cast<double>(stats.handshakes) / iterations : 0.0;
+    result["rssDeltaBytes"] = rssAfter - rssBefore;
+    return result;
+}
+
+QString formatSizeLabel(qint64 bytes)
+{
+    if (bytes >= 1024 * 1024) {
+        return QString("%1MiB").arg(bytes / (1024 * 1024));
+    }
+    return QString("%1KiB").arg(bytes / 1024);
+}
+
+/* ============================================================================
+ * 测试数据
+ * ============================================================================ */
+
+const char *BENCH_UDID = "00008110-0000BENCH0000001";
+const char *LARGE_DIR = "/Bench/Large";
+const char *READ_DIR = "/Bench/Read";
+
+// 多设备场景使用的模拟设备数
+const int FLEET_SIZE = 8;
+
+QStringList fleetUdids()
+{
+    QStringList udids;
+    for (int i = 0; i < FLEET_SIZE; ++i) {
+        udids << QString("00008110-0000FLEET%1").arg(i + 1, 7, 10, QChar('0'));
+    }
+    return udids;
+}
+
+void buildLargeDirectory(int entries)
+{
+    for (int i = 0; i < entries; ++i) {
+        SimulatedBackend::addSyntheticFile(QString("%1/file_%2.dat").arg(LARGE_DIR).arg(i, 5, 10, QChar('0')),
+                                           4096 + (i % 97) * 512);
+    }
+}
+
+/**
+ * @brief 构建多层嵌套的 DCIM 目录
+ *
+ * albums 个顶层相册，每个相册向下嵌套 depth 层子目录，每层 filesPerLevel 个文件，
+ * 其中混有视频和 .AAE 附属文件。
+ */
+int buildDeepDcim(int albums, int depth, int filesPerLevel)
+{
+    const qint64 baseNs = 1704067200LL * 1000000000LL;
+    int mediaCount = 0;
+    int index = 0;
+    for (int album = 0; album < albums; ++album) {
+        QString dir = QString("/DCIM/%1APPLE").arg(100 + album);
+        for (int level = 0; level <= depth; ++level) {
+            if (level > 0) {
+                dir += QString("/SUB%1").arg(level);
+            }
+            SimulatedBackend::addDirectory(dir, baseNs);
+            for (int i = 0; i < filesPerLevel; ++i) {
+                ++index;
+                const qint64 mtime = baseNs + index * 60LL * 1000000000LL;
+                const QString stem = QString("%1/IMG_%2").arg(dir).arg(index, 5, 10, QChar('0'));
+                if (index % 10 == 0) {
+                    SimulatedBackend::addSyntheticFile(stem + ".MOV", 8 * 1024 * 1024, mtime);
+                    ++mediaCount;
+                } else if (index % 5 == 0) {
+                    SimulatedBackend::addSyntheticFile(stem + ".AAE", 812, mtime);
+                } else {
+                    SimulatedBackend::addSyntheticFile(stem + ".JPG", 2 * 1024 * 1024, mtime);
+                    ++mediaCount;
+                }
+            }
+        }
+    }
+    return mediaCount;
+}
+
+/**
+ * @brief 生成 iOS 14 起结构的图库数据库，并作为 /PhotoData/Photos.sqlite 放入模拟文件系统
+ *
+ * assets 个资源分布在 /DCIM/100APPLE 下（每 10 个一个视频、每 7 个一个截屏、每 5 个一个收藏），
+ * 依次分配到 albums 个用户相簿中。
+ */
+void buildPhotosDatabase(int assets, int albums)
+{
+    const QString path = QDir::temp().filePath("phone-linkc-bench-photos.sqlite");
+    QFile::remove(path);
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "bench-photos");
+        db.setDatabaseName(path);
+        db.open();
+        QSqlQuery query(db);
+        query.exec("CREATE TABLE ZASSET (Z_PK INTEGER PRIMARY KEY, ZDIRECTORY TEXT, ZFILENAME TEXT,"
+                   " ZKIND INTEGER, ZKINDSUBTYPE INTEGER, ZFAVORITE INTEGER, ZTRASHEDSTATE INTEGER,"
+                   " ZHIDDEN INTEGER, ZDATECREATED REAL, ZMODIFICATIONDATE REAL)");
+        query.exec("CREATE TABLE ZADDITIONALASSETATTRIBUTES (Z_PK INTEGER PRIMARY KEY, ZASSET INTEGER,"
+                   " ZORIGINALFILESIZE INTEGER)");
+        query.exec("CREATE TABLE ZGENERICALBUM (Z_PK INTEGER PRIMARY KEY, ZKIND INTEGER, ZTITLE TEXT,"
+                   " ZTRASHEDSTATE INTEGER)");
+        query.exec("CREATE TABLE Z_28ASSETS (Z_28ALBUMS INTEGER, Z_3ASSETS INTEGER, Z_FOK_3ASSETS INTEGER)");
+
+        db.transaction();
+        for (int album = 1; album <= albums; ++album) {
+            query.exec(QString("INSERT INTO ZGENERICALBUM VALUES (%1, 2, '相簿 %1', 0)").arg(album));
+        }
+        for (int i = 1; i <= assets; ++i) {
+            const bool video = i % 10 == 0;
+            query.exec(QString("INSERT INTO ZASSET VALUES (%1, 'DCIM/100APPLE', 'IMG_%2.%3', %4, %5, %6, 0, 0, %7, %7)")
+                           .arg(i).arg(i, 5, 10, QChar('0')).arg(video ? "MOV" : "JPG")
+                           .arg(video ? 1 : 0).arg(i % 7 == 0 ? 10 : 0).arg(i % 5 == 0 ? 1 : 0)
+                           .arg(700000000 + i * 60));
+            query.exec(QString("INSERT INTO ZADDITIONALASSETATTRIBUTES VALUES (%1, %1, %2)")
+                           .arg(i).arg(video ? 8 * 1024 * 1024 : 2 * 1024 * 1024));
+            if (albums > 0) {
+                query.exec(QString("INSERT INTO Z_28ASSETS VALUES (%1, %2, %2)").arg(1 + i % albums).arg(i));
+            }
+        }
+        db.commit();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase("bench-photos");
+
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly)) {
+        SimulatedBackend::addFile(PhotoLibrary::DEVICE_PATH, file.readAll());
+    }
+    QFile::remove(path);
+}
+
+/**
+ * @brief 通过模拟的 mobilesync 服务取得一批联系人实体
+ */
+plist_t fetchContactEntities(int count)
+{
+    LibimobiledeviceDynamic &lib = LibimobiledeviceDynamic::instance();
+    SimulatedBackend::setContactCount(count, count);
+
+    idevice_t device = nullptr;
+    if (lib.idevice_new(&device, BENCH_UDID) != IDEVICE_E_SUCCESS) {
+        return nullptr;
+    }
+    mobilesync_client_t client = nullptr;
+    plist_t entities = nullptr;
+    if (lib.mobilesync_client_start_service(device, &client, "phone-linkc-bench") == MOBILESYNC_E_SUCCESS) {
+        uint8_t isLast = 0;
+        lib.mobilesync_get_all_records_from_device(client);
+        lib.mobilesync_receive_changes(client, &entities, &isLast, nullptr);
+        lib.mobilesync_client_free(client);
+    }
+    lib.idevice_free(device);
+    return entities;
+}
+
+/* ============================================================================
+ * 场景定义
+ * ============================================================================ */
+
+QVector<Scenario> buildScenarios()
+{
+    QVector<Scenario> scenarios;
+
+    // ----- FileManager::listDirectory -----
+    {
+        auto manager = std::make_shared<FileManager>();
+        const int entries = 10000;
+        Scenario s;
+        s.name = "file.listDirectory.10k";
+        s.description = "FileManager::listDirectory 读取含 1 万个文件的目录";
+        s.setUp = [manager, entries]() {
+            SimulatedBackend::clearFileSystem();
+            buildLargeDirectory(entries);
+            return manager->connectToDevice(BENCH_UDID);
+        };
+        s.run = [manager]() {
+            OpResult r;
+            r.items = manager->listDirectory(LARGE_DIR).size();
+            return r;
+        };
+        s.tearDown = [manager]() { manager->disconnectFromDevice(); };
+        scenarios << s;
+    }
+
+    // ----- PhotoManager::getAllPhotos -----
+    {
+        auto manager = std::make_shared<PhotoManager>();
+        Scenario s;
+        s.name = "photo.getAllPhotos.deepDcim";
+        s.description = "PhotoManager::getAllPhotos 扫描 20 个相册 × 4 层嵌套 × 每层 100 个文件的 DCIM";
+        s.setUp = [manager]() {
+            SimulatedBackend::clearFileSystem();
+            buildDeepDcim(20, 3, 100);
+            manager->setCatalogEnabled(false);
+            return manager->connectToDevice(BENCH_UDID);
+        };
+        s.run = [manager]() {
+            OpResult r;
+            r.items = manager->getAllPhotos().size();
+            return r;
+        };
+        s.tearDown = [manager]() { manager->disconnect(); };
+        scenarios << s;
+    }
+
+    // ----- PhotoScanner 扫描耗时 vs AFC 连接数 -----
+    for (int connections : {1, 2, 4, 8}) {
+        auto manager = std::make_shared<PhotoManager>();
+        Scenario s;
+        s.name = QString("photo.scanParallel.deepDcim.c%1").arg(connections);
+        s.description = QString("PhotoManager::getAllPhotos 使用 %1 个 AFC 连接扫描同一 DCIM").arg(connections);
+        s.setUp = [manager, connections]() {
+            SimulatedBackend::clearFileSystem();
+            buildDeepDcim(20, 3, 100);
+            manager->setScanConnections(connections);
+            manager->setCatalogEnabled(false);
+            return manager->connectToDevice(BENCH_UDID);
+        };
+        s.run = [manager]() {
+            OpResult r;
+            r.items = manager->getAllPhotos().size();
+            return r;
+        };
+        s.tearDown = [manager]() { manager->disconnect(); };
+        scenarios << s;
+    }
+
+    // ----- PhotoCatalog 增量刷新 -----
+    {
+        auto manager = std::make_shared<PhotoManager>();
+        auto setUpCatalog = [manager]() {
+            SimulatedBackend::clearFileSystem();
+            buildDeepDcim(20, 3, 100);
+            PhotoCatalog(BENCH_UDID).clear();
+            manager->setCatalogEnabled(true);
+            if (!manager->connectToDevice(BENCH_UDID)) {
+                return false;
+            }
+            // 首次完整扫描写入照片目录，之后的迭代都是增量刷新
+            return !manager->getAllPhotos().isEmpty();
+        };
+
+        Scenario unchanged;
+        unchanged.name = "photo.catalog.refreshUnchanged";
+        unchanged.description = "PhotoManager::getAllPhotos 在图库未变化时的增量刷新（每个目录一次 stat）";
+        unchanged.setUp = setUpCatalog;
+        unchanged.run = [manager]() {
+            OpResult r;
+            r.items = manager->getAllPhotos().size();
+            return r;
+        };
+        unchanged.tearDown = [manager]() {
+            manager->disconnect();
+            PhotoCatalog(BENCH_UDID).clear();
+        };
+        scenarios << unchanged;
+
+        auto added = std::make_shared<int>(0);
+        Scenario oneNew;
+        oneNew.name = "photo.catalog.refreshOneNewFile";
+        oneNew.description = "每次迭代在一个相册中新增一张照片后增量刷新（只重新读取该目录）";
+        oneNew.setUp = setUpCatalog;
+        oneNew.run = [manager, added]() {
+            SimulatedBackend::addSyntheticFile(QString("/DCIM/100APPLE/NEW_%1.JPG").arg(++*added, 5, 10, QChar('0')),
+                                               2 * 1024 * 1024);
+            OpResult r;
+            r.items = manager->getAllPhotos().size();
+            return r;
+        };
+        oneNew.tearDown = unchanged.tearDown;
+        scenarios << oneNew;
+    }
+
+    // ----- PhotoLibrary 图库数据库 -----
+    // 首次同步在 setUp 中完成，之后的同步只比较三个文件的大小和 st_mtime
+    {
+        const int assets = 20000;
+        auto setUpLibrary = [assets]() {
+            SimulatedBackend::clearFileSystem();
+            QDir(PhotoLibrary::cacheDirectory(BENCH_UDID)).removeRecursively();
+            buildPhotosDatabase(assets, 50);
+        };
+        auto tearDownLibrary = []() {
+            QDir(PhotoLibrary::cacheDirectory(BENCH_UDID)).removeRecursively();
+        };
+
+        auto session = std::make_shared<DeviceSession::Ptr>();
+        Scenario unchanged;
+        unchanged.name = "photo.library.syncUnchanged";
+        unchanged.description = QString("PhotoLibrary::sync 在图库数据库未变化时的同步（%1 个资源）").arg(assets);
+        unchanged.setUp = [setUpLibrary, session]() {
+            setUpLibrary();
+            *session = DeviceSession::acquire(BENCH_UDID);
+            afc_client_t client = *session ? (*session)->createAfcClient() : nullptr;
+            const bool ok = client && PhotoLibrary(BENCH_UDID).sync(client);
+            if (client) {
+                LibimobiledeviceDynamic::instance().afc_client_free(client);
+            }
+            return ok;
+        };
+        unchanged.run = [session]() {
+            OpResult r;
+            afc_client_t client = (*session)->createAfcClient();
+            PhotoLibrary library(BENCH_UDID);
+            bool changed = true;
+            if (library.sync(client, &changed) && !changed) {
+                r.items = 1;
+            }
+            LibimobiledeviceDynamic::instance().afc_client_free(client);
+            return r;
+        };
+        unchanged.tearDown = [session, tearDownLibrary]() {
+            session->reset();
+            tearDownLibrary();
+        };
+        scenarios << unchanged;
+
+        auto manager = std::make_shared<PhotoManager>();
+        Scenario query;
+        query.name = "photo.library.albumQuery";
+        query.description = QString("PhotoManager::getLibraryPhotos 切换到一个用户相簿（本地查询，%1 个资源）").arg(assets);
+        query.setUp = [setUpLibrary, manager]() {
+            setUpLibrary();
+            if (!manager->connectToDevice(BENCH_UDID)) {
+                return false;
+            }
+            QEventLoop loop;
+            QObject::connect(manager.get(), &PhotoManager::libraryAlbumsReady, &loop, &QEventLoop::quit);
+            manager->startLibrarySync();
+            loop.exec();
+            return true;
+        };
+        query.run = [manager]() {
+            OpResult r;
+            r.items = manager->getLibraryPhotos(QString(PhotoLibrary::ALBUM_PREFIX) + "1").size();
+            return r;
+        };
+        query.tearDown = [manager, tearDownLibrary]() {
+            manager->disconnect();
+            tearDownLibrary();
+        };
+        scenarios << query;
+    }
+
+    // ----- PhotoIndex vs PhotoInfo 列表 -----
+    {
+        const int assets = 100000;
+        auto photos = std::make_shared<QVector<PhotoInfo>>();
+        auto setUpPhotos = [photos, assets]() {
+            photos->clear();
+            photos->reserve(assets);
+            const QDateTime base = QDateTime::fromSecsSinceEpoch(1600000000);
+            for (int i = 0; i < assets; ++i) {
+                PhotoInfo info;
+                info.name = QString("IMG_%1.%2").arg(i % 10000, 4, 10, QChar('0')).arg(i % 10 == 0 ? "MOV" : "HEIC");
+                info.path = QString("/DCIM/%1APPLE/%2").arg(100 + i / 1000).arg(info.name);
+                info.size = 2 * 1024 * 1024 + i;
+                info.modifiedTime = base.addSecs(i);
+                info.isVideo = i % 10 == 0;
+                photos->append(info);
+            }
+            return true;
+        };
+        auto tearDownPhotos = [photos]() {
+            photos->clear();
+            photos->squeeze();
+        };
+
+        Scenario list;
+        list.name = "photo.index.photoInfoList.100k";
+        list.description = QString("QVector<PhotoInfo> 加路径 -> 行号哈希表：构建并按路径查找全部 %1 张照片").arg(assets);
+        list.setUp = setUpPhotos;
+        list.run = [photos]() {
+            OpResult r;
+            // 逐个复制，与网格模型追加照片时的行为一致（不共享源列表的字符串）
+            QVector<PhotoInfo> copies;
+            QHash<QString, int> rows;
+            copies.reserve(photos->size());
+            rows.reserve(photos->size());
+            for (const PhotoInfo &photo : *photos) {
+                PhotoInfo copy;
+                copy.path = QString(photo.path.constData(), photo.path.size());
+                copy.name = QString(photo.name.constData(), photo.name.size());
+                copy.size = photo.size;
+                copy.modifiedTime = photo.modifiedTime;
+                copy.isVideo = photo.isVideo;
+                rows.insert(copy.path, copies.size());
+                copies.append(copy);
+            }
+            for (const PhotoInfo &photo : *photos) {
+                if (rows.value(photo.path, -1) >= 0) {
+                    ++r.items;
+                }
+            }
+            // 估算：结构体 + 两个 UTF-16 字符串（含 QArrayData 头）+ 哈希表节点
+            for (const PhotoInfo &photo : copies) {
+                r.memory += sizeof(PhotoInfo) + (photo.path.size() + photo.name.size()) * 2 + 2 * 24
+                            + sizeof(QString) + sizeof(int) + 16;
+            }
+            return r;
+        };
+        list.tearDown = tearDownPhotos;
+        scenarios << list;
+
+        Scenario index;
+        index.name = "photo.index.photoIndex.100k";
+        index.description = QString("PhotoIndex 按列索引：构建并按路径查找全部 %1 张照片").arg(assets);
+        index.setUp = setUpPhotos;
+        index.run = [photos]() {
+            OpResult r;
+            PhotoIndex photoIndex;
+            photoIndex.reserve(photos->size());
+            photoIndex.append(*photos);
+            for (const PhotoInfo &photo : *photos) {
+                if (photoIndex.indexOf(photo.path) >= 0) {
+                    ++r.items;
+                }
+            }
+            r.memory = photoIndex.memoryUsage();
+            return r;
+        };
+        index.tearDown = tearDownPhotos;
+        scenarios << index;
+    }
+
+    // ----- PhotoManager 流式扫描首批延迟 -----
+    {
+        auto manager = std::make_shared<PhotoManager>();
+        auto connection = std::make_shared<QMetaObject::Connection>();
+        Scenario s;
+        s.name = "photo.scanStreaming.firstBatch";
+        s.description = "PhotoManager::scanPhotosStreaming 在同一 DCIM 上产出第一批照片所需时间（收到后即取消）";
+        s.setUp = [manager, connection]() {
+            SimulatedBackend::clearFileSystem();
+            buildDeepDcim(20, 3, 100);
+            // 扫描在当前线程同步执行，信号直接回调
+            *connection = QObject::connect(manager.get(), &PhotoManager::photosBatchReady, manager.get(),
+                             [raw = manager.get()](quint64, const QString &, const QVector<PhotoInfo> &) {
+                                 raw->cancelPhotoScan();
+                             });
+            manager->setCatalogEnabled(false);
+            return manager->connectToDevice(BENCH_UDID);
+        };
+        s.run = [manager]() {
+            OpResult r;
+            r.items = manager->scanPhotosStreaming();
+            return r;
+        };
+        s.tearDown = [manager, connection]() {
+            QObject::disconnect(*connection);
+            manager->disconnect();
+        };
+        scenarios << s;
+    }
+
+    // ----- 文件读取吞吐量 -----
+    const QVector<qint64> sizes = {64 * 1024, 1024 * 1024, 8 * 1024 * 1024, 32 * 1024 * 1024};
+    for (qint64 size : sizes) {
+        const QString path = QString("%1/blob_%2.JPG").arg(READ_DIR).arg(size);
+        auto setUpFile = [path, size]() {
+            SimulatedBackend::clearFileSystem();
+            SimulatedBackend::addSyntheticFile(path, size);
+        };
+
+        auto photoManager = std::make_shared<PhotoManager>();
+        Scenario photo;
+        photo.name = QString("photo.readPhotoData.%1").arg(formatSizeLabel(size));
+        photo.description = QString("PhotoManager::readPhotoData 读取 %1 文件").arg(formatSizeLabel(size));
+        photo.setUp = [photoManager, setUpFile]() {
+            setUpFile();
+            return photoManager->connectToDevice(BENCH_UDID);
+        };
+        photo.run = [photoManager, path]() {
+            OpResult r;
+            r.bytes = photoManager->readPhotoData(path).size();
+            r.items = 1;
+            return r;
+        };
+        photo.tearDown = [photoManager]() { photoManager->disconnect(); };
+        scenarios << photo;
+
+        auto fileManager = std::make_shared<FileManager>();
+        Scenario file;
+        file.name = QString("file.readFile.%1").arg(formatSizeLabel(size));
+        file.description = QString("FileManager::readFile 读取 %1 文件").arg(formatSizeLabel(size));
+        file.setUp = [fileManager, setUpFile]() {
+            setUpFile();
+            return fileManager->connectToDevice(BENCH_UDID);
+        };
+        file.run = [fileManager, path]() {
+            OpResult r;
+            r.bytes = fileManager->readFile(path).size();
+            r.items = 1;
+            return r;
+        };
+        file.tearDown = [fileManager]() { fileManager->disconnectFromDevice(); };
+        scenarios << file;
+    }
+
+    // ----- EXIF 内嵌缩略图 vs 整个文件 -----
+    // bytes 为从设备读取的字节数，两个场景对比缩略图生成的 USB 传输量
+    {
+        const QString path = QString("%1/IMG_4MB.JPG").arg(READ_DIR);
+        const qint64 size = 4 * 1024 * 1024;
+        auto manager = std::make_shared<PhotoManager>();
+        auto setUp = [manager, path, size]() {
+            SimulatedBackend::clearFileSystem();
+            SimulatedBackend::addSyntheticFile(path, size);
+            return manager->connectToDevice(BENCH_UDID);
+        };
+        auto tearDown = [manager]() { manager->disconnect(); };
+
+        Scenario embedded;
+        embedded.name = "photo.thumbnailSource.exif.4MB";
+        embedded.description = "PhotoManager::readEmbeddedThumbnail 从 4MB JPEG 头部提取 EXIF 缩略图";
+        embedded.setUp = setUp;
+        embedded.run = [manager, path, size]() {
+            OpResult r;
+            ExifThumbnail::Result result = manager->readEmbeddedThumbnail(path, size);
+            r.bytes = result.bytesRead;
+            r.items = result.data.isEmpty() ? 0 : 1;
+            return r;
+        };
+        embedded.tearDown = tearDown;
+        scenarios << embedded;
+
+        Scenario full;
+        full.name = "photo.thumbnailSource.fullFile.4MB";
+        full.description = "PhotoManager::readPhotoData 读取整个 4MB JPEG 用于生成缩略图";
+        full.setUp = setUp;
+        full.run = [manager, path]() {
+            OpResult r;
+            r.bytes = manager->readPhotoData(path).size();
+            r.items = 1;
+            return r;
+        };
+        full.tearDown = tearDown;
+        scenarios << full;
+    }
+    {
+        const QString path = QString("%1/IMG_4MB.HEIC").arg(READ_DIR);
+        const qint64 size = 4 * 1024 * 1024;
+        auto manager = std::make_shared<PhotoManager>();
+        Scenario s;
+        s.name = "photo.thumbnailSource.heif.4MB";
+        s.description = "PhotoManager::readEmbeddedThumbnail 从 4MB HEIC 中只读取 meta 和 HEVC 缩略图项"
+                        "（与缩略图流水线相同：没有 HEIF 插件时只读取 meta）";
+        s.setUp = [manager, path, size]() {
+            SimulatedBackend::clearFileSystem();
+            SimulatedBackend::addSyntheticFile(path, size);
+            return manager->connectToDevice(BENCH_UDID);
+        };
+        s.run = [manager, path, size]() {
+            OpResult r;
+            const QList<QByteArray> formats = QImageReader::supportedImageFormats();
+            const bool canDecodeHeif = formats.contains("heic") || formats.contains("heif");
+            ExifThumbnail::Result result = manager->readEmbeddedThumbnail(path, size, canDecodeHeif);
+            r.bytes = result.bytesRead;
+            r.items = result.data.isEmpty() ? 0 : 1;
+            return r;
+        };
+        s.tearDown = [manager]() { manager->disconnect(); };
+        scenarios << s;
+    }
+    {
+        const QString path = QString("%1/IMG_64MB.MOV").arg(READ_DIR);
+        const qint64 size = 64 * 1024 * 1024;
+        auto manager = std::make_shared<PhotoManager>();
+        Scenario s;
+        s.name = "photo.thumbnailSource.video.64MB";
+        s.description = "PhotoManager::readVideoThumbnail 从 64MB HEVC MOV 中读取时长"
+                        "（与缩略图流水线相同：只有 HEIF 插件可用时才读取第一个关键帧）";
+        s.setUp = [manager, path, size]() {
+            SimulatedBackend::clearFileSystem();
+            SimulatedBackend::addSyntheticFile(path, size);
+            return manager->connectToDevice(BENCH_UDID);
+        };
+        s.run = [manager, path, size]() {
+            const QList<QByteArray> formats = QImageReader::supportedImageFormats();
+            const bool canDecodeHeif = formats.contains("heic") || formats.contains("heif");
+            OpResult r;
+            VideoThumbnail::Result result = manager->readVideoThumbnail(path, size, canDecodeHeif);
+            r.bytes = result.bytesRead;
+            // 真机视频在这里通常只得到时长，封面帧来自设备缩略图或 HEIF 插件
+            r.items = result.durationMs > 0 ? 1 : 0;
+            return r;
+        };
+        s.tearDown = [manager]() { manager->disconnect(); };
+        scenarios << s;
+    }
+
+    // ----- 缩略图解码：完整解码 + 平滑缩放 vs IDCT 缩放 + 面积平均 -----
+    {
+        auto jpeg = std::make_shared<QByteArray>();
+        auto setUpJpeg = [jpeg]() {
+            // 渐变而不是纯色，避免编码结果过小、解码过快
+            QImage image(4032, 3024, QImage::Format_RGB32);
+            for (int y = 0; y < image.height(); ++y) {
+                QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+                for (int x = 0; x < image.width(); ++x) {
+                    line[x] = qRgb(x & 0xff, y & 0xff, (x + y) & 0xff);
+                }
+            }
+            jpeg->clear();
+            QBuffer buffer(jpeg.get());
+            buffer.open(QIODevice::WriteOnly);
+            return image.save(&buffer, "JPEG", 90);
+        };
+        auto tearDownJpeg = [jpeg]() { jpeg->clear(); };
+
+        Scenario full;
+        full.name = "photo.decode.fullSmooth.12MP";
+        full.description = "4032x3024 JPEG 完整解码后平滑缩放到 100px";
+        full.setUp = setUpJpeg;
+        full.run = [jpeg]() {
+            OpResult r;
+            QImage image;
+            if (image.loadFromData(*jpeg)) {
+                image = image.scaled(100, 100, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+                r.items = 1;
+                r.bytes = jpeg->size();
+            }
+            return r;
+        };
+        full.tearDown = tearDownJpeg;
+        scenarios << full;
+
+        Scenario scaled;
+        scaled.name = "photo.decode.scaledJpeg.12MP";
+        scaled.description = "4032x3024 JPEG 以 1/8 分辨率解码后面积平均缩小到 100px（ScaledDecoder）";
+        scaled.setUp = setUpJpeg;
+        scaled.run = [jpeg]() {
+            OpResult r;
+            if (!ScaledDecoder::decode(*jpeg, QSize(100, 100)).isNull()) {
+                r.items = 1;
+                r.bytes = jpeg->size();
+            }
+            return r;
+        };
+        scaled.tearDown = tearDownJpeg;
+        scenarios << scaled;
+    }
+
+    // ----- ThumbnailCache 命中读取 -----
+    {
+        const int count = 2000;
+        auto cache = std::make_shared<ThumbnailCache::Ptr>();
+        auto photos = std::make_shared<QVector<PhotoInfo>>();
+        Scenario s;
+        s.name = "photo.thumbnailCache.find2k";
+        s.description = "ThumbnailCache::find 读取 2000 个 8KB 缩略图（对比 photo.readPhotoData.* 的设备读取）";
+        s.setUp = [cache, photos, count]() {
+            *cache = ThumbnailCache::forDevice("phone-linkc-bench");
+            (*cache)->clear();
+            photos->clear();
+            const QByteArray payload(8 * 1024, 'T');
+            const QDateTime mtime = QDateTime::fromSecsSinceEpoch(1700000000);
+            for (int i = 0; i < count; ++i) {
+                PhotoInfo photo;
+                photo.path = QString("/DCIM/100APPLE/IMG_%1.JPG").arg(i, 4, 10, QChar('0'));
+                photo.size = 2 * 1024 * 1024;
+                photo.modifiedTime = mtime;
+                (*cache)->insert(photo, payload);
+                photos->append(photo);
+            }
+            return (*cache)->count() == count;
+        };
+        s.run = [cache, photos]() {
+            OpResult r;
+            for (const PhotoInfo &photo : *photos) {
+                const qint64 size = (*cache)->find(photo).size();
+                if (size > 0) {
+                    r.items++;
+                    r.bytes += size;
+                }
+            }
+            return r;
+        };
+        s.tearDown = [cache]() {
+            (*cache)->clear();
+            cache->reset();
+        };
+        scenarios << s;
+    }
+
+    // ----- ThumbnailPipeline 生成缩略图 -----
+    // 每次迭代前清空本地缓存，测量的是设备读取 + 解码缩放的完整流水线
+    {
+        const int count = 200;
+        auto pipeline = std::make_shared<std::unique_ptr<ThumbnailPipeline>>();
+        auto photos = std::make_shared<QVector<PhotoInfo>>();
+        Scenario s;
+        s.name = "photo.thumbnailPipeline.200";
+        s.description = QString("ThumbnailPipeline 为 200 张 640x480 JPEG 生成缩略图（%1 个解码线程）")
+                            .arg(QThread::idealThreadCount());
+        s.setUp = [pipeline, photos, count]() {
+            SimulatedBackend::clearFileSystem();
+            photos->clear();
+            const QDateTime mtime = QDateTime::fromSecsSinceEpoch(1700000000);
+            for (int i = 0; i < count; ++i) {
+                PhotoInfo photo;
+                photo.path = QString("/DCIM/100APPLE/IMG_%1.JPG").arg(i, 4, 10, QChar('0'));
+                photo.name = photo.path.section('/', -1);
+                photo.size = 256 * 1024;
+                photo.modifiedTime = mtime;
+                SimulatedBackend::addSyntheticFile(photo.path, photo.size);
+                photos->append(photo);
+            }
+            *pipeline = std::make_unique<ThumbnailPipeline>();
+            (*pipeline)->setDevice(BENCH_UDID);
+            return true;
+        };
+        s.run = [pipeline, photos]() {
+            OpResult r;
+            ThumbnailCache::forDevice(BENCH_UDID)->clear();
+
+            QEventLoop loop;
+            QObject::connect(pipeline->get(), &ThumbnailPipeline::thumbnailsReady, &loop,
+                             [&r, &loop, photos](const QVector<ThumbnailResult> &results) {
+                r.items += results.size();
+                if (r.items >= photos->size()) {
+                    loop.quit();
+                }
+            });
+            QTimer::singleShot(60000, &loop, &QEventLoop::quit);
+            (*pipeline)->request(*photos);
+            loop.exec();
+            return r;
+        };
+        s.tearDown = [pipeline]() {
+            pipeline->reset();
+            ThumbnailCache::forDevice(BENCH_UDID)->clear();
+        };
+        scenarios << s;
+    }
+
+    // 同样 200 张，但设备上有 /PhotoData/Thumbnails/V2 下的系统缩略图：每张只读取一个小 JPEG
+    {
+        const int count = 200;
+        auto pipeline = std::make_shared<std::unique_ptr<ThumbnailPipeline>>();
+        auto photos = std::make_shared<QVector<PhotoInfo>>();
+        Scenario s;
+        s.name = "photo.thumbnailPipeline.deviceThumbnails.200";
+        s.description = "ThumbnailPipeline 读取设备预生成的缩略图（200 张，每张 256x192 JPEG）";
+        s.setUp = [pipeline, photos, count]() {
+            SimulatedBackend::clearFileSystem();
+            photos->clear();
+
+            QImage image(256, 192, QImage::Format_RGB32);
+            image.fill(qRgb(90, 140, 200));
+            QByteArray thumbnail;
+            QBuffer buffer(&thumbnail);
+            buffer.open(QIODevice::WriteOnly);
+            image.save(&buffer, "JPEG", 80);
+
+            const QDateTime mtime = QDateTime::fromSecsSinceEpoch(1700000000);
+            for (int i = 0; i < count; ++i) {
+                PhotoInfo photo;
+                photo.path = QString("/DCIM/100APPLE/IMG_%1.JPG").arg(i, 4, 10, QChar('0'));
+                photo.name = photo.path.section('/', -1);
+                photo.size = 256 * 1024;
+                photo.modifiedTime = mtime;
+                SimulatedBackend::addSyntheticFile(photo.path, photo.size);
+                SimulatedBackend::addFile(DeviceThumbnail::thumbnailDirectory(photo.path) + "/5005.JPG", thumbnail);
+                photos->append(photo);
+            }
+            *pipeline = std::make_unique<ThumbnailPipeline>();
+            (*pipeline)->setDevice(BENCH_UDID);
+            return true;
+        };
+        s.run = [pipeline, photos]() {
+            OpResult r;
+            ThumbnailCache::forDevice(BENCH_UDID)->clear();
+
+            QEventLoop loop;
+            QObject::connect(pipeline->get(), &ThumbnailPipeline::thumbnailsReady, &loop,
+                             [&r, &loop, photos](const QVector<ThumbnailResult> &results) {
+                r.items += results.size();
+                if (r.items >= photos->size()) {
+                    loop.quit();
+                }
+            });
+            QTimer::singleShot(60000, &loop, &QEventLoop::quit);
+            (*pipeline)->request(*photos);
+            loop.exec();
+            return r;
+        };
+        s.tearDown = [pipeline]() {
+            pipeline->reset();
+            ThumbnailCache::forDevice(BENCH_UDID)->clear();
+        };
+        scenarios << s;
+    }
+
+    // 2000 张排队后跳到末尾：测量末尾一屏（24 张）全部到达的时间，其余请求在结束时取消
+    {
+        const int count = 2000;
+        const int screen = 24;
+        auto pipeline = std::make_shared<std::unique_ptr<ThumbnailPipeline>>();
+        auto photos = std::make_shared<QVector<PhotoInfo>>();
+        Scenario s;
+        s.name = "photo.thumbnailPipeline.visibleFirst.2k";
+        s.description = "ThumbnailPipeline 排队 2000 张后将最后 24 张提升为可见，测量可见项全部到达的耗时";
+        s.setUp = [pipeline, photos, count]() {
+            SimulatedBackend::clearFileSystem();
+            photos->clear();
+            const QDateTime mtime = QDateTime::fromSecsSinceEpoch(1700000000);
+            for (int i = 0; i < count; ++i) {
+                PhotoInfo photo;
+                photo.path = QString("/DCIM/100APPLE/IMG_%1.JPG").arg(i, 4, 10, QChar('0'));
+                photo.name = photo.path.section('/', -1);
+                photo.size = 256 * 1024;
+                photo.modifiedTime = mtime;
+                SimulatedBackend::addSyntheticFile(photo.path, photo.size);
+                photos->append(photo);
+            }
+            *pipeline = std::make_unique<ThumbnailPipeline>();
+            (*pipeline)->setDevice(BENCH_UDID);
+            return true;
+        };
+        s.run = [pipeline, photos, screen]() {
+            OpResult r;
+            ThumbnailCache::forDevice(BENCH_UDID)->clear();
+
+            QVector<QString> visible;
+            QSet<QString> wanted;
+            for (int i = photos->size() - screen; i < photos->size(); ++i) {
+                visible.append(photos->at(i).path);
+                wanted.insert(photos->at(i).path);
+            }
+
+            QEventLoop loop;
+            QObject::connect(pipeline->get(), &ThumbnailPipeline::thumbnailsReady, &loop,
+                             [&r, &loop, &wanted, screen](const QVector<ThumbnailResult> &results) {
+                for (const ThumbnailResult &result : results) {
+                    if (wanted.contains(result.path)) {
+                        r.items++;
+                    }
+                }
+                if (r.items >= screen) {
+                    loop.quit();
+                }
+            });
+            QTimer::singleShot(60000, &loop, &QEventLoop::quit);
+            (*pipeline)->request(*photos);
+            (*pipeline)->prioritize(visible, QVector<QString>());
+            loop.exec();
+            (*pipeline)->cancelAll();
+            return r;
+        };
+        s.tearDown = [pipeline]() {
+            pipeline->reset();
+            ThumbnailCache::forDevice(BENCH_UDID)->clear();
+        };
+        scenarios << s;
+    }
+
+    // ----- 全尺寸预览：解码 vs 解码图片缓存 -----
+    for (bool cached : {false, true}) {
+        const QString path = "/DCIM/100APPLE/IMG_0001.JPG";
+        auto loader = std::make_shared<std::unique_ptr<PhotoPreviewLoader>>();
+        Scenario s;
+        s.name = cached ? "photo.preview.cached" : "photo.preview.decode";
+        s.description = cached
+            ? "PhotoPreviewLoader 再次打开同一张照片（命中解码图片缓存，4032x3024 JPEG）"
+            : "PhotoPreviewLoader 打开照片（读取整个文件并解码，4032x3024 JPEG）";
+        s.setUp = [loader, path, cached]() {
+            SimulatedBackend::clearFileSystem();
+            QImage image(4032, 3024, QImage::Format_RGB32);
+            image.fill(qRgb(120, 160, 90));
+            QByteArray jpeg;
+            QBuffer buffer(&jpeg);
+            buffer.open(QIODevice::WriteOnly);
+            image.save(&buffer, "JPEG", 90);
+            SimulatedBackend::addFile(path, jpeg);
+
+            *loader = std::make_unique<PhotoPreviewLoader>();
+            (*loader)->setDevice(BENCH_UDID);
+            // 预算小于一张图片时每次都重新读取和解码
+            (*loader)->setCacheLimit(cached ? ImageCache::DEFAULT_MAX_BYTES : 1024);
+            return true;
+        };
+        s.run = [loader, path]() {
+            OpResult r;
+            PhotoInfo photo;
+            photo.path = path;
+            photo.name = path.section('/', -1);
+
+            QEventLoop loop;
+            QObject::connect(loader->get(), &PhotoPreviewLoader::previewReady, &loop,
+                             [&r, &loop](const QString &, const QImage &image, bool fullSize) {
+                if (fullSize) {
+                    r.items = 1;
+                    r.bytes = image.sizeInBytes();
+                    loop.quit();
+                }
+            });
+            QObject::connect(loader->get(), &PhotoPreviewLoader::previewFailed, &loop, &QEventLoop::quit);
+            QTimer::singleShot(60000, &loop, &QEventLoop::quit);
+            (*loader)->load(photo, {}, false);
+            loop.exec();
+            return r;
+        };
+        s.tearDown = [loader]() { loader->reset(); };
+        scenarios << s;
+    }
+
+    // ----- 批量导出 -----
+    // 逐个读取整个文件再写入（原导出方式） vs PhotoExporter 多连接按块流式写入
+    {
+        const int files = 32;
+        const qint64 size = 4 * 1024 * 1024;
+        const QString exportDir = QDir::temp().filePath("phone-linkc-bench-export");
+        auto photos = std::make_shared<QVector<PhotoInfo>>();
+        auto setUpFiles = [photos, files, size]() {
+            SimulatedBackend::clearFileSystem();
+            photos->clear();
+            for (int i = 0; i < files; ++i) {
+                PhotoInfo photo;
+                photo.path = QString("%1/IMG_%2.JPG").arg(READ_DIR).arg(i, 4, 10, QChar('0'));
+                photo.name = QString("IMG_%1.JPG").arg(i, 4, 10, QChar('0'));
+                photo.size = size;
+                photo.modifiedTime = QDateTime::currentDateTime().addDays(-1);
+                SimulatedBackend::addSyntheticFile(photo.path, size);
+                photos->append(photo);
+            }
+        };
+        auto resetDir = [exportDir]() {
+            QDir(exportDir).removeRecursively();
+            QDir().mkpath(exportDir);
+        };
+
+        auto manager = std::make_shared<PhotoManager>();
+        Scenario whole;
+        whole.name = QString("photo.export.readWhole.%1x4MB").arg(files);
+        whole.description = QString("逐个 readPhotoData 读取整个文件后写入本地（%1 个 4MB 文件）").arg(files);
+        whole.setUp = [manager, setUpFiles]() {
+            setUpFiles();
+            return manager->connectToDevice(BENCH_UDID);
+        };
+        whole.run = [manager, photos, exportDir, resetDir]() {
+            OpResult r;
+            resetDir();
+            for (const PhotoInfo &photo : *photos) {
+                const QByteArray data = manager->readPhotoData(photo.path);
+                QFile file(QDir(exportDir).filePath(photo.name));
+                if (file.open(QIODevice::WriteOnly) && file.write(data) == data.size()) {
+                    r.items++;
+                    r.bytes += data.size();
+                }
+            }
+            return r;
+        };
+        whole.tearDown = [manager, exportDir]() {
+            manager->disconnect();
+            QDir(exportDir).removeRecursively();
+        };
+        scenarios << whole;
+
+        Scenario streaming;
+        streaming.name = QString("photo.export.streaming%1.%2x4MB").arg(PhotoExporter::DEFAULT_CONNECTIONS).arg(files);
+        streaming.description = QString("PhotoExporter 以 %1 个 AFC 连接按块流式导出（%2 个 4MB 文件）")
+            .arg(PhotoExporter::DEFAULT_CONNECTIONS).arg(files);
+        streaming.setUp = [setUpFiles]() {
+            setUpFiles();
+            return true;
+        };
+        streaming.run = [photos, exportDir, resetDir]() {
+            OpResult r;
+            resetDir();
+            PhotoExporter exporter(BENCH_UDID);
+            const PhotoExporter::Result result = exporter.run(PhotoExporter::jobsForDirectory(*photos, exportDir));
+            r.items = result.exported;
+            r.bytes = result.bytes;
+            return r;
+        };
+        streaming.tearDown = [exportDir]() { QDir(exportDir).removeRecursively(); };
+        scenarios << streaming;
+    }
+
+    // ----- AppManager::listApps -----
+    {
+        auto manager = std::make_shared<AppManager>();
+        Scenario s;
+        s.name = "app.listApps.500";
+        s.description = "AppManager::listApps 解析 500 个应用（含磁盘使用）";
+        s.setUp = [manager]() {
+            SimulatedBackend::setAppCount(500);
+            return manager->connectToDevice(BENCH_UDID);
+        };
+        s.run = [manager]() {
+            OpResult r;
+            r.items = manager->listApps(true).size();
+            return r;
+        };
+        s.tearDown = [manager]() { manager->disconnectFromDevice(); };
+        scenarios << s;
+    }
+
+    // ----- DeviceInfoManager::getDeviceInfo -----
+    // 场景期间持有会话，测量结果只包含 lockdown 查询往返，不含握手
+    {
+        auto manager = std::make_shared<DeviceInfoManager>();
+        auto session = std::make_shared<DeviceSession::Ptr>();
+        auto setUp = [session]() {
+            *session = DeviceSession::acquire(BENCH_UDID);
+            return *session != nullptr;
+        };
+        auto tearDown = [session]() { session->reset(); };
+
+        Scenario bulk;
+        bulk.name = "device.getDeviceInfo.bulk";
+        bulk.description = "DeviceInfoManager::getDeviceInfo 按域批量查询（3 次往返）";
+        bulk.setUp = setUp;
+        bulk.run = [manager]() {
+            OpResult r;
+            r.items = manager->getDeviceInfo(BENCH_UDID).name.isEmpty() ? 0 : 1;
+            return r;
+        };
+        bulk.tearDown = tearDown;
+        scenarios << bulk;
+
+        Scenario perKey;
+        perKey.name = "device.getDeviceInfo.perKey";
+        perKey.description = "DeviceInfoManager::getDeviceInfoPerKey 逐键查询（每个属性一次往返）";
+        perKey.setUp = setUp;
+        perKey.run = [manager]() {
+            OpResult r;
+            r.items = manager->getDeviceInfoPerKey(BENCH_UDID).name.isEmpty() ? 0 : 1;
+            return r;
+        };
+        perKey.tearDown = tearDown;
+        scenarios << perKey;
+    }
+
+    // ----- 多设备：逐台串行 vs 每台设备独立线程 -----
+    {
+        auto managers = std::make_shared<QVector<std::shared_ptr<AppManager>>>();
+        Scenario serial;
+        serial.name = QString("fleet.listApps.serial%1").arg(FLEET_SIZE);
+        serial.description = QString("%1 台设备逐台执行 AppManager::listApps（各 100 个应用）").arg(FLEET_SIZE);
+        serial.setUp = [managers]() {
+            SimulatedBackend::setAppCount(100);
+            for (const QString &udid : fleetUdids()) {
+                auto manager = std::make_shared<AppManager>();
+                if (!manager->connectToDevice(udid)) {
+                    return false;
+                }
+                *managers << manager;
+            }
+            return true;
+        };
+        serial.run = [managers]() {
+            OpResult r;
+            for (const auto &manager : *managers) {
+                r.items += manager->listApps(false).size();
+            }
+            return r;
+        };
+        serial.tearDown = [managers]() { managers->clear(); };
+        scenarios << serial;
+
+        auto fleet = std::make_shared<DeviceFleet>();
+        Scenario parallel;
+        parallel.name = QString("fleet.listApps.parallel%1").arg(FLEET_SIZE);
+        parallel.description = QString("DeviceFleet::listAppsOnAll 在 %1 台设备上并行执行（各 100 个应用）").arg(FLEET_SIZE);
+        parallel.setUp = [fleet]() {
+            SimulatedBackend::setAppCount(100);
+            for (const QString &udid : fleetUdids()) {
+                fleet->open(udid);
+            }
+            return true;
+        };
+        parallel.run = [fleet]() {
+            OpResult r;
+            const QMap<QString, QVector<AppInfo>> apps = fleet->listAppsOnAll(false).result();
+            for (const QVector<AppInfo> &list : apps) {
+                r.items += list.size();
+            }
+            return r;
+        };
+        parallel.tearDown = [fleet]() { fleet->closeAll(); };
+        scenarios << parallel;
+    }
+
+    // ----- ContactManager::parseContactEntities -----
+    {
+        auto manager = std::make_shared<ContactManager>();
+        auto entities = std::make_shared<plist_t>(nullptr);
+        Scenario s;
+        s.name = "contact.parseContactEntities.20k";
+        s.description = "ContactManager::parseContactEntities 解析 2 万个联系人";
+        s.setUp = [entities]() {
+            *entities = fetchContactEntities(20000);
+            return *entities != nullptr;
+        };
+        s.run = [manager, entities]() {
+            OpResult r;
+            r.items = manager->parseContactEntities(*entities).size();
+            return r;
+        };
+        s.tearDown = [entities]() {
+            if (*entities) {
+                LibimobiledeviceDynamic::instance().plist_free(*entities);
+                *entities = nullptr;
+            }
+        };
+        scenarios << s;
+    }
+
+    return scenarios;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("phone-linkc-bench");
+    app.setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("phone-linkc 设备交互热点路径基准测试（使用模拟设备后端）");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption iterationsOption("iterations", "每个场景的测量次数", "n", "10");
+    QCommandLineOption warmupOption("warmup", "每个场景的预热次数", "n", "1");
+    QCommandLineOption latencyOption("latency-us", "模拟每次服务调用的往返延迟（微秒）", "us", "0");
+    QCommandLineOption handshakeOption("handshake-us", "模拟 lockdown 握手的额外延迟（微秒）", "us", "0");
+    QCommandLineOption bandwidthOption("bandwidth", "模拟链路带宽（字节/秒，0 表示不限速）", "bytes", "0");
+    QCommandLineOption scenarioOption("scenario", "只运行名称包含该字符串的场景", "filter");
+    QCommandLineOption outputOption("output", "将 JSON 结果写入文件（默认输出到标准输出）", "file");
+    QCommandLineOption verboseOption("verbose", "输出管理器的调试日志");
+    parser.addOptions({iterationsOption, warmupOption, latencyOption, handshakeOption,
+                       bandwidthOption, scenarioOption, outputOption, verboseOption});
+    parser.process(app);
+
+    if (!parser.isSet(verboseOption)) {
+        // 管理器内部的 qDebug 日志会严重干扰计时
+        QLoggingCategory::setFilterRules("*.debug=false\n*.info=false");
+    }
+
+    const int iterations = qMax(1, parser.value(iterationsOption).toInt());
+    const int warmup = qMax(0, parser.value(warmupOption).toInt());
+
+    SimulatedBackendConfig config;
+    config.udids << QString::fromLatin1(BENCH_UDID) << fleetUdids();
+    config.latencyUs = parser.value(latencyOption).toLongLong();
+    config.handshakeLatencyUs = parser.value(handshakeOption).toLongLong();
+    config.bandwidthBytesPerSec = parser.value(bandwidthOption).toLongLong();
+    config.albumCount = 0;
+
+    LibimobiledeviceDynamic &lib = LibimobiledeviceDynamic::instance();
+    if (!lib.initializeSimulated(config)) {
+        fprintf(stderr, "无法初始化模拟设备后端\n");
+        return 1;
+    }
+
+    const QString filter = parser.value(scenarioOption);
+    QJsonArray results;
+    for (const Scenario &scenario : buildScenarios()) {
+        if (!filter.isEmpty() && !scenario.name.contains(filter)) {
+            continue;
+        }
+        fprintf(stderr, "运行场景: %s\n", qPrintable(scenario.name));
+        results.append(runScenario(scenario, iterations, warmup));
+    }
+
+    QJsonObject configJson;
+    configJson["iterations"] = iterations;
+    configJson["warmup"] = warmup;
+    configJson["latencyUs"] = config.latencyUs;
+    configJson["handshakeLatencyUs"] = config.handshakeLatencyUs;
+    configJson["bandwidthBytesPerSec"] = config.bandwidthBytesPerSec;
+
+    QJsonObject root;
+    root["tool"] = app.applicationName();
+    root["version"] = app.applicationVersion();
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["qtVersion"] = QString::fromLatin1(qVersion());
+    root["platform"] = QSysInfo::prettyProductName();
+    root["cpuArchitecture"] = QSysInfo::currentCpuArchitecture();
+    root["config"] = configJson;
+    root["results"] = results;
+    root["peakRssBytes"] = peakRssBytes();
+
+    const QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            fprintf(stderr, "无法写入结果文件: %s\n", qPrintable(file.fileName()));
+            return 1;
+        }
+        file.write(json);
+    } else {
+        fwrite(json.constData(), 1, static_cast<size_t>(json.size()), stdout);
+    }
+    return 0;
+}
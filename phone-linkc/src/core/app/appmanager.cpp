@@ -1,4 +1,5 @@
 #include "appmanager.h"
+#include "../device/devicesession.h"
 #include "../../platform/libimobiledevice_dynamic.h"
 #include <QDebug>
 #include <QFileInfo>
@@ -23,8 +24,6 @@ namespace {
 AppManager::AppManager(QObject *parent)
     : QObject(parent)
     , m_connected(false)
-    , m_device(nullptr)
-    , m_lockdown(nullptr)
     , m_instproxy(nullptr)
 {
 }
@@ -63,15 +62,8 @@ void AppManager::cleanup()
         m_instproxy = nullptr;
     }
 
-    if (m_lockdown) {
-        lib.lockdownd_client_free(static_cast<lockdownd_client_t>(m_lockdown));
-        m_lockdown = nullptr;
-    }
-
-    if (m_device) {
-        lib.idevice_free(static_cast<idevice_t>(m_device));
-        m_device = nullptr;
-    }
+    // 释放会话引用，最后一个持有者释放时关闭连接
+    m_session.reset();
 }
 
 bool AppManager::initClient()
@@ -82,49 +74,20 @@ bool AppManager::initClient()
         return false;
     }
 
-    // 1. 创建设备对象
-    idevice_t device = nullptr;
-    if (lib.idevice_new(&device, m_udid.toUtf8().constData()) != IDEVICE_E_SUCCESS) {
-        m_lastError = "无法连接设备: " + m_udid;
+    // 1. 获取共享的设备会话
+    m_session = DeviceSession::acquire(m_udid, &m_lastError);
+    if (!m_session) {
         return false;
     }
-    m_device = device;
 
-    // 2. 创建 lockdown 客户端
-    lockdownd_client_t lockdown = nullptr;
-    if (lib.lockdownd_client_new_with_handshake(device, &lockdown, "phone-linkc") != LOCKDOWN_E_SUCCESS) {
-        m_lastError = "无法建立 lockdown 连接";
-        lib.idevice_free(device);
-        m_device = nullptr;
-        return false;
-    }
-    m_lockdown = lockdown;
-
-    // 3. 启动 installation_proxy 服务
-    lockdownd_service_descriptor_t service = nullptr;
-    if (lib.lockdownd_start_service(lockdown, "com.apple.mobile.installation_proxy", &service) != LOCKDOWN_E_SUCCESS || !service) {
-        m_lastError = "无法启动 installation_proxy 服务";
-        lib.lockdownd_client_free(lockdown);
-        m_lockdown = nullptr;
-        lib.idevice_free(device);
-        m_device = nullptr;
-        return false;
-    }
-
-    // 4. 创建 instproxy 客户端
-    instproxy_client_t instproxy = nullptr;
-    if (lib.instproxy_client_new(device, service, &instproxy) != INSTPROXY_E_SUCCESS) {
-        m_lastError = "无法创建 application proxy 客户端";
-        lib.lockdownd_service_descriptor_free(service);
-        lib.lockdownd_client_free(lockdown);
-        m_lockdown = nullptr;
-        lib.idevice_free(device);
-        m_device = nullptr;
+    // 2. 从会话启动 installation_proxy 服务并创建客户端
+    instproxy_client_t instproxy = m_session->createInstproxyClient(&m_lastError);
+    if (!instproxy) {
+        m_session.reset();
         return false;
     }
     m_instproxy = instproxy;
 
-    lib.lockdownd_service_descriptor_free(service);
     m_connected = true;
     return true;
 }
@@ -501,38 +464,27 @@ bool AppManager::installApp(const QString &path)
     
     emit progressUpdated("正在连接AFC服务...", 0);
     
-    // 1. 启动AFC服务
-    lockdownd_service_descriptor_t afc_service = nullptr;
-    if (lib.lockdownd_start_service(static_cast<lockdownd_client_t>(m_lockdown),
-                                     "com.apple.afc", &afc_service) != LOCKDOWN_E_SUCCESS || !afc_service) {
-        m_lastError = "无法启动AFC服务";
-        emit errorOccurred(m_lastError);
-        return false;
-    }
-    
-    // 2. 创建AFC客户端
-    afc_client_t afc = nullptr;
-    if (lib.afc_client_new(static_cast<idevice_t>(m_device), afc_service, &afc) != AFC_E_SUCCESS) {
+    // 1. 从共享会话创建AFC客户端
+    afc_client_t afc = m_session->createAfcClient();
+    if (!afc) {
         m_lastError = "无法创建AFC客户端";
-        lib.lockdownd_service_descriptor_free(afc_service);
         emit errorOccurred(m_lastError);
         return false;
     }
-    lib.lockdownd_service_descriptor_free(afc_service);
     
     emit progressUpdated("正在准备上传目录...", 10);
     
-    // 3. 创建上传目录（PublicStaging）
+    // 2. 创建上传目录（PublicStaging）
     const char* staging_dir = "PublicStaging";
     lib.afc_make_directory(afc, staging_dir);
     
-    // 4. 构造设备上的目标路径
+    // 3. 构造设备上的目标路径
     QString fileName = fileInfo.fileName();
     QString devicePath = QString("%1/%2").arg(staging_dir).arg(fileName);
     
     emit progressUpdated("正在上传IPA文件...", 20);
     
-    // 5. 打开本地文件
+    // 4. 打开本地文件
     QFile localFile(path);
     if (!localFile.open(QIODevice::ReadOnly)) {
         m_lastError = "无法打开本地文件: " + path;
@@ -541,7 +493,7 @@ bool AppManager::installApp(const QString &path)
         return false;
     }
     
-    // 6. 在设备上创建文件
+    // 5. 在设备上创建文件
     uint64_t afc_file = 0;
     if (lib.afc_file_open(afc, devicePath.toUtf8().constData(), AFC_FOPEN_WRONLY, &afc_file) != AFC_E_SUCCESS) {
         m_lastError = "无法在设备上创建文件";
@@ -551,7 +503,7 @@ bool AppManager::installApp(const QString &path)
         return false;
     }
     
-    // 7. 分块上传文件
+    // 6. 分块上传文件
     const int chunkSize = 8192; // 8KB每块
     qint64 totalSize = localFile.size();
     qint64 uploadedSize = 0;
@@ -589,7 +541,7 @@ bool AppManager::installApp(const QString &path)
     
     emit progressUpdated("正在安装应用...", 70);
     
-    // 8. 调用instproxy_install安装
+    // 7. 调用instproxy_install安装
     QString installPath = QString("/") + devicePath;
     
     // 创建安装选项
@@ -689,7 +641,7 @@ bool AppManager::installApp(const QString &path)
     
     lib.plist_free(client_opts);
     
-    // 9. 清理：删除临时文件
+    // 8. 清理：删除临时文件
     lib.afc_remove_path(afc, devicePath.toUtf8().constData());
     lib.afc_client_free(afc);
     
@@ -12,6 +12,9 @@
 #include <QString>
 #include <QVector>
 #include <QIcon>
+#include <memory>
+
+class DeviceSession;
 
 /**
  * @brief 应用信息结构体
@@ -149,8 +152,7 @@ private:
     QString m_lastError;            ///< 最后的错误信息
     
     // libimobiledevice 句柄
-    void *m_device;                 ///< idevice_t
-    void *m_lockdown;               ///< lockdownd_client_t
+    std::shared_ptr<DeviceSession> m_session; ///< 共享的设备会话
     void *m_instproxy;              ///< instproxy_client_t
 };
 
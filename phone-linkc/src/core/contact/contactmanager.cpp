@@ -2,6 +2,7 @@
 // 通过 com.apple.mobilesync 服务直接同步联系人数据
 
 #include "contactmanager.h"
+#include "core/device/devicesession.h"
 #include "platform/libimobiledevice_dynamic.h"
 #include <QFile>
 #include <QTextStream>
@@ -22,7 +23,6 @@ static const char* CONTACTS_DATA_CLASS = "com.apple.Contacts";
 ContactManager::ContactManager(QObject *parent)
     : QObject(parent)
     , m_isConnected(false)
-    , m_device(nullptr)
 {
 }
 
@@ -46,11 +46,12 @@ bool ContactManager::connectToDevice(const QString &udid)
         return false;
     }
     
-    // 连接设备
-    qDebug() << "ContactManager: 创建设备句柄...";
-    idevice_error_t ret = lib.idevice_new(&m_device, udid.toUtf8().constData());
-    if (ret != IDEVICE_E_SUCCESS) {
-        qWarning() << "ContactManager: idevice_new 失败，错误代码:" << ret;
+    // 获取共享的设备会话
+    qDebug() << "ContactManager: 获取设备会话...";
+    QString error;
+    m_session = DeviceSession::acquire(udid, &error);
+    if (!m_session) {
+        qWarning() << "ContactManager: 获取设备会话失败:" << error;
         emit errorOccurred("无法连接到设备");
         return false;
     }
@@ -102,7 +103,7 @@ bool ContactManager::syncContactsViaMobileSync()
     LibimobiledeviceDynamic& lib = LibimobiledeviceDynamic::instance();
     
     // 检查 mobilesync 函数是否可用
-    if (!lib.mobilesync_client_start_service ||
+    if (!lib.mobilesync_client_new ||
         !lib.mobilesync_start ||
         !lib.mobilesync_get_all_records_from_device ||
         !lib.mobilesync_receive_changes ||
@@ -116,16 +117,14 @@ bool ContactManager::syncContactsViaMobileSync()
         return false;
     }
     
-    mobilesync_client_t sync_client = nullptr;
-    
-    // 启动 mobilesync 服务
+    // 从共享会话启动 mobilesync 服务
     qDebug() << "ContactManager: 启动 mobilesync 服务...";
-    mobilesync_error_t sync_err = lib.mobilesync_client_start_service(
-        m_device, &sync_client, "phone-linkc");
+    QString serviceError;
+    mobilesync_client_t sync_client = m_session ? m_session->createMobilesyncClient(&serviceError) : nullptr;
     
-    if (sync_err != MOBILESYNC_E_SUCCESS || !sync_client) {
-        qWarning() << "ContactManager: 启动 mobilesync 服务失败，错误码:" << sync_err;
-        emit errorOccurred(QString("启动 mobilesync 服务失败，错误码: %1").arg(sync_err));
+    if (!sync_client) {
+        qWarning() << "ContactManager: 启动 mobilesync 服务失败:" << serviceError;
+        emit errorOccurred(QString("启动 mobilesync 服务失败: %1").arg(serviceError));
         return false;
     }
     
@@ -156,7 +155,7 @@ bool ContactManager::syncContactsViaMobileSync()
     qDebug() << "ContactManager: 设备锚点:" << (m_deviceAnchor.isEmpty() ? "(空)" : m_deviceAnchor);
     qDebug() << "ContactManager: 计算机锚点:" << newComputerAnchor;
     
-    sync_err = lib.mobilesync_start(
+    mobilesync_error_t sync_err = lib.mobilesync_start(
         sync_client,
         CONTACTS_DATA_CLASS,
         anchors,
@@ -804,10 +803,6 @@ bool ContactManager::exportToVCard(const QString &filePath) const
 
 void ContactManager::cleanup()
 {
-    LibimobiledeviceDynamic& lib = LibimobiledeviceDynamic::instance();
-    
-    if (m_device) {
-        lib.idevice_free(m_device);
-        m_device = nullptr;
-    }
+    // 释放会话引用，最后一个持有者释放时关闭连接
+    m_session.reset();
 }
@@ -9,6 +9,9 @@
 #include <libimobiledevice/libimobiledevice.h>
 #include <libimobiledevice/mobilesync.h>
 #include <plist/plist.h>
+#include <memory>
+
+class DeviceSession;
 
 /**
  * @brief 联系人数据结构
@@ -94,6 +97,15 @@ public:
      * @return 是否导出成功
      */
     bool exportToVCard(const QString &filePath) const;
+    
+    /**
+     * @brief 解析联系人实体（从 mobilesync plist 数据）
+     * @param entities 实体 plist
+     * @return 解析的联系人列表
+     *
+     * @note 不访问设备，可直接用于离线数据解析和基准测试
+     */
+    QVector<Contact> parseContactEntities(plist_t entities);
 
 signals:
     /**
@@ -120,8 +132,8 @@ private:
     QString m_currentUdid;
     QVector<Contact> m_contacts;
     
-    // libimobiledevice 句柄
-    idevice_t m_device;
+    // 共享的设备会话
+    std::shared_ptr<DeviceSession> m_session;
     
     // 保存的锚点（用于增量同步）
     QString m_deviceAnchor;
@@ -138,13 +150,6 @@ private:
      */
     bool syncContactsViaMobileSync();
     
-    /**
-     * @brief 解析联系人实体（从 mobilesync plist 数据）
-     * @param entities 实体 plist
-     * @return 解析的联系人列表
-     */
-    QVector<Contact> parseContactEntities(plist_t entities);
-    
     /**
      * @brief 从 plist 字典解析单个联系人
      * @param contactDict 联系人字典
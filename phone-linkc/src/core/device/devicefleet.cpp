@@ -0,0 +1,117 @@
+/**
+ * @file devicefleet.cpp
+ * @brief 多设备并行作业实现
+ */
+
+#include "devicefleet.h"
+#include "devicemanager.h"
+#include "core/photo/photomanager.h"
+#include "core/photo/photoexporter.h"
+#include <QDebug>
+#include <QDir>
+
+DeviceFleet::DeviceFleet(QObject *parent)
+    : QObject(parent)
+{
+}
+
+DeviceFleet::~DeviceFleet()
+{
+    // 程序退出时事件循环可能已停止，工作区无法自行删除：直接销毁，等待各设备线程结束
+    closeAll();
+    const QSet<DeviceWorkspace *> closing = m_closing;
+    m_closing.clear();
+    qDeleteAll(closing);
+}
+
+void DeviceFleet::attach(DeviceManager *deviceManager)
+{
+    for (const QString &udid : deviceManager->getConnectedDevices()) {
+        open(udid);
+    }
+
+    connect(deviceManager, &DeviceManager::deviceFound, this, [this](const QString &udid, const QString &) {
+        open(udid);
+    });
+    connect(deviceManager, &DeviceManager::deviceLost, this, &DeviceFleet::close);
+}
+
+DeviceWorkspace *DeviceFleet::open(const QString &udid)
+{
+    DeviceWorkspace *workspace = m_workspaces.value(udid);
+    if (workspace) {
+        return workspace;
+    }
+
+    workspace = new DeviceWorkspace(udid);
+    m_workspaces.insert(udid, workspace);
+    emit workspaceOpened(udid);
+    return workspace;
+}
+
+void DeviceFleet::close(const QString &udid)
+{
+    DeviceWorkspace *workspace = m_workspaces.take(udid);
+    if (!workspace) {
+        return;
+    }
+
+    // 设备断开时在 GUI 线程中调用，不能等待设备线程中正在执行的任务
+    m_closing.insert(workspace);
+    connect(workspace, &QObject::destroyed, this, [this, workspace]() {
+        m_closing.remove(workspace);
+    });
+    workspace->closeLater();
+    emit workspaceClosed(udid);
+}
+
+void DeviceFleet::closeAll()
+{
+    const QStringList ids = m_workspaces.keys();
+    for (const QString &udid : ids) {
+        close(udid);
+    }
+}
+
+QFuture<QMap<QString, QVector<AppInfo>>> DeviceFleet::listAppsOnAll(bool includeSize)
+{
+    qDebug() << "DeviceFleet: 在" << m_workspaces.size() << "台设备上并行列出应用";
+
+    return runOnAll([includeSize](DeviceWorkspace &workspace) {
+        AppManager *manager = workspace.appManager();
+        if (!manager->isConnected()) {
+            return QVector<AppInfo>();
+        }
+        return manager->listApps(includeSize);
+    });
+}
+
+QFuture<QMap<QString, int>> DeviceFleet::pullDcimFromAll(const QString &destinationDir)
+{
+    qDebug() << "DeviceFleet: 在" << m_workspaces.size() << "台设备上并行导出 DCIM 到" << destinationDir;
+
+    return runOnAll([destinationDir](DeviceWorkspace &workspace) {
+        PhotoManager *manager = workspace.photoManager();
+        if (!manager->isConnected()) {
+            return 0;
+        }
+
+        QDir root(QDir(destinationDir).filePath(workspace.udid()));
+        const QVector<PhotoInfo> photos = manager->getAllPhotos();
+
+        // 保留设备上的目录结构，例如 <UDID>/DCIM/100APPLE/IMG_0001.JPG
+        QVector<PhotoExporter::Job> jobs;
+        jobs.reserve(photos.size());
+        for (const PhotoInfo &photo : photos) {
+            PhotoExporter::Job job;
+            job.photo = photo;
+            job.localPath = root.filePath(photo.path.mid(photo.path.startsWith('/') ? 1 : 0));
+            jobs.append(job);
+        }
+
+        // 按块流式写入磁盘，多个 AFC 连接同时导出；本地已存在且大小相同的文件跳过
+        PhotoExporter exporter(workspace.udid());
+        exporter.setSkipExisting(true);
+        return exporter.run(jobs).exported;
+    });
+}
@@ -0,0 +1,123 @@
+/**
+ * @file devicefleet.h
+ * @brief 多设备并行作业头文件
+ *
+ * 为每台已连接设备维护一个 DeviceWorkspace（独立线程 + 独立管理器），
+ * “列出所有设备的应用”“导出所有设备的 DCIM”等作业在各设备线程中同时执行，
+ * 总吞吐量随 USB 控制器数量增长，而不是逐台串行处理。
+ */
+
+#ifndef DEVICEFLEET_H
+#define DEVICEFLEET_H
+
+#include <QObject>
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+#include <QFuture>
+#include <type_traits>
+
+#include "deviceworkspace.h"
+#include "core/app/appmanager.h"
+
+class DeviceManager;
+
+/**
+ * @brief 多设备工作区集合
+ *
+ * 使用方法：
+ * @code
+ * DeviceFleet fleet;
+ * fleet.attach(deviceManager);   // 随设备连接/断开自动创建/关闭工作区
+ * QFuture<QMap<QString, QVector<AppInfo>>> apps = fleet.listAppsOnAll();
+ * @endcode
+ */
+class DeviceFleet : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DeviceFleet(QObject *parent = nullptr);
+    ~DeviceFleet();
+
+    /**
+     * @brief 跟随设备管理器的设备列表：已知设备立即创建工作区，之后随 deviceFound/deviceLost 增减
+     */
+    void attach(DeviceManager *deviceManager);
+
+    /**
+     * @brief 为设备创建工作区（已存在时直接返回）
+     */
+    DeviceWorkspace *open(const QString &udid);
+
+    /**
+     * @brief 关闭设备工作区
+     *
+     * 立即返回：尚未开始的任务被取消，管理器在设备线程中断开，线程结束后工作区自行删除。
+     */
+    void close(const QString &udid);
+
+    /**
+     * @brief 关闭所有工作区（异步，同 close()）
+     */
+    void closeAll();
+
+    QStringList udids() const { return m_workspaces.keys(); }
+    DeviceWorkspace *workspace(const QString &udid) const { return m_workspaces.value(udid); }
+
+    /**
+     * @brief 在所有设备上并行执行同一任务，并汇总各设备的结果
+     *
+     * 每台设备的任务在其工作区线程中执行；被取消或未产生结果的设备不出现在汇总中。
+     * @param func 形如 T(DeviceWorkspace &) 的可调用对象，会被复制到每台设备
+     * @return UDID -> 结果
+     */
+    template<typename Func>
+    auto runOnAll(Func func) -> QFuture<QMap<QString, std::invoke_result_t<Func &, DeviceWorkspace &>>>
+    {
+        using Result = std::invoke_result_t<Func &, DeviceWorkspace &>;
+
+        QStringList ids;
+        QList<QFuture<Result>> futures;
+        for (auto it = m_workspaces.constBegin(); it != m_workspaces.constEnd(); ++it) {
+            ids << it.key();
+            futures << it.value()->run(func);
+        }
+
+        return QtFuture::whenAll(futures.begin(), futures.end())
+            .then([ids](const QList<QFuture<Result>> &finished) {
+                QMap<QString, Result> results;
+                for (int i = 0; i < finished.size(); ++i) {
+                    if (finished.at(i).resultCount() > 0) {
+                        results.insert(ids.at(i), finished.at(i).result());
+                    }
+                }
+                return results;
+            });
+    }
+
+    /**
+     * @brief 并行列出所有设备上的应用
+     * @param includeSize 是否包含磁盘使用信息
+     */
+    QFuture<QMap<QString, QVector<AppInfo>>> listAppsOnAll(bool includeSize = false);
+
+    /**
+     * @brief 并行导出所有设备的 DCIM 照片和视频
+     *
+     * 每台设备导出到 destinationDir/<UDID>/ 下，保留设备上的目录结构；
+     * 本地已存在且大小相同的文件跳过。
+     * @return UDID -> 本次导出的文件数
+     */
+    QFuture<QMap<QString, int>> pullDcimFromAll(const QString &destinationDir);
+
+signals:
+    void workspaceOpened(const QString &udid);
+    void workspaceClosed(const QString &udid);
+
+private:
+    QMap<QString, DeviceWorkspace *> m_workspaces;  ///< UDID -> 工作区
+    QSet<DeviceWorkspace *> m_closing;              ///< 已关闭但线程尚未结束的工作区
+};
+
+#endif // DEVICEFLEET_H
@@ -1,8 +1,12 @@
 
 #include "deviceinfo.h"
+#include "devicesession.h"
 #include "platform/libimobiledevice_dynamic.h"
 #include <QDebug>
 #include <QMap>
+#include <QElapsedTimer>
+#include <QPromise>
+#include <QtConcurrent/QtConcurrent>
 
 // 产品类型到友好名称的映射表
 static const QMap<QString, QString> productTypeToFriendlyName = {
@@ -327,52 +331,58 @@ QString DeviceInfo::toString() const
           << QString("  主板ID: %1").arg(boardId.isEmpty() ? "未知" : boardId)
           << QString("  设备颜色: %1").arg(deviceColor.isEmpty() ? "未知" : deviceColor);
     
-    // 存储信息
-    qint64 usedCapacity = totalCapacity - availableCapacity;
-    double usagePercent = totalCapacity > 0 ? (static_cast<double>(usedCapacity) / totalCapacity * 100) : 0;
+    // 存储信息（异步获取时可能尚未到达）
+    if (!storageLoaded) {
+        lines << ""
+              << "【存储信息】"
+              << "  正在获取...";
+    } else {
+        qint64 usedCapacity = totalCapacity - availableCapacity;
+        double usagePercent = totalCapacity > 0 ? (static_cast<double>(usedCapacity) / totalCapacity * 100) : 0;
     
-    lines << ""
-          << "【存储信息】"
-          << QString("  物理磁盘: %1").arg(formatCapacity(totalCapacity))
-          << QString("  已使用: %1 (%2%)")
-                  .arg(formatCapacity(usedCapacity))
-                  .arg(usagePercent, 0, 'f', 1)
-          << QString("  可用空间: %1").arg(formatCapacity(availableCapacity));
-    
-    // 分区详情
-    if (totalSystemCapacity > 0 || totalDataCapacity > 0) {
-        lines << "";
-        lines << "  ┌─ 分区详情 ─";
+        lines << ""
+              << "【存储信息】"
+              << QString("  物理磁盘: %1").arg(formatCapacity(totalCapacity))
+              << QString("  已使用: %1 (%2%)")
+                      .arg(formatCapacity(usedCapacity))
+                      .arg(usagePercent, 0, 'f', 1)
+              << QString("  可用空间: %1").arg(formatCapacity(availableCapacity));
+    
+        // 分区详情
+        if (totalSystemCapacity > 0 || totalDataCapacity > 0) {
+            lines << "";
+            lines << "  ┌─ 分区详情 ─";
         
-        if (totalSystemCapacity > 0) {
-            qint64 systemUsed = totalSystemCapacity - totalSystemAvailable;
-            double systemUsagePercent = totalSystemCapacity > 0 ?
-                (static_cast<double>(systemUsed) / totalSystemCapacity * 100) : 0;
-            lines << QString("  │ 系统分区: %1 / %2 (使用 %3%)")
-                      .arg(formatCapacity(systemUsed),
-                           formatCapacity(totalSystemCapacity))
-                      .arg(systemUsagePercent, 0, 'f', 1);
-        }
+            if (totalSystemCapacity > 0) {
+                qint64 systemUsed = totalSystemCapacity - totalSystemAvailable;
+                double systemUsagePercent = totalSystemCapacity > 0 ?
+                    (static_cast<double>(systemUsed) / totalSystemCapacity * 100) : 0;
+                lines << QString("  │ 系统分区: %1 / %2 (使用 %3%)")
+                          .arg(formatCapacity(systemUsed),
+                               formatCapacity(totalSystemCapacity))
+                          .arg(systemUsagePercent, 0, 'f', 1);
+            }
         
-        if (totalDataCapacity > 0) {
-            qint64 dataUsed = totalDataCapacity - totalDataAvailable;
-            double dataUsagePercent = totalDataCapacity > 0 ?
-                (static_cast<double>(dataUsed) / totalDataCapacity * 100) : 0;
-            lines << QString("  │ 数据分区: %1 / %2 (使用 %3%)")
-                      .arg(formatCapacity(dataUsed),
-                           formatCapacity(totalDataCapacity))
-                      .arg(dataUsagePercent, 0, 'f', 1);
-        }
+            if (totalDataCapacity > 0) {
+                qint64 dataUsed = totalDataCapacity - totalDataAvailable;
+                double dataUsagePercent = totalDataCapacity > 0 ?
+                    (static_cast<double>(dataUsed) / totalDataCapacity * 100) : 0;
+                lines << QString("  │ 数据分区: %1 / %2 (使用 %3%)")
+                          .arg(formatCapacity(dataUsed),
+                               formatCapacity(totalDataCapacity))
+                          .arg(dataUsagePercent, 0, 'f', 1);
+            }
         
-        if (amountDataReserved > 0) {
-            lines << QString("  │ 系统预留: %1").arg(formatCapacity(amountDataReserved));
-        }
+            if (amountDataReserved > 0) {
+                lines << QString("  │ 系统预留: %1").arg(formatCapacity(amountDataReserved));
+            }
         
-        if (amountDataAvailable > 0 && amountDataAvailable != totalDataAvailable) {
-            lines << QString("  │ 立即可用: %1 (扣除预留)").arg(formatCapacity(amountDataAvailable));
-        }
+            if (amountDataAvailable > 0 && amountDataAvailable != totalDataAvailable) {
+                lines << QString("  │ 立即可用: %1 (扣除预留)").arg(formatCapacity(amountDataAvailable));
+            }
         
-        lines << "  └────────────";
+            lines << "  └────────────";
+        }
     }
     
     // 网络信息
@@ -408,11 +418,17 @@ QString DeviceInfo::toString() const
     }
     
     // 电池信息
-    lines << ""
-          << "【电池信息】"
-          << QString("  电量: %1%").arg(batteryCurrentCapacity)
-          << QString("  充电状态: %1")
-                  .arg(batteryIsCharging ? "正在充电" : (fullyCharged ? "已充满" : "未充电"));
+    if (!batteryLoaded) {
+        lines << ""
+              << "【电池信息】"
+              << "  正在获取...";
+    } else {
+        lines << ""
+              << "【电池信息】"
+              << QString("  电量: %1%").arg(batteryCurrentCapacity)
+              << QString("  充电状态: %1")
+                      .arg(batteryIsCharging ? "正在充电" : (fullyCharged ? "已充满" : "未充电"));
+    }
     
     // 安全状态
     lines << ""
@@ -424,6 +440,48 @@ QString DeviceInfo::toString() const
     return lines.join('\n');
 }
 
+// lockdown 域名
+static const char* DOMAIN_DISK_USAGE = "com.apple.disk_usage";
+static const char* DOMAIN_BATTERY = "com.apple.mobile.battery";
+
+/**
+ * @brief DeviceInfo 用到的 lockdown 属性（逐键查询时每项一次往返）
+ */
+struct DeviceInfoKey {
+    const char* domain;
+    const char* key;
+};
+
+static const DeviceInfoKey DEVICE_INFO_KEYS[] = {
+    {nullptr, "DeviceName"}, {nullptr, "SerialNumber"},
+    {nullptr, "DeviceClass"}, {nullptr, "ProductType"}, {nullptr, "ProductName"},
+    {nullptr, "ModelNumber"}, {nullptr, "RegionInfo"},
+    {nullptr, "HardwareModel"}, {nullptr, "HardwarePlatform"}, {nullptr, "CPUArchitecture"},
+    {nullptr, "ChipID"}, {nullptr, "BoardId"}, {nullptr, "UniqueChipID"}, {nullptr, "DieID"},
+    {nullptr, "FirmwareVersion"},
+    {nullptr, "ProductVersion"}, {nullptr, "BuildVersion"}, {nullptr, "BasebandVersion"},
+    {nullptr, "FirmwareRevision"},
+    {nullptr, "DeviceColor"}, {nullptr, "EnclosureColor"},
+    {DOMAIN_DISK_USAGE, "TotalDiskCapacity"}, {DOMAIN_DISK_USAGE, "TotalDataAvailable"},
+    {DOMAIN_DISK_USAGE, "TotalSystemCapacity"}, {DOMAIN_DISK_USAGE, "TotalSystemAvailable"},
+    {DOMAIN_DISK_USAGE, "TotalDataCapacity"}, {DOMAIN_DISK_USAGE, "AmountDataReserved"},
+    {DOMAIN_DISK_USAGE, "AmountDataAvailable"},
+    {nullptr, "WiFiAddress"}, {nullptr, "BluetoothAddress"}, {nullptr, "EthernetAddress"},
+    {nullptr, "PhoneNumber"}, {nullptr, "InternationalMobileEquipmentIdentity"},
+    {nullptr, "InternationalMobileEquipmentIdentity2"}, {nullptr, "MobileEquipmentIdentifier"},
+    {nullptr, "IntegratedCircuitCardIdentity"}, {nullptr, "CarrierBundleInfoVersion"},
+    {DOMAIN_BATTERY, "BatteryCurrentCapacity"}, {DOMAIN_BATTERY, "BatteryIsCharging"},
+    {DOMAIN_BATTERY, "ExternalChargeCapable"}, {DOMAIN_BATTERY, "FullyCharged"},
+    {nullptr, "ActivationState"}, {nullptr, "PasswordProtected"}, {nullptr, "DeviceSupportsLockdown"},
+    {nullptr, "HostAttached"}, {nullptr, "HasSiMLock"}, {nullptr, "iTunesHasConnected"},
+    {nullptr, "TimeZone"}, {nullptr, "TimeIntervalSince1970"},
+    {nullptr, "TrustedHostAttached"}, {nullptr, "PairingState"},
+    {nullptr, "MLBSerialNumber"}, {nullptr, "ProtocolVersion"}, {nullptr, "SupportsWirelessSync"},
+    {nullptr, "WirelessBuddyID"},
+};
+
+static const int DEVICE_INFO_KEY_COUNT = static_cast<int>(sizeof(DEVICE_INFO_KEYS) / sizeof(DEVICE_INFO_KEYS[0]));
+
 DeviceInfoManager::DeviceInfoManager(QObject *parent)
     : QObject(parent)
 {
@@ -431,134 +489,230 @@ DeviceInfoManager::DeviceInfoManager(QObject *parent)
 
 DeviceInfo DeviceInfoManager::getDeviceInfo(const QString &udid)
 {
+    DeviceInfo info;
+    info.udid = udid;
+    
     LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
     if (!loader.isInitialized()) {
         // 库未初始化，返回空的设备信息
         qWarning() << "libimobiledevice 库未初始化，无法获取设备信息";
-        DeviceInfo info;
-        info.udid = udid;
         return info;
     }
     
-    DeviceInfo info;
-    idevice_t device = nullptr;
-    lockdownd_client_t lockdown = nullptr;
-    
-    do {
-        // 连接到设备
-        if (!loader.idevice_new || loader.idevice_new(&device, udid.toUtf8().constData()) != IDEVICE_E_SUCCESS) {
-            qWarning() << "无法连接到设备:" << udid;
-            break;
-        }
-        
-        if (!loader.lockdownd_client_new_with_handshake || 
-            loader.lockdownd_client_new_with_handshake(device, &lockdown, "phone-linkc") != LOCKDOWN_E_SUCCESS) {
-            qWarning() << "无法建立 lockdown 连接:" << udid;
-            break;
-        }
-        
-        // ===== 基础标识信息 =====
+    // 获取共享的设备会话
+    QString error;
+    DeviceSession::Ptr session = DeviceSession::acquire(udid, &error);
+    if (!session) {
+        qWarning() << "无法获取设备会话:" << udid << error;
+        return info;
+    }
+    
+    // 每个域一次往返，整体读取后本地解码
+    QElapsedTimer timer;
+    timer.start();
+    
+    QVariantMap global = session->getDomain(nullptr);
+    qint64 globalMs = timer.elapsed();
+    QVariantMap diskUsage = session->getDomain(DOMAIN_DISK_USAGE);
+    qint64 diskMs = timer.elapsed() - globalMs;
+    QVariantMap battery = session->getDomain(DOMAIN_BATTERY);
+    qint64 batteryMs = timer.elapsed() - globalMs - diskMs;
+    qint64 totalMs = timer.elapsed();
+    
+    applyGlobalDomain(info, global);
+    applyDiskUsageDomain(info, diskUsage);
+    applyBatteryDomain(info, battery);
+    
+    // 与逐键查询的对比见基准测试 device.getDeviceInfo.bulk / device.getDeviceInfo.perKey
+    qDebug() << "[性能] getDeviceInfo 按域批量查询: 3 次往返，耗时" << totalMs << "ms"
+             << "(全局" << globalMs << "ms, 存储" << diskMs << "ms, 电池" << batteryMs << "ms)";
+    
+    return info;
+}
+
+QFuture<DeviceInfo> DeviceInfoManager::getDeviceInfoAsync(const QString &udid)
+{
+    return QtConcurrent::run([](QPromise<DeviceInfo> &promise, const QString &udid) {
+        DeviceInfo info;
         info.udid = udid;
-        info.name = this->getStringValue(lockdown, nullptr, "DeviceName");
-        info.serialNumber = this->getStringValue(lockdown, nullptr, "SerialNumber");
-        
-        // ===== 产品信息 =====
-        info.deviceClass = this->getStringValue(lockdown, nullptr, "DeviceClass");
-        info.productType = this->getStringValue(lockdown, nullptr, "ProductType");
-        info.productName = this->getStringValue(lockdown, nullptr, "ProductName");
-        info.modelNumber = this->getStringValue(lockdown, nullptr, "ModelNumber");
-        info.regionInfo = this->getStringValue(lockdown, nullptr, "RegionInfo");
-        
-        // ===== 硬件信息 =====
-        info.hardwareModel = this->getStringValue(lockdown, nullptr, "HardwareModel");
-        info.hardwarePlatform = this->getStringValue(lockdown, nullptr, "HardwarePlatform");
-        info.cpuArchitecture = this->getStringValue(lockdown, nullptr, "CPUArchitecture");
-        info.chipID = this->getStringValue(lockdown, nullptr, "ChipID");
-        info.boardId = this->getStringValue(lockdown, nullptr, "BoardId");
-        info.uniqueChipID = this->getStringValue(lockdown, nullptr, "UniqueChipID");
-        info.dieID = this->getStringValue(lockdown, nullptr, "DieID");
-        info.firmwareVersion = static_cast<qint32>(this->getIntValue(lockdown, nullptr, "FirmwareVersion"));
-        
-        // ===== 系统版本信息 =====
-        info.productVersion = this->getStringValue(lockdown, nullptr, "ProductVersion");
-        info.buildVersion = this->getStringValue(lockdown, nullptr, "BuildVersion");
-        info.basebandVersion = this->getStringValue(lockdown, nullptr, "BasebandVersion");
-        info.firmwareRevision = this->getStringValue(lockdown, nullptr, "FirmwareRevision");
         
-        // ===== 外观信息 =====
-        info.deviceColor = this->getStringValue(lockdown, nullptr, "DeviceColor");
-        info.enclosureColor = this->getStringValue(lockdown, nullptr, "EnclosureColor");
-        
-        // ===== 存储信息 (使用 com.apple.disk_usage 域) =====
-        // TotalDiskCapacity 是物理磁盘总容量（如128GB）
-        // TotalDataCapacity + TotalSystemCapacity 才是实际可用分区总容量
-        info.totalCapacity = this->getIntValue(lockdown, "com.apple.disk_usage", "TotalDiskCapacity");
-        // TotalDataAvailable 是数据分区可用空间，与手机设置中显示的"可用空间"一致
-        info.availableCapacity = this->getIntValue(lockdown, "com.apple.disk_usage", "TotalDataAvailable");
-        info.totalSystemCapacity = this->getIntValue(lockdown, "com.apple.disk_usage", "TotalSystemCapacity");
-        info.totalSystemAvailable = this->getIntValue(lockdown, "com.apple.disk_usage", "TotalSystemAvailable");
-        info.totalDataCapacity = this->getIntValue(lockdown, "com.apple.disk_usage", "TotalDataCapacity");
-        info.totalDataAvailable = this->getIntValue(lockdown, "com.apple.disk_usage", "TotalDataAvailable");
-        info.amountDataReserved = this->getIntValue(lockdown, "com.apple.disk_usage", "AmountDataReserved");
-        info.amountDataAvailable = this->getIntValue(lockdown, "com.apple.disk_usage", "AmountDataAvailable");
-        
-        // ===== 网络信息 =====
-        info.wifiAddress = this->getStringValue(lockdown, nullptr, "WiFiAddress");
-        info.bluetoothAddress = this->getStringValue(lockdown, nullptr, "BluetoothAddress");
-        info.ethernetAddress = this->getStringValue(lockdown, nullptr, "EthernetAddress");
-        
-        // ===== 电话/SIM信息 =====
-        info.phoneNumber = this->getStringValue(lockdown, nullptr, "PhoneNumber");
-        info.imei = this->getStringValue(lockdown, nullptr, "InternationalMobileEquipmentIdentity");
-        info.imei2 = this->getStringValue(lockdown, nullptr, "InternationalMobileEquipmentIdentity2");
-        info.meid = this->getStringValue(lockdown, nullptr, "MobileEquipmentIdentifier");
-        info.iccid = this->getStringValue(lockdown, nullptr, "IntegratedCircuitCardIdentity");
-        info.carrierBundleInfoVersion = this->getStringValue(lockdown, nullptr, "CarrierBundleInfoVersion");
+        LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+        if (!loader.isInitialized()) {
+            qWarning() << "libimobiledevice 库未初始化，无法获取设备信息";
+            return;
+        }
         
-        // ===== 电池信息 (使用 com.apple.mobile.battery 域) =====
-        info.batteryCurrentCapacity = static_cast<qint32>(this->getIntValue(lockdown, "com.apple.mobile.battery", "BatteryCurrentCapacity"));
-        info.batteryIsCharging = this->getBoolValue(lockdown, "com.apple.mobile.battery", "BatteryIsCharging");
-        info.externalChargeCapable = this->getStringValue(lockdown, "com.apple.mobile.battery", "ExternalChargeCapable");
-        info.fullyCharged = this->getBoolValue(lockdown, "com.apple.mobile.battery", "FullyCharged");
+        // 会话握手也在工作线程完成，慢设备不会阻塞界面
+        QString error;
+        DeviceSession::Ptr session = DeviceSession::acquire(udid, &error);
+        if (!session) {
+            qWarning() << "无法获取设备会话:" << udid << error;
+            return;
+        }
         
-        // ===== 设备状态 =====
-        info.activationState = this->getStringValue(lockdown, nullptr, "ActivationState");
-        info.passwordProtected = this->getBoolValue(lockdown, nullptr, "PasswordProtected");
-        info.deviceSupportsLockdown = this->getBoolValue(lockdown, nullptr, "DeviceSupportsLockdown");
-        info.hostAttached = this->getBoolValue(lockdown, nullptr, "HostAttached");
-        info.hasSimLockedStatus = this->getBoolValue(lockdown, nullptr, "HasSiMLock");
-        info.iTunesHasConnected = this->getBoolValue(lockdown, nullptr, "iTunesHasConnected");
+        QElapsedTimer timer;
+        timer.start();
         
-        // ===== 时间信息 =====
-        info.timeZone = this->getStringValue(lockdown, nullptr, "TimeZone");
-        info.timeIntervalSince1970 = this->getIntValue(lockdown, nullptr, "TimeIntervalSince1970");
-        if (info.timeIntervalSince1970 > 0) {
-            info.deviceTime = QDateTime::fromSecsSinceEpoch(info.timeIntervalSince1970);
+        QVariantMap global = session->getDomain(nullptr);
+        if (global.isEmpty()) {
+            qWarning() << "读取设备全局信息失败:" << udid;
+            return;
         }
+        applyGlobalDomain(info, global);
+        promise.addResult(info, IdentityStage);
         
-        // ===== 安全信息 =====
-        info.trustedHostAttached = this->getBoolValue(lockdown, nullptr, "TrustedHostAttached");
-        info.pairingState = this->getStringValue(lockdown, nullptr, "PairingState");
+        if (promise.isCanceled()) {
+            return;
+        }
+        applyDiskUsageDomain(info, session->getDomain(DOMAIN_DISK_USAGE));
+        promise.addResult(info, StorageStage);
         
-        // ===== 其他信息 =====
-        info.mlbSerialNumber = this->getStringValue(lockdown, nullptr, "MLBSerialNumber");
-        info.protocolVersion = this->getStringValue(lockdown, nullptr, "ProtocolVersion");
-        info.supportsWirelessSync = this->getBoolValue(lockdown, nullptr, "SupportsWirelessSync");
-        info.wirelessBuddyID = this->getStringValue(lockdown, nullptr, "WirelessBuddyID");
+        if (promise.isCanceled()) {
+            return;
+        }
+        applyBatteryDomain(info, session->getDomain(DOMAIN_BATTERY));
+        promise.addResult(info, BatteryStage);
         
-    } while (false);
+        qDebug() << "[性能] getDeviceInfoAsync 三个阶段总耗时:" << timer.elapsed() << "ms";
+    }, udid);
+}
+
+DeviceInfo DeviceInfoManager::getDeviceInfoPerKey(const QString &udid)
+{
+    DeviceInfo info;
+    info.udid = udid;
     
-    // 清理资源
-    if (lockdown && loader.lockdownd_client_free) {
-        loader.lockdownd_client_free(lockdown);
+    DeviceSession::Ptr session = DeviceSession::acquire(udid);
+    if (!session) {
+        return info;
     }
-    if (device && loader.idevice_free) {
-        loader.idevice_free(device);
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    QVariantMap global;
+    QVariantMap diskUsage;
+    QVariantMap battery;
+    for (const DeviceInfoKey &entry : DEVICE_INFO_KEYS) {
+        QVariant value = session->getVariant(entry.domain, entry.key);
+        if (!value.isValid()) {
+            continue;
+        }
+        if (!entry.domain) {
+            global.insert(entry.key, value);
+        } else if (entry.domain == DOMAIN_DISK_USAGE) {
+            diskUsage.insert(entry.key, value);
+        } else {
+            battery.insert(entry.key, value);
+        }
     }
     
+    applyGlobalDomain(info, global);
+    applyDiskUsageDomain(info, diskUsage);
+    applyBatteryDomain(info, battery);
+    
+    qDebug() << "[性能] getDeviceInfo 逐键查询:" << DEVICE_INFO_KEY_COUNT << "次往返，耗时" << timer.elapsed() << "ms";
     return info;
 }
 
+void DeviceInfoManager::applyGlobalDomain(DeviceInfo &info, const QVariantMap &values)
+{
+    // ===== 基础标识信息 =====
+    info.name = values.value("DeviceName").toString();
+    info.serialNumber = values.value("SerialNumber").toString();
+    
+    // ===== 产品信息 =====
+    info.deviceClass = values.value("DeviceClass").toString();
+    info.productType = values.value("ProductType").toString();
+    info.productName = values.value("ProductName").toString();
+    info.modelNumber = values.value("ModelNumber").toString();
+    info.regionInfo = values.value("RegionInfo").toString();
+    
+    // ===== 硬件信息 =====
+    // ChipID/BoardId/UniqueChipID/DieID 在设备上是整数，转换为十进制字符串
+    info.hardwareModel = values.value("HardwareModel").toString();
+    info.hardwarePlatform = values.value("HardwarePlatform").toString();
+    info.cpuArchitecture = values.value("CPUArchitecture").toString();
+    info.chipID = values.value("ChipID").toString();
+    info.boardId = values.value("BoardId").toString();
+    info.uniqueChipID = values.value("UniqueChipID").toString();
+    info.dieID = values.value("DieID").toString();
+    info.firmwareVersion = values.value("FirmwareVersion").toInt();
+    
+    // ===== 系统版本信息 =====
+    info.productVersion = values.value("ProductVersion").toString();
+    info.buildVersion = values.value("BuildVersion").toString();
+    info.basebandVersion = values.value("BasebandVersion").toString();
+    info.firmwareRevision = values.value("FirmwareRevision").toString();
+    
+    // ===== 外观信息 =====
+    info.deviceColor = values.value("DeviceColor").toString();
+    info.enclosureColor = values.value("EnclosureColor").toString();
+    
+    // ===== 网络信息 =====
+    info.wifiAddress = values.value("WiFiAddress").toString();
+    info.bluetoothAddress = values.value("BluetoothAddress").toString();
+    info.ethernetAddress = values.value("EthernetAddress").toString();
+    
+    // ===== 电话/SIM信息 =====
+    info.phoneNumber = values.value("PhoneNumber").toString();
+    info.imei = values.value("InternationalMobileEquipmentIdentity").toString();
+    info.imei2 = values.value("InternationalMobileEquipmentIdentity2").toString();
+    info.meid = values.value("MobileEquipmentIdentifier").toString();
+    info.iccid = values.value("IntegratedCircuitCardIdentity").toString();
+    info.carrierBundleInfoVersion = values.value("CarrierBundleInfoVersion").toString();
+    
+    // ===== 设备状态 =====
+    info.activationState = values.value("ActivationState").toString();
+    info.passwordProtected = values.value("PasswordProtected").toBool();
+    info.deviceSupportsLockdown = values.value("DeviceSupportsLockdown").toBool();
+    info.hostAttached = values.value("HostAttached").toBool();
+    info.hasSimLockedStatus = values.value("HasSiMLock").toBool();
+    info.iTunesHasConnected = values.value("iTunesHasConnected").toBool();
+    
+    // ===== 时间信息 =====
+    info.timeZone = values.value("TimeZone").toString();
+    info.timeIntervalSince1970 = values.value("TimeIntervalSince1970").toLongLong();
+    if (info.timeIntervalSince1970 > 0) {
+        info.deviceTime = QDateTime::fromSecsSinceEpoch(info.timeIntervalSince1970);
+    }
+    
+    // ===== 安全信息 =====
+    info.trustedHostAttached = values.value("TrustedHostAttached").toBool();
+    info.pairingState = values.value("PairingState").toString();
+    
+    // ===== 其他信息 =====
+    info.mlbSerialNumber = values.value("MLBSerialNumber").toString();
+    info.protocolVersion = values.value("ProtocolVersion").toString();
+    info.supportsWirelessSync = values.value("SupportsWirelessSync").toBool();
+    info.wirelessBuddyID = values.value("WirelessBuddyID").toString();
+}
+
+void DeviceInfoManager::applyDiskUsageDomain(DeviceInfo &info, const QVariantMap &values)
+{
+    // TotalDiskCapacity 是物理磁盘总容量（如128GB）
+    // TotalDataCapacity + TotalSystemCapacity 才是实际可用分区总容量
+    info.totalCapacity = values.value("TotalDiskCapacity").toLongLong();
+    // TotalDataAvailable 是数据分区可用空间，与手机设置中显示的"可用空间"一致
+    info.availableCapacity = values.value("TotalDataAvailable").toLongLong();
+    info.totalSystemCapacity = values.value("TotalSystemCapacity").toLongLong();
+    info.totalSystemAvailable = values.value("TotalSystemAvailable").toLongLong();
+    info.totalDataCapacity = values.value("TotalDataCapacity").toLongLong();
+    info.totalDataAvailable = values.value("TotalDataAvailable").toLongLong();
+    info.amountDataReserved = values.value("AmountDataReserved").toLongLong();
+    info.amountDataAvailable = values.value("AmountDataAvailable").toLongLong();
+    info.storageLoaded = true;
+}
+
+void DeviceInfoManager::applyBatteryDomain(DeviceInfo &info, const QVariantMap &values)
+{
+    info.batteryCurrentCapacity = values.value("BatteryCurrentCapacity").toInt();
+    info.batteryIsCharging = values.value("BatteryIsCharging").toBool();
+    info.externalChargeCapable = values.value("ExternalChargeCapable").toString();
+    info.fullyCharged = values.value("FullyCharged").toBool();
+    info.batteryLoaded = true;
+}
+
 QVariantMap DeviceInfoManager::getDetailedInfo(const QString &udid)
 {
     DeviceInfo basicInfo = getDeviceInfo(udid);
@@ -576,36 +730,25 @@ QVariantMap DeviceInfoManager::getBatteryInfo(const QString &udid)
         return batteryInfo;
     }
     
-    idevice_t device = nullptr;
-    lockdownd_client_t lockdown = nullptr;
-    
-    do {
-        if (!loader.idevice_new || loader.idevice_new(&device, udid.toUtf8().constData()) != IDEVICE_E_SUCCESS) {
-            break;
-        }
-        
-        if (!loader.lockdownd_client_new_with_handshake || 
-            loader.lockdownd_client_new_with_handshake(device, &lockdown, "phone-linkc") != LOCKDOWN_E_SUCCESS) {
-            break;
-        }
-        
-        batteryInfo["BatteryCurrentCapacity"] = static_cast<int>(getIntValue(lockdown, "com.apple.mobile.battery", "BatteryCurrentCapacity"));
-        batteryInfo["BatteryIsCharging"] = getBoolValue(lockdown, "com.apple.mobile.battery", "BatteryIsCharging");
-        batteryInfo["FullyCharged"] = getBoolValue(lockdown, "com.apple.mobile.battery", "FullyCharged");
-        batteryInfo["ExternalChargeCapable"] = getBoolValue(lockdown, "com.apple.mobile.battery", "ExternalChargeCapable");
-        batteryInfo["ExternalConnected"] = getBoolValue(lockdown, "com.apple.mobile.battery", "ExternalConnected");
-        batteryInfo["GasGaugeBatteryCapacity"] = static_cast<int>(getIntValue(lockdown, "com.apple.mobile.battery", "GasGaugeBatteryCapacity"));
-        batteryInfo["GasGaugeCapability"] = getBoolValue(lockdown, "com.apple.mobile.battery", "GasGaugeCapability");
-        
-    } while (false);
-    
-    if (lockdown && loader.lockdownd_client_free) {
-        loader.lockdownd_client_free(lockdown);
+    DeviceSession::Ptr session = DeviceSession::acquire(udid);
+    if (!session) {
+        return batteryInfo;
     }
-    if (device && loader.idevice_free) {
-        loader.idevice_free(device);
+    
+    // 一次往返读取整个电池域
+    QVariantMap battery = session->getDomain(DOMAIN_BATTERY);
+    if (battery.isEmpty()) {
+        return batteryInfo;
     }
     
+    batteryInfo["BatteryCurrentCapacity"] = battery.value("BatteryCurrentCapacity").toInt();
+    batteryInfo["BatteryIsCharging"] = battery.value("BatteryIsCharging").toBool();
+    batteryInfo["FullyCharged"] = battery.value("FullyCharged").toBool();
+    batteryInfo["ExternalChargeCapable"] = battery.value("ExternalChargeCapable").toBool();
+    batteryInfo["ExternalConnected"] = battery.value("ExternalConnected").toBool();
+    batteryInfo["GasGaugeBatteryCapacity"] = battery.value("GasGaugeBatteryCapacity").toInt();
+    batteryInfo["GasGaugeCapability"] = battery.value("GasGaugeCapability").toBool();
+    
     return batteryInfo;
 }
 
@@ -620,146 +763,43 @@ QVariantMap DeviceInfoManager::getDiskUsageInfo(const QString &udid)
         return diskInfo;
     }
     
-    idevice_t device = nullptr;
-    lockdownd_client_t lockdown = nullptr;
-    
-    do {
-        if (!loader.idevice_new || loader.idevice_new(&device, udid.toUtf8().constData()) != IDEVICE_E_SUCCESS) {
-            break;
-        }
-        
-        if (!loader.lockdownd_client_new_with_handshake || 
-            loader.lockdownd_client_new_with_handshake(device, &lockdown, "phone-linkc") != LOCKDOWN_E_SUCCESS) {
-            break;
-        }
-        
-        qint64 totalDisk = getIntValue(lockdown, "com.apple.disk_usage", "TotalDiskCapacity");
-        qint64 totalDataAvailable = getIntValue(lockdown, "com.apple.disk_usage", "TotalDataAvailable");
-        qint64 totalSystemCapacity = getIntValue(lockdown, "com.apple.disk_usage", "TotalSystemCapacity");
-        qint64 totalSystemAvailable = getIntValue(lockdown, "com.apple.disk_usage", "TotalSystemAvailable");
-        qint64 totalDataCapacity = getIntValue(lockdown, "com.apple.disk_usage", "TotalDataCapacity");
-        qint64 amountDataReserved = getIntValue(lockdown, "com.apple.disk_usage", "AmountDataReserved");
-        qint64 amountDataAvailable = getIntValue(lockdown, "com.apple.disk_usage", "AmountDataAvailable");
-        
-        diskInfo["TotalDiskCapacity"] = totalDisk;
-        diskInfo["TotalDataAvailable"] = totalDataAvailable;
-        diskInfo["TotalSystemCapacity"] = totalSystemCapacity;
-        diskInfo["TotalSystemAvailable"] = totalSystemAvailable;
-        diskInfo["TotalDataCapacity"] = totalDataCapacity;
-        diskInfo["AmountDataReserved"] = amountDataReserved;
-        diskInfo["AmountDataAvailable"] = amountDataAvailable;
-        
-        diskInfo["TotalDiskCapacityFormatted"] = DeviceInfo::formatCapacity(totalDisk);
-        diskInfo["TotalDataAvailableFormatted"] = DeviceInfo::formatCapacity(totalDataAvailable);
-        diskInfo["TotalSystemCapacityFormatted"] = DeviceInfo::formatCapacity(totalSystemCapacity);
-        diskInfo["TotalDataCapacityFormatted"] = DeviceInfo::formatCapacity(totalDataCapacity);
-        
-        // 计算使用百分比
-        if (totalDisk > 0) {
-            double usedPercent = static_cast<double>(totalDisk - totalDataAvailable) / totalDisk * 100;
-            diskInfo["UsedPercentage"] = usedPercent;
-        }
-        
-    } while (false);
-    
-    if (lockdown && loader.lockdownd_client_free) {
-        loader.lockdownd_client_free(lockdown);
-    }
-    if (device && loader.idevice_free) {
-        loader.idevice_free(device);
-    }
-    
-    return diskInfo;
-}
-
-QString DeviceInfoManager::getStringValue(lockdownd_client_t lockdown, const char* domain, const char* key)
-{
-    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
-    if (!loader.isInitialized() || !loader.lockdownd_get_value) {
-        return QString();
-    }
-    
-    plist_t value = nullptr;
-    QString result;
-    
-    if (loader.lockdownd_get_value(lockdown, domain, key, &value) == LOCKDOWN_E_SUCCESS && value) {
-        if (loader.plist_get_node_type && loader.plist_get_node_type(value) == PLIST_STRING) {
-            // 使用 plist_get_string_ptr 获取字符串指针，无需手动释放内存
-            // 该指针在 plist_free(value) 调用前有效
-            if (loader.plist_get_string_ptr) {
-                uint64_t length = 0;
-                const char* str_ptr = loader.plist_get_string_ptr(value, &length);
-                if (str_ptr) {
-                    result = QString::fromUtf8(str_ptr, static_cast<int>(length));
-                }
-            }
-        }
-        if (loader.plist_free) {
-            loader.plist_free(value);
-        }
-    }
-    
-    return result;
-}
-
-qint64 DeviceInfoManager::getIntValue(lockdownd_client_t lockdown, const char* domain, const char* key)
-{
-    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
-    if (!loader.isInitialized() || !loader.lockdownd_get_value) {
-        return 0;
-    }
-    
-    plist_t value = nullptr;
-    qint64 result = 0;
-    
-    if (loader.lockdownd_get_value(lockdown, domain, key, &value) == LOCKDOWN_E_SUCCESS && value) {
-        if (loader.plist_get_node_type && loader.plist_get_node_type(value) == PLIST_UINT) {
-            uint64_t uint_value = 0;
-            if (loader.plist_get_uint_val) {
-                loader.plist_get_uint_val(value, &uint_value);
-                result = static_cast<qint64>(uint_value);
-            }
-        }
-        if (loader.plist_free) {
-            loader.plist_free(value);
-        }
+    DeviceSession::Ptr session = DeviceSession::acquire(udid);
+    if (!session) {
+        return diskInfo;
     }
     
-    return result;
-}
-
-bool DeviceInfoManager::getBoolValue(lockdownd_client_t lockdown, const char* domain, const char* key)
-{
-    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
-    if (!loader.isInitialized() || !loader.lockdownd_get_value) {
-        return false;
+    // 一次往返读取整个存储域
+    QVariantMap diskUsage = session->getDomain(DOMAIN_DISK_USAGE);
+    if (diskUsage.isEmpty()) {
+        return diskInfo;
     }
     
-    plist_t value = nullptr;
-    bool result = false;
-    
-    if (loader.lockdownd_get_value(lockdown, domain, key, &value) == LOCKDOWN_E_SUCCESS && value) {
-        if (loader.plist_get_node_type && loader.plist_get_node_type(value) == PLIST_BOOLEAN) {
-            uint8_t bool_value = 0;
-            if (loader.plist_get_bool_val) {
-                loader.plist_get_bool_val(value, &bool_value);
-                result = bool_value != 0;
-            }
-        }
-        if (loader.plist_free) {
-            loader.plist_free(value);
-        }
+    qint64 totalDisk = diskUsage.value("TotalDiskCapacity").toLongLong();
+    qint64 totalDataAvailable = diskUsage.value("TotalDataAvailable").toLongLong();
+    qint64 totalSystemCapacity = diskUsage.value("TotalSystemCapacity").toLongLong();
+    qint64 totalSystemAvailable = diskUsage.value("TotalSystemAvailable").toLongLong();
+    qint64 totalDataCapacity = diskUsage.value("TotalDataCapacity").toLongLong();
+    qint64 amountDataReserved = diskUsage.value("AmountDataReserved").toLongLong();
+    qint64 amountDataAvailable = diskUsage.value("AmountDataAvailable").toLongLong();
+    
+    diskInfo["TotalDiskCapacity"] = totalDisk;
+    diskInfo["TotalDataAvailable"] = totalDataAvailable;
+    diskInfo["TotalSystemCapacity"] = totalSystemCapacity;
+    diskInfo["TotalSystemAvailable"] = totalSystemAvailable;
+    diskInfo["TotalDataCapacity"] = totalDataCapacity;
+    diskInfo["AmountDataReserved"] = amountDataReserved;
+    diskInfo["AmountDataAvailable"] = amountDataAvailable;
+    
+    diskInfo["TotalDiskCapacityFormatted"] = DeviceInfo::formatCapacity(totalDisk);
+    diskInfo["TotalDataAvailableFormatted"] = DeviceInfo::formatCapacity(totalDataAvailable);
+    diskInfo["TotalSystemCapacityFormatted"] = DeviceInfo::formatCapacity(totalSystemCapacity);
+    diskInfo["TotalDataCapacityFormatted"] = DeviceInfo::formatCapacity(totalDataCapacity);
+    
+    // 计算使用百分比
+    if (totalDisk > 0) {
+        double usedPercent = static_cast<double>(totalDisk - totalDataAvailable) / totalDisk * 100;
+        diskInfo["UsedPercentage"] = usedPercent;
     }
     
-    return result;
-}
-
-double DeviceInfoManager::getDoubleValue(lockdownd_client_t lockdown, const char* domain, const char* key)
-{
-    // 注意: plist_get_real_val 函数暂未在动态库加载器中实现
-    // 如果需要获取浮点数值，可以尝试作为整数获取
-    Q_UNUSED(lockdown);
-    Q_UNUSED(domain);
-    Q_UNUSED(key);
-    return 0.0;
+    return diskInfo;
 }
@@ -4,8 +4,7 @@
 #include <QObject>
 #include <QVariantMap>
 #include <QDateTime>
-
-#include <libimobiledevice/lockdown.h>
+#include <QFuture>
 
 /**
  * @brief 设备详细信息结构体
@@ -32,7 +31,7 @@ struct DeviceInfo {
     QString boardId;                // 主板ID (BoardId)
     QString uniqueChipID;           // 唯一芯片ID (UniqueChipID)
     QString dieID;                  // Die ID (DieID)
-    qint32 firmwareVersion;         // 固件版本 (FirmwareVersion)
+    qint32 firmwareVersion = 0;     // 固件版本 (FirmwareVersion)
     
     // ===== 系统版本信息 =====
     QString productVersion;         // iOS版本 (ProductVersion: 17.1.1)
@@ -45,14 +44,14 @@ struct DeviceInfo {
     QString enclosureColor;         // 外壳颜色 (EnclosureColor)
     
     // ===== 存储信息 =====
-    qint64 totalCapacity;           // 总存储容量 (字节)
-    qint64 availableCapacity;       // 可用存储容量 (字节)
-    qint64 totalSystemCapacity;     // 系统分区总容量 (字节)
-    qint64 totalSystemAvailable;    // 系统分区可用容量 (字节)
-    qint64 totalDataCapacity;       // 数据分区总容量 (字节)
-    qint64 totalDataAvailable;      // 数据分区可用容量 (字节)
-    qint64 amountDataReserved;      // 预留数据空间 (字节)
-    qint64 amountDataAvailable;     // 实际可用数据空间 (字节)
+    qint64 totalCapacity = 0;       // 总存储容量 (字节)
+    qint64 availableCapacity = 0;   // 可用存储容量 (字节)
+    qint64 totalSystemCapacity = 0; // 系统分区总容量 (字节)
+    qint64 totalSystemAvailable = 0; // 系统分区可用容量 (字节)
+    qint64 totalDataCapacity = 0;   // 数据分区总容量 (字节)
+    qint64 totalDataAvailable = 0;  // 数据分区可用容量 (字节)
+    qint64 amountDataReserved = 0;  // 预留数据空间 (字节)
+    qint64 amountDataAvailable = 0; // 实际可用数据空间 (字节)
     
     // ===== 网络信息 =====
     QString wifiAddress;            // WiFi MAC地址 (WiFiAddress)
@@ -68,34 +67,38 @@ struct DeviceInfo {
     QString carrierBundleInfoVersion; // 运营商包版本
     
     // ===== 电池信息 =====
-    qint32 batteryCurrentCapacity;  // 当前电量百分比 (0-100)
-    bool batteryIsCharging;         // 是否正在充电
+    qint32 batteryCurrentCapacity = 0; // 当前电量百分比 (0-100)
+    bool batteryIsCharging = false; // 是否正在充电
     QString externalChargeCapable;  // 外部充电能力
-    bool fullyCharged;              // 是否已充满
+    bool fullyCharged = false;      // 是否已充满
     
     // ===== 设备状态 =====
     QString activationState;        // 激活状态 (ActivationState: Activated)
-    bool passwordProtected;         // 是否设置密码 (PasswordProtected)
-    bool deviceSupportsLockdown;    // 是否支持锁定协议
-    bool hostAttached;              // 主机是否已连接
-    bool hasSimLockedStatus;        // SIM锁状态
-    bool iTunesHasConnected;        // iTunes是否曾连接
+    bool passwordProtected = false; // 是否设置密码 (PasswordProtected)
+    bool deviceSupportsLockdown = false; // 是否支持锁定协议
+    bool hostAttached = false;      // 主机是否已连接
+    bool hasSimLockedStatus = false; // SIM锁状态
+    bool iTunesHasConnected = false; // iTunes是否曾连接
     
     // ===== 时间信息 =====
     QString timeZone;               // 时区 (TimeZone: Asia/Shanghai)
-    qint64 timeIntervalSince1970;   // 设备时间戳
+    qint64 timeIntervalSince1970 = 0; // 设备时间戳
     QDateTime deviceTime;           // 设备当前时间
     
     // ===== 安全信息 =====
-    bool trustedHostAttached;       // 信任主机是否已连接
+    bool trustedHostAttached = false; // 信任主机是否已连接
     QString pairingState;           // 配对状态
     
     // ===== 其他信息 =====
     QString mlbSerialNumber;        // MLB序列号 (MLBSerialNumber)
     QString protocolVersion;        // 协议版本 (ProtocolVersion)
-    bool supportsWirelessSync;      // 是否支持无线同步
+    bool supportsWirelessSync = false; // 是否支持无线同步
     QString wirelessBuddyID;        // 无线配对ID
     
+    // ===== 加载状态 =====
+    bool storageLoaded = false;     // 存储域是否已读取（异步获取时分阶段到达）
+    bool batteryLoaded = false;     // 电池域是否已读取
+    
     /**
      * @brief 将设备信息转换为 QVariantMap
      * @return 包含所有设备信息的 QVariantMap
@@ -127,6 +130,16 @@ class DeviceInfoManager : public QObject
     Q_OBJECT
 
 public:
+    /**
+     * @brief 异步获取设备信息时各阶段结果在 QFuture 中的序号
+     */
+    enum InfoStage {
+        IdentityStage = 0,  ///< 全局域：标识、产品、硬件、系统、网络等信息
+        StorageStage,       ///< 追加 com.apple.disk_usage 存储信息
+        BatteryStage,       ///< 追加 com.apple.mobile.battery 电池信息
+        StageCount
+    };
+
     explicit DeviceInfoManager(QObject *parent = nullptr);
     
     /**
@@ -136,6 +149,20 @@ public:
      */
     DeviceInfo getDeviceInfo(const QString &udid);
     
+    /**
+     * @brief 在工作线程中分阶段获取设备信息
+     *
+     * 每读取完一个 lockdown 域就向 QFuture 追加一个结果，序号对应 InfoStage，
+     * 后一个结果包含前面阶段的全部字段。可通过 QFutureWatcher::resultReadyAt
+     * 逐段刷新界面；取消 QFuture 后不再读取后续的域。
+     * 获取失败时 QFuture 结束且不含任何结果。
+     *
+     * 任务不引用管理器本身，管理器先于任务销毁也是安全的。
+     * @param udid 设备唯一标识符
+     * @return 最多包含 StageCount 个结果的 QFuture
+     */
+    QFuture<DeviceInfo> getDeviceInfoAsync(const QString &udid);
+    
     /**
      * @brief 获取设备详细信息（包含所有可用字段）
      * @param udid 设备唯一标识符
@@ -157,12 +184,29 @@ public:
      */
     QVariantMap getDiskUsageInfo(const QString &udid);
 
-private:
-    // libimobiledevice辅助方法（动态加载模式）
-    QString getStringValue(lockdownd_client_t lockdown, const char* domain, const char* key);
-    qint64 getIntValue(lockdownd_client_t lockdown, const char* domain, const char* key);
-    bool getBoolValue(lockdownd_client_t lockdown, const char* domain, const char* key);
-    double getDoubleValue(lockdownd_client_t lockdown, const char* domain, const char* key);
+    /**
+     * @brief 逐键查询设备信息（每个属性一次 lockdown 往返）
+     *
+     * 旧的查询方式，仅用于与 getDeviceInfo() 的按域批量查询做延迟对比。
+     * @param udid 设备唯一标识符
+     * @return DeviceInfo 结构体
+     */
+    DeviceInfo getDeviceInfoPerKey(const QString &udid);
+    
+    /**
+     * @brief 从全局域解码标识、产品、硬件、系统、网络和状态信息
+     */
+    static void applyGlobalDomain(DeviceInfo &info, const QVariantMap &values);
+    
+    /**
+     * @brief 从 com.apple.disk_usage 域解码存储信息
+     */
+    static void applyDiskUsageDomain(DeviceInfo &info, const QVariantMap &values);
+    
+    /**
+     * @brief 从 com.apple.mobile.battery 域解码电池信息
+     */
+    static void applyBatteryDomain(DeviceInfo &info, const QVariantMap &values);
 };
 
 #endif // DEVICEINFO_H
\ No newline at end of file
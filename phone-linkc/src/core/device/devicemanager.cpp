@@ -1,20 +1,34 @@
 #include "devicemanager.h"
+#include "devicesession.h"
+#include "devicemetadatacache.h"
+#include "hotplugprocessor.h"
 #include "platform/libimobiledevice_dynamic.h"
 #include <QDebug>
 #include <QRandomGenerator>
-#include <QMetaObject>
 #include <QCoreApplication>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
 
 DeviceManager::DeviceManager(QObject *parent)
     : QObject(parent)
     , m_isConnected(false)
-    , m_device(nullptr)
-    , m_lockdown(nullptr)
+    , m_connectGeneration(0)
     , m_eventSubscribed(false)
     , m_subscriptionContext(nullptr)
+    , m_hotplugThread(new QThread(this))
+    , m_hotplug(new HotplugProcessor())
 {
     qDebug() << "DeviceManager 已创建";
     
+    // 热插拔事件在独立线程中去抖合并，主线程只接收最终的连接/断开结果
+    m_hotplugThread->setObjectName("HotplugThread");
+    m_hotplug->moveToThread(m_hotplugThread);
+    connect(m_hotplug, &HotplugProcessor::deviceArrived,
+            this, &DeviceManager::onHotplugArrived);
+    connect(m_hotplug, &HotplugProcessor::deviceRemoved,
+            this, &DeviceManager::onHotplugRemoved);
+    m_hotplugThread->start();
+    
     // 初始化动态库加载器
     LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
     if (loader.initialize()) {
@@ -27,6 +41,12 @@ DeviceManager::DeviceManager(QObject *parent)
 DeviceManager::~DeviceManager()
 {
     cleanup();
+    
+    // cleanup() 已停止事件订阅，不会再有新事件投递，结束处理线程后销毁处理器
+    m_hotplugThread->quit();
+    m_hotplugThread->wait();
+    delete m_hotplug;
+    m_hotplug = nullptr;
     qDebug() << "DeviceManager 已销毁";
 }
 
@@ -116,22 +136,26 @@ void DeviceManager::scanCurrentDevices()
         QString udid = QString::fromUtf8(device_list[i]);
         currentDevices << udid;
         
-        // 检查是否是新设备
+        // 检查是否是新设备（名称取自缓存，不在此处握手）
         if (!m_knownDevices.contains(udid)) {
-            QString deviceName = getDeviceName(udid);
+            QString deviceName = cachedDeviceName(udid);
             qDebug() << "发现新设备:" << udid << "名称:" << deviceName;
             emit deviceFound(udid, deviceName);
         }
     }
     
+    // 后台并行刷新缺失或过期的设备元数据
+    DeviceMetadataCache::instance().refresh(currentDevices);
+    
     // 检查丢失的设备
     for (const QString &knownUdid : m_knownDevices) {
         if (!currentDevices.contains(knownUdid)) {
             qDebug() << "设备断开连接:" << knownUdid;
+            DeviceSession::invalidate(knownUdid);
             emit deviceLost(knownUdid);
             
-            // 如果当前连接的设备断开了
-            if (knownUdid == m_currentUdid) {
+            // 如果当前连接（或正在连接）的设备断开了
+            if (knownUdid == m_currentUdid || knownUdid == m_connectingUdid) {
                 disconnectFromDevice();
             }
         }
@@ -148,34 +172,49 @@ void DeviceManager::scanCurrentDevices()
     }
 }
 
-bool DeviceManager::connectToDevice(const QString &udid)
+void DeviceManager::connectToDevice(const QString &udid)
 {
-    if (m_isConnected) {
-        disconnectFromDevice();
-    }
+    // 断开当前连接，同时作废之前尚未完成的握手
+    disconnectFromDevice();
     
     qDebug() << "尝试连接到设备:" << udid;
     
     LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
     if (!loader.isInitialized()) {
         emit errorOccurred("libimobiledevice 未安装或不可用。无法连接到 iOS 设备。");
-        return false;
+        return;
     }
     
-    if (initializeConnection(udid)) {
-        m_currentUdid = udid;
-        m_isConnected = true;
-        emit deviceConnected(udid);
-        qDebug() << "成功连接到设备:" << udid;
-        return true;
-    } else {
-        emit errorOccurred(QString("无法连接到设备: %1").arg(udid));
-        return false;
-    }
+    m_connectingUdid = udid;
+    const quint64 generation = m_connectGeneration;
+    
+    // 慢速设备的握手可能需要数秒，在线程池中获取会话，完成后回到主线程发布结果
+    QtConcurrent::run([udid]() {
+        return initializeConnection(udid);
+    }).then(this, [this, udid, generation](const std::shared_ptr<DeviceSession> &session) {
+        if (generation != m_connectGeneration) {
+            // 握手期间已断开或改连其他设备，会话随 session 释放
+            return;
+        }
+        m_connectingUdid.clear();
+        
+        if (session) {
+            m_session = session;
+            m_currentUdid = udid;
+            m_isConnected = true;
+            emit deviceConnected(udid);
+            qDebug() << "成功连接到设备:" << udid;
+        } else {
+            emit errorOccurred(QString("无法连接到设备: %1").arg(udid));
+        }
+    });
 }
 
 void DeviceManager::disconnectFromDevice()
 {
+    ++m_connectGeneration;
+    m_connectingUdid.clear();
+    
     if (m_isConnected) {
         cleanup();
         m_isConnected = false;
@@ -187,29 +226,21 @@ void DeviceManager::disconnectFromDevice()
 }
 
 
-bool DeviceManager::initializeConnection(const QString &udid)
+std::shared_ptr<DeviceSession> DeviceManager::initializeConnection(const QString &udid)
 {
     LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
-    if (!loader.isInitialized() || !loader.idevice_new || !loader.lockdownd_client_new_with_handshake) {
+    if (!loader.isInitialized()) {
         qWarning() << "动态库未正确加载，无法初始化连接";
-        return false;
-    }
-    
-    // 创建设备连接
-    if (loader.idevice_new(&m_device, udid.toUtf8().constData()) != IDEVICE_E_SUCCESS) {
-        qWarning() << "创建设备连接失败:" << udid;
-        return false;
+        return nullptr;
     }
     
-    // 创建 lockdown 客户端
-    if (loader.lockdownd_client_new_with_handshake(m_device, &m_lockdown, "phone-linkc") != LOCKDOWN_E_SUCCESS) {
-        qWarning() << "创建 lockdown 客户端失败:" << udid;
-        loader.idevice_free(m_device);
-        m_device = nullptr;
-        return false;
+    // 获取共享的设备会话，连接期间一直持有，其他管理器复用同一次握手（在线程池中执行）
+    QString error;
+    std::shared_ptr<DeviceSession> session = DeviceSession::acquire(udid, &error);
+    if (!session) {
+        qWarning() << "创建设备会话失败:" << udid << error;
     }
-    
-    return true;
+    return session;
 }
 
 QString DeviceManager::getDeviceName(const QString &udid)
@@ -219,60 +250,39 @@ QString DeviceManager::getDeviceName(const QString &udid)
         return "Unknown Device";
     }
     
-    idevice_t device = nullptr;
-    lockdownd_client_t lockdown = nullptr;
-    plist_t value = nullptr;
-    QString name = "Unknown Device";
-    
-    // 创建临时连接获取设备名称
-    if (loader.idevice_new && loader.idevice_new(&device, udid.toUtf8().constData()) == IDEVICE_E_SUCCESS) {
-        if (loader.lockdownd_client_new_with_handshake && 
-            loader.lockdownd_client_new_with_handshake(device, &lockdown, "phone-linkc") == LOCKDOWN_E_SUCCESS) {
-            if (loader.lockdownd_get_value && 
-                loader.lockdownd_get_value(lockdown, nullptr, "DeviceName", &value) == LOCKDOWN_E_SUCCESS) {
-                if (value && loader.plist_get_node_type && loader.plist_get_node_type(value) == PLIST_STRING) {
-                    // 使用 plist_get_string_ptr 获取字符串指针，无需手动释放内存
-                    // 该指针在 plist_free(value) 调用前有效
-                    if (loader.plist_get_string_ptr) {
-                        uint64_t length = 0;
-                        const char* str_ptr = loader.plist_get_string_ptr(value, &length);
-                        if (str_ptr) {
-                            name = QString::fromUtf8(str_ptr, static_cast<int>(length));
-                        }
-                    }
-                }
-                if (value && loader.plist_free) {
-                    loader.plist_free(value);
-                }
-            }
-            if (loader.lockdownd_client_free) {
-                loader.lockdownd_client_free(lockdown);
-            }
-        }
-        if (loader.idevice_free) {
-            loader.idevice_free(device);
-        }
+    // 优先使用缓存，过期时在后台刷新
+    DeviceMetadataCache &cache = DeviceMetadataCache::instance();
+    DeviceMetadata metadata = cache.lookup(udid);
+    if (metadata.isValid() && !metadata.name.isEmpty()) {
+        cache.refresh(QStringList{udid});
+        return metadata.name;
+    }
+    
+    // 没有缓存时同步读取（复用设备会话，会话已存在时无需再次握手）
+    metadata = cache.fetch(udid);
+    if (metadata.isValid() && !metadata.name.isEmpty()) {
+        return metadata.name;
     }
     
-    return name;
+    return "Unknown Device";
+}
+
+QString DeviceManager::cachedDeviceName(const QString &udid) const
+{
+    DeviceMetadata metadata = DeviceMetadataCache::instance().lookup(udid);
+    if (metadata.name.isEmpty()) {
+        return "iOS Device";
+    }
+    return metadata.name;
 }
 
 void DeviceManager::cleanup()
 {
-    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
-    
     // 停止事件订阅
     stopEventSubscription();
     
-    if (m_lockdown && loader.lockdownd_client_free) {
-        loader.lockdownd_client_free(m_lockdown);
-        m_lockdown = nullptr;
-    }
-    
-    if (m_device && loader.idevice_free) {
-        loader.idevice_free(m_device);
-        m_device = nullptr;
-    }
+    // 释放会话引用，最后一个持有者释放时关闭连接
+    m_session.reset();
 }
 
 void DeviceManager::startEventSubscription()
@@ -330,45 +340,40 @@ void DeviceManager::deviceEventCallback(const void* event, void* user_data)
     
     if (device_event->event == IDEVICE_DEVICE_ADD) {
         qDebug() << "USB 事件：设备连接" << udid;
-        
-        // 使用线程安全的方式在主线程中处理设备连接事件
-        QMetaObject::invokeMethod(manager, [manager, udid]() {
-            if (!manager->m_knownDevices.contains(udid)) {
-                QString deviceName = manager->getDeviceName(udid);
-                manager->m_knownDevices << udid;
-                qDebug() << "主线程处理：发现新设备" << udid << "名称:" << deviceName;
-                emit manager->deviceFound(udid, deviceName);
-            }
-        }, Qt::QueuedConnection);
-        
     } else if (device_event->event == IDEVICE_DEVICE_REMOVE) {
         qDebug() << "USB 事件：设备断开" << udid;
         
-        // 使用线程安全的方式在主线程中处理设备断开事件
-        QMetaObject::invokeMethod(manager, [manager, udid]() {
-            if (manager->m_knownDevices.contains(udid)) {
-                manager->m_knownDevices.removeAll(udid);
-                qDebug() << "主线程处理：设备断开连接" << udid;
-                emit manager->deviceLost(udid);
-                
-                // 如果是当前连接的设备断开了
-                if (udid == manager->m_currentUdid) {
-                    manager->disconnectFromDevice();
-                }
-            }
-        }, Qt::QueuedConnection);
-        
+        // 设备已拔出，之后的连接需要重新握手
+        DeviceSession::invalidate(udid);
     } else if (device_event->event == IDEVICE_DEVICE_PAIRED) {
         qDebug() << "USB 事件：设备配对" << udid;
+    } else {
+        return;
+    }
+    
+    // 交给热插拔处理线程去抖合并，名称解析也在后台完成
+    manager->m_hotplug->postEvent(udid, device_event->event);
+}
+
+void DeviceManager::onHotplugArrived(const QString &udid, const QString &name)
+{
+    if (!m_knownDevices.contains(udid)) {
+        m_knownDevices << udid;
+        qDebug() << "主线程处理：发现新设备" << udid << "名称:" << name;
+        emit deviceFound(udid, name);
+    }
+}
+
+void DeviceManager::onHotplugRemoved(const QString &udid)
+{
+    if (m_knownDevices.contains(udid)) {
+        m_knownDevices.removeAll(udid);
+        qDebug() << "主线程处理：设备断开连接" << udid;
+        emit deviceLost(udid);
         
-        // 使用线程安全的方式在主线程中处理设备配对事件
-        QMetaObject::invokeMethod(manager, [manager, udid]() {
-            if (!manager->m_knownDevices.contains(udid)) {
-                QString deviceName = manager->getDeviceName(udid);
-                manager->m_knownDevices << udid;
-                qDebug() << "主线程处理：设备配对" << udid << "名称:" << deviceName;
-                emit manager->deviceFound(udid, deviceName);
-            }
-        }, Qt::QueuedConnection);
+        // 如果是当前连接（或正在连接）的设备断开了
+        if (udid == m_currentUdid || udid == m_connectingUdid) {
+            disconnectFromDevice();
+        }
     }
-}
\ No newline at end of file
+}
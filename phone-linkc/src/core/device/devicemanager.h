@@ -7,6 +7,11 @@
 
 #include <libimobiledevice/libimobiledevice.h>
 #include <libimobiledevice/lockdown.h>
+#include <memory>
+
+class DeviceSession;
+class HotplugProcessor;
+class QThread;
 
 class DeviceManager : public QObject
 {
@@ -20,7 +25,13 @@ public:
     void startDiscovery();
     void stopDiscovery();
     void refreshDevices();
-    bool connectToDevice(const QString &udid);
+    /**
+     * @brief 异步连接设备
+     *
+     * 握手（idevice_new + lockdown TLS）在线程池中进行，不阻塞 GUI 线程；
+     * 结果通过 deviceConnected 或 errorOccurred 通知。连接完成前再次调用或断开会作废本次连接。
+     */
+    void connectToDevice(const QString &udid);
     void disconnectFromDevice();
     
     // 获取信息
@@ -28,6 +39,11 @@ public:
     QString getCurrentDevice() const { return m_currentUdid; }
     bool isConnected() const { return m_isConnected; }
     QString getDeviceName(const QString &udid);
+    
+    /**
+     * @brief 从元数据缓存读取设备名称（不访问设备，没有缓存时返回 "iOS Device"）
+     */
+    QString cachedDeviceName(const QString &udid) const;
 
 signals:
     void deviceFound(const QString &udid, const QString &name);
@@ -37,19 +53,27 @@ signals:
     void errorOccurred(const QString &error);
     void noDevicesFound();  // 扫描完成但没有发现任何设备
 
+private slots:
+    // 热插拔处理线程结算后的最终状态（在主线程执行）
+    void onHotplugArrived(const QString &udid, const QString &name);
+    void onHotplugRemoved(const QString &udid);
+
 private:
     QStringList m_knownDevices;
     QString m_currentUdid;
     bool m_isConnected;
+    QString m_connectingUdid;           ///< 正在握手的设备（空表示没有进行中的连接）
+    quint64 m_connectGeneration;        ///< 连接代数，断开或重新连接时递增，作废进行中的握手
     
     // libimobiledevice相关成员（动态加载模式）
-    idevice_t m_device;
-    lockdownd_client_t m_lockdown;
+    std::shared_ptr<DeviceSession> m_session;  ///< 当前连接设备的共享会话
     bool m_eventSubscribed;
     idevice_subscription_context_t m_subscriptionContext;  ///< v1.4.0+ 事件订阅上下文
+    QThread *m_hotplugThread;           ///< 热插拔事件处理线程
+    HotplugProcessor *m_hotplug;        ///< 热插拔事件去抖合并（运行在 m_hotplugThread）
     
     // 私有方法
-    bool initializeConnection(const QString &udid);
+    static std::shared_ptr<DeviceSession> initializeConnection(const QString &udid);
     void cleanup();
     void scanCurrentDevices();
     
@@ -0,0 +1,258 @@
+/**
+ * @file devicemetadatacache.cpp
+ * @brief 设备元数据缓存实现
+ */
+
+#include "devicemetadatacache.h"
+#include "devicesession.h"
+#include "platform/libimobiledevice_dynamic.h"
+#include <QDebug>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaObject>
+#include <QMutexLocker>
+#include <QStandardPaths>
+#include <QThread>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrent>
+
+// 缓存文件格式版本
+static const int CACHE_VERSION = 1;
+
+// 默认有效期：设备名称和系统版本很少变化，一天内不重复查询
+static const qint64 DEFAULT_MAX_AGE_SECS = 24 * 60 * 60;
+
+// 并行刷新线程数：查询耗时主要在 USB 往返上，线程数可以高于 CPU 核数
+static const int REFRESH_THREADS = 8;
+
+// 写盘延迟（毫秒），合并同一批刷新结果
+static const int SAVE_DELAY_MS = 500;
+
+DeviceMetadataCache &DeviceMetadataCache::instance()
+{
+    static DeviceMetadataCache cache;
+    return cache;
+}
+
+DeviceMetadataCache::DeviceMetadataCache()
+    : QObject(nullptr)
+    , m_maxAgeSecs(DEFAULT_MAX_AGE_SECS)
+    , m_saveTimer(new QTimer(this))
+{
+    // 单例可能在工作线程中首次创建，刷新结果和写盘统一在主线程处理
+    if (QCoreApplication::instance()) {
+        moveToThread(QCoreApplication::instance()->thread());
+    }
+
+    m_pool.setMaxThreadCount(REFRESH_THREADS);
+
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(SAVE_DELAY_MS);
+    connect(m_saveTimer, &QTimer::timeout, this, &DeviceMetadataCache::save);
+
+    // 使用 %appdata%/iPhonLinkC/ 目录
+    QString configPath = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/iPhonLinkC";
+    QDir().mkpath(configPath);
+    m_filePath = QDir(configPath).filePath("devices.json");
+
+    load();
+}
+
+DeviceMetadataCache::~DeviceMetadataCache()
+{
+    m_pool.waitForDone();
+    if (m_saveTimer->isActive()) {
+        save();
+    }
+}
+
+DeviceMetadata DeviceMetadataCache::lookup(const QString &udid) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.value(udid);
+}
+
+bool DeviceMetadataCache::isFresh(const DeviceMetadata &metadata) const
+{
+    if (!metadata.isValid() || !metadata.refreshedAt.isValid()) {
+        return false;
+    }
+    return metadata.refreshedAt.secsTo(QDateTime::currentDateTimeUtc()) < m_maxAgeSecs;
+}
+
+void DeviceMetadataCache::setMaxAge(qint64 seconds)
+{
+    m_maxAgeSecs = seconds;
+}
+
+void DeviceMetadataCache::refresh(const QStringList &udids, bool force)
+{
+    QStringList toQuery;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const QString &udid : udids) {
+            if (m_pending.contains(udid)) {
+                continue;
+            }
+            if (!force && isFresh(m_entries.value(udid))) {
+                continue;
+            }
+            m_pending.insert(udid);
+            toQuery << udid;
+        }
+    }
+
+    if (toQuery.isEmpty()) {
+        return;
+    }
+
+    qDebug() << "DeviceMetadataCache: 后台刷新" << toQuery.size() << "台设备的元数据";
+
+    for (const QString &udid : toQuery) {
+        QtConcurrent::run(&m_pool, [this, udid]() {
+            DeviceMetadata metadata = query(udid);
+
+            // 回到主线程更新缓存并通知界面
+            QMetaObject::invokeMethod(this, [this, udid, metadata]() {
+                {
+                    QMutexLocker locker(&m_mutex);
+                    m_pending.remove(udid);
+                }
+                if (metadata.isValid()) {
+                    store(metadata);
+                }
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+DeviceMetadata DeviceMetadataCache::fetch(const QString &udid)
+{
+    DeviceMetadata metadata = query(udid);
+    if (metadata.isValid()) {
+        if (thread() == QThread::currentThread()) {
+            store(metadata);
+        } else {
+            QMetaObject::invokeMethod(this, [this, metadata]() {
+                store(metadata);
+            }, Qt::QueuedConnection);
+        }
+    }
+    return metadata;
+}
+
+DeviceMetadata DeviceMetadataCache::query(const QString &udid)
+{
+    DeviceMetadata metadata;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QString error;
+    DeviceSession::Ptr session = DeviceSession::acquire(udid, &error);
+    if (!session) {
+        qWarning() << "DeviceMetadataCache: 无法获取设备会话:" << udid << error;
+        return metadata;
+    }
+
+    // 一次往返读取整个全局域
+    QVariantMap global = session->getDomain(nullptr);
+    if (global.isEmpty()) {
+        qWarning() << "DeviceMetadataCache: 读取设备信息失败:" << udid;
+        return metadata;
+    }
+
+    metadata.udid = udid;
+    metadata.name = global.value("DeviceName").toString();
+    metadata.productType = global.value("ProductType").toString();
+    metadata.productVersion = global.value("ProductVersion").toString();
+    metadata.refreshedAt = QDateTime::currentDateTimeUtc();
+
+    qDebug() << "[性能] 读取设备元数据" << udid << metadata.name << "耗时:" << timer.elapsed() << "ms";
+    return metadata;
+}
+
+void DeviceMetadataCache::store(const DeviceMetadata &metadata)
+{
+    bool changed = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        const DeviceMetadata old = m_entries.value(metadata.udid);
+        changed = old.name != metadata.name
+               || old.productType != metadata.productType
+               || old.productVersion != metadata.productVersion;
+        m_entries.insert(metadata.udid, metadata);
+    }
+
+    // 刷新时间也需要持久化，否则下次启动会再次查询
+    m_saveTimer->start();
+
+    if (changed) {
+        emit metadataUpdated(metadata.udid, metadata);
+    }
+}
+
+void DeviceMetadataCache::load()
+{
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "DeviceMetadataCache: 无已保存的设备缓存";
+        return;
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    file.close();
+
+    QJsonObject root = doc.object();
+    if (root["version"].toInt() != CACHE_VERSION) {
+        qDebug() << "DeviceMetadataCache: 缓存版本不匹配，忽略";
+        return;
+    }
+
+    QJsonObject devices = root["devices"].toObject();
+    QMutexLocker locker(&m_mutex);
+    for (auto it = devices.constBegin(); it != devices.constEnd(); ++it) {
+        QJsonObject obj = it.value().toObject();
+        DeviceMetadata metadata;
+        metadata.udid = it.key();
+        metadata.name = obj["name"].toString();
+        metadata.productType = obj["productType"].toString();
+        metadata.productVersion = obj["productVersion"].toString();
+        metadata.refreshedAt = QDateTime::fromString(obj["refreshedAt"].toString(), Qt::ISODate);
+        m_entries.insert(metadata.udid, metadata);
+    }
+
+    qDebug() << "DeviceMetadataCache: 已加载" << m_entries.size() << "台设备的缓存";
+}
+
+void DeviceMetadataCache::save()
+{
+    QJsonObject devices;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const DeviceMetadata &metadata : m_entries) {
+            QJsonObject obj;
+            obj["name"] = metadata.name;
+            obj["productType"] = metadata.productType;
+            obj["productVersion"] = metadata.productVersion;
+            obj["refreshedAt"] = metadata.refreshedAt.toString(Qt::ISODate);
+            devices[metadata.udid] = obj;
+        }
+    }
+
+    QJsonObject root;
+    root["version"] = CACHE_VERSION;
+    root["devices"] = devices;
+
+    QFile file(m_filePath);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(root).toJson());
+        file.close();
+    } else {
+        qWarning() << "DeviceMetadataCache: 无法保存设备缓存到" << m_filePath;
+    }
+}
@@ -0,0 +1,125 @@
+/**
+ * @file devicemetadatacache.h
+ * @brief 设备元数据缓存头文件
+ *
+ * 缓存 UDID -> 设备名称、产品类型、iOS 版本，并持久化到本地 JSON 文件。
+ * 设备列表和连接对话框直接读取缓存即可显示，过期或缺失的条目在后台线程池中并行刷新，
+ * 不再为了一个设备名称在主线程上逐台执行 idevice + lockdown 握手。
+ */
+
+#ifndef DEVICEMETADATACACHE_H
+#define DEVICEMETADATACACHE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QDateTime>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QThreadPool>
+
+class QTimer;
+
+/**
+ * @brief 设备元数据
+ */
+struct DeviceMetadata {
+    QString udid;               ///< 设备 UDID
+    QString name;               ///< 设备名称 (DeviceName)
+    QString productType;        ///< 产品类型 (ProductType: iPhone15,2)
+    QString productVersion;     ///< iOS 版本 (ProductVersion: 17.1.1)
+    QDateTime refreshedAt;      ///< 最近一次从设备读取的时间
+
+    bool isValid() const { return !udid.isEmpty(); }
+};
+
+/**
+ * @brief 设备元数据缓存（进程内单例）
+ *
+ * 启动时从 %appdata%/iPhonLinkC/devices.json 加载，更新后延迟写回。
+ * lookup() 只读内存，可在任意线程调用；refresh() 只对缺失或超过 maxAge 的条目
+ * 发起查询，查询在专用线程池中并行执行，完成后在主线程更新缓存并发出 metadataUpdated。
+ *
+ * 使用方法：
+ * @code
+ * DeviceMetadataCache &cache = DeviceMetadataCache::instance();
+ * DeviceMetadata meta = cache.lookup(udid);   // 立即返回，可能为空或过期
+ * cache.refresh(udids);                       // 后台并行刷新过期条目
+ * @endcode
+ */
+class DeviceMetadataCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DeviceMetadataCache &instance();
+
+    ~DeviceMetadataCache();
+
+    /**
+     * @brief 读取缓存的元数据（不访问设备）
+     * @return 缓存条目，不存在时返回无效条目
+     */
+    DeviceMetadata lookup(const QString &udid) const;
+
+    /**
+     * @brief 条目是否仍在有效期内
+     */
+    bool isFresh(const DeviceMetadata &metadata) const;
+
+    /**
+     * @brief 在后台并行刷新元数据
+     * @param udids 需要刷新的设备
+     * @param force 为 true 时忽略有效期，全部重新查询
+     */
+    void refresh(const QStringList &udids, bool force = false);
+
+    /**
+     * @brief 同步读取设备元数据并写入缓存（会阻塞当前线程直到设备应答）
+     * @return 读取到的元数据，失败返回无效条目
+     */
+    DeviceMetadata fetch(const QString &udid);
+
+    /**
+     * @brief 设置条目有效期（秒），超过后 refresh() 会重新查询
+     */
+    void setMaxAge(qint64 seconds);
+
+    /**
+     * @brief 缓存文件路径
+     */
+    QString cacheFilePath() const { return m_filePath; }
+
+signals:
+    /**
+     * @brief 条目从设备刷新后发出（在主线程）
+     */
+    void metadataUpdated(const QString &udid, const DeviceMetadata &metadata);
+
+private:
+    DeviceMetadataCache();
+
+    /**
+     * @brief 从设备读取元数据（在工作线程执行）
+     */
+    static DeviceMetadata query(const QString &udid);
+
+    /**
+     * @brief 写入缓存并安排保存
+     */
+    void store(const DeviceMetadata &metadata);
+
+    void load();
+    void save();
+
+    QString m_filePath;                         ///< 缓存文件路径
+    qint64 m_maxAgeSecs;                        ///< 条目有效期（秒）
+    mutable QMutex m_mutex;                     ///< 保护 m_entries 和 m_pending
+    QHash<QString, DeviceMetadata> m_entries;   ///< UDID -> 元数据
+    QSet<QString> m_pending;                    ///< 正在刷新的 UDID
+    QTimer *m_saveTimer;                        ///< 合并多次更新后统一写盘
+    QThreadPool m_pool;                         ///< 刷新线程池（最后声明，析构时先等待任务结束）
+};
+
+#endif // DEVICEMETADATACACHE_H
@@ -0,0 +1,468 @@
+/**
+ * @file devicesession.cpp
+ * @brief 设备会话池实现
+ */
+
+#include "devicesession.h"
+#include "platform/libimobiledevice_dynamic.h"
+#include <QDebug>
+#include <QHash>
+#include <QMutexLocker>
+#include <limits>
+
+// lockdown 客户端标签
+static const char* SESSION_LABEL = "phone-linkc";
+
+namespace {
+
+/**
+ * @brief 会话池：UDID -> 弱引用，会话的生命周期由持有者决定
+ *
+ * 握手期间只持有该 UDID 的 openLock，不同设备可以并行握手。
+ * openLock 只在握手期间存在，最后一个使用者结束时从表中移除。
+ */
+struct SessionPool {
+    QMutex mutex;
+    QHash<QString, std::weak_ptr<DeviceSession>> sessions;
+    QHash<QString, std::shared_ptr<QMutex>> openLocks;
+};
+
+SessionPool &sessionPool()
+{
+    static SessionPool pool;
+    return pool;
+}
+
+/**
+ * @brief 判断 lockdown 错误是否意味着会话已失效，需要重新握手
+ */
+bool isSessionLost(lockdownd_error_t error)
+{
+    switch (error) {
+    case LOCKDOWN_E_SSL_ERROR:
+    case LOCKDOWN_E_RECEIVE_TIMEOUT:
+    case LOCKDOWN_E_MUX_ERROR:
+    case LOCKDOWN_E_NO_RUNNING_SESSION:
+    case LOCKDOWN_E_SESSION_INACTIVE:
+    case LOCKDOWN_E_INVALID_SESSION_ID:
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+DeviceSession::Ptr DeviceSession::acquire(const QString &udid, QString *errorMessage)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!loader.isInitialized()) {
+        if (errorMessage) {
+            *errorMessage = "libimobiledevice 动态库未初始化";
+        }
+        return nullptr;
+    }
+
+    SessionPool &pool = sessionPool();
+    std::shared_ptr<QMutex> openLock;
+    {
+        QMutexLocker locker(&pool.mutex);
+        Ptr session = pool.sessions.value(udid).lock();
+        if (session) {
+            return session;
+        }
+        std::shared_ptr<QMutex> &lock = pool.openLocks[udid];
+        if (!lock) {
+            lock = std::make_shared<QMutex>();
+        }
+        openLock = lock;
+    }
+
+    // 同一设备的并发获取只会握手一次，等待者拿到先到者建立的会话
+    QMutexLocker openLocker(openLock.get());
+    Ptr session;
+    {
+        QMutexLocker locker(&pool.mutex);
+        session = pool.sessions.value(udid).lock();
+    }
+
+    // 握手不持有池锁，其他设备的获取不受影响
+    bool opened = false;
+    if (!session) {
+        Ptr candidate(new DeviceSession(udid));
+        if (candidate->open(errorMessage)) {
+            session = candidate;
+            opened = true;
+        }
+    }
+
+    QMutexLocker locker(&pool.mutex);
+    if (opened) {
+        pool.sessions.insert(udid, session);
+        qDebug() << "DeviceSession: 已建立设备会话" << udid;
+    }
+    // 等待者的引用都在池锁下取得，此时计数稳定：只剩表和本次调用持有时，不再有人等待该锁
+    if (openLock.use_count() == 2 && pool.openLocks.value(udid) == openLock) {
+        pool.openLocks.remove(udid);
+    }
+    return session;
+}
+
+void DeviceSession::invalidate(const QString &udid)
+{
+    SessionPool &pool = sessionPool();
+    QMutexLocker locker(&pool.mutex);
+    if (pool.sessions.remove(udid) > 0) {
+        qDebug() << "DeviceSession: 已从会话池移除" << udid;
+    }
+    // 没有进行中的握手时一并移除 openLock
+    auto it = pool.openLocks.find(udid);
+    if (it != pool.openLocks.end() && it.value().use_count() == 1) {
+        pool.openLocks.erase(it);
+    }
+}
+
+DeviceSession::DeviceSession(const QString &udid)
+    : m_udid(udid)
+    , m_device(nullptr)
+    , m_lockdown(nullptr)
+{
+}
+
+DeviceSession::~DeviceSession()
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+
+    if (m_lockdown && loader.lockdownd_client_free) {
+        loader.lockdownd_client_free(m_lockdown);
+        m_lockdown = nullptr;
+    }
+
+    if (m_device && loader.idevice_free) {
+        loader.idevice_free(m_device);
+        m_device = nullptr;
+    }
+
+    qDebug() << "DeviceSession: 已关闭设备会话" << m_udid;
+}
+
+bool DeviceSession::open(QString *errorMessage)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!loader.idevice_new || !loader.lockdownd_client_new_with_handshake) {
+        if (errorMessage) {
+            *errorMessage = "设备连接函数不可用";
+        }
+        return false;
+    }
+
+    if (loader.idevice_new(&m_device, m_udid.toUtf8().constData()) != IDEVICE_E_SUCCESS) {
+        m_device = nullptr;
+        if (errorMessage) {
+            *errorMessage = QString("无法连接到设备: %1").arg(m_udid);
+        }
+        return false;
+    }
+
+    lockdownd_error_t ret = loader.lockdownd_client_new_with_handshake(m_device, &m_lockdown, SESSION_LABEL);
+    if (ret != LOCKDOWN_E_SUCCESS) {
+        m_lockdown = nullptr;
+        if (errorMessage) {
+            *errorMessage = QString("无法建立 lockdown 连接，错误码: %1").arg(ret);
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool DeviceSession::reconnectLockdown()
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!m_device || !loader.lockdownd_client_new_with_handshake) {
+        return false;
+    }
+
+    if (m_lockdown && loader.lockdownd_client_free) {
+        loader.lockdownd_client_free(m_lockdown);
+    }
+    m_lockdown = nullptr;
+
+    lockdownd_error_t ret = loader.lockdownd_client_new_with_handshake(m_device, &m_lockdown, SESSION_LABEL);
+    if (ret != LOCKDOWN_E_SUCCESS) {
+        qWarning() << "DeviceSession: 重新建立 lockdown 会话失败，错误码:" << ret;
+        m_lockdown = nullptr;
+        return false;
+    }
+
+    qDebug() << "DeviceSession: lockdown 会话已重新建立" << m_udid;
+    return true;
+}
+
+plist_t DeviceSession::getValue(const char *domain, const char *key)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!loader.lockdownd_get_value) {
+        return nullptr;
+    }
+
+    QMutexLocker locker(&m_lockdownMutex);
+    if (!m_lockdown && !reconnectLockdown()) {
+        return nullptr;
+    }
+
+    plist_t value = nullptr;
+    lockdownd_error_t ret = loader.lockdownd_get_value(m_lockdown, domain, key, &value);
+    if (isSessionLost(ret) && reconnectLockdown()) {
+        value = nullptr;
+        ret = loader.lockdownd_get_value(m_lockdown, domain, key, &value);
+    }
+
+    if (ret != LOCKDOWN_E_SUCCESS) {
+        if (value && loader.plist_free) {
+            loader.plist_free(value);
+        }
+        return nullptr;
+    }
+    return value;
+}
+
+QVariant DeviceSession::getVariant(const char *domain, const char *key)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+
+    plist_t value = getValue(domain, key);
+    if (!value) {
+        return QVariant();
+    }
+
+    QVariant result = toVariant(value);
+    if (loader.plist_free) {
+        loader.plist_free(value);
+    }
+    return result;
+}
+
+QVariantMap DeviceSession::getDomain(const char *domain)
+{
+    return getVariant(domain, nullptr).toMap();
+}
+
+QVariant DeviceSession::toVariant(plist_t node)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!node || !loader.plist_get_node_type) {
+        return QVariant();
+    }
+
+    switch (loader.plist_get_node_type(node)) {
+    case PLIST_STRING: {
+        if (!loader.plist_get_string_ptr) {
+            return QVariant();
+        }
+        // 使用 plist_get_string_ptr 获取字符串指针，无需手动释放内存
+        uint64_t length = 0;
+        const char* str_ptr = loader.plist_get_string_ptr(node, &length);
+        return str_ptr ? QString::fromUtf8(str_ptr, static_cast<int>(length)) : QString();
+    }
+    case PLIST_BOOLEAN: {
+        uint8_t value = 0;
+        if (loader.plist_get_bool_val) {
+            loader.plist_get_bool_val(node, &value);
+        }
+        return value != 0;
+    }
+    case PLIST_UINT: {
+        uint64_t value = 0;
+        if (loader.plist_get_uint_val) {
+            loader.plist_get_uint_val(node, &value);
+        }
+        if (value > static_cast<uint64_t>(std::numeric_limits<qint64>::max())) {
+            return static_cast<quint64>(value);
+        }
+        return static_cast<qint64>(value);
+    }
+    case PLIST_DATA: {
+        if (!loader.plist_get_data_val) {
+            return QVariant();
+        }
+        char *data = nullptr;
+        uint64_t length = 0;
+        loader.plist_get_data_val(node, &data, &length);
+        QByteArray bytes(data, static_cast<int>(length));
+        // data 由 libplist 分配，只能通过库导出的 plist_mem_free 释放（跨 DLL 堆问题）
+        if (data && loader.plist_mem_free) {
+            loader.plist_mem_free(data);
+        }
+        return bytes;
+    }
+    case PLIST_ARRAY: {
+        QVariantList list;
+        if (loader.plist_array_get_size && loader.plist_array_get_item) {
+            uint32_t count = loader.plist_array_get_size(node);
+            list.reserve(static_cast<int>(count));
+            for (uint32_t i = 0; i < count; i++) {
+                list.append(toVariant(loader.plist_array_get_item(node, i)));
+            }
+        }
+        return list;
+    }
+    case PLIST_DICT: {
+        QVariantMap map;
+        if (!loader.plist_dict_new_iter || !loader.plist_dict_next_item) {
+            return map;
+        }
+        plist_dict_iter iter = nullptr;
+        loader.plist_dict_new_iter(node, &iter);
+        if (!iter) {
+            return map;
+        }
+        while (true) {
+            char *key = nullptr;
+            plist_t value = nullptr;
+            loader.plist_dict_next_item(node, iter, &key, &value);
+            if (!key) {
+                break;
+            }
+            map.insert(QString::fromUtf8(key), toVariant(value));
+            // key 由库分配，只能通过库导出的 plist_mem_free 释放；不可用时保持不释放（跨 DLL 堆问题）
+            if (loader.plist_mem_free) {
+                loader.plist_mem_free(key);
+            }
+        }
+        if (loader.plist_mem_free) {
+            loader.plist_mem_free(iter);
+        }
+        return map;
+    }
+    default:
+        return QVariant();
+    }
+}
+
+lockdownd_service_descriptor_t DeviceSession::startService(const char *serviceName, QString *errorMessage)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!loader.lockdownd_start_service) {
+        if (errorMessage) {
+            *errorMessage = "lockdown 服务函数不可用";
+        }
+        return nullptr;
+    }
+
+    QMutexLocker locker(&m_lockdownMutex);
+    if (!m_lockdown && !reconnectLockdown()) {
+        if (errorMessage) {
+            *errorMessage = "lockdown 会话不可用";
+        }
+        return nullptr;
+    }
+
+    lockdownd_service_descriptor_t service = nullptr;
+    lockdownd_error_t ret = loader.lockdownd_start_service(m_lockdown, serviceName, &service);
+    if (isSessionLost(ret) && reconnectLockdown()) {
+        service = nullptr;
+        ret = loader.lockdownd_start_service(m_lockdown, serviceName, &service);
+    }
+
+    if (ret != LOCKDOWN_E_SUCCESS || !service) {
+        if (errorMessage) {
+            *errorMessage = QString("无法启动 %1 服务，错误码: %2").arg(serviceName).arg(ret);
+        }
+        return nullptr;
+    }
+    return service;
+}
+
+afc_client_t DeviceSession::createAfcClient(QString *errorMessage)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!loader.afc_client_new) {
+        if (errorMessage) {
+            *errorMessage = "AFC 服务函数不可用";
+        }
+        return nullptr;
+    }
+
+    lockdownd_service_descriptor_t service = startService(AFC_SERVICE_NAME, errorMessage);
+    if (!service) {
+        return nullptr;
+    }
+
+    afc_client_t client = nullptr;
+    afc_error_t ret = loader.afc_client_new(m_device, service, &client);
+
+    if (loader.lockdownd_service_descriptor_free) {
+        loader.lockdownd_service_descriptor_free(service);
+    }
+
+    if (ret != AFC_E_SUCCESS || !client) {
+        if (errorMessage) {
+            *errorMessage = QString("无法创建 AFC 客户端，错误码: %1").arg(ret);
+        }
+        return nullptr;
+    }
+    return client;
+}
+
+instproxy_client_t DeviceSession::createInstproxyClient(QString *errorMessage)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!loader.instproxy_client_new) {
+        if (errorMessage) {
+            *errorMessage = "installation_proxy 服务函数不可用";
+        }
+        return nullptr;
+    }
+
+    lockdownd_service_descriptor_t service = startService(INSTPROXY_SERVICE_NAME, errorMessage);
+    if (!service) {
+        return nullptr;
+    }
+
+    instproxy_client_t client = nullptr;
+    instproxy_error_t ret = loader.instproxy_client_new(m_device, service, &client);
+
+    if (loader.lockdownd_service_descriptor_free) {
+        loader.lockdownd_service_descriptor_free(service);
+    }
+
+    if (ret != INSTPROXY_E_SUCCESS || !client) {
+        if (errorMessage) {
+            *errorMessage = QString("无法创建 installation_proxy 客户端，错误码: %1").arg(ret);
+        }
+        return nullptr;
+    }
+    return client;
+}
+
+mobilesync_client_t DeviceSession::createMobilesyncClient(QString *errorMessage)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!loader.mobilesync_client_new) {
+        if (errorMessage) {
+            *errorMessage = "mobilesync 服务函数不可用";
+        }
+        return nullptr;
+    }
+
+    lockdownd_service_descriptor_t service = startService(MOBILESYNC_SERVICE_NAME, errorMessage);
+    if (!service) {
+        return nullptr;
+    }
+
+    mobilesync_client_t client = nullptr;
+    mobilesync_error_t ret = loader.mobilesync_client_new(m_device, service, &client);
+
+    if (loader.lockdownd_service_descriptor_free) {
+        loader.lockdownd_service_descriptor_free(service);
+    }
+
+    if (ret != MOBILESYNC_E_SUCCESS || !client) {
+        if (errorMessage) {
+            *errorMessage = QString("无法创建 mobilesync 客户端，错误码: %1").arg(ret);
+        }
+        return nullptr;
+    }
+    return client;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file devicesession.h
+ * @brief 设备会话池头文件
+ *
+ * 每个 UDID 只保留一个 idevice_t 和一个完成握手的 lockdown 会话，
+ * 各业务管理器（照片、文件、应用、通讯录、设备信息）从同一会话中获取服务客户端，
+ * 避免每个管理器各自执行 idevice_new + lockdownd_client_new_with_handshake
+ * 带来的重复 TLS 握手和配对校验开销。
+ */
+
+#ifndef DEVICESESSION_H
+#define DEVICESESSION_H
+
+#include <QString>
+#include <QVariant>
+#include <QVariantMap>
+#include <QMutex>
+#include <memory>
+
+#include <libimobiledevice/libimobiledevice.h>
+#include <libimobiledevice/lockdown.h>
+#include <libimobiledevice/afc.h>
+#include <libimobiledevice/installation_proxy.h>
+#include <libimobiledevice/mobilesync.h>
+
+/**
+ * @brief 引用计数的设备会话
+ *
+ * 通过 acquire() 获取，同一 UDID 的并发获取返回同一个会话；
+ * 最后一个持有者释放 shared_ptr 时关闭 lockdown 会话并释放设备句柄。
+ *
+ * 服务客户端（AFC、instproxy、mobilesync）由调用方负责释放，
+ * 调用方在客户端存活期间应一直持有会话。
+ *
+ * lockdown 客户端不是线程安全的，会话内部对 lockdown 调用加锁串行化；
+ * 服务客户端各自使用独立连接，可在不同线程中使用。
+ *
+ * 使用方法：
+ * @code
+ * DeviceSession::Ptr session = DeviceSession::acquire(udid);
+ * if (session) {
+ *     afc_client_t afc = session->createAfcClient();
+ *     // ...
+ *     lib.afc_client_free(afc);
+ * }
+ * @endcode
+ */
+class DeviceSession
+{
+public:
+    using Ptr = std::shared_ptr<DeviceSession>;
+
+    /**
+     * @brief 获取指定设备的会话（不存在时创建并握手）
+     * @param udid 设备 UDID
+     * @param errorMessage 失败时的错误信息（可为空）
+     * @return 会话指针，失败返回 nullptr
+     */
+    static Ptr acquire(const QString &udid, QString *errorMessage = nullptr);
+
+    /**
+     * @brief 将设备会话从池中移除（设备拔出时调用）
+     *
+     * 已持有的会话不受影响，之后的 acquire() 会重新建立连接。
+     */
+    static void invalidate(const QString &udid);
+
+    ~DeviceSession();
+
+    DeviceSession(const DeviceSession &) = delete;
+    DeviceSession &operator=(const DeviceSession &) = delete;
+
+    QString udid() const { return m_udid; }
+    idevice_t device() const { return m_device; }
+
+    /**
+     * @brief 读取 lockdown 属性
+     * @param domain 域名，nullptr 表示全局域
+     * @param key 键名，nullptr 表示整个域
+     * @return plist 节点，调用方负责 plist_free；失败返回 nullptr
+     */
+    plist_t getValue(const char *domain, const char *key);
+
+    /**
+     * @brief 读取单个 lockdown 属性并转换为 QVariant
+     * @return 属性值，失败返回无效 QVariant
+     */
+    QVariant getVariant(const char *domain, const char *key);
+
+    /**
+     * @brief 一次往返读取整个 lockdown 域
+     * @param domain 域名，nullptr 表示全局域
+     * @return 域内全部键值，失败返回空 map
+     */
+    QVariantMap getDomain(const char *domain);
+
+    /**
+     * @brief 将 plist 节点转换为 QVariant
+     *
+     * 字典转换为 QVariantMap，数组转换为 QVariantList，DATA 转换为 QByteArray，
+     * 整数转换为 qint64（超出范围时为 quint64），REAL/DATE 等未加载读取函数的类型返回无效值。
+     */
+    static QVariant toVariant(plist_t node);
+
+    /**
+     * @brief 创建 AFC 客户端（调用方负责 afc_client_free）
+     */
+    afc_client_t createAfcClient(QString *errorMessage = nullptr);
+
+    /**
+     * @brief 创建 installation_proxy 客户端（调用方负责 instproxy_client_free）
+     */
+    instproxy_client_t createInstproxyClient(QString *errorMessage = nullptr);
+
+    /**
+     * @brief 创建 mobilesync 客户端（调用方负责 mobilesync_client_free）
+     */
+    mobilesync_client_t createMobilesyncClient(QString *errorMessage = nullptr);
+
+private:
+    explicit DeviceSession(const QString &udid);
+
+    /**
+     * @brief 建立设备连接和 lockdown 会话
+     */
+    bool open(QString *errorMessage);
+
+    /**
+     * @brief 重新建立 lockdown 会话（会话超时或连接中断后调用，需持有 m_lockdownMutex）
+     */
+    bool reconnectLockdown();
+
+    /**
+     * @brief 启动服务并返回服务描述符（调用方负责释放）
+     */
+    lockdownd_service_descriptor_t startService(const char *serviceName, QString *errorMessage);
+
+    QString m_udid;                 ///< 设备 UDID
+    idevice_t m_device;             ///< 设备句柄
+    lockdownd_client_t m_lockdown;  ///< 已握手的 lockdown 客户端
+    QMutex m_lockdownMutex;         ///< 串行化 lockdown 调用
+};
+
+#endif // DEVICESESSION_H
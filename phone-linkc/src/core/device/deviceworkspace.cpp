@@ -0,0 +1,151 @@
+/**
+ * @file deviceworkspace.cpp
+ * @brief 单台设备的工作区实现
+ */
+
+#include "deviceworkspace.h"
+#include "deviceinfo.h"
+#include "core/photo/photomanager.h"
+#include "core/file/filemanager.h"
+#include "core/app/appmanager.h"
+#include "core/contact/contactmanager.h"
+#include <QDebug>
+#include <QThread>
+
+DeviceWorkspace::DeviceWorkspace(const QString &udid, QObject *parent)
+    : QObject(parent)
+    , m_udid(udid)
+    , m_thread(new QThread())
+    , m_context(new QObject())
+    , m_closing(false)
+    , m_photoManager(nullptr)
+    , m_fileManager(nullptr)
+    , m_appManager(nullptr)
+    , m_contactManager(nullptr)
+    , m_deviceInfoManager(nullptr)
+{
+    m_thread->setObjectName(QString("Device-%1").arg(udid.right(8)));
+    m_context->moveToThread(m_thread);
+    m_thread->start();
+    qDebug() << "DeviceWorkspace: 已创建设备工作区" << udid;
+}
+
+DeviceWorkspace::~DeviceWorkspace()
+{
+    // 经 closeLater() 关闭时线程已结束，这里立即返回；
+    // 直接销毁时（如程序退出，事件循环已停止）在此等待工作线程完成关闭
+    shutdown();
+    m_thread->wait();
+    delete m_context;
+    delete m_thread;
+    qDebug() << "DeviceWorkspace: 已关闭设备工作区" << m_udid;
+}
+
+void DeviceWorkspace::closeLater()
+{
+    if (m_closing.load()) {
+        return;
+    }
+    // finished 在工作线程中发出，排队到本对象所在线程删除
+    connect(m_thread, &QThread::finished, this, &QObject::deleteLater);
+    shutdown();
+}
+
+void DeviceWorkspace::shutdown()
+{
+    if (m_closing.exchange(true)) {
+        return;
+    }
+    // 管理器属于工作线程，必须在该线程中断开连接并销毁；正在执行的任务先执行完，
+    // 排队中的任务看到 m_closing 后直接取消
+    QMetaObject::invokeMethod(m_context, [this]() {
+        destroyManagers();
+        m_thread->quit();
+    }, Qt::QueuedConnection);
+}
+
+void DeviceWorkspace::destroyManagers()
+{
+    // deleteLater 的对象在线程退出时（finished 之后）统一销毁
+    if (m_photoManager) {
+        m_photoManager->disconnect();
+        m_photoManager->deleteLater();
+        m_photoManager = nullptr;
+    }
+    if (m_fileManager) {
+        m_fileManager->disconnectFromDevice();
+        m_fileManager->deleteLater();
+        m_fileManager = nullptr;
+    }
+    if (m_appManager) {
+        m_appManager->disconnectFromDevice();
+        m_appManager->deleteLater();
+        m_appManager = nullptr;
+    }
+    if (m_contactManager) {
+        m_contactManager->disconnectFromDevice();
+        m_contactManager->deleteLater();
+        m_contactManager = nullptr;
+    }
+    if (m_deviceInfoManager) {
+        m_deviceInfoManager->deleteLater();
+        m_deviceInfoManager = nullptr;
+    }
+}
+
+PhotoManager *DeviceWorkspace::photoManager()
+{
+    Q_ASSERT(QThread::currentThread() == m_thread);
+    if (!m_photoManager) {
+        m_photoManager = new PhotoManager();
+    }
+    if (!m_photoManager->isConnected()) {
+        m_photoManager->connectToDevice(m_udid);
+    }
+    return m_photoManager;
+}
+
+FileManager *DeviceWorkspace::fileManager()
+{
+    Q_ASSERT(QThread::currentThread() == m_thread);
+    if (!m_fileManager) {
+        m_fileManager = new FileManager();
+    }
+    if (!m_fileManager->isConnected()) {
+        m_fileManager->connectToDevice(m_udid);
+    }
+    return m_fileManager;
+}
+
+AppManager *DeviceWorkspace::appManager()
+{
+    Q_ASSERT(QThread::currentThread() == m_thread);
+    if (!m_appManager) {
+        m_appManager = new AppManager();
+    }
+    if (!m_appManager->isConnected()) {
+        m_appManager->connectToDevice(m_udid);
+    }
+    return m_appManager;
+}
+
+ContactManager *DeviceWorkspace::contactManager()
+{
+    Q_ASSERT(QThread::currentThread() == m_thread);
+    if (!m_contactManager) {
+        m_contactManager = new ContactManager();
+    }
+    if (!m_contactManager->isConnected()) {
+        m_contactManager->connectToDevice(m_udid);
+    }
+    return m_contactManager;
+}
+
+DeviceInfoManager *DeviceWorkspace::deviceInfoManager()
+{
+    Q_ASSERT(QThread::currentThread() == m_thread);
+    if (!m_deviceInfoManager) {
+        m_deviceInfoManager = new DeviceInfoManager();
+    }
+    return m_deviceInfoManager;
+}
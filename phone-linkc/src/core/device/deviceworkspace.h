@@ -0,0 +1,130 @@
+/**
+ * @file deviceworkspace.h
+ * @brief 单台设备的工作区头文件
+ *
+ * 每台设备拥有一个独立的工作线程和一套业务管理器（照片、文件、应用、通讯录、设备信息），
+ * 不同设备的任务在各自线程中同时执行，互不阻塞。
+ */
+
+#ifndef DEVICEWORKSPACE_H
+#define DEVICEWORKSPACE_H
+
+#include <QObject>
+#include <QString>
+#include <QFuture>
+#include <QPromise>
+#include <QMetaObject>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+
+class QThread;
+class PhotoManager;
+class FileManager;
+class AppManager;
+class ContactManager;
+class DeviceInfoManager;
+
+/**
+ * @brief 单台设备的工作区
+ *
+ * 管理器在工作区的线程中创建、使用和销毁，只能在 run() 投递的任务中访问。
+ * 各管理器在首次访问时连接设备，连接共享同一个 DeviceSession。
+ * 设备断开时用 closeLater() 异步关闭，调用线程不等待工作线程中的任务和断开连接。
+ *
+ * 使用方法：
+ * @code
+ * DeviceWorkspace workspace(udid);
+ * QFuture<int> count = workspace.run([](DeviceWorkspace &ws) {
+ *     return ws.photoManager()->getAllPhotos().size();
+ * });
+ * @endcode
+ */
+class DeviceWorkspace : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DeviceWorkspace(const QString &udid, QObject *parent = nullptr);
+    ~DeviceWorkspace();
+
+    QString udid() const { return m_udid; }
+
+    /**
+     * @brief 在工作区线程中执行任务
+     *
+     * 任务按投递顺序串行执行；取消尚未开始的 QFuture 会跳过该任务。
+     * 工作区开始关闭后，尚未开始的任务和之后投递的任务都会被取消。
+     * @param func 形如 T(DeviceWorkspace &) 的可调用对象
+     * @return 任务结果
+     */
+    template<typename Func>
+    auto run(Func func) -> QFuture<std::invoke_result_t<Func &, DeviceWorkspace &>>
+    {
+        using Result = std::invoke_result_t<Func &, DeviceWorkspace &>;
+        auto promise = std::make_shared<QPromise<Result>>();
+        QFuture<Result> future = promise->future();
+        promise->start();
+
+        if (m_closing.load()) {
+            future.cancel();
+            promise->finish();
+            return future;
+        }
+
+        QMetaObject::invokeMethod(m_context, [this, promise, func]() mutable {
+            if (m_closing.load()) {
+                promise->future().cancel();
+            } else if (!promise->isCanceled()) {
+                if constexpr (std::is_void_v<Result>) {
+                    func(*this);
+                } else {
+                    promise->addResult(func(*this));
+                }
+            }
+            promise->finish();
+        }, Qt::QueuedConnection);
+
+        return future;
+    }
+
+    /**
+     * @brief 异步关闭工作区
+     *
+     * 取消尚未开始的任务，在工作线程中断开并销毁管理器，随后工作线程退出，
+     * 线程结束后工作区删除自身。调用后不得再使用该对象。
+     */
+    void closeLater();
+
+    // ===== 管理器访问（仅限 run() 中调用，首次访问时连接设备） =====
+    PhotoManager *photoManager();
+    FileManager *fileManager();
+    AppManager *appManager();
+    ContactManager *contactManager();
+    DeviceInfoManager *deviceInfoManager();
+
+private:
+    /**
+     * @brief 向工作线程投递关闭任务：销毁管理器后退出线程（只投递一次）
+     */
+    void shutdown();
+
+    /**
+     * @brief 在工作线程中断开所有管理器并延迟销毁
+     */
+    void destroyManagers();
+
+    QString m_udid;                         ///< 设备 UDID
+    QThread *m_thread;                      ///< 工作线程
+    QObject *m_context;                     ///< 工作线程中的任务接收对象
+    std::atomic<bool> m_closing;            ///< 是否已开始关闭
+
+    // 以下管理器属于 m_thread，按需创建
+    PhotoManager *m_photoManager;
+    FileManager *m_fileManager;
+    AppManager *m_appManager;
+    ContactManager *m_contactManager;
+    DeviceInfoManager *m_deviceInfoManager;
+};
+
+#endif // DEVICEWORKSPACE_H
@@ -0,0 +1,149 @@
+/**
+ * @file hotplugprocessor.cpp
+ * @brief 设备热插拔事件处理实现
+ */
+
+#include "hotplugprocessor.h"
+#include "devicemetadatacache.h"
+#include <QDebug>
+#include <QDateTime>
+#include <QMetaObject>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrent>
+#include <limits>
+
+// 去抖时间（毫秒）：ADD 与 PAIRED 之间、Hub 复位的事件风暴通常在此时间内结束
+static const int DEBOUNCE_MS = 300;
+
+// 名称解析线程数
+static const int RESOLVE_THREADS = 4;
+
+HotplugProcessor::HotplugProcessor(QObject *parent)
+    : QObject(parent)
+    , m_flushTimer(new QTimer(this))
+{
+    m_resolvePool.setMaxThreadCount(RESOLVE_THREADS);
+
+    m_flushTimer->setSingleShot(true);
+    connect(m_flushTimer, &QTimer::timeout, this, &HotplugProcessor::flushDue);
+}
+
+HotplugProcessor::~HotplugProcessor()
+{
+    m_resolvePool.waitForDone();
+}
+
+void HotplugProcessor::postEvent(const QString &udid, idevice_event_type event)
+{
+    // 回调线程只负责投递，合并和解析都在处理线程进行
+    QMetaObject::invokeMethod(this, [this, udid, event]() {
+        handleEvent(udid, event);
+    }, Qt::QueuedConnection);
+}
+
+void HotplugProcessor::handleEvent(const QString &udid, idevice_event_type event)
+{
+    PendingDevice &pending = m_pending[udid];
+    switch (event) {
+    case IDEVICE_DEVICE_ADD:
+        pending.present = true;
+        break;
+    case IDEVICE_DEVICE_PAIRED:
+        pending.present = true;
+        pending.paired = true;
+        break;
+    case IDEVICE_DEVICE_REMOVE:
+        pending.present = false;
+        pending.removed = true;
+        break;
+    default:
+        return;
+    }
+    pending.eventCount++;
+    pending.deadline = QDateTime::currentMSecsSinceEpoch() + DEBOUNCE_MS;
+
+    scheduleFlush();
+}
+
+void HotplugProcessor::scheduleFlush()
+{
+    if (m_pending.isEmpty()) {
+        m_flushTimer->stop();
+        return;
+    }
+
+    // 定时器对准最早到期的设备
+    qint64 nearest = std::numeric_limits<qint64>::max();
+    for (const PendingDevice &pending : m_pending) {
+        nearest = qMin(nearest, pending.deadline);
+    }
+    qint64 delay = qMax<qint64>(0, nearest - QDateTime::currentMSecsSinceEpoch());
+    m_flushTimer->start(static_cast<int>(delay));
+}
+
+void HotplugProcessor::flushDue()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (it->deadline > now) {
+            ++it;
+            continue;
+        }
+
+        const QString udid = it.key();
+        const PendingDevice pending = it.value();
+        it = m_pending.erase(it);
+
+        quint64 generation = ++m_generations[udid];
+        if (pending.eventCount > 1) {
+            qDebug() << "热插拔: 合并" << pending.eventCount << "个事件" << udid
+                     << "最终状态:" << (pending.present ? "连接" : "断开")
+                     << (pending.removed && pending.present ? "（期间断开过，需要重新连接）" : "");
+        }
+
+        // Hub 复位等 REMOVE 后又 ADD 的情况：旧会话已失效，先报告断开，再按新设备报告出现
+        if (pending.removed) {
+            emit deviceRemoved(udid);
+        }
+        if (pending.present) {
+            resolveArrival(udid, pending.paired, generation);
+        }
+    }
+
+    scheduleFlush();
+}
+
+void HotplugProcessor::resolveArrival(const QString &udid, bool paired, quint64 generation)
+{
+    QtConcurrent::run(&m_resolvePool, [this, udid, paired, generation]() {
+        QString name = resolveName(udid, paired);
+
+        QMetaObject::invokeMethod(this, [this, udid, name, generation]() {
+            // 解析期间该设备又有新事件，以之后的结算结果为准
+            if (m_generations.value(udid) != generation || m_pending.contains(udid)) {
+                return;
+            }
+            emit deviceArrived(udid, name);
+        }, Qt::QueuedConnection);
+    });
+}
+
+QString HotplugProcessor::resolveName(const QString &udid, bool paired)
+{
+    DeviceMetadataCache &cache = DeviceMetadataCache::instance();
+
+    // 有缓存时直接使用，过期（或刚配对）的条目在后台刷新
+    DeviceMetadata metadata = cache.lookup(udid);
+    if (!metadata.name.isEmpty()) {
+        cache.refresh(QStringList{udid}, paired);
+        return metadata.name;
+    }
+
+    // 首次见到的设备同步读取一次
+    metadata = cache.fetch(udid);
+    if (!metadata.name.isEmpty()) {
+        return metadata.name;
+    }
+    return "iOS Device";
+}
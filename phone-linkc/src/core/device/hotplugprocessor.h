@@ -0,0 +1,85 @@
+/**
+ * @file hotplugprocessor.h
+ * @brief 设备热插拔事件处理头文件
+ *
+ * libimobiledevice 的事件回调在其内部线程触发，一台设备插入时通常先后产生
+ * ADD 和 PAIRED，USB Hub 复位时还会对每个端口产生一连串 REMOVE/ADD。
+ * HotplugProcessor 运行在独立线程中，按 UDID 对事件去抖合并，在后台解析设备名称，
+ * 只把最终的“出现/消失”结果交给 DeviceManager。窗口内出现过 REMOVE 的设备即使最终在线，
+ * 也先报告消失再报告出现：REMOVE 时会话已被作废，持有旧连接的一方需要重新连接。
+ */
+
+#ifndef HOTPLUGPROCESSOR_H
+#define HOTPLUGPROCESSOR_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QThreadPool>
+
+#include <libimobiledevice/libimobiledevice.h>
+
+class QTimer;
+
+/**
+ * @brief 热插拔事件处理器
+ *
+ * 通过 moveToThread 放到独立线程后使用。postEvent() 可在任意线程调用；
+ * 同一 UDID 在 DEBOUNCE_MS 内没有新事件时才结算最终状态。
+ * 设备出现时在线程池中解析名称（优先使用元数据缓存），解析期间若又有新事件则丢弃本次结果。
+ */
+class HotplugProcessor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HotplugProcessor(QObject *parent = nullptr);
+    ~HotplugProcessor();
+
+    /**
+     * @brief 投递一个设备事件（线程安全）
+     * @param udid 设备 UDID
+     * @param event IDEVICE_DEVICE_ADD / IDEVICE_DEVICE_REMOVE / IDEVICE_DEVICE_PAIRED
+     */
+    void postEvent(const QString &udid, idevice_event_type event);
+
+signals:
+    /**
+     * @brief 设备最终处于连接状态，名称已解析
+     */
+    void deviceArrived(const QString &udid, const QString &name);
+
+    /**
+     * @brief 设备最终处于断开状态，或在去抖窗口内断开过（之后可能紧跟 deviceArrived）
+     */
+    void deviceRemoved(const QString &udid);
+
+private:
+    /**
+     * @brief 一个 UDID 尚未结算的事件
+     */
+    struct PendingDevice {
+        bool present = false;   ///< 最后一个事件之后设备是否在线
+        bool paired = false;    ///< 期间是否收到 PAIRED（需要重新读取元数据）
+        bool removed = false;   ///< 期间是否收到 REMOVE（会话已作废，需要重新连接）
+        int eventCount = 0;     ///< 合并的事件数
+        qint64 deadline = 0;    ///< 结算时间（毫秒时间戳）
+    };
+
+    void handleEvent(const QString &udid, idevice_event_type event);
+    void flushDue();
+    void scheduleFlush();
+    void resolveArrival(const QString &udid, bool paired, quint64 generation);
+
+    /**
+     * @brief 解析设备名称（在线程池中执行）
+     */
+    static QString resolveName(const QString &udid, bool paired);
+
+    QHash<QString, PendingDevice> m_pending;    ///< UDID -> 未结算事件
+    QHash<QString, quint64> m_generations;      ///< UDID -> 结算代数，用于丢弃过期的解析结果
+    QTimer *m_flushTimer;                       ///< 去抖定时器
+    QThreadPool m_resolvePool;                  ///< 名称解析线程池（最后声明，析构时先等待任务结束）
+};
+
+#endif // HOTPLUGPROCESSOR_H
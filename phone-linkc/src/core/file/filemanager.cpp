@@ -4,6 +4,7 @@
  */
 
 #include "filemanager.h"
+#include "core/device/devicesession.h"
 #include "platform/libimobiledevice_dynamic.h"
 #include <QDebug>
 #include <QFileInfo>
@@ -11,21 +12,19 @@
 FileManager::FileManager(QObject *parent)
     : QObject(parent)
     , m_connected(false)
-    , m_device(nullptr)
-    , m_lockdown(nullptr)
     , m_afcClient(nullptr)
 {
 }
 
 FileManager::~FileManager()
 {
-    disconnect();
+    disconnectFromDevice();
 }
 
 bool FileManager::connectToDevice(const QString &udid)
 {
     if (m_connected) {
-        disconnect();
+        disconnectFromDevice();
     }
     
     LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
@@ -37,25 +36,12 @@ bool FileManager::connectToDevice(const QString &udid)
     
     m_udid = udid;
     
-    // 创建设备连接
-    idevice_t device = nullptr;
-    if (!loader.idevice_new || loader.idevice_new(&device, udid.toUtf8().constData()) != IDEVICE_E_SUCCESS) {
-        m_lastError = QString("无法连接到设备: %1").arg(udid);
+    // 获取共享的设备会话（同一设备的其他管理器已连接时无需再次握手）
+    m_session = DeviceSession::acquire(udid, &m_lastError);
+    if (!m_session) {
         emit errorOccurred(m_lastError);
         return false;
     }
-    m_device = device;
-    
-    // 创建 lockdown 客户端
-    lockdownd_client_t lockdown = nullptr;
-    if (!loader.lockdownd_client_new_with_handshake || 
-        loader.lockdownd_client_new_with_handshake(device, &lockdown, "phone-linkc-file") != LOCKDOWN_E_SUCCESS) {
-        m_lastError = "无法创建 lockdown 客户端";
-        emit errorOccurred(m_lastError);
-        cleanup();
-        return false;
-    }
-    m_lockdown = lockdown;
     
     // 初始化 AFC 客户端
     if (!initAfcClient()) {
@@ -77,37 +63,8 @@ void FileManager::disconnectFromDevice()
 
 bool FileManager::initAfcClient()
 {
-    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
-    
-    if (!loader.lockdownd_start_service || !loader.afc_client_new) {
-        m_lastError = "AFC 服务函数不可用";
-        emit errorOccurred(m_lastError);
-        return false;
-    }
-    
-    lockdownd_client_t lockdown = static_cast<lockdownd_client_t>(m_lockdown);
-    idevice_t device = static_cast<idevice_t>(m_device);
-    
-    // 启动 AFC 服务
-    lockdownd_service_descriptor_t service = nullptr;
-    lockdownd_error_t lockdown_ret = loader.lockdownd_start_service(lockdown, AFC_SERVICE_NAME, &service);
-    if (lockdown_ret != LOCKDOWN_E_SUCCESS || !service) {
-        m_lastError = QString("无法启动 AFC 服务，错误码: %1").arg(lockdown_ret);
-        emit errorOccurred(m_lastError);
-        return false;
-    }
-    
-    // 创建 AFC 客户端
-    afc_client_t afcClient = nullptr;
-    afc_error_t afc_ret = loader.afc_client_new(device, service, &afcClient);
-    
-    // 释放服务描述符
-    if (loader.lockdownd_service_descriptor_free && service) {
-        loader.lockdownd_service_descriptor_free(service);
-    }
-    
-    if (afc_ret != AFC_E_SUCCESS || !afcClient) {
-        m_lastError = QString("无法创建 AFC 客户端，错误码: %1").arg(afc_ret);
+    afc_client_t afcClient = m_session->createAfcClient(&m_lastError);
+    if (!afcClient) {
         emit errorOccurred(m_lastError);
         return false;
     }
@@ -126,15 +83,8 @@ void FileManager::cleanup()
         m_afcClient = nullptr;
     }
     
-    if (m_lockdown && loader.lockdownd_client_free) {
-        loader.lockdownd_client_free(static_cast<lockdownd_client_t>(m_lockdown));
-        m_lockdown = nullptr;
-    }
-    
-    if (m_device && loader.idevice_free) {
-        loader.idevice_free(static_cast<idevice_t>(m_device));
-        m_device = nullptr;
-    }
+    // 释放会话引用，最后一个持有者释放时关闭连接
+    m_session.reset();
 }
 
 QVector<FileNode> FileManager::listDirectory(const QString &path)
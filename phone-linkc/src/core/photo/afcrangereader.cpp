@@ -0,0 +1,114 @@
+/**
+ * @file afcrangereader.cpp
+ * @brief AFC 文件范围读取实现
+ */
+
+#include "afcrangereader.h"
+#include "photoscanner.h"
+#include "platform/libimobiledevice_dynamic.h"
+#include <cstdio>
+
+// 不支持 afc_file_seek 时，允许用顺序读取跳过的最大字节数
+static const qint64 MAX_SKIP_BYTES = 256 * 1024;
+
+// 单次 afc_file_read 的最大长度
+static const qint64 MAX_READ_SIZE = 1024 * 1024;
+
+AfcRangeReader::AfcRangeReader(void *afcClient, const QString &path, qint64 fileSize)
+    : m_client(afcClient)
+    , m_handle(0)
+    , m_open(false)
+    , m_fileSize(fileSize)
+    , m_position(0)
+    , m_bytesRead(0)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!afcClient || !loader.afc_file_open || !loader.afc_file_read || !loader.afc_file_close) {
+        return;
+    }
+
+    if (m_fileSize <= 0) {
+        m_fileSize = PhotoScanner::statFile(afcClient, path).size;
+        if (m_fileSize <= 0) {
+            return;
+        }
+    }
+
+    m_open = loader.afc_file_open(static_cast<afc_client_t>(afcClient), path.toUtf8().constData(),
+                                  AFC_FOPEN_RDONLY, &m_handle) == AFC_E_SUCCESS;
+}
+
+AfcRangeReader::~AfcRangeReader()
+{
+    if (m_open) {
+        LibimobiledeviceDynamic::instance().afc_file_close(static_cast<afc_client_t>(m_client), m_handle);
+    }
+}
+
+bool AfcRangeReader::read(qint64 offset, qint64 length, QByteArray &out)
+{
+    if (!m_open || offset < 0 || length < 0 || offset + length > m_fileSize) {
+        return false;
+    }
+
+    // 头部范围内按块追加读取并缓存，相邻的小范围读取不再产生设备往返
+    const qint64 end = offset + length;
+    if (end > m_head.size() && end <= HEAD_LIMIT) {
+        const qint64 target = qMin(m_fileSize, qMax(end, static_cast<qint64>(m_head.size()) + HEAD_CHUNK));
+        QByteArray chunk;
+        if (!readAt(m_head.size(), target - m_head.size(), chunk)) {
+            return false;
+        }
+        m_head.append(chunk);
+    }
+
+    if (end <= m_head.size()) {
+        out = m_head.mid(offset, length);
+        return true;
+    }
+    return readAt(offset, length, out);
+}
+
+bool AfcRangeReader::readAt(qint64 offset, qint64 length, QByteArray &out)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+
+    if (offset != m_position) {
+        if (loader.afc_file_seek) {
+            if (loader.afc_file_seek(static_cast<afc_client_t>(m_client), m_handle, offset, SEEK_SET) != AFC_E_SUCCESS) {
+                return false;
+            }
+            m_position = offset;
+        } else if (offset > m_position && offset - m_position <= MAX_SKIP_BYTES) {
+            QByteArray skipped;
+            if (!readSequential(offset - m_position, skipped)) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    return readSequential(length, out);
+}
+
+bool AfcRangeReader::readSequential(qint64 length, QByteArray &out)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+
+    out.resize(length);
+    qint64 total = 0;
+    while (total < length) {
+        uint32_t bytesRead = 0;
+        const uint32_t toRead = static_cast<uint32_t>(qMin(length - total, MAX_READ_SIZE));
+        afc_error_t ret = loader.afc_file_read(static_cast<afc_client_t>(m_client), m_handle,
+                                               out.data() + total, toRead, &bytesRead);
+        if (ret != AFC_E_SUCCESS || bytesRead == 0) {
+            break;
+        }
+        total += bytesRead;
+    }
+    m_position += total;
+    m_bytesRead += total;
+    out.resize(total);
+    return total == length;
+}
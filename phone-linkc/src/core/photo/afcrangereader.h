@@ -0,0 +1,96 @@
+/**
+ * @file afcrangereader.h
+ * @brief AFC 文件范围读取头文件
+ *
+ * 解析文件头部结构（EXIF、HEIF 等）时只需要文件中的若干小范围。
+ * AfcRangeReader 缓存文件开头的一段数据，头部以外的范围通过 afc_file_seek 定位后读取，
+ * 避免为了几十 KB 的元数据传输整个文件。
+ */
+
+#ifndef AFCRANGEREADER_H
+#define AFCRANGEREADER_H
+
+#include <QString>
+#include <QByteArray>
+#include <cstdint>
+
+/**
+ * @brief 设备文件的范围读取器
+ *
+ * 构造时打开文件，析构时关闭。不可在多个线程间共享。
+ *
+ * 使用方法：
+ * @code
+ * AfcRangeReader reader(afcClient, "/DCIM/100APPLE/IMG_0001.HEIC");
+ * QByteArray header;
+ * if (reader.isOpen() && reader.read(0, 32, header)) {
+ *     // ...
+ * }
+ * @endcode
+ */
+class AfcRangeReader
+{
+public:
+    /// 头部每次追加读取的大小
+    static const qint64 HEAD_CHUNK = 16 * 1024;
+
+    /// 头部缓存上限，此范围内的读取按块缓存
+    static const qint64 HEAD_LIMIT = 128 * 1024;
+
+    /**
+     * @brief 打开设备文件
+     * @param afcClient AFC 客户端（afc_client_t）
+     * @param path 设备上的文件路径
+     * @param fileSize 文件大小，未知时传 0（将先查询文件信息）
+     */
+    AfcRangeReader(void *afcClient, const QString &path, qint64 fileSize = 0);
+    ~AfcRangeReader();
+
+    AfcRangeReader(const AfcRangeReader &) = delete;
+    AfcRangeReader &operator=(const AfcRangeReader &) = delete;
+
+    /**
+     * @brief 文件是否已打开
+     */
+    bool isOpen() const { return m_open; }
+
+    /**
+     * @brief 文件大小
+     */
+    qint64 size() const { return m_fileSize; }
+
+    /**
+     * @brief 读取文件中的一段数据
+     * @param offset 起始偏移
+     * @param length 长度
+     * @param out 读取到的数据
+     * @return 是否完整读取（范围越界或设备读取失败时返回 false）
+     */
+    bool read(qint64 offset, qint64 length, QByteArray &out);
+
+    /**
+     * @brief 已从设备读取的字节数
+     */
+    qint64 bytesRead() const { return m_bytesRead; }
+
+private:
+    /**
+     * @brief 从设备读取指定范围（必要时先移动读取位置）
+     */
+    bool readAt(qint64 offset, qint64 length, QByteArray &out);
+
+    /**
+     * @brief 从当前位置顺序读取
+     */
+    bool readSequential(qint64 length, QByteArray &out);
+
+    void *m_client;             ///< AFC 客户端
+    uint64_t m_handle;          ///< 文件句柄
+    bool m_open;                ///< 文件是否已打开
+    qint64 m_fileSize;          ///< 文件大小
+    qint64 m_position;          ///< 设备端当前读取位置
+    qint64 m_bytesRead;         ///< 已读取的字节数
+    QByteArray m_head;          ///< 文件开头的缓存
+};
+
+#endif // AFCRANGEREADER_H
@@ -0,0 +1,120 @@
+/**
+ * @file devicethumbnail.cpp
+ * @brief 设备预生成缩略图读取实现
+ */
+
+#include "devicethumbnail.h"
+#include "photoscanner.h"
+#include "platform/libimobiledevice_dynamic.h"
+#include <QBuffer>
+#include <QDebug>
+#include <QImageReader>
+
+const char *const DeviceThumbnail::ROOT_PATH = "/PhotoData/Thumbnails/V2";
+
+// 缩略图文件大小上限，超出视为不是缩略图（一次读取即可取完整个文件）
+static const qint64 MAX_THUMBNAIL_SIZE = 512 * 1024;
+
+// 已知的缩略图文件名，按尺寸从小到大排列
+static const char *const THUMBNAIL_NAMES[] = { "5003.JPG", "5005.JPG" };
+
+namespace {
+
+/**
+ * @brief 读取整个小文件（超过上限时放弃）
+ * @return 文件内容，文件不存在或读取失败时为空
+ */
+QByteArray readSmallFile(afc_client_t client, const QString &path, qint64 &bytesRead)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    uint64_t handle = 0;
+    if (loader.afc_file_open(client, path.toUtf8().constData(), AFC_FOPEN_RDONLY, &handle) != AFC_E_SUCCESS) {
+        return QByteArray();
+    }
+
+    // 请求长度比上限多一字节：读满说明文件超出上限；读不满说明已到文件末尾，不必再往返一次
+    QByteArray data(static_cast<int>(MAX_THUMBNAIL_SIZE + 1), Qt::Uninitialized);
+    qint64 total = 0;
+    bool ok = true;
+    while (total < data.size()) {
+        uint32_t count = 0;
+        const uint32_t request = static_cast<uint32_t>(data.size() - total);
+        if (loader.afc_file_read(client, handle, data.data() + total, request, &count) != AFC_E_SUCCESS) {
+            ok = false;
+            break;
+        }
+        total += count;
+        if (count < request) {
+            break;
+        }
+    }
+    loader.afc_file_close(client, handle);
+    bytesRead += total;
+
+    if (!ok || total == 0 || total > MAX_THUMBNAIL_SIZE) {
+        return QByteArray();
+    }
+    data.truncate(static_cast<int>(total));
+    return data;
+}
+
+/**
+ * @brief 只解析 JPEG 头得到图像尺寸的最长边，无法识别时返回 0
+ */
+int longestSide(const QByteArray &data)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer, "jpeg");
+    const QSize size = reader.size();
+    return size.isValid() ? qMax(size.width(), size.height()) : 0;
+}
+
+} // namespace
+
+bool DeviceThumbnail::isAvailable(void *afcClient)
+{
+    return PhotoScanner::isDirectory(afcClient, QString::fromLatin1(ROOT_PATH));
+}
+
+QString DeviceThumbnail::thumbnailDirectory(const QString &path)
+{
+    if (!path.startsWith("/DCIM/")) {
+        return QString();
+    }
+    return QString::fromLatin1(ROOT_PATH) + path;
+}
+
+DeviceThumbnail::Result DeviceThumbnail::extract(void *afcClient, const QString &path, int minSize)
+{
+    Result result;
+
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!afcClient || !loader.afc_file_open || !loader.afc_file_read || !loader.afc_file_close) {
+        return result;
+    }
+    const QString directory = thumbnailDirectory(path);
+    if (directory.isEmpty()) {
+        return result;
+    }
+    afc_client_t client = static_cast<afc_client_t>(afcClient);
+
+    // 不列目录，直接按已知文件名打开：不存在时只多一次往返
+    int bestSide = 0;
+    for (const char *name : THUMBNAIL_NAMES) {
+        const QByteArray data = readSmallFile(client, directory + '/' + QLatin1String(name), result.bytesRead);
+        if (data.isEmpty()) {
+            continue;
+        }
+        const int side = longestSide(data);
+        if (side > bestSide) {
+            bestSide = side;
+            result.data = data;
+        }
+        if (side >= minSize) {
+            break;
+        }
+    }
+    return result;
+}
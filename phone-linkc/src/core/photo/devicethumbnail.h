@@ -0,0 +1,76 @@
+/**
+ * @file devicethumbnail.h
+ * @brief 设备预生成缩略图读取头文件
+ *
+ * iOS 为图库中的每个资源预先渲染好缩略图，存放在 /PhotoData/Thumbnails 下，
+ * 媒体 AFC 服务可以直接访问。iOS 8 起的 V2 布局按原文件路径组织：
+ * @code
+ * /PhotoData/Thumbnails/V2/DCIM/100APPLE/IMG_0001.JPG/5005.JPG
+ * @endcode
+ * 每个资源的缩略图只有十几 KB，读取一次即可得到已按方向渲染好的 JPEG，
+ * 不必传输原文件或解析其中的元数据。照片、HEIC 和视频都有对应的缩略图。
+ */
+
+#ifndef DEVICETHUMBNAIL_H
+#define DEVICETHUMBNAIL_H
+
+#include <QString>
+#include <QByteArray>
+
+/**
+ * @brief 设备缩略图读取器
+ *
+ * 缩略图由系统在后台生成，刚拍摄或刚同步的资源可能还没有，
+ * 早期系统的 .ithmb 合集格式也不支持，这些情况下调用方回退到读取原文件。
+ *
+ * 使用方法：
+ * @code
+ * if (DeviceThumbnail::isAvailable(afcClient)) {
+ *     DeviceThumbnail::Result result = DeviceThumbnail::extract(afcClient, "/DCIM/100APPLE/IMG_0001.JPG", 100);
+ *     if (!result.data.isEmpty()) {
+ *         QImage image = QImage::fromData(result.data);
+ *     }
+ * }
+ * @endcode
+ */
+class DeviceThumbnail
+{
+public:
+    /// V2 缩略图根目录，其下的目录结构与 /DCIM 相同
+    static const char *const ROOT_PATH;
+
+    /**
+     * @brief 读取结果
+     */
+    struct Result {
+        QByteArray data;        ///< 缩略图 JPEG 数据，为空表示设备上没有该资源的缩略图
+        qint64 bytesRead = 0;   ///< 本次从设备读取的字节数
+    };
+
+    /**
+     * @brief 设备上是否有 V2 布局的缩略图目录（一次 afc_get_file_info）
+     * @param afcClient AFC 客户端（afc_client_t）
+     */
+    static bool isAvailable(void *afcClient);
+
+    /**
+     * @brief 设备缩略图在设备上的目录（原文件路径映射到 V2 目录下）
+     * @param path 原文件路径，如 /DCIM/100APPLE/IMG_0001.JPG
+     * @return 缩略图目录，原文件不在 /DCIM 下时返回空字符串
+     */
+    static QString thumbnailDirectory(const QString &path);
+
+    /**
+     * @brief 读取原文件对应的设备缩略图
+     *
+     * 按尺寸从小到大尝试已知的缩略图文件名，取第一个最长边不小于 minSize 的文件；
+     * 都不够大时返回其中最大的一个。
+     * @param afcClient AFC 客户端（afc_client_t）
+     * @param path 原文件路径
+     * @param minSize 需要的最长边（像素）
+     * @return 读取结果，data 为空时调用方应回退到内嵌缩略图或原文件
+     */
+    static Result extract(void *afcClient, const QString &path, int minSize);
+};
+
+#endif // DEVICETHUMBNAIL_H
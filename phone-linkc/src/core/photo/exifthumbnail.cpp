@@ -0,0 +1,229 @@
+/**
+ * @file exifthumbnail.cpp
+ * @brief EXIF 内嵌缩略图提取实现
+ */
+
+#include "exifthumbnail.h"
+#include "afcrangereader.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <QStringList>
+#include <QTransform>
+
+// 内嵌缩略图大小上限，超出视为数据损坏
+static const qint64 MAX_THUMBNAIL_SIZE = 512 * 1024;
+
+// IFD 链最多遍历的 IFD 数和单个 IFD 的最大条目数，防止损坏的文件导致大量读取
+static const int MAX_IFDS = 4;
+static const int MAX_IFD_ENTRIES = 512;
+
+// TIFF 标签
+static const quint16 TAG_ORIENTATION = 0x0112;
+static const quint16 TAG_JPEG_OFFSET = 0x0201;
+static const quint16 TAG_JPEG_LENGTH = 0x0202;
+
+// TIFF 数据类型
+static const quint16 TYPE_SHORT = 3;
+static const quint16 TYPE_LONG = 4;
+
+namespace {
+
+quint16 readU16(const QByteArray &data, int offset, bool littleEndian)
+{
+    const uchar *p = reinterpret_cast<const uchar*>(data.constData()) + offset;
+    return littleEndian ? static_cast<quint16>(p[0] | (p[1] << 8))
+                        : static_cast<quint16>((p[0] << 8) | p[1]);
+}
+
+quint32 readU32(const QByteArray &data, int offset, bool littleEndian)
+{
+    const quint32 a = readU16(data, offset, littleEndian);
+    const quint32 b = readU16(data, offset + 2, littleEndian);
+    return littleEndian ? (a | (b << 16)) : ((a << 16) | b);
+}
+
+/**
+ * @brief 解析 TIFF 结构，沿 IFD 链查找 JPEG 缩略图
+ * @param base TIFF 头在文件中的偏移（JPEG 为 APP1 中 "Exif\0\0" 之后，TIFF/RAW 为 0）
+ * @param limit 缩略图数据不得超过的文件偏移
+ */
+bool parseTiff(AfcRangeReader &reader, qint64 base, qint64 limit, ExifThumbnail::Result &result)
+{
+    QByteArray header;
+    if (!reader.read(base, 8, header)) {
+        return false;
+    }
+
+    bool littleEndian;
+    if (header.startsWith("II")) {
+        littleEndian = true;
+    } else if (header.startsWith("MM")) {
+        littleEndian = false;
+    } else {
+        return false;
+    }
+    if (readU16(header, 2, littleEndian) != 42) {
+        return false;
+    }
+
+    qint64 thumbnailOffset = 0;
+    qint64 thumbnailLength = 0;
+    quint32 ifdOffset = readU32(header, 4, littleEndian);
+
+    // IFD0 描述主图（含方向），IFD1 描述缩略图；部分 RAW 把缩略图放在更后面的 IFD
+    for (int ifd = 0; ifd < MAX_IFDS && ifdOffset != 0; ++ifd) {
+        QByteArray countBytes;
+        if (!reader.read(base + ifdOffset, 2, countBytes)) {
+            return false;
+        }
+        const int count = readU16(countBytes, 0, littleEndian);
+        if (count == 0 || count > MAX_IFD_ENTRIES) {
+            return false;
+        }
+
+        QByteArray entries;
+        if (!reader.read(base + ifdOffset + 2, count * 12 + 4, entries)) {
+            return false;
+        }
+
+        qint64 offset = 0;
+        qint64 length = 0;
+        for (int i = 0; i < count; ++i) {
+            const int entry = i * 12;
+            const quint16 tag = readU16(entries, entry, littleEndian);
+            const quint16 type = readU16(entries, entry + 2, littleEndian);
+            // SHORT 值位于值字段的前 2 字节，与字节序无关
+            const quint32 value = type == TYPE_SHORT ? readU16(entries, entry + 8, littleEndian)
+                                : type == TYPE_LONG ? readU32(entries, entry + 8, littleEndian) : 0;
+
+            if (tag == TAG_ORIENTATION && ifd == 0 && value >= 1 && value <= 8) {
+                result.orientation = static_cast<int>(value);
+            } else if (tag == TAG_JPEG_OFFSET) {
+                offset = value;
+            } else if (tag == TAG_JPEG_LENGTH) {
+                length = value;
+            }
+        }
+
+        if (offset > 0 && length > 0) {
+            thumbnailOffset = offset;
+            thumbnailLength = length;
+            break;
+        }
+        ifdOffset = readU32(entries, count * 12, littleEndian);
+    }
+
+    if (thumbnailOffset == 0 || thumbnailLength > MAX_THUMBNAIL_SIZE
+        || base + thumbnailOffset + thumbnailLength > limit) {
+        return false;
+    }
+
+    QByteArray thumbnail;
+    if (!reader.read(base + thumbnailOffset, thumbnailLength, thumbnail)) {
+        return false;
+    }
+    if (!thumbnail.startsWith("\xFF\xD8")) {
+        return false;
+    }
+    result.data = thumbnail;
+    return true;
+}
+
+/**
+ * @brief 遍历 JPEG 开头的段，找到 APP1/EXIF 后解析其中的 TIFF 结构
+ */
+bool parseJpeg(AfcRangeReader &reader, qint64 fileSize, ExifThumbnail::Result &result)
+{
+    qint64 position = 2; // 跳过 SOI
+    while (position + 4 <= fileSize && position < AfcRangeReader::HEAD_LIMIT) {
+        QByteArray marker;
+        if (!reader.read(position, 4, marker)) {
+            return false;
+        }
+
+        const uchar prefix = static_cast<uchar>(marker.at(0));
+        const uchar type = static_cast<uchar>(marker.at(1));
+        // SOS 之后是压缩数据，EXIF 只会出现在它之前
+        if (prefix != 0xFF || type == 0xDA || type == 0xD9) {
+            return false;
+        }
+
+        const qint64 length = readU16(marker, 2, false);
+        if (length < 2) {
+            return false;
+        }
+
+        if (type == 0xE1) {
+            QByteArray identifier;
+            if (reader.read(position + 4, 6, identifier) && identifier == QByteArray("Exif\0\0", 6)) {
+                return parseTiff(reader, position + 10, position + 2 + length, result);
+            }
+        }
+        position += 2 + length;
+    }
+    return false;
+}
+
+} // namespace
+
+bool ExifThumbnail::isSupported(const QString &path)
+{
+    static const QStringList extensions = {
+        "jpg", "jpeg", "tif", "tiff", "dng", "cr2", "nef", "arw"
+    };
+    return extensions.contains(QFileInfo(path).suffix().toLower());
+}
+
+ExifThumbnail::Result ExifThumbnail::extract(void *afcClient, const QString &path, qint64 fileSize)
+{
+    Result result;
+
+    AfcRangeReader reader(afcClient, path, fileSize);
+    if (!reader.isOpen()) {
+        return result;
+    }
+
+    QByteArray magic;
+    if (reader.read(0, 2, magic)) {
+        if (magic.startsWith("\xFF\xD8")) {
+            parseJpeg(reader, reader.size(), result);
+        } else if (magic == "II" || magic == "MM") {
+            parseTiff(reader, 0, reader.size(), result);
+        }
+    }
+    result.bytesRead = reader.bytesRead();
+
+    if (result.data.isEmpty()) {
+        qDebug() << "ExifThumbnail: 未找到内嵌缩略图" << path << "已读取:" << result.bytesRead;
+    }
+    return result;
+}
+
+QImage ExifThumbnail::applyOrientation(const QImage &image, int orientation)
+{
+    QTransform transform;
+    switch (orientation) {
+    case 2:
+        return image.mirrored(true, false);
+    case 3:
+        transform.rotate(180);
+        break;
+    case 4:
+        return image.mirrored(false, true);
+    case 5:
+        transform.rotate(270);
+        return image.mirrored(true, false).transformed(transform);
+    case 6:
+        transform.rotate(90);
+        break;
+    case 7:
+        transform.rotate(90);
+        return image.mirrored(true, false).transformed(transform);
+    case 8:
+        transform.rotate(270);
+        break;
+    default:
+        return image;
+    }
+    return image.transformed(transform);
+}
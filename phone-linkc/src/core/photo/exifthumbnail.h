@@ -0,0 +1,65 @@
+/**
+ * @file exifthumbnail.h
+ * @brief EXIF 内嵌缩略图提取头文件
+ *
+ * JPEG 以及多数相机 RAW（DNG/CR2/NEF/ARW 等基于 TIFF 结构的格式）在 EXIF IFD1 中
+ * 内嵌一张约 160px 的 JPEG 缩略图，通常位于文件开头的几十 KB 内。
+ * 这里通过 AFC 只读取文件头部（必要时按偏移定位读取），解析出这张缩略图，
+ * 生成缩略图时不必传输整个文件。
+ */
+
+#ifndef EXIFTHUMBNAIL_H
+#define EXIFTHUMBNAIL_H
+
+#include <QString>
+#include <QByteArray>
+#include <QImage>
+
+/**
+ * @brief EXIF 内嵌缩略图提取器
+ *
+ * 使用方法：
+ * @code
+ * if (ExifThumbnail::isSupported(path)) {
+ *     ExifThumbnail::Result result = ExifThumbnail::extract(afcClient, path, size);
+ *     if (!result.data.isEmpty()) {
+ *         QImage image = ExifThumbnail::applyOrientation(QImage::fromData(result.data), result.orientation);
+ *     }
+ * }
+ * @endcode
+ */
+class ExifThumbnail
+{
+public:
+    /**
+     * @brief 提取结果
+     */
+    struct Result {
+        QByteArray data;        ///< 缩略图 JPEG 数据，为空表示文件中没有内嵌缩略图
+        int orientation = 1;    ///< 主图的 EXIF 方向（1-8），内嵌缩略图未按此旋转
+        qint64 bytesRead = 0;   ///< 本次从设备读取的字节数（含解析失败时已读取的部分）
+    };
+
+    /**
+     * @brief 文件格式是否可能带有 EXIF 内嵌缩略图（按扩展名判断）
+     */
+    static bool isSupported(const QString &path);
+
+    /**
+     * @brief 通过 AFC 范围读取提取内嵌缩略图
+     * @param afcClient AFC 客户端（afc_client_t）
+     * @param path 设备上的文件路径
+     * @param fileSize 文件大小，未知时传 0（将先查询文件信息）
+     * @return 提取结果，data 为空时调用方应回退到读取整个文件
+     */
+    static Result extract(void *afcClient, const QString &path, qint64 fileSize = 0);
+
+    /**
+     * @brief 按 EXIF 方向旋转/翻转图像
+     * @param image 原始图像
+     * @param orientation EXIF 方向（1-8，其他值视为 1）
+     */
+    static QImage applyOrientation(const QImage &image, int orientation);
+};
+
+#endif // EXIFTHUMBNAIL_H
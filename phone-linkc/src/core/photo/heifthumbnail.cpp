@@ -0,0 +1,476 @@
+/**
+ * @file heifthumbnail.cpp
+ * @brief HEIF/HEIC 缩略图项提取实现
+ */
+
+#include "heifthumbnail.h"
+#include "afcrangereader.h"
+#include "isobmff.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <QHash>
+#include <QPair>
+#include <QStringList>
+#include <QVector>
+
+// meta 盒大小上限（Apple 的 HEIC 通常只有几 KB）
+static const qint64 MAX_META_SIZE = 1024 * 1024;
+
+// 缩略图项大小上限，超出视为数据损坏
+static const qint64 MAX_THUMBNAIL_SIZE = 1024 * 1024;
+
+// 封装后的最小 HEIF 中 ipma 使用 7 位属性序号
+static const int MAX_WRAPPED_PROPERTIES = 127;
+
+namespace {
+
+/**
+ * @brief meta 中登记的一个项
+ */
+struct HeifItem {
+    QByteArray type;                            ///< 项类型（hvc1、jpeg、grid、Exif 等）
+    int constructionMethod = 0;                 ///< 0：文件偏移，1：idat 内偏移
+    quint64 baseOffset = 0;
+    QVector<QPair<quint64, quint64>> extents;   ///< 偏移, 长度（长度 0 表示到末尾）
+    bool located = false;                       ///< iloc 中是否有完整记录
+};
+
+/**
+ * @brief meta 盒的解析结果
+ */
+struct HeifMeta {
+    quint32 primaryId = 0;
+    QHash<quint32, HeifItem> items;
+    QVector<QPair<quint32, quint32>> thumbnailRefs;     ///< 缩略图项 -> 被描述的项
+    QVector<QByteArray> properties;                     ///< ipco 中的属性盒（原始字节）
+    QHash<quint32, QVector<quint16>> associations;      ///< 项 -> 属性序号（从 1 开始，最高位为 essential）
+    QByteArray idat;
+};
+
+void parsePitm(const QByteArray &data, const IsoBox &box, HeifMeta &meta)
+{
+    IsoByteReader r(data, box.payload, box.end);
+    const int version = IsoBmff::fullBoxVersion(r);
+    meta.primaryId = version == 0 ? r.u16() : r.u32();
+}
+
+void parseIinf(const QByteArray &data, const IsoBox &box, HeifMeta &meta)
+{
+    IsoByteReader r(data, box.payload, box.end);
+    const int version = IsoBmff::fullBoxVersion(r);
+    r.read(version == 0 ? 2 : 4); // entry_count，直接遍历子盒
+
+    for (const IsoBox &infe : IsoBmff::childBoxes(data, r.pos(), box.end)) {
+        if (infe.type != "infe") {
+            continue;
+        }
+        IsoByteReader e(data, infe.payload, infe.end);
+        const int infeVersion = IsoBmff::fullBoxVersion(e);
+        if (infeVersion < 2) {
+            continue; // 旧版 infe 没有 item_type
+        }
+        const quint32 id = infeVersion == 2 ? e.u16() : e.u32();
+        e.u16(); // item_protection_index
+        const QByteArray type = e.fourcc();
+        if (e.ok()) {
+            meta.items[id].type = type;
+        }
+    }
+}
+
+void parseIloc(const QByteArray &data, const IsoBox &box, HeifMeta &meta)
+{
+    IsoByteReader r(data, box.payload, box.end);
+    const int version = IsoBmff::fullBoxVersion(r);
+    const quint32 sizes = r.u8();
+    const int offsetSize = static_cast<int>(sizes >> 4);
+    const int lengthSize = static_cast<int>(sizes & 0x0F);
+    const quint32 sizes2 = r.u8();
+    const int baseOffsetSize = static_cast<int>(sizes2 >> 4);
+    const int indexSize = (version == 1 || version == 2) ? static_cast<int>(sizes2 & 0x0F) : 0;
+    const quint32 count = version < 2 ? r.u16() : r.u32();
+
+    for (quint32 i = 0; i < count && r.ok(); ++i) {
+        const quint32 id = version < 2 ? r.u16() : r.u32();
+        int constructionMethod = 0;
+        if (version == 1 || version == 2) {
+            constructionMethod = static_cast<int>(r.u16() & 0x0F);
+        }
+        r.u16(); // data_reference_index
+        const quint64 baseOffset = r.read(baseOffsetSize);
+        const quint32 extentCount = r.u16();
+
+        QVector<QPair<quint64, quint64>> extents;
+        for (quint32 e = 0; e < extentCount && r.ok(); ++e) {
+            r.read(indexSize);
+            const quint64 offset = r.read(offsetSize);
+            const quint64 length = r.read(lengthSize);
+            extents.append(qMakePair(offset, length));
+        }
+
+        if (r.ok()) {
+            HeifItem &item = meta.items[id];
+            item.constructionMethod = constructionMethod;
+            item.baseOffset = baseOffset;
+            item.extents = extents;
+            item.located = true;
+        }
+    }
+}
+
+void parseIref(const QByteArray &data, const IsoBox &box, HeifMeta &meta)
+{
+    IsoByteReader r(data, box.payload, box.end);
+    const int version = IsoBmff::fullBoxVersion(r);
+
+    for (const IsoBox &reference : IsoBmff::childBoxes(data, r.pos(), box.end)) {
+        if (reference.type != "thmb") {
+            continue;
+        }
+        IsoByteReader c(data, reference.payload, reference.end);
+        const quint32 from = version == 0 ? c.u16() : c.u32();
+        const quint32 count = c.u16();
+        for (quint32 i = 0; i < count; ++i) {
+            const quint32 to = version == 0 ? c.u16() : c.u32();
+            if (!c.ok()) {
+                break;
+            }
+            meta.thumbnailRefs.append(qMakePair(from, to));
+        }
+    }
+}
+
+void parseIprp(const QByteArray &data, const IsoBox &box, HeifMeta &meta)
+{
+    for (const IsoBox &child : IsoBmff::childBoxes(data, box.payload, box.end)) {
+        if (child.type == "ipco") {
+            for (const IsoBox &property : IsoBmff::childBoxes(data, child.payload, child.end)) {
+                meta.properties.append(data.mid(property.begin, property.end - property.begin));
+            }
+        } else if (child.type == "ipma") {
+            IsoByteReader r(data, child.payload, child.end);
+            const int version = static_cast<int>(r.u8());
+            const quint32 flags = static_cast<quint32>(r.read(3));
+            const quint32 count = r.u32();
+            for (quint32 i = 0; i < count && r.ok(); ++i) {
+                const quint32 id = version < 1 ? r.u16() : r.u32();
+                const quint32 associationCount = r.u8();
+                QVector<quint16> &associations = meta.associations[id];
+                for (quint32 a = 0; a < associationCount && r.ok(); ++a) {
+                    if (flags & 1) {
+                        associations.append(static_cast<quint16>(r.u16()));
+                    } else {
+                        const quint32 value = r.u8();
+                        associations.append(static_cast<quint16>(((value & 0x80) << 8) | (value & 0x7F)));
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief 解析 meta 盒内容
+ */
+HeifMeta parseMeta(const QByteArray &data, int payload, int end)
+{
+    HeifMeta meta;
+    IsoByteReader r(data, payload, end);
+    IsoBmff::fullBoxVersion(r);
+
+    for (const IsoBox &box : IsoBmff::childBoxes(data, r.pos(), end)) {
+        if (box.type == "pitm") {
+            parsePitm(data, box, meta);
+        } else if (box.type == "iinf") {
+            parseIinf(data, box, meta);
+        } else if (box.type == "iloc") {
+            parseIloc(data, box, meta);
+        } else if (box.type == "iref") {
+            parseIref(data, box, meta);
+        } else if (box.type == "iprp") {
+            parseIprp(data, box, meta);
+        } else if (box.type == "idat") {
+            meta.idat = data.mid(box.payload, box.end - box.payload);
+        }
+    }
+    return meta;
+}
+
+/**
+ * @brief 选择主图的缩略图项，优先可直接解码的 JPEG
+ * @param allowHevc 是否可以选择 HEVC 缩略图项
+ */
+quint32 chooseThumbnail(const HeifMeta &meta, bool allowHevc)
+{
+    quint32 hevc = 0;
+    for (const auto &reference : meta.thumbnailRefs) {
+        if (meta.primaryId != 0 && reference.second != meta.primaryId) {
+            continue;
+        }
+        auto it = meta.items.constFind(reference.first);
+        if (it == meta.items.constEnd() || !it->located) {
+            continue;
+        }
+        if (it->type == "jpeg") {
+            return reference.first;
+        }
+        if (allowHevc && it->type == "hvc1" && hevc == 0) {
+            hevc = reference.first;
+        }
+    }
+    return hevc;
+}
+
+QByteArray propertyType(const QByteArray &property)
+{
+    return property.mid(4, 4);
+}
+
+/**
+ * @brief 把项的 irot/imir 变换换算为 EXIF 方向值
+ *
+ * 变换按 ipma 中的顺序依次作用，状态表示为“先水平翻转（可选）再顺时针旋转”，与 EXIF 方向值一一对应。
+ */
+int orientationOf(const HeifMeta &meta, quint32 itemId, bool *found)
+{
+    bool mirrored = false;
+    int rotation = 0; // 顺时针角度
+    *found = false;
+
+    for (quint16 association : meta.associations.value(itemId)) {
+        const int index = association & 0x7FFF;
+        if (index == 0 || index > meta.properties.size()) {
+            continue;
+        }
+        const QByteArray &property = meta.properties.at(index - 1);
+        if (property.size() < 9) {
+            continue;
+        }
+        const QByteArray type = propertyType(property);
+        const int value = static_cast<uchar>(property.at(8));
+        if (type == "irot") {
+            // 逆时针旋转 angle * 90 度
+            rotation = (rotation - (value & 0x03) * 90 + 360) % 360;
+            *found = true;
+        } else if (type == "imir") {
+            // axis 0：沿竖直轴（左右翻转）；axis 1：沿水平轴（上下翻转 = 左右翻转 + 旋转 180 度）
+            mirrored = !mirrored;
+            rotation = (value & 0x01) ? (540 - rotation) % 360 : (360 - rotation) % 360;
+            *found = true;
+        }
+    }
+
+    static const int orientations[2][4] = {
+        {1, 6, 3, 8},
+        {2, 7, 4, 5}
+    };
+    return orientations[mirrored ? 1 : 0][rotation / 90];
+}
+
+/**
+ * @brief 读取项的数据（各 extent 依次拼接）
+ */
+bool readItem(AfcRangeReader &reader, const HeifMeta &meta, const HeifItem &item, QByteArray &out)
+{
+    out.clear();
+    for (const auto &extent : item.extents) {
+        const quint64 start = item.baseOffset + extent.first;
+        if (item.constructionMethod == 1) {
+            if (start > static_cast<quint64>(meta.idat.size())) {
+                return false;
+            }
+            const quint64 length = extent.second ? extent.second : meta.idat.size() - start;
+            if (start + length > static_cast<quint64>(meta.idat.size())) {
+                return false;
+            }
+            out.append(meta.idat.mid(static_cast<int>(start), static_cast<int>(length)));
+        } else if (item.constructionMethod == 0) {
+            if (start > static_cast<quint64>(reader.size())) {
+                return false;
+            }
+            const quint64 length = extent.second ? extent.second : reader.size() - start;
+            if (out.size() + length > static_cast<quint64>(MAX_THUMBNAIL_SIZE)) {
+                return false;
+            }
+            QByteArray chunk;
+            if (!reader.read(static_cast<qint64>(start), static_cast<qint64>(length), chunk)) {
+                return false;
+            }
+            out.append(chunk);
+        } else {
+            return false;
+        }
+    }
+    return !out.isEmpty() && out.size() <= MAX_THUMBNAIL_SIZE;
+}
+
+/**
+ * @brief 构造只含一个 HEVC 图像项的最小 HEIF 文件
+ * @param ipco 该项的属性盒（依次拼接）
+ * @param associations ipma 中的属性序号（7 位，最高位为 essential）
+ * @param count 属性数
+ */
+QByteArray buildSingleItemHeif(const QByteArray &ipco, const QByteArray &associations, int count,
+                               const QByteArray &data)
+{
+    QByteArray ftyp("heic", 4);
+    IsoBmff::appendBe32(ftyp, 0);
+    ftyp.append("mif1heic", 8);
+
+    QByteArray hdlr;
+    IsoBmff::appendBe32(hdlr, 0);
+    hdlr.append("pict", 4);
+    hdlr.append(QByteArray(13, '\0')); // reserved[3] + 空名称
+
+    QByteArray pitm;
+    IsoBmff::appendBe16(pitm, 1);
+
+    QByteArray infe;
+    IsoBmff::appendBe16(infe, 1);
+    IsoBmff::appendBe16(infe, 0);
+    infe.append("hvc1", 4);
+    infe.append('\0');
+    QByteArray iinf;
+    IsoBmff::appendBe16(iinf, 1);
+    iinf.append(IsoBmff::makeFullBox("infe", 2, infe));
+
+    QByteArray ipma;
+    IsoBmff::appendBe32(ipma, 1);
+    IsoBmff::appendBe16(ipma, 1);
+    ipma.append(static_cast<char>(count));
+    ipma.append(associations);
+    const QByteArray iprp = IsoBmff::makeBox("iprp", IsoBmff::makeBox("ipco", ipco)
+                                             + IsoBmff::makeFullBox("ipma", 0, ipma));
+
+    auto buildMeta = [&](quint32 dataOffset) {
+        QByteArray iloc;
+        iloc.append('\x44');    // offset_size = 4, length_size = 4
+        iloc.append('\0');      // base_offset_size = 0
+        IsoBmff::appendBe16(iloc, 1);
+        IsoBmff::appendBe16(iloc, 1);
+        IsoBmff::appendBe16(iloc, 0);
+        IsoBmff::appendBe16(iloc, 1);
+        IsoBmff::appendBe32(iloc, dataOffset);
+        IsoBmff::appendBe32(iloc, static_cast<quint32>(data.size()));
+        return IsoBmff::makeFullBox("meta", 0, IsoBmff::makeFullBox("hdlr", 0, hdlr)
+                                    + IsoBmff::makeFullBox("pitm", 0, pitm)
+                                    + IsoBmff::makeFullBox("iloc", 0, iloc)
+                                    + IsoBmff::makeFullBox("iinf", 0, iinf) + iprp);
+    };
+
+    const QByteArray header = IsoBmff::makeBox("ftyp", ftyp);
+    const quint32 dataOffset = static_cast<quint32>(header.size() + buildMeta(0).size() + 8);
+    return header + buildMeta(dataOffset) + IsoBmff::makeBox("mdat", data);
+}
+
+/**
+ * @brief 把 HEVC 缩略图项封装为只含这一项的最小 HEIF 文件
+ *
+ * 复制该项关联的解码属性（hvcC、ispe、colr 等），irot/imir 由调用方按 orientation 处理。
+ */
+QByteArray wrapHevcItem(const HeifMeta &meta, quint32 itemId, const QByteArray &data)
+{
+    QByteArray ipco;
+    QByteArray associations;
+    int count = 0;
+    for (quint16 association : meta.associations.value(itemId)) {
+        const int index = association & 0x7FFF;
+        if (index == 0 || index > meta.properties.size()) {
+            continue;
+        }
+        const QByteArray &property = meta.properties.at(index - 1);
+        const QByteArray type = propertyType(property);
+        if (type == "irot" || type == "imir") {
+            continue;
+        }
+        if (++count > MAX_WRAPPED_PROPERTIES) {
+            return QByteArray();
+        }
+        ipco.append(property);
+        associations.append(static_cast<char>(((association & 0x8000) ? 0x80 : 0) | count));
+    }
+    return buildSingleItemHeif(ipco, associations, count, data);
+}
+
+/**
+ * @brief ftyp 是否声明了 HEIF 图像品牌
+ */
+bool isHeifBrand(const QByteArray &ftyp)
+{
+    static const QList<QByteArray> brands = {"heic", "heix", "heim", "heis", "hevc", "mif1", "msf1"};
+    // major_brand(4) + minor_version(4) + compatible_brands(4 * n)
+    for (int i = 0; i + 4 <= ftyp.size(); i += 4) {
+        if (i == 4) {
+            continue;
+        }
+        if (brands.contains(ftyp.mid(i, 4))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool HeifThumbnail::isSupported(const QString &path)
+{
+    static const QStringList extensions = {"heic", "heif", "hif"};
+    return extensions.contains(QFileInfo(path).suffix().toLower());
+}
+
+HeifThumbnail::Result HeifThumbnail::extract(void *afcClient, const QString &path, qint64 fileSize,
+                                             bool readHevcItem)
+{
+    Result result;
+
+    AfcRangeReader reader(afcClient, path, fileSize);
+    if (!reader.isOpen()) {
+        return result;
+    }
+
+    // 顺序查找顶层 meta 盒，跳过的盒（如位于 meta 之前的 mdat）只读取盒头
+    QByteArray ftyp;
+    QByteArray metaBox;
+    int metaPayload = 0;
+    if (!IsoBmff::readTopLevelBox(reader, "meta", MAX_META_SIZE, metaBox, metaPayload, &ftyp)
+        || !isHeifBrand(ftyp)) {
+        metaBox.clear();
+    }
+
+    if (!metaBox.isEmpty()) {
+        const HeifMeta meta = parseMeta(metaBox, metaPayload, metaBox.size());
+        // 没有 HEIF 插件时封装出的 HEVC 项也无法解码，不传输其数据
+        const quint32 thumbnailId = chooseThumbnail(meta, readHevcItem);
+        QByteArray data;
+        if (thumbnailId != 0 && readItem(reader, meta, meta.items.value(thumbnailId), data)) {
+            bool found = false;
+            result.orientation = orientationOf(meta, thumbnailId, &found);
+            if (!found) {
+                // 缩略图项没有变换属性时沿用主图的
+                result.orientation = orientationOf(meta, meta.primaryId, &found);
+            }
+            result.data = meta.items.value(thumbnailId).type == "jpeg" ? data : wrapHevcItem(meta, thumbnailId, data);
+        }
+    }
+    result.bytesRead = reader.bytesRead();
+
+    if (result.data.isEmpty()) {
+        qDebug() << "HeifThumbnail: 未找到缩略图项" << path << "已读取:" << result.bytesRead;
+    }
+    return result;
+}
+
+QByteArray HeifThumbnail::wrapHevcImage(const QByteArray &hvcC, quint32 width, quint32 height,
+                                        const QByteArray &data)
+{
+    QByteArray ispe;
+    IsoBmff::appendBe32(ispe, width);
+    IsoBmff::appendBe32(ispe, height);
+
+    // hvcC 为解码必需属性（essential），ispe 为描述属性
+    const QByteArray ipco = hvcC + IsoBmff::makeFullBox("ispe", 0, ispe);
+    QByteArray associations;
+    associations.append(static_cast<char>(0x81));
+    associations.append(static_cast<char>(0x02));
+    return buildSingleItemHeif(ipco, associations, 2, data);
+}
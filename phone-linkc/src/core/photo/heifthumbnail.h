@@ -0,0 +1,75 @@
+/**
+ * @file heifthumbnail.h
+ * @brief HEIF/HEIC 缩略图项提取头文件
+ *
+ * HEIC 的主图由几十个 HEVC 图块组成，完整下载并解码的代价很高，而且 Qt 默认没有 HEIF 插件。
+ * 文件的 meta 盒中同时登记了一个通过 iref 'thmb' 关联到主图的小尺寸缩略图项。
+ * 这里只读取 ftyp/meta（通常几 KB）和缩略图项的字节范围：
+ * - JPEG 缩略图项直接返回；
+ * - HEVC 缩略图项（iPhone 拍摄的 HEIC 都是这种）重新封装为只含这一项的最小 HEIF 文件，
+ *   有 HEIF 插件时解码的是约 320px 的单个图块而不是整张主图；没有插件时不读取该项。
+ */
+
+#ifndef HEIFTHUMBNAIL_H
+#define HEIFTHUMBNAIL_H
+
+#include <QString>
+
+#include "exifthumbnail.h"
+
+/**
+ * @brief HEIF 缩略图项提取器
+ *
+ * 使用方法：
+ * @code
+ * if (HeifThumbnail::isSupported(path)) {
+ *     ExifThumbnail::Result result = HeifThumbnail::extract(afcClient, path, size);
+ *     if (!result.data.isEmpty()) {
+ *         QImage image = ExifThumbnail::applyOrientation(QImage::fromData(result.data), result.orientation);
+ *     }
+ * }
+ * @endcode
+ */
+class HeifThumbnail
+{
+public:
+    /**
+     * @brief 提取结果，与 ExifThumbnail 相同
+     *
+     * data 为 JPEG 或最小 HEIF 文件；缩略图项的 irot/imir 变换换算为 EXIF 方向值放在 orientation 中，
+     * 不写入封装后的文件，解码后统一用 ExifThumbnail::applyOrientation 处理。
+     */
+    using Result = ExifThumbnail::Result;
+
+    /**
+     * @brief 是否为 HEIF 格式（按扩展名判断）
+     */
+    static bool isSupported(const QString &path);
+
+    /**
+     * @brief 通过 AFC 范围读取提取缩略图项
+     * @param afcClient AFC 客户端（afc_client_t）
+     * @param path 设备上的文件路径
+     * @param fileSize 文件大小，未知时传 0（将先查询文件信息）
+     * @param readHevcItem 是否读取 HEVC 缩略图项（没有 HEIF 插件时传 false，只读取 meta 查找 JPEG 缩略图项）
+     * @return 提取结果，data 为空表示没有可用的缩略图项
+     */
+    static Result extract(void *afcClient, const QString &path, qint64 fileSize = 0, bool readHevcItem = true);
+
+    /**
+     * @brief 把一段 HEVC 图像数据封装为只含这一项的最小 HEIF 文件
+     *
+     * 用于视频关键帧：MP4/MOV 样本描述中的 hvcC 盒与 HEIF 的 hvcC 属性格式相同，
+     * 样本数据同为长度前缀的 NAL 单元，可以原样放入 HEIF 交给 HEIF 插件解码。
+     *
+     * @param hvcC 完整的 hvcC 盒（含盒头）
+     * @param width 图像宽度
+     * @param height 图像高度
+     * @param data 图像数据
+     * @return HEIF 文件数据
+     */
+    static QByteArray wrapHevcImage(const QByteArray &hvcC, quint32 width, quint32 height,
+                                    const QByteArray &data);
+};
+
+#endif // HEIFTHUMBNAIL_H
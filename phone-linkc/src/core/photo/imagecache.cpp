@@ -0,0 +1,87 @@
+/**
+ * @file imagecache.cpp
+ * @brief 解码图片缓存实现
+ */
+
+#include "imagecache.h"
+#include <QMutexLocker>
+
+namespace {
+
+qint64 costOf(const QImage &image)
+{
+    return qMax<qint64>(1, image.sizeInBytes() / 1024);
+}
+
+} // namespace
+
+ImageCache::ImageCache(qint64 maxBytes)
+    : m_images(qMax<qint64>(1, maxBytes / 1024))
+{
+}
+
+void ImageCache::setMaxBytes(qint64 maxBytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_images.setMaxCost(qMax<qint64>(1, maxBytes / 1024));
+}
+
+qint64 ImageCache::maxBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<qint64>(m_images.maxCost()) * 1024;
+}
+
+qint64 ImageCache::totalBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<qint64>(m_images.totalCost()) * 1024;
+}
+
+int ImageCache::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_images.count();
+}
+
+QImage ImageCache::find(const QString &key) const
+{
+    QMutexLocker locker(&m_mutex);
+    // object() 同时把该图片移到最近使用的位置
+    const QImage *image = m_images.object(key);
+    return image ? *image : QImage();
+}
+
+bool ImageCache::contains(const QString &key) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_images.contains(key);
+}
+
+bool ImageCache::insert(const QString &key, const QImage &image)
+{
+    if (image.isNull()) {
+        return false;
+    }
+
+    const qint64 cost = costOf(image);
+    QMutexLocker locker(&m_mutex);
+    if (cost > m_images.maxCost()) {
+        // QCache 会直接丢弃超过上限的对象，先移除旧值以免返回过期图片
+        m_images.remove(key);
+        return false;
+    }
+    return m_images.insert(key, new QImage(image), cost);
+}
+
+void ImageCache::remove(const QString &key)
+{
+    QMutexLocker locker(&m_mutex);
+    m_images.remove(key);
+}
+
+void ImageCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_images.clear();
+}
@@ -0,0 +1,94 @@
+/**
+ * @file imagecache.h
+ * @brief 解码图片缓存头文件
+ *
+ * 全尺寸预览的解码结果动辄数十 MB，重复打开同一张照片时不应再次读取和解码。
+ * 缓存按图片占用的字节数计费，超出预算时淘汰最久未使用的图片。
+ */
+
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+
+/**
+ * @brief 按字节预算淘汰的解码图片 LRU 缓存（线程安全）
+ *
+ * 内部以 KB 为单位计费；单张超过预算的图片不会放入缓存。
+ * QImage 隐式共享，取出的图片与缓存共享像素数据，不发生复制。
+ *
+ * 使用方法：
+ * @code
+ * ImageCache cache(128 * 1024 * 1024);
+ * cache.insert(path, image);
+ * QImage cached = cache.find(path);   // 未命中时为空
+ * @endcode
+ */
+class ImageCache
+{
+public:
+    /// 默认预算（字节）
+    static const qint64 DEFAULT_MAX_BYTES = 256LL * 1024 * 1024;
+
+    explicit ImageCache(qint64 maxBytes = DEFAULT_MAX_BYTES);
+
+    ImageCache(const ImageCache &) = delete;
+    ImageCache &operator=(const ImageCache &) = delete;
+
+    /**
+     * @brief 设置预算，缩小时立即淘汰超出的图片
+     * @param maxBytes 预算（字节）
+     */
+    void setMaxBytes(qint64 maxBytes);
+
+    /**
+     * @brief 预算（字节）
+     */
+    qint64 maxBytes() const;
+
+    /**
+     * @brief 已缓存图片占用的字节数
+     */
+    qint64 totalBytes() const;
+
+    /**
+     * @brief 已缓存的图片数
+     */
+    int count() const;
+
+    /**
+     * @brief 查找图片并刷新其 LRU 顺序
+     * @return 图片，未命中时为空
+     */
+    QImage find(const QString &key) const;
+
+    /**
+     * @brief 是否已缓存（不刷新 LRU 顺序）
+     */
+    bool contains(const QString &key) const;
+
+    /**
+     * @brief 放入图片，键已存在时替换
+     * @return 是否放入（空图片或超过预算时返回 false）
+     */
+    bool insert(const QString &key, const QImage &image);
+
+    /**
+     * @brief 移除图片
+     */
+    void remove(const QString &key);
+
+    /**
+     * @brief 清空缓存
+     */
+    void clear();
+
+private:
+    mutable QMutex m_mutex;
+    mutable QCache<QString, QImage> m_images;   ///< 键 -> 图片（按 KB 计费）
+};
+
+#endif // IMAGECACHE_H
@@ -0,0 +1,168 @@
+/**
+ * @file isobmff.cpp
+ * @brief ISO 基础媒体文件格式（ISOBMFF）盒解析辅助实现
+ */
+
+#include "isobmff.h"
+#include "afcrangereader.h"
+
+// 查找顶层盒时最多遍历的盒数
+static const int MAX_TOP_LEVEL_BOXES = 16;
+
+// ftyp 大小上限
+static const quint64 MAX_FTYP_SIZE = 4096;
+
+IsoByteReader::IsoByteReader(const QByteArray &data, int begin, int end)
+    : m_data(data), m_pos(begin), m_end(end < 0 || end > data.size() ? data.size() : end), m_ok(true)
+{
+}
+
+quint64 IsoByteReader::read(int bytes)
+{
+    if (bytes < 0 || bytes > 8 || m_pos < 0 || bytes > m_end - m_pos) {
+        m_ok = false;
+        m_pos = m_end;
+        return 0;
+    }
+    quint64 value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value = (value << 8) | static_cast<uchar>(m_data.at(m_pos + i));
+    }
+    m_pos += bytes;
+    return value;
+}
+
+QByteArray IsoByteReader::fourcc()
+{
+    if (m_pos < 0 || 4 > m_end - m_pos) {
+        m_ok = false;
+        m_pos = m_end;
+        return QByteArray();
+    }
+    const QByteArray type = m_data.mid(m_pos, 4);
+    m_pos += 4;
+    return type;
+}
+
+void IsoByteReader::skip(int bytes)
+{
+    if (bytes < 0 || m_pos < 0 || bytes > m_end - m_pos) {
+        m_ok = false;
+        m_pos = m_end;
+        return;
+    }
+    m_pos += bytes;
+}
+
+QVector<IsoBox> IsoBmff::childBoxes(const QByteArray &data, int begin, int end)
+{
+    QVector<IsoBox> boxes;
+    int pos = begin;
+    while (pos + 8 <= end) {
+        IsoByteReader r(data, pos, end);
+        quint64 size = r.u32();
+        IsoBox box;
+        box.type = r.fourcc();
+        if (size == 1) {
+            size = r.u64();
+        } else if (size == 0) {
+            size = static_cast<quint64>(end - pos);
+        }
+        if (!r.ok() || size < static_cast<quint64>(r.pos() - pos) || size > static_cast<quint64>(end - pos)) {
+            break;
+        }
+        box.begin = pos;
+        box.payload = r.pos();
+        box.end = pos + static_cast<int>(size);
+        boxes.append(box);
+        pos = box.end;
+    }
+    return boxes;
+}
+
+bool IsoBmff::findChild(const QByteArray &data, int begin, int end, const char *type, IsoBox &box)
+{
+    for (const IsoBox &child : childBoxes(data, begin, end)) {
+        if (child.type == type) {
+            box = child;
+            return true;
+        }
+    }
+    return false;
+}
+
+int IsoBmff::fullBoxVersion(IsoByteReader &r)
+{
+    const int version = static_cast<int>(r.u8());
+    r.read(3); // flags
+    return version;
+}
+
+bool IsoBmff::readTopLevelBox(AfcRangeReader &reader, const char *type, qint64 maxSize,
+                              QByteArray &box, int &payload, QByteArray *ftyp)
+{
+    qint64 position = 0;
+    for (int i = 0; i < MAX_TOP_LEVEL_BOXES && position + 8 <= reader.size(); ++i) {
+        QByteArray header;
+        if (!reader.read(position, qMin<qint64>(16, reader.size() - position), header)) {
+            return false;
+        }
+        IsoByteReader h(header);
+        quint64 size = h.u32();
+        const QByteArray boxType = h.fourcc();
+        if (size == 1) {
+            size = h.u64();
+        } else if (size == 0) {
+            size = static_cast<quint64>(reader.size() - position);
+        }
+        const int headerSize = h.pos();
+        if (!h.ok() || size < static_cast<quint64>(headerSize)
+            || size > static_cast<quint64>(reader.size() - position)) {
+            return false;
+        }
+
+        if (i == 0 && ftyp) {
+            if (boxType != "ftyp" || size > MAX_FTYP_SIZE
+                || !reader.read(position + headerSize, static_cast<qint64>(size) - headerSize, *ftyp)) {
+                return false;
+            }
+        } else if (boxType == type) {
+            if (size > static_cast<quint64>(maxSize) || !reader.read(position, static_cast<qint64>(size), box)) {
+                return false;
+            }
+            payload = headerSize;
+            return true;
+        }
+        position += static_cast<qint64>(size);
+    }
+    return false;
+}
+
+void IsoBmff::appendBe16(QByteArray &out, quint32 value)
+{
+    out.append(static_cast<char>((value >> 8) & 0xFF));
+    out.append(static_cast<char>(value & 0xFF));
+}
+
+void IsoBmff::appendBe32(QByteArray &out, quint32 value)
+{
+    appendBe16(out, value >> 16);
+    appendBe16(out, value & 0xFFFF);
+}
+
+QByteArray IsoBmff::makeBox(const char *type, const QByteArray &payload)
+{
+    QByteArray box;
+    appendBe32(box, static_cast<quint32>(payload.size() + 8));
+    box.append(type, 4);
+    box.append(payload);
+    return box;
+}
+
+QByteArray IsoBmff::makeFullBox(const char *type, quint8 version, const QByteArray &payload)
+{
+    QByteArray body;
+    appendBe32(body, static_cast<quint32>(version) << 24);
+    body.append(payload);
+    return makeBox(type, body);
+}
@@ -0,0 +1,120 @@
+/**
+ * @file isobmff.h
+ * @brief ISO 基础媒体文件格式（ISOBMFF）盒解析辅助头文件
+ *
+ * HEIF 图片与 MP4/MOV 视频同属 ISOBMFF：文件由嵌套的盒（box/atom）组成，
+ * 每个盒以 32 位大小和 4 字符类型开头。这里提供两者共用的大端序读取、盒列举、
+ * 顶层盒查找和盒构造，解析只针对已读入内存的 meta/moov 盒。
+ */
+
+#ifndef ISOBMFF_H
+#define ISOBMFF_H
+
+#include <QByteArray>
+#include <QVector>
+
+class AfcRangeReader;
+
+/**
+ * @brief 大端序读取器，越界（含负位置）后 ok() 为 false，后续读取均返回 0
+ *
+ * end 超出缓冲区时按缓冲区末尾处理。
+ */
+class IsoByteReader
+{
+public:
+    IsoByteReader(const QByteArray &data, int begin = 0, int end = -1);
+
+    /**
+     * @brief 读取 bytes 字节（0~8）的无符号大端整数
+     */
+    quint64 read(int bytes);
+
+    quint32 u8() { return static_cast<quint32>(read(1)); }
+    quint32 u16() { return static_cast<quint32>(read(2)); }
+    quint32 u32() { return static_cast<quint32>(read(4)); }
+    quint64 u64() { return read(8); }
+
+    /**
+     * @brief 读取 4 字符类型码
+     */
+    QByteArray fourcc();
+
+    /**
+     * @brief 跳过 bytes 字节
+     */
+    void skip(int bytes);
+
+    int pos() const { return m_pos; }
+    bool ok() const { return m_ok; }
+
+private:
+    const QByteArray &m_data;
+    int m_pos;
+    int m_end;
+    bool m_ok;
+};
+
+/**
+ * @brief 缓冲区中的一个盒
+ */
+struct IsoBox {
+    QByteArray type;
+    int begin = 0;      ///< 盒头起始位置
+    int payload = 0;    ///< 内容起始位置
+    int end = 0;        ///< 结束位置
+};
+
+/**
+ * @brief ISOBMFF 辅助函数
+ */
+class IsoBmff
+{
+public:
+    /**
+     * @brief 列出缓冲区 [begin, end) 中的盒，遇到损坏的盒头即停止
+     */
+    static QVector<IsoBox> childBoxes(const QByteArray &data, int begin, int end);
+
+    /**
+     * @brief 查找 [begin, end) 中第一个指定类型的盒
+     * @return 是否找到
+     */
+    static bool findChild(const QByteArray &data, int begin, int end, const char *type, IsoBox &box);
+
+    /**
+     * @brief 读取 FullBox 的 version 并跳过 flags
+     */
+    static int fullBoxVersion(IsoByteReader &r);
+
+    /**
+     * @brief 顺序查找文件的顶层盒并读入内存
+     *
+     * 跳过的盒（如位于 moov/meta 之前的 mdat）只读取盒头，不传输内容。
+     *
+     * @param reader 设备文件读取器
+     * @param type 要查找的盒类型
+     * @param maxSize 盒大小上限，超出视为未找到
+     * @param box 整个盒（含盒头）
+     * @param payload 盒内容在 box 中的起始位置
+     * @param ftyp 非空时要求第一个盒为 ftyp，并返回其内容（major_brand、minor_version、compatible_brands）
+     * @return 是否找到并完整读取
+     */
+    static bool readTopLevelBox(AfcRangeReader &reader, const char *type, qint64 maxSize,
+                                QByteArray &box, int &payload, QByteArray *ftyp = nullptr);
+
+    static void appendBe16(QByteArray &out, quint32 value);
+    static void appendBe32(QByteArray &out, quint32 value);
+
+    /**
+     * @brief 构造盒
+     */
+    static QByteArray makeBox(const char *type, const QByteArray &payload);
+
+    /**
+     * @brief 构造 FullBox（flags 为 0）
+     */
+    static QByteArray makeFullBox(const char *type, quint8 version, const QByteArray &payload);
+};
+
+#endif // ISOBMFF_H
@@ -0,0 +1,353 @@
+/**
+ * @file photocatalog.cpp
+ * @brief 照片目录持久化实现
+ */
+
+#include "photocatalog.h"
+#include <QDebug>
+#include <QAtomicInt>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QSqlError>
+#include <QSqlQuery>
+
+// 数据库结构版本，结构变化时递增，旧数据库会被重建
+static const int CATALOG_VERSION = 1;
+
+// 其他连接正在写入时的等待时间（毫秒）
+static const int BUSY_TIMEOUT_MS = 5000;
+
+static const char *DCIM_PREFIX = "/DCIM/";
+
+namespace {
+
+/**
+ * @brief 绑定“根目录及其子孙”的范围条件：path = root OR (path >= root/ AND path < root0)
+ *
+ * '0' 是 '/' 的下一个字符，范围查询可以使用主键索引，且不受路径中 '_'、'%' 的影响。
+ */
+void bindSubtree(QSqlQuery &query, const QString &rootPath)
+{
+    query.addBindValue(rootPath);
+    query.addBindValue(rootPath + '/');
+    query.addBindValue(rootPath + '0');
+}
+
+QString parentOf(const QString &path)
+{
+    const int index = path.lastIndexOf('/');
+    return index <= 0 ? QStringLiteral("/") : path.left(index);
+}
+
+} // namespace
+
+PhotoCatalog::PhotoCatalog(const QString &udid)
+    : m_open(false)
+{
+    static QAtomicInt connectionCounter;
+    m_connectionName = QString("PhotoCatalog-%1-%2").arg(udid).arg(connectionCounter.fetchAndAddRelaxed(1));
+
+    const QString path = databasePath(udid);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    m_db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    m_db.setDatabaseName(path);
+    m_db.setConnectOptions(QString("QSQLITE_BUSY_TIMEOUT=%1").arg(BUSY_TIMEOUT_MS));
+    if (!m_db.open()) {
+        qWarning() << "PhotoCatalog: 无法打开数据库" << path << m_db.lastError().text();
+        return;
+    }
+
+    m_open = createSchema();
+}
+
+PhotoCatalog::~PhotoCatalog()
+{
+    m_db.close();
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+QString PhotoCatalog::databasePath(const QString &udid)
+{
+    // 使用 %appdata%/iPhonLinkC/catalog/ 目录
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation)
+        + QString("/iPhonLinkC/catalog/%1.sqlite").arg(udid);
+}
+
+QString PhotoCatalog::albumOf(const QString &directory)
+{
+    const QString prefix = QString::fromLatin1(DCIM_PREFIX);
+    if (!directory.startsWith(prefix)) {
+        return QString();
+    }
+    const QString albumName = directory.mid(prefix.size()).section('/', 0, 0);
+    return albumName.isEmpty() ? QString() : prefix + albumName;
+}
+
+bool PhotoCatalog::createSchema()
+{
+    QSqlQuery query(m_db);
+
+    // WAL 模式下读取不阻塞写入，界面读取和后台刷新可以同时进行
+    query.exec("PRAGMA journal_mode=WAL");
+    query.exec("PRAGMA synchronous=NORMAL");
+
+    int version = 0;
+    if (query.exec("PRAGMA user_version") && query.next()) {
+        version = query.value(0).toInt();
+    }
+    if (version != CATALOG_VERSION) {
+        query.exec("DROP TABLE IF EXISTS photos");
+        query.exec("DROP TABLE IF EXISTS directories");
+    }
+
+    const char *statements[] = {
+        "CREATE TABLE IF NOT EXISTS directories ("
+        " path TEXT PRIMARY KEY,"
+        " parent TEXT NOT NULL,"
+        " mtime_ns INTEGER NOT NULL)",
+
+        "CREATE TABLE IF NOT EXISTS photos ("
+        " path TEXT PRIMARY KEY,"
+        " directory TEXT NOT NULL,"
+        " name TEXT NOT NULL,"
+        " size INTEGER NOT NULL,"
+        " mtime INTEGER NOT NULL,"
+        " is_video INTEGER NOT NULL,"
+        " album TEXT NOT NULL)",
+
+        "CREATE INDEX IF NOT EXISTS photos_directory ON photos(directory)",
+        "CREATE INDEX IF NOT EXISTS photos_album ON photos(album)",
+    };
+    for (const char *statement : statements) {
+        if (!query.exec(statement)) {
+            qWarning() << "PhotoCatalog: 创建表失败" << query.lastError().text();
+            return false;
+        }
+    }
+
+    if (version != CATALOG_VERSION) {
+        query.exec(QString("PRAGMA user_version=%1").arg(CATALOG_VERSION));
+    }
+    return true;
+}
+
+PhotoScanner::KnownDirectories PhotoCatalog::load(const QString &rootPath)
+{
+    PhotoScanner::KnownDirectories known;
+    if (!m_open) {
+        return known;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+
+    // 目录及其父子关系
+    QHash<QString, QString> parents;
+    query.prepare("SELECT path, parent, mtime_ns FROM directories"
+                  " WHERE path = ? OR (path >= ? AND path < ?)");
+    bindSubtree(query, rootPath);
+    if (!query.exec()) {
+        qWarning() << "PhotoCatalog: 读取目录失败" << query.lastError().text();
+        return known;
+    }
+    while (query.next()) {
+        const QString path = query.value(0).toString();
+        known[path].mtimeNs = query.value(2).toLongLong();
+        parents.insert(path, query.value(1).toString());
+    }
+    for (auto it = parents.constBegin(); it != parents.constEnd(); ++it) {
+        auto parent = known.find(it.value());
+        if (parent != known.end() && it.key() != rootPath) {
+            parent->subdirectories << it.key();
+        }
+    }
+
+    // 各目录中的照片
+    int photoCount = 0;
+    query.prepare("SELECT directory, path, name, size, mtime, is_video FROM photos"
+                  " WHERE directory = ? OR (directory >= ? AND directory < ?)");
+    bindSubtree(query, rootPath);
+    if (!query.exec()) {
+        qWarning() << "PhotoCatalog: 读取照片失败" << query.lastError().text();
+        return PhotoScanner::KnownDirectories();
+    }
+    while (query.next()) {
+        auto directory = known.find(query.value(0).toString());
+        if (directory == known.end()) {
+            continue;
+        }
+        PhotoInfo info;
+        info.path = query.value(1).toString();
+        info.name = query.value(2).toString();
+        info.size = query.value(3).toLongLong();
+        info.modifiedTime = QDateTime::fromSecsSinceEpoch(query.value(4).toLongLong());
+        info.isVideo = query.value(5).toBool();
+        directory->photos.append(info);
+        ++photoCount;
+    }
+
+    qDebug() << "[性能] PhotoCatalog 加载" << rootPath << "目录:" << known.size()
+             << "照片:" << photoCount << "耗时:" << timer.elapsed() << "ms";
+    return known;
+}
+
+bool PhotoCatalog::update(const QString &rootPath,
+                          const QHash<QString, qint64> &listedDirectories,
+                          const QHash<QString, QVector<PhotoInfo>> &rescannedPhotos)
+{
+    if (!m_open) {
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!m_db.transaction()) {
+        qWarning() << "PhotoCatalog: 无法开始事务" << m_db.lastError().text();
+        return false;
+    }
+
+    QSqlQuery query(m_db);
+    QSqlQuery deletePhotos(m_db);
+    deletePhotos.prepare("DELETE FROM photos WHERE directory = ?");
+    bool ok = true;
+
+    // 本次未到达的目录已从设备上删除
+    QStringList removed;
+    query.prepare("SELECT path FROM directories WHERE path = ? OR (path >= ? AND path < ?)");
+    bindSubtree(query, rootPath);
+    ok = query.exec();
+    while (ok && query.next()) {
+        const QString path = query.value(0).toString();
+        if (!listedDirectories.contains(path)) {
+            removed << path;
+        }
+    }
+
+    QSqlQuery deleteDirectory(m_db);
+    deleteDirectory.prepare("DELETE FROM directories WHERE path = ?");
+    for (const QString &path : removed) {
+        if (!ok) {
+            break;
+        }
+        deletePhotos.addBindValue(path);
+        deleteDirectory.addBindValue(path);
+        ok = deletePhotos.exec() && deleteDirectory.exec();
+    }
+
+    // 重新读取过的目录整体替换
+    QSqlQuery insertPhoto(m_db);
+    insertPhoto.prepare("INSERT OR REPLACE INTO photos (path, directory, name, size, mtime, is_video, album)"
+                        " VALUES (?, ?, ?, ?, ?, ?, ?)");
+    int photoCount = 0;
+    for (auto it = rescannedPhotos.constBegin(); ok && it != rescannedPhotos.constEnd(); ++it) {
+        deletePhotos.addBindValue(it.key());
+        ok = deletePhotos.exec();
+
+        const QString album = albumOf(it.key());
+        for (const PhotoInfo &photo : it.value()) {
+            if (!ok) {
+                break;
+            }
+            insertPhoto.addBindValue(photo.path);
+            insertPhoto.addBindValue(it.key());
+            insertPhoto.addBindValue(photo.name);
+            insertPhoto.addBindValue(photo.size);
+            insertPhoto.addBindValue(photo.modifiedTime.isValid() ? photo.modifiedTime.toSecsSinceEpoch() : 0);
+            insertPhoto.addBindValue(photo.isVideo ? 1 : 0);
+            insertPhoto.addBindValue(album);
+            ok = insertPhoto.exec();
+            ++photoCount;
+        }
+    }
+
+    // 目录的 st_mtime（沿用的目录不变，一并写入即可）
+    QSqlQuery upsertDirectory(m_db);
+    upsertDirectory.prepare("INSERT OR REPLACE INTO directories (path, parent, mtime_ns) VALUES (?, ?, ?)");
+    for (auto it = listedDirectories.constBegin(); ok && it != listedDirectories.constEnd(); ++it) {
+        upsertDirectory.addBindValue(it.key());
+        upsertDirectory.addBindValue(parentOf(it.key()));
+        upsertDirectory.addBindValue(it.value());
+        ok = upsertDirectory.exec();
+    }
+
+    if (!ok || !m_db.commit()) {
+        qWarning() << "PhotoCatalog: 更新失败" << m_db.lastError().text();
+        m_db.rollback();
+        return false;
+    }
+
+    qDebug() << "[性能] PhotoCatalog 更新" << rootPath << "重新读取目录:" << rescannedPhotos.size()
+             << "删除目录:" << removed.size() << "写入照片:" << photoCount
+             << "耗时:" << timer.elapsed() << "ms";
+    return true;
+}
+
+QVector<AlbumInfo> PhotoCatalog::albums()
+{
+    QVector<AlbumInfo> albums;
+    if (!m_open) {
+        return albums;
+    }
+
+    QSqlQuery query(m_db);
+    if (!query.exec("SELECT album, COUNT(*) FROM photos WHERE album <> '' GROUP BY album ORDER BY album")) {
+        qWarning() << "PhotoCatalog: 统计相册失败" << query.lastError().text();
+        return albums;
+    }
+    while (query.next()) {
+        AlbumInfo album;
+        album.path = query.value(0).toString();
+        album.name = album.path.section('/', -1);
+        album.photoCount = query.value(1).toInt();
+        albums.append(album);
+    }
+    return albums;
+}
+
+int PhotoCatalog::resolve(QVector<PhotoInfo> &photos)
+{
+    if (!m_open || photos.isEmpty()) {
+        return 0;
+    }
+
+    // 逐条按主键查找，放在同一个读事务中
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare("SELECT size, mtime, is_video FROM photos WHERE path = ?");
+    m_db.transaction();
+    int resolved = 0;
+    for (PhotoInfo &photo : photos) {
+        query.addBindValue(photo.path);
+        if (!query.exec()) {
+            qWarning() << "PhotoCatalog: 查询照片失败" << query.lastError().text();
+            break;
+        }
+        if (query.next()) {
+            photo.size = query.value(0).toLongLong();
+            photo.modifiedTime = QDateTime::fromSecsSinceEpoch(query.value(1).toLongLong());
+            photo.isVideo = query.value(2).toBool();
+            ++resolved;
+        }
+        query.finish();
+    }
+    m_db.commit();
+    return resolved;
+}
+
+void PhotoCatalog::clear()
+{
+    if (!m_open) {
+        return;
+    }
+    QSqlQuery query(m_db);
+    query.exec("DELETE FROM photos");
+    query.exec("DELETE FROM directories");
+}
@@ -0,0 +1,112 @@
+/**
+ * @file photocatalog.h
+ * @brief 照片目录持久化头文件
+ *
+ * 每台设备的 DCIM 目录结构（目录 st_mtime、文件路径、大小、修改时间、类型、所属相册）
+ * 保存在本地 SQLite 数据库中。刷新时只重新读取 st_mtime 变化的目录，
+ * 未变化的图库只需每个目录一次 afc_get_file_info。
+ */
+
+#ifndef PHOTOCATALOG_H
+#define PHOTOCATALOG_H
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QSqlDatabase>
+
+#include "photomanager.h"
+#include "photoscanner.h"
+
+/**
+ * @brief 单台设备的照片目录数据库
+ *
+ * QSqlDatabase 连接只能在创建它的线程中使用，因此每个实例在构造时打开独立连接，
+ * 只在同一线程中使用；多个实例可以同时访问同一数据库。
+ *
+ * 使用方法：
+ * @code
+ * PhotoCatalog catalog(udid);
+ * PhotoScanner::KnownDirectories known = catalog.load("/DCIM");
+ * scanner.setKnownDirectories(&known);
+ * // ... 扫描并收集目录状态 ...
+ * catalog.update("/DCIM", listedDirectories, rescannedPhotos);
+ * @endcode
+ */
+class PhotoCatalog
+{
+public:
+    explicit PhotoCatalog(const QString &udid);
+    ~PhotoCatalog();
+
+    PhotoCatalog(const PhotoCatalog &) = delete;
+    PhotoCatalog &operator=(const PhotoCatalog &) = delete;
+
+    /**
+     * @brief 数据库是否可用
+     */
+    bool isOpen() const { return m_open; }
+
+    /**
+     * @brief 读取根目录下（含根目录）记录的所有目录及其照片
+     * @param rootPath 根目录
+     * @return 目录路径 -> 目录状态
+     */
+    PhotoScanner::KnownDirectories load(const QString &rootPath);
+
+    /**
+     * @brief 用一次完整结束的扫描结果更新数据库
+     *
+     * 本次未到达的目录（已被删除）连同其照片一起移除；重新读取过的目录替换其照片；
+     * 沿用的目录保持不变。
+     * @param rootPath 扫描根目录
+     * @param listedDirectories 本次到达的目录 -> st_mtime（纳秒，0 表示下次需要重新读取）
+     * @param rescannedPhotos 重新读取过的目录 -> 目录中的媒体文件
+     * @return 是否写入成功
+     */
+    bool update(const QString &rootPath,
+                const QHash<QString, qint64> &listedDirectories,
+                const QHash<QString, QVector<PhotoInfo>> &rescannedPhotos);
+
+    /**
+     * @brief 按相册统计照片数（相册为 /DCIM 下的第一级目录）
+     */
+    QVector<AlbumInfo> albums();
+
+    /**
+     * @brief 用记录中的大小、修改时间和类型校正照片信息（按路径查找，未记录的保持不变）
+     *
+     * 其他来源（如图库数据库）给出的照片信息与扫描结果可能不同，校正后缩略图缓存等
+     * 以大小和修改时间为键的数据才能命中。
+     * @param photos 照片列表
+     * @return 找到记录的照片数
+     */
+    int resolve(QVector<PhotoInfo> &photos);
+
+    /**
+     * @brief 删除所有记录
+     */
+    void clear();
+
+    /**
+     * @brief 设备数据库文件路径（%appdata%/iPhonLinkC/catalog/<UDID>.sqlite）
+     */
+    static QString databasePath(const QString &udid);
+
+    /**
+     * @brief 文件所属相册路径（/DCIM/100APPLE/IMG_0001.JPG -> /DCIM/100APPLE）
+     */
+    static QString albumOf(const QString &directory);
+
+private:
+    /**
+     * @brief 创建表和索引
+     */
+    bool createSchema();
+
+    QString m_connectionName;   ///< 本实例的连接名
+    QSqlDatabase m_db;          ///< 数据库连接
+    bool m_open;                ///< 是否可用
+};
+
+#endif // PHOTOCATALOG_H
@@ -0,0 +1,294 @@
+/**
+ * @file photoexporter.cpp
+ * @brief 照片批量导出引擎实现
+ */
+
+#include "photoexporter.h"
+#include "photoscanner.h"
+#include "core/device/devicesession.h"
+#include "platform/libimobiledevice_dynamic.h"
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrent>
+#include <atomic>
+
+// 进度回调的最小间隔（毫秒）
+static const int PROGRESS_INTERVAL_MS = 250;
+
+// 导出中的文件先写入带此后缀的临时文件，完整写入后再改名
+static const char *PART_SUFFIX = ".part";
+
+PhotoExporter::PhotoExporter(const QString &udid, int connections)
+    : m_udid(udid)
+    , m_connections(qMax(1, connections))
+{
+}
+
+PhotoExporter::Result PhotoExporter::run(const QVector<Job> &jobs, const ProgressCallback &onProgress)
+{
+    Result result;
+    QElapsedTimer timer;
+    timer.start();
+
+    QString sessionError;
+    DeviceSession::Ptr session = DeviceSession::acquire(m_udid, &sessionError);
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!session || !loader.afc_file_open || !loader.afc_file_read || !loader.afc_file_close) {
+        result.failed = jobs.size();
+        result.lastError = session ? QString("AFC 文件操作函数不可用") : sessionError;
+        return result;
+    }
+
+    std::atomic<qint64> bytesTotal(0);
+    for (const Job &job : jobs) {
+        bytesTotal += job.photo.size;
+    }
+
+    std::atomic<int> nextJob(0);
+    std::atomic<qint64> bytesDone(0);
+    std::atomic<bool> stopped(false);
+    QAtomicInt workers = 0;
+
+    // 保护 result、filesDone 和进度回调（回调串行调用）
+    QMutex mutex;
+    int filesDone = 0;
+    QElapsedTimer sinceReport;
+    sinceReport.start();
+
+    // 调用时须持有 mutex
+    auto report = [&](bool force) {
+        if (!onProgress || stopped.load()) {
+            return;
+        }
+        if (!force && sinceReport.elapsed() < PROGRESS_INTERVAL_MS) {
+            return;
+        }
+        sinceReport.restart();
+
+        Progress progress;
+        progress.filesDone = filesDone;
+        progress.filesTotal = jobs.size();
+        progress.bytesDone = bytesDone.load();
+        progress.bytesTotal = bytesTotal.load();
+        const qint64 elapsed = timer.elapsed();
+        if (elapsed > 0 && progress.bytesDone > 0) {
+            progress.bytesPerSecond = progress.bytesDone * 1000.0 / elapsed;
+            const qint64 remaining = qMax<qint64>(0, progress.bytesTotal - progress.bytesDone);
+            progress.etaMs = static_cast<qint64>(remaining * 1000.0 / progress.bytesPerSecond);
+        }
+        if (!onProgress(progress)) {
+            stopped = true;
+        }
+    };
+
+    auto worker = [&]() {
+        QString clientError;
+        afc_client_t afcClient = session->createAfcClient(&clientError);
+        if (!afcClient) {
+            QMutexLocker locker(&mutex);
+            if (result.lastError.isEmpty()) {
+                result.lastError = clientError;
+            }
+            return;
+        }
+        workers.ref();
+
+        // 每个连接只有一个块缓冲区，内存占用与文件大小无关
+        QByteArray buffer(CHUNK_SIZE, Qt::Uninitialized);
+
+        while (!stopped.load()) {
+            const int index = nextJob.fetch_add(1);
+            if (index >= jobs.size()) {
+                break;
+            }
+            const Job &job = jobs.at(index);
+
+            if (m_skipExisting) {
+                const QFileInfo localInfo(job.localPath);
+                if (localInfo.exists() && localInfo.size() == job.photo.size) {
+                    bytesTotal -= job.photo.size;
+                    QMutexLocker locker(&mutex);
+                    ++result.skipped;
+                    ++filesDone;
+                    report(false);
+                    continue;
+                }
+            }
+
+            qint64 written = 0;
+            QString error;
+            const bool ok = pullFile(afcClient, job.photo, job.localPath, buffer.data(), buffer.size(),
+                [&](qint64 chunk) {
+                    written += chunk;
+                    bytesDone += chunk;
+                    // 其他连接正在回调时不等待，下一块再报告
+                    if (mutex.tryLock()) {
+                        report(false);
+                        mutex.unlock();
+                    }
+                    return !stopped.load();
+                }, &error);
+
+            QMutexLocker locker(&mutex);
+            ++filesDone;
+            if (ok) {
+                ++result.exported;
+                result.bytes += written;
+            } else {
+                // 未完成的文件不计入已传输量
+                bytesDone -= written;
+                if (!stopped.load()) {
+                    ++result.failed;
+                    result.lastError = error;
+                    qWarning() << "PhotoExporter: 导出失败" << job.photo.path << error;
+                }
+            }
+            report(false);
+        }
+
+        if (loader.afc_client_free) {
+            loader.afc_client_free(afcClient);
+        }
+    };
+
+    // 调用线程本身也作为一个导出线程，其余连接在临时线程池中运行
+    QThreadPool pool;
+    pool.setMaxThreadCount(m_connections - 1);
+    for (int i = 1; i < m_connections; ++i) {
+        QtConcurrent::run(&pool, worker);
+    }
+    worker();
+    pool.waitForDone();
+
+    QMutexLocker locker(&mutex);
+    if (workers.loadRelaxed() == 0) {
+        // 一个连接也没有建立，所有任务都未执行
+        result.failed = jobs.size();
+    }
+    result.canceled = stopped.load();
+    report(true);
+    result.elapsedMs = timer.elapsed();
+
+    const double seconds = qMax<qint64>(1, result.elapsedMs) / 1000.0;
+    qDebug() << "[性能] PhotoExporter 导出" << m_udid << (result.canceled ? "(已取消)" : "")
+             << "连接数:" << workers.loadRelaxed() << "成功:" << result.exported << "失败:" << result.failed
+             << "跳过:" << result.skipped << "大小:" << result.bytes / (1024 * 1024) << "MB,"
+             << "速度:" << QString::number(result.bytes / seconds / (1024 * 1024), 'f', 1) << "MB/s,"
+             << "耗时:" << result.elapsedMs << "ms";
+    return result;
+}
+
+QVector<PhotoExporter::Job> PhotoExporter::jobsForDirectory(const QVector<PhotoInfo> &photos, const QString &directory)
+{
+    const QDir dir(directory);
+
+    // 本批已分配的文件名（忽略大小写，Windows 和 macOS 的文件系统通常不区分大小写）
+    QSet<QString> reserved;
+    reserved.reserve(photos.size());
+
+    QVector<Job> jobs;
+    jobs.reserve(photos.size());
+    for (const PhotoInfo &photo : photos) {
+        // 文件已存在或与本批中的文件重名时自动重命名: name_1.jpg, name_2.jpg
+        const QFileInfo fi(photo.name);
+        QString name = photo.name;
+        int counter = 1;
+        while (reserved.contains(name.toLower()) || QFile::exists(dir.filePath(name))) {
+            name = QString("%1_%2.%3").arg(fi.baseName()).arg(counter++).arg(fi.suffix());
+        }
+        reserved.insert(name.toLower());
+
+        Job job;
+        job.photo = photo;
+        job.localPath = dir.filePath(name);
+        jobs.append(job);
+    }
+    return jobs;
+}
+
+bool PhotoExporter::pullFile(void *afcClient, const PhotoInfo &photo, const QString &localPath,
+                             char *buffer, qint64 bufferSize, const std::function<bool(qint64)> &onChunk,
+                             QString *error)
+{
+    auto fail = [error](const QString &message) {
+        if (error) {
+            *error = message;
+        }
+        return false;
+    };
+
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!afcClient || !loader.afc_file_open || !loader.afc_file_read || !loader.afc_file_close) {
+        return fail("AFC 文件操作函数不可用");
+    }
+    afc_client_t client = static_cast<afc_client_t>(afcClient);
+
+    // 扫描结果没有修改时间时（例如调用方只知道路径）重新查询
+    QDateTime modifiedTime = photo.modifiedTime;
+    if (!modifiedTime.isValid()) {
+        modifiedTime = PhotoScanner::statFile(afcClient, photo.path).modifiedTime;
+    }
+
+    uint64_t handle = 0;
+    if (loader.afc_file_open(client, photo.path.toUtf8().constData(), AFC_FOPEN_RDONLY, &handle) != AFC_E_SUCCESS) {
+        return fail(QString("无法打开文件: %1").arg(photo.path));
+    }
+
+    QDir().mkpath(QFileInfo(localPath).absolutePath());
+    const QString partPath = localPath + PART_SUFFIX;
+    QFile file(partPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        loader.afc_file_close(client, handle);
+        return fail(QString("无法创建目标文件: %1").arg(localPath));
+    }
+
+    // 一直读到文件末尾，不依赖扫描时记录的大小（文件可能在此期间变化）
+    QString message;
+    for (;;) {
+        uint32_t bytesRead = 0;
+        if (loader.afc_file_read(client, handle, buffer, static_cast<uint32_t>(bufferSize), &bytesRead) != AFC_E_SUCCESS) {
+            message = QString("读取文件失败: %1").arg(photo.path);
+            break;
+        }
+        if (bytesRead == 0) {
+            break;
+        }
+        if (file.write(buffer, bytesRead) != static_cast<qint64>(bytesRead)) {
+            message = QString("写入文件失败: %1").arg(localPath);
+            break;
+        }
+        if (onChunk && !onChunk(bytesRead)) {
+            message = "已取消";
+            break;
+        }
+    }
+    loader.afc_file_close(client, handle);
+    file.close();
+
+    if (!message.isEmpty()) {
+        QFile::remove(partPath);
+        return fail(message);
+    }
+
+    QFile::remove(localPath);
+    if (!QFile::rename(partPath, localPath)) {
+        QFile::remove(partPath);
+        return fail(QString("无法创建目标文件: %1").arg(localPath));
+    }
+
+    // 保留设备上的修改时间（setFileTime 需要打开的文件，追加模式不改动内容）
+    if (modifiedTime.isValid()) {
+        QFile target(localPath);
+        if (!target.open(QIODevice::Append) || !target.setFileTime(modifiedTime, QFileDevice::FileModificationTime)) {
+            qWarning() << "PhotoExporter: 无法设置修改时间" << localPath;
+        }
+    }
+    return true;
+}
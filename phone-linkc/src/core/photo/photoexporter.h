@@ -0,0 +1,131 @@
+/**
+ * @file photoexporter.h
+ * @brief 照片批量导出引擎头文件
+ *
+ * 单个 AFC 连接上的读取一问一答，逐个文件导出时 USB 链路大部分时间在等待往返。
+ * 导出引擎对同一设备打开多个 AFC 客户端，每个连接同时导出一个文件：
+ * 文件按块从 AFC 读出后直接写入磁盘，内存占用只有每个连接一个块缓冲区，与文件大小无关。
+ * 写完后将本地文件的修改时间设为设备上的 st_mtime。
+ */
+
+#ifndef PHOTOEXPORTER_H
+#define PHOTOEXPORTER_H
+
+#include <QString>
+#include <QVector>
+#include <functional>
+
+#include "photomanager.h"
+
+/**
+ * @brief 照片批量导出引擎
+ *
+ * 使用方法：
+ * @code
+ * PhotoExporter exporter(udid, 4);
+ * PhotoExporter::Result result = exporter.run(PhotoExporter::jobsForDirectory(photos, dir),
+ *     [](const PhotoExporter::Progress &progress) {
+ *         qDebug() << progress.bytesPerSecond << progress.etaMs;
+ *         return true;   // 返回 false 取消导出
+ *     });
+ * @endcode
+ */
+class PhotoExporter
+{
+public:
+    /// 默认 AFC 连接数（即同时导出的文件数）
+    static const int DEFAULT_CONNECTIONS = 4;
+
+    /// 每次 afc_file_read 读取并写入磁盘的块大小
+    static const qint64 CHUNK_SIZE = 1024 * 1024;
+
+    /**
+     * @brief 导出任务：设备上的照片和本地目标路径
+     */
+    struct Job {
+        PhotoInfo photo;        ///< 设备上的照片
+        QString localPath;      ///< 本地目标路径
+    };
+
+    /**
+     * @brief 导出进度（所有连接汇总）
+     */
+    struct Progress {
+        int filesDone = 0;          ///< 已完成的文件数（含失败和跳过）
+        int filesTotal = 0;         ///< 文件总数
+        qint64 bytesDone = 0;       ///< 已写入的字节数
+        qint64 bytesTotal = 0;      ///< 总字节数（按扫描时的文件大小）
+        double bytesPerSecond = 0;  ///< 平均速度
+        qint64 etaMs = -1;          ///< 预计剩余时间（毫秒），-1 表示未知
+    };
+
+    /**
+     * @brief 导出结果
+     */
+    struct Result {
+        int exported = 0;       ///< 成功导出的文件数
+        int failed = 0;         ///< 失败的文件数
+        int skipped = 0;        ///< 本地已存在且大小相同而跳过的文件数
+        qint64 bytes = 0;       ///< 写入的字节数
+        qint64 elapsedMs = 0;   ///< 耗时（毫秒）
+        bool canceled = false;  ///< 是否被取消
+        QString lastError;      ///< 最后一次错误
+    };
+
+    /**
+     * @brief 进度回调，在导出线程中串行调用（限频）；返回 false 时取消导出
+     */
+    using ProgressCallback = std::function<bool(const Progress &progress)>;
+
+    /**
+     * @param udid 设备 UDID（设备会话在 run() 中获取，与其他管理器共享）
+     * @param connections AFC 连接数，至少为 1
+     */
+    explicit PhotoExporter(const QString &udid, int connections = DEFAULT_CONNECTIONS);
+
+    /**
+     * @brief 本地已存在且大小相同的文件是否跳过（默认不跳过，目标路径由调用方保证不冲突）
+     */
+    void setSkipExisting(bool skip) { m_skipExisting = skip; }
+
+    /**
+     * @brief 执行导出（阻塞直到完成或被取消）
+     * @param jobs 导出任务
+     * @param onProgress 进度回调，可为空
+     * @return 导出结果
+     */
+    Result run(const QVector<Job> &jobs, const ProgressCallback &onProgress = ProgressCallback());
+
+    /**
+     * @brief 为导出到同一目录的照片分配不冲突的文件名
+     *
+     * 目录中已存在或本批中重名的文件依次改名为 name_1.ext、name_2.ext……
+     * @param photos 照片列表
+     * @param directory 本地目录
+     */
+    static QVector<Job> jobsForDirectory(const QVector<PhotoInfo> &photos, const QString &directory);
+
+    /**
+     * @brief 使用指定 AFC 客户端将一个文件按块写入本地
+     *
+     * 先写入 localPath.part，完整写入后改名并设置修改时间；失败或取消时删除临时文件。
+     * @param afcClient afc_client_t
+     * @param photo 设备上的照片（modifiedTime 无效时重新查询）
+     * @param localPath 本地目标路径
+     * @param buffer 块缓冲区
+     * @param bufferSize 缓冲区大小
+     * @param onChunk 每写入一块后调用，参数为块大小；返回 false 时中止
+     * @param error 错误信息（输出，可为空）
+     * @return 是否完整导出
+     */
+    static bool pullFile(void *afcClient, const PhotoInfo &photo, const QString &localPath,
+                         char *buffer, qint64 bufferSize, const std::function<bool(qint64)> &onChunk,
+                         QString *error = nullptr);
+
+private:
+    QString m_udid;                            ///< 设备 UDID
+    int m_connections;                         ///< AFC 连接数
+    bool m_skipExisting = false;               ///< 是否跳过本地已存在的文件
+};
+
+#endif // PHOTOEXPORTER_H
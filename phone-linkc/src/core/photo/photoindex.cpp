@@ -0,0 +1,188 @@
+/**
+ * @file photoindex.cpp
+ * @brief 紧凑的照片索引实现
+ */
+
+#include "photoindex.h"
+#include <limits>
+
+const qint64 PhotoIndex::INVALID_TIME = std::numeric_limits<qint64>::min();
+
+// 查找表的初始槽位数（2 的幂）
+static const int INITIAL_SLOTS = 64;
+
+namespace {
+
+/**
+ * @brief 拆分路径为目录和文件名，"/DCIM/100APPLE/IMG_0001.HEIC" -> "/DCIM/100APPLE", "IMG_0001.HEIC"
+ */
+void splitPath(const QString &path, QString &directory, QString &name)
+{
+    const int index = path.lastIndexOf('/');
+    directory = path.left(qMax(index, 0));
+    name = path.mid(index + 1);
+}
+
+} // namespace
+
+PhotoIndex::PhotoIndex()
+{
+}
+
+void PhotoIndex::reserve(int count)
+{
+    m_records.reserve(count);
+    // 文件名多为 IMG_0001.HEIC 这样的 12~13 字节
+    m_names.reserve(count * 13);
+}
+
+int PhotoIndex::append(const PhotoInfo &photo)
+{
+    QString directory;
+    QString name;
+    splitPath(photo.path, directory, name);
+
+    Record record;
+    record.size = photo.size;
+    record.mtime = photo.modifiedTime.isValid() ? photo.modifiedTime.toSecsSinceEpoch() : INVALID_TIME;
+    record.nameOffset = static_cast<quint32>(m_names.size());
+    record.directoryAndType = (static_cast<quint32>(internDirectory(directory)) << 1)
+                              | (photo.isVideo ? VIDEO_BIT : 0);
+
+    m_names.append(name.toUtf8());
+    m_records.append(record);
+
+    const int index = m_records.size() - 1;
+    insertSlot(index);
+    return index;
+}
+
+void PhotoIndex::append(const QVector<PhotoInfo> &photos)
+{
+    m_records.reserve(m_records.size() + photos.size());
+    for (const PhotoInfo &photo : photos) {
+        append(photo);
+    }
+}
+
+void PhotoIndex::clear()
+{
+    m_records.clear();
+    m_names.clear();
+    m_directories.clear();
+    m_directoryIds.clear();
+    m_slots.clear();
+}
+
+int PhotoIndex::indexOf(const QString &path) const
+{
+    if (m_slots.isEmpty()) {
+        return -1;
+    }
+
+    QString directory;
+    QString name;
+    splitPath(path, directory, name);
+
+    const auto directoryIt = m_directoryIds.constFind(directory);
+    if (directoryIt == m_directoryIds.constEnd()) {
+        return -1;
+    }
+    return m_slots.at(findSlot(directoryIt.value(), name.toUtf8()));
+}
+
+QString PhotoIndex::path(int index) const
+{
+    return m_directories.at(directoryId(index)) + '/' + name(index);
+}
+
+QString PhotoIndex::name(int index) const
+{
+    const Record &record = m_records.at(index);
+    const int end = index + 1 < m_records.size() ? m_records.at(index + 1).nameOffset : m_names.size();
+    return QString::fromUtf8(m_names.constData() + record.nameOffset, end - record.nameOffset);
+}
+
+QString PhotoIndex::directory(int index) const
+{
+    return m_directories.at(directoryId(index));
+}
+
+PhotoInfo PhotoIndex::photo(int index) const
+{
+    const Record &record = m_records.at(index);
+    PhotoInfo info;
+    info.name = name(index);
+    info.path = m_directories.at(directoryId(index)) + '/' + info.name;
+    info.size = record.size;
+    if (record.mtime != INVALID_TIME) {
+        info.modifiedTime = QDateTime::fromSecsSinceEpoch(record.mtime);
+    }
+    info.isVideo = record.directoryAndType & VIDEO_BIT;
+    return info;
+}
+
+qint64 PhotoIndex::memoryUsage() const
+{
+    qint64 bytes = static_cast<qint64>(m_records.capacity()) * sizeof(Record)
+                   + m_names.capacity()
+                   + static_cast<qint64>(m_slots.capacity()) * sizeof(int);
+    for (const QString &directory : m_directories) {
+        // 目录表和目录 ID 表共享同一份字符串
+        bytes += directory.capacity() * 2 + 64;
+    }
+    return bytes;
+}
+
+QByteArray PhotoIndex::nameBytes(int index) const
+{
+    const quint32 offset = m_records.at(index).nameOffset;
+    const int end = index + 1 < m_records.size() ? m_records.at(index + 1).nameOffset : m_names.size();
+    return QByteArray::fromRawData(m_names.constData() + offset, end - offset);
+}
+
+int PhotoIndex::internDirectory(const QString &directory)
+{
+    auto it = m_directoryIds.constFind(directory);
+    if (it != m_directoryIds.constEnd()) {
+        return it.value();
+    }
+    const int id = m_directories.size();
+    m_directories.append(directory);
+    m_directoryIds.insert(directory, id);
+    return id;
+}
+
+int PhotoIndex::findSlot(int directoryId, const QByteArray &name) const
+{
+    // 线性探测，槽位数为 2 的幂
+    const int mask = m_slots.size() - 1;
+    int slot = static_cast<int>(qHash(name, static_cast<size_t>(directoryId)) & mask);
+    while (true) {
+        const int index = m_slots.at(slot);
+        if (index < 0 || (this->directoryId(index) == directoryId && nameBytes(index) == name)) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+void PhotoIndex::insertSlot(int index)
+{
+    // 装载率保持在 1/2 以下
+    if (m_slots.isEmpty() || m_records.size() * 2 > m_slots.size()) {
+        int capacity = qMax(INITIAL_SLOTS, m_slots.size());
+        while (m_records.size() * 2 > capacity) {
+            capacity *= 2;
+        }
+        if (capacity != m_slots.size()) {
+            m_slots.fill(-1, capacity);
+            for (int i = 0; i < index; ++i) {
+                m_slots[findSlot(directoryId(i), nameBytes(i))] = i;
+            }
+        }
+    }
+
+    // 路径重复时新记录取代旧记录
+    m_slots[findSlot(directoryId(index), nameBytes(index))] = index;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file photoindex.h
+ * @brief 紧凑的照片索引头文件
+ *
+ * PhotoInfo 为每张照片保存完整路径和文件名两个 QString（UTF-16，各自带有堆分配）以及一个
+ * QDateTime，十万张照片时仅字符串就占用数十 MB。照片索引按列保存：目录表只保存一次目录路径，
+ * 每张照片一条定长记录（目录 ID、文件名在名称池中的偏移、大小、修改时间、类型位），
+ * 文件名以 UTF-8 连续存放在名称池中。每张照片约 40 字节，PhotoInfo 只在需要时临时生成。
+ */
+
+#ifndef PHOTOINDEX_H
+#define PHOTOINDEX_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "photomanager.h"
+
+/**
+ * @brief 按列存储的照片索引
+ *
+ * 记录只追加、不删除，记录号从 0 开始连续编号，调用方（如照片网格模型）保存记录号而不是
+ * PhotoInfo 的副本。按路径查找使用开放寻址的记录号表，不再为每张照片保存一份路径键。
+ *
+ * 使用方法：
+ * @code
+ * PhotoIndex index;
+ * index.append(photos);
+ * int record = index.indexOf("/DCIM/100APPLE/IMG_0001.HEIC");
+ * if (record >= 0) {
+ *     PhotoInfo info = index.photo(record);
+ * }
+ * @endcode
+ */
+class PhotoIndex
+{
+public:
+    PhotoIndex();
+
+    /**
+     * @brief 预留记录空间
+     * @param count 预计的照片数
+     */
+    void reserve(int count);
+
+    /**
+     * @brief 追加一张照片
+     *
+     * 路径已存在时同样追加，之后按路径查找返回新记录。
+     * @return 新记录的记录号
+     */
+    int append(const PhotoInfo &photo);
+
+    /**
+     * @brief 追加一批照片
+     */
+    void append(const QVector<PhotoInfo> &photos);
+
+    /**
+     * @brief 清空所有记录和目录
+     */
+    void clear();
+
+    /**
+     * @brief 记录数
+     */
+    int count() const { return m_records.size(); }
+
+    /**
+     * @brief 是否没有记录
+     */
+    bool isEmpty() const { return m_records.isEmpty(); }
+
+    /**
+     * @brief 根据路径查找记录号
+     * @return 记录号，不存在时返回 -1
+     */
+    int indexOf(const QString &path) const;
+
+    /**
+     * @brief 设备上的完整路径（临时拼接）
+     */
+    QString path(int index) const;
+
+    /**
+     * @brief 文件名
+     */
+    QString name(int index) const;
+
+    /**
+     * @brief 所在目录
+     */
+    QString directory(int index) const;
+
+    /**
+     * @brief 文件大小（字节）
+     */
+    qint64 fileSize(int index) const { return m_records.at(index).size; }
+
+    /**
+     * @brief 修改时间（秒级时间戳），未知时为 INVALID_TIME
+     */
+    qint64 modifiedSecs(int index) const { return m_records.at(index).mtime; }
+
+    /**
+     * @brief 是否为视频文件
+     */
+    bool isVideo(int index) const { return m_records.at(index).directoryAndType & VIDEO_BIT; }
+
+    /**
+     * @brief 生成记录对应的 PhotoInfo
+     */
+    PhotoInfo photo(int index) const;
+
+    /**
+     * @brief 目录数
+     */
+    int directoryCount() const { return m_directories.size(); }
+
+    /**
+     * @brief 索引占用的内存（字节，估算值）
+     */
+    qint64 memoryUsage() const;
+
+    /// 未知的修改时间
+    static const qint64 INVALID_TIME;
+
+private:
+    /**
+     * @brief 每张照片的定长记录
+     */
+    struct Record {
+        qint64 size;                ///< 文件大小（字节）
+        qint64 mtime;               ///< 修改时间（秒级时间戳）
+        quint32 nameOffset;         ///< 文件名在名称池中的偏移，长度由下一条记录的偏移得出
+        quint32 directoryAndType;   ///< 目录 ID 左移一位，最低位为视频标记
+    };
+
+    static const quint32 VIDEO_BIT = 1;
+
+    int directoryId(int index) const { return static_cast<int>(m_records.at(index).directoryAndType >> 1); }
+
+    /**
+     * @brief 文件名的 UTF-8 字节（不复制，引用名称池）
+     */
+    QByteArray nameBytes(int index) const;
+
+    /**
+     * @brief 目录 ID，不存在时新建
+     */
+    int internDirectory(const QString &directory);
+
+    /**
+     * @brief 在查找表中定位路径：返回已有记录的槽位，或应写入的空槽位
+     */
+    int findSlot(int directoryId, const QByteArray &name) const;
+
+    /**
+     * @brief 把记录写入查找表，装载率过高时先扩容
+     */
+    void insertSlot(int index);
+
+    QVector<Record> m_records;              ///< 照片记录
+    QByteArray m_names;                     ///< 名称池（UTF-8 文件名首尾相接）
+    QVector<QString> m_directories;         ///< 目录 ID -> 目录路径
+    QHash<QString, int> m_directoryIds;     ///< 目录路径 -> 目录 ID
+    QVector<int> m_slots;                   ///< 开放寻址表，槽位中为记录号，-1 为空
+};
+
+#endif // PHOTOINDEX_H
@@ -0,0 +1,537 @@
+/**
+ * @file photolibrary.cpp
+ * @brief 设备图库数据库读取实现
+ */
+
+#include "photolibrary.h"
+#include "photoexporter.h"
+#include "platform/libimobiledevice_dynamic.h"
+#include <QDebug>
+#include <QAtomicInt>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QSqlError>
+#include <QSqlQuery>
+
+const char *const PhotoLibrary::DEVICE_PATH = "/PhotoData/Photos.sqlite";
+const char *const PhotoLibrary::FAVORITES = "library:favorites";
+const char *const PhotoLibrary::SCREENSHOTS = "library:screenshots";
+const char *const PhotoLibrary::VIDEOS = "library:videos";
+const char *const PhotoLibrary::ALBUM_PREFIX = "library:album/";
+
+// 数据库主文件及 WAL 文件。-shm 只是 WAL 的共享内存索引，SQLite 打开时会按 WAL 重建，不必复制
+static const char *const DATABASE_SUFFIXES[] = { "", "-wal" };
+
+// 本地副本的文件名，以及记录设备上各文件大小和 st_mtime 的文件
+static const char *LOCAL_NAME = "Photos.sqlite";
+static const char *STAMPS_NAME = "stamps.json";
+
+// 快照目录前缀、正在写入的快照目录，以及记录当前快照目录名的文件
+static const char *SNAPSHOT_PREFIX = "snapshot-";
+static const char *STAGING_NAME = "staging";
+static const char *CURRENT_NAME = "current";
+
+// Core Data 时间戳以 2001-01-01 00:00:00 UTC 为起点
+static const qint64 CORE_DATA_EPOCH = 978307200;
+
+// 资源类型（ZKIND）和子类型（ZKINDSUBTYPE）、相簿类型（ZGENERICALBUM.ZKIND）
+static const int KIND_VIDEO = 1;
+static const int KIND_SUBTYPE_SCREENSHOT = 10;
+static const int ALBUM_KIND_USER = 2;
+
+namespace {
+
+/**
+ * @brief 设备上的文件状态
+ */
+struct DeviceStamp {
+    qint64 size = 0;
+    qint64 mtimeNs = 0;
+};
+
+/**
+ * @brief 查询设备文件的大小和 st_mtime（纳秒），一次往返
+ * @return 文件是否存在
+ */
+bool statDeviceFile(void *afcClient, const QString &path, DeviceStamp &stamp)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!afcClient || !loader.afc_get_file_info || !loader.afc_dictionary_free) {
+        return false;
+    }
+
+    char **file_info = nullptr;
+    if (loader.afc_get_file_info(static_cast<afc_client_t>(afcClient), path.toUtf8().constData(), &file_info) != AFC_E_SUCCESS
+        || !file_info) {
+        return false;
+    }
+    for (int i = 0; file_info[i] && file_info[i + 1]; i += 2) {
+        const QString key = QString::fromUtf8(file_info[i]);
+        if (key == "st_size") {
+            stamp.size = QString::fromUtf8(file_info[i + 1]).toLongLong();
+        } else if (key == "st_mtime") {
+            stamp.mtimeNs = QString::fromUtf8(file_info[i + 1]).toLongLong();
+        }
+    }
+    loader.afc_dictionary_free(file_info);
+    return true;
+}
+
+/**
+ * @brief 读取上次同步记录的文件状态（JSON 数值为双精度，纳秒时间戳按字符串保存）
+ */
+QJsonObject readStamps(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QJsonObject();
+    }
+    return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+bool writeStamps(const QString &path, const QJsonObject &stamps)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        && file.write(QJsonDocument(stamps).toJson(QJsonDocument::Compact)) >= 0;
+}
+
+/**
+ * @brief 当前快照目录，没有同步过时为空
+ */
+QString currentSnapshot(const QDir &dir)
+{
+    QFile file(dir.filePath(CURRENT_NAME));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    const QString name = QString::fromUtf8(file.readAll()).trimmed();
+    return name.startsWith(QLatin1String(SNAPSHOT_PREFIX)) && dir.exists(name) ? dir.filePath(name) : QString();
+}
+
+/**
+ * @brief 原子地切换当前快照（写临时文件后改名）
+ */
+bool publishSnapshot(const QDir &dir, const QString &name)
+{
+    QSaveFile file(dir.filePath(CURRENT_NAME));
+    return file.open(QIODevice::WriteOnly) && file.write(name.toUtf8()) >= 0 && file.commit();
+}
+
+QStringList columnsOf(const QSqlDatabase &db, const QString &table)
+{
+    QStringList columns;
+    QSqlQuery query(db);
+    if (query.exec(QString("PRAGMA table_info(%1)").arg(table))) {
+        while (query.next()) {
+            columns << query.value(1).toString();
+        }
+    }
+    return columns;
+}
+
+} // namespace
+
+PhotoLibrary::PhotoLibrary(const QString &udid)
+    : m_udid(udid)
+    , m_open(false)
+    , m_hasTrashedState(false)
+    , m_hasHidden(false)
+    , m_hasFileSize(false)
+{
+    static QAtomicInt connectionCounter;
+    m_connectionName = QString("PhotoLibrary-%1-%2").arg(udid).arg(connectionCounter.fetchAndAddRelaxed(1));
+
+    // 之前同步过的副本可直接查询
+    open();
+}
+
+PhotoLibrary::~PhotoLibrary()
+{
+    close();
+}
+
+QString PhotoLibrary::cacheDirectory(const QString &udid)
+{
+    // 使用 %appdata%/iPhonLinkC/library/<UDID>/ 目录
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation)
+        + QString("/iPhonLinkC/library/%1").arg(udid);
+}
+
+bool PhotoLibrary::isLibraryAlbum(const QString &path)
+{
+    return path.startsWith("library:");
+}
+
+bool PhotoLibrary::sync(void *afcClient, bool *changed, QString *error, const std::atomic<bool> *canceled)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // 主文件与 WAL 必须来自同一时刻：有变化时在暂存目录中组装一套完整的文件，全部成功后
+    // 才切换当前快照。已发布的快照不再修改，其他连接（如界面线程的相簿查询）可同时读取
+    close();
+    if (changed) {
+        *changed = false;
+    }
+
+    QDir dir(cacheDirectory(m_udid));
+    QDir().mkpath(dir.absolutePath());
+    const QString current = currentSnapshot(dir);
+    const QJsonObject stamps = current.isEmpty() ? QJsonObject() : readStamps(QDir(current).filePath(STAMPS_NAME));
+
+    DeviceStamp devices[2];
+    bool present[2] = { false, false };
+    bool stale = current.isEmpty();
+    for (int i = 0; i < 2; ++i) {
+        const QString name = QString::fromLatin1(LOCAL_NAME) + DATABASE_SUFFIXES[i];
+        present[i] = statDeviceFile(afcClient, QString::fromLatin1(DEVICE_PATH) + DATABASE_SUFFIXES[i], devices[i]);
+        if (!present[i]) {
+            // 设备已合并并删除了 WAL 时，本地的旧 WAL 不能再与新的主文件一起使用
+            stale = stale || stamps.contains(name);
+            continue;
+        }
+        const QJsonObject stamp = stamps.value(name).toObject();
+        stale = stale || stamp.value("size").toString().toLongLong() != devices[i].size
+                || stamp.value("mtime").toString().toLongLong() != devices[i].mtimeNs;
+    }
+
+    QString message;
+    int copied = 0;
+    qint64 bytes = 0;
+    if (!present[0]) {
+        message = "设备上没有图库数据库";
+    } else if (stale) {
+        const QString stagingPath = dir.filePath(STAGING_NAME);
+        QDir(stagingPath).removeRecursively();
+        QDir().mkpath(stagingPath);
+        const QDir staging(stagingPath);
+
+        QByteArray buffer(PhotoExporter::CHUNK_SIZE, Qt::Uninitialized);
+        QJsonObject updated;
+        for (int i = 0; i < 2 && message.isEmpty(); ++i) {
+            if (!present[i]) {
+                continue;
+            }
+            const QString name = QString::fromLatin1(LOCAL_NAME) + DATABASE_SUFFIXES[i];
+            const QString localPath = staging.filePath(name);
+            const QJsonObject stamp = stamps.value(name).toObject();
+            const bool unchanged = !current.isEmpty()
+                && stamp.value("size").toString().toLongLong() == devices[i].size
+                && stamp.value("mtime").toString().toLongLong() == devices[i].mtimeNs;
+
+            if (unchanged) {
+                // 未变化的文件从当前快照复制（本地复制远快于经 AFC 传输）
+                if (!QFile::copy(QDir(current).filePath(name), localPath)) {
+                    message = QString("无法复制本地文件: %1").arg(name);
+                }
+            } else {
+                PhotoInfo file;
+                file.path = QString::fromLatin1(DEVICE_PATH) + DATABASE_SUFFIXES[i];
+                file.size = devices[i].size;
+                file.modifiedTime = QDateTime::fromSecsSinceEpoch(devices[i].mtimeNs / 1000000000LL);
+                // Photos.sqlite 常有数百 MB，断开设备时要能在块之间中止
+                auto onChunk = [canceled](qint64) {
+                    return !canceled || !canceled->load();
+                };
+                if (PhotoExporter::pullFile(afcClient, file, localPath, buffer.data(), buffer.size(),
+                                            onChunk, &message)) {
+                    ++copied;
+                    bytes += devices[i].size;
+                }
+            }
+
+            QJsonObject entry;
+            entry.insert("size", QString::number(devices[i].size));
+            entry.insert("mtime", QString::number(devices[i].mtimeNs));
+            updated.insert(name, entry);
+        }
+
+        // 全部成功后改名为新快照并切换；任一步失败时丢弃暂存目录，仍使用上一个完整快照
+        const QString snapshotName = QString::fromLatin1(SNAPSHOT_PREFIX)
+            + QString::number(QDateTime::currentMSecsSinceEpoch());
+        if (message.isEmpty() && !writeStamps(staging.filePath(STAMPS_NAME), updated)) {
+            message = "无法保存同步记录";
+        }
+        if (message.isEmpty() && !dir.rename(STAGING_NAME, snapshotName)) {
+            message = "无法保存图库副本";
+        }
+        if (message.isEmpty() && !publishSnapshot(dir, snapshotName)) {
+            message = "无法切换图库副本";
+            QDir(dir.filePath(snapshotName)).removeRecursively();
+        }
+        if (!message.isEmpty()) {
+            QDir(stagingPath).removeRecursively();
+        } else {
+            if (changed) {
+                *changed = true;
+            }
+            // 旧快照可能仍被其他连接打开（Windows 上无法删除），删除失败时留到下次同步
+            const QStringList snapshots = dir.entryList(QStringList() << QString::fromLatin1(SNAPSHOT_PREFIX) + "*",
+                                                        QDir::Dirs | QDir::NoDotAndDotDot);
+            for (const QString &snapshot : snapshots) {
+                if (snapshot != snapshotName) {
+                    QDir(dir.filePath(snapshot)).removeRecursively();
+                }
+            }
+        }
+    }
+
+    const bool ok = open();
+    if (!message.isEmpty() || !ok) {
+        if (error) {
+            *error = !message.isEmpty() ? message : QString("无法识别图库数据库结构");
+        }
+    }
+
+    qDebug() << "[性能] PhotoLibrary 同步" << m_udid << "复制文件:" << copied
+             << "大小:" << bytes / 1024 << "KB, 耗时:" << timer.elapsed() << "ms";
+    return ok;
+}
+
+bool PhotoLibrary::open()
+{
+    const QString snapshot = currentSnapshot(QDir(cacheDirectory(m_udid)));
+    const QString path = QDir(snapshot).filePath(LOCAL_NAME);
+    if (snapshot.isEmpty() || !QFile::exists(path)) {
+        return false;
+    }
+
+    // 只读打开，不会把 WAL 合并进主文件，下次同步时未变化的主文件仍与设备一致
+    m_db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    m_db.setDatabaseName(path);
+    m_db.setConnectOptions("QSQLITE_OPEN_READONLY");
+    if (!m_db.open()) {
+        qWarning() << "PhotoLibrary: 无法打开图库数据库" << path << m_db.lastError().text();
+        return false;
+    }
+
+    m_open = detectSchema();
+    return m_open;
+}
+
+void PhotoLibrary::close()
+{
+    if (!m_db.isValid()) {
+        return;
+    }
+    m_open = false;
+    m_db.close();
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+bool PhotoLibrary::detectSchema()
+{
+    QSqlQuery query(m_db);
+    if (!query.exec("SELECT name FROM sqlite_master WHERE type = 'table'")) {
+        qWarning() << "PhotoLibrary: 读取表结构失败" << query.lastError().text();
+        return false;
+    }
+    QStringList tables;
+    while (query.next()) {
+        tables << query.value(0).toString();
+    }
+
+    m_assetTable = tables.contains("ZASSET") ? QString("ZASSET")
+                 : tables.contains("ZGENERICASSET") ? QString("ZGENERICASSET") : QString();
+    if (m_assetTable.isEmpty()) {
+        qWarning() << "PhotoLibrary: 未找到资源表";
+        return false;
+    }
+
+    const QStringList assetColumns = columnsOf(m_db, m_assetTable);
+    const char *required[] = {
+        "Z_PK", "ZDIRECTORY", "ZFILENAME", "ZKIND", "ZKINDSUBTYPE", "ZFAVORITE", "ZDATECREATED", "ZMODIFICATIONDATE"
+    };
+    for (const char *column : required) {
+        if (!assetColumns.contains(QLatin1String(column))) {
+            qWarning() << "PhotoLibrary: 资源表缺少列" << column;
+            return false;
+        }
+    }
+    m_hasTrashedState = assetColumns.contains("ZTRASHEDSTATE");
+    m_hasHidden = assetColumns.contains("ZHIDDEN");
+    m_hasFileSize = tables.contains("ZADDITIONALASSETATTRIBUTES")
+        && columnsOf(m_db, "ZADDITIONALASSETATTRIBUTES").contains("ZORIGINALFILESIZE");
+
+    // 相簿与资源的多对多关联表名随 Core Data 实体编号变化，如 Z_26ASSETS(Z_26ALBUMS, Z_3ASSETS)
+    m_albumJoinTable.clear();
+    if (tables.contains("ZGENERICALBUM")) {
+        static const QRegularExpression joinTable("^Z_\\d+ASSETS$");
+        static const QRegularExpression albumColumn("^Z_\\d+ALBUMS$");
+        for (const QString &table : tables) {
+            if (!joinTable.match(table).hasMatch()) {
+                continue;
+            }
+            QString album;
+            QString asset;
+            for (const QString &column : columnsOf(m_db, table)) {
+                if (albumColumn.match(column).hasMatch()) {
+                    album = column;
+                } else if (joinTable.match(column).hasMatch()) {
+                    asset = column;
+                }
+            }
+            if (!album.isEmpty() && !asset.isEmpty()) {
+                m_albumJoinTable = table;
+                m_albumJoinAlbum = album;
+                m_albumJoinAsset = asset;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+QString PhotoLibrary::assetFilter(const QString &alias) const
+{
+    // 只有 DCIM 中的资源可以通过 AFC 读取（iCloud 资源位于 PhotoData 下的其他目录）
+    QString filter = QString("%1.ZDIRECTORY LIKE 'DCIM/%'").arg(alias);
+    if (m_hasTrashedState) {
+        filter += QString(" AND %1.ZTRASHEDSTATE = 0").arg(alias);
+    }
+    if (m_hasHidden) {
+        filter += QString(" AND %1.ZHIDDEN = 0").arg(alias);
+    }
+    return filter;
+}
+
+QVector<AlbumInfo> PhotoLibrary::albums()
+{
+    QVector<AlbumInfo> albums;
+    if (!m_open) {
+        return albums;
+    }
+
+    struct SmartAlbum {
+        const char *key;
+        const char *name;
+        QString condition;
+    };
+    const SmartAlbum smartAlbums[] = {
+        { FAVORITES, "个人收藏", QString("a.ZFAVORITE = 1") },
+        { SCREENSHOTS, "截屏", QString("a.ZKINDSUBTYPE = %1").arg(KIND_SUBTYPE_SCREENSHOT) },
+        { VIDEOS, "视频", QString("a.ZKIND = %1").arg(KIND_VIDEO) },
+    };
+    for (const SmartAlbum &smart : smartAlbums) {
+        const int count = countPhotos(smart.condition);
+        if (count > 0) {
+            AlbumInfo album;
+            album.path = QString::fromLatin1(smart.key);
+            album.name = QString::fromUtf8(smart.name);
+            album.photoCount = count;
+            albums.append(album);
+        }
+    }
+
+    if (m_albumJoinTable.isEmpty()) {
+        return albums;
+    }
+
+    QString albumFilter = QString("g.ZKIND = %1 AND g.ZTITLE IS NOT NULL").arg(ALBUM_KIND_USER);
+    if (columnsOf(m_db, "ZGENERICALBUM").contains("ZTRASHEDSTATE")) {
+        albumFilter += " AND g.ZTRASHEDSTATE = 0";
+    }
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    const QString sql = QString("SELECT g.Z_PK, g.ZTITLE, COUNT(*) FROM ZGENERICALBUM g"
+                                " JOIN %1 j ON j.%2 = g.Z_PK"
+                                " JOIN %3 a ON a.Z_PK = j.%4"
+                                " WHERE %5 AND %6"
+                                " GROUP BY g.Z_PK ORDER BY g.ZTITLE")
+        .arg(m_albumJoinTable, m_albumJoinAlbum, m_assetTable, m_albumJoinAsset, albumFilter, assetFilter("a"));
+    if (!query.exec(sql)) {
+        qWarning() << "PhotoLibrary: 读取相簿失败" << query.lastError().text();
+        return albums;
+    }
+    while (query.next()) {
+        AlbumInfo album;
+        album.path = QString::fromLatin1(ALBUM_PREFIX) + query.value(0).toString();
+        album.name = query.value(1).toString();
+        album.photoCount = query.value(2).toInt();
+        albums.append(album);
+    }
+    return albums;
+}
+
+QVector<PhotoInfo> PhotoLibrary::photos(const QString &albumKey)
+{
+    if (!m_open) {
+        return QVector<PhotoInfo>();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QVector<PhotoInfo> result;
+    if (albumKey == QLatin1String(FAVORITES)) {
+        result = queryPhotos(QString(), "a.ZFAVORITE = 1");
+    } else if (albumKey == QLatin1String(SCREENSHOTS)) {
+        result = queryPhotos(QString(), QString("a.ZKINDSUBTYPE = %1").arg(KIND_SUBTYPE_SCREENSHOT));
+    } else if (albumKey == QLatin1String(VIDEOS)) {
+        result = queryPhotos(QString(), QString("a.ZKIND = %1").arg(KIND_VIDEO));
+    } else if (albumKey.startsWith(QLatin1String(ALBUM_PREFIX)) && !m_albumJoinTable.isEmpty()) {
+        bool ok = false;
+        const qint64 albumId = albumKey.mid(QString::fromLatin1(ALBUM_PREFIX).size()).toLongLong(&ok);
+        if (ok) {
+            result = queryPhotos(QString("JOIN %1 j ON j.%2 = a.Z_PK").arg(m_albumJoinTable, m_albumJoinAsset),
+                                 QString("j.%1 = %2").arg(m_albumJoinAlbum).arg(albumId));
+        }
+    }
+
+    qDebug() << "[性能] PhotoLibrary 查询" << albumKey << "照片:" << result.size()
+             << "耗时:" << timer.elapsed() << "ms";
+    return result;
+}
+
+QVector<PhotoInfo> PhotoLibrary::queryPhotos(const QString &join, const QString &condition)
+{
+    QVector<PhotoInfo> photos;
+
+    const QString sizeColumn = m_hasFileSize ? QString("COALESCE(x.ZORIGINALFILESIZE, 0)") : QString("0");
+    const QString sizeJoin = m_hasFileSize ? QString("LEFT JOIN ZADDITIONALASSETATTRIBUTES x ON x.ZASSET = a.Z_PK")
+                                           : QString();
+    const QString sql = QString("SELECT a.ZDIRECTORY, a.ZFILENAME, a.ZKIND, a.ZMODIFICATIONDATE, %1"
+                                " FROM %2 a %3 %4 WHERE %5 AND %6"
+                                " ORDER BY a.ZDATECREATED, a.Z_PK")
+        .arg(sizeColumn, m_assetTable, join, sizeJoin, assetFilter("a"), condition);
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    if (!query.exec(sql)) {
+        qWarning() << "PhotoLibrary: 查询照片失败" << query.lastError().text();
+        return photos;
+    }
+    while (query.next()) {
+        PhotoInfo info;
+        info.name = query.value(1).toString();
+        info.path = QString("/%1/%2").arg(query.value(0).toString(), info.name);
+        info.isVideo = query.value(2).toInt() == KIND_VIDEO;
+        if (!query.value(3).isNull()) {
+            info.modifiedTime = QDateTime::fromSecsSinceEpoch(CORE_DATA_EPOCH + query.value(3).toLongLong());
+        }
+        info.size = query.value(4).toLongLong();
+        photos.append(info);
+    }
+    return photos;
+}
+
+int PhotoLibrary::countPhotos(const QString &condition)
+{
+    QSqlQuery query(m_db);
+    const QString sql = QString("SELECT COUNT(*) FROM %1 a WHERE %2 AND %3")
+        .arg(m_assetTable, assetFilter("a"), condition);
+    if (!query.exec(sql) || !query.next()) {
+        qWarning() << "PhotoLibrary: 统计照片失败" << query.lastError().text();
+        return 0;
+    }
+    return query.value(0).toInt();
+}
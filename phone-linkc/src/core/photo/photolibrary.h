@@ -0,0 +1,158 @@
+/**
+ * @file photolibrary.h
+ * @brief 设备图库数据库读取头文件
+ *
+ * DCIM 下只有 100APPLE、101APPLE 这样的物理文件夹，用户相簿、个人收藏、截屏等
+ * 记录在设备的图库数据库 /PhotoData/Photos.sqlite 中。媒体 AFC 服务可以读取该文件，
+ * 这里把它连同 -wal 复制到本地缓存目录，以只读方式打开并查询（-shm 由 SQLite 按 WAL 重建）。
+ *
+ * 再次同步时先比较设备上两个文件的大小和 st_mtime，只重新传输有变化的文件；
+ * 图库未变化时一次同步只需两次 afc_get_file_info。相册切换只查询本地副本，不访问设备。
+ *
+ * 本地副本按快照保存：有变化时在暂存目录中组装主文件和 WAL，全部成功后才切换当前快照，
+ * 主文件与 WAL 始终来自同一次同步；已发布的快照不再修改，同步时其他连接可以继续读取。
+ */
+
+#ifndef PHOTOLIBRARY_H
+#define PHOTOLIBRARY_H
+
+#include <QString>
+#include <QVector>
+#include <QSqlDatabase>
+#include <atomic>
+
+#include "photomanager.h"
+
+/**
+ * @brief 单台设备的图库数据库本地副本
+ *
+ * 与 PhotoCatalog 相同，每个实例打开独立的数据库连接，只在创建它的线程中使用。
+ * 相册以 AlbumInfo::path 中的键区分：智能相簿为固定键，用户相簿为 ALBUM_PREFIX 加相簿 ID。
+ *
+ * 使用方法：
+ * @code
+ * PhotoLibrary library(udid);
+ * if (library.sync(afcClient)) {
+ *     for (const AlbumInfo &album : library.albums()) {
+ *         QVector<PhotoInfo> photos = library.photos(album.path);
+ *     }
+ * }
+ * @endcode
+ */
+class PhotoLibrary
+{
+public:
+    /// 设备上的图库数据库路径
+    static const char *const DEVICE_PATH;
+
+    /// 智能相簿：个人收藏
+    static const char *const FAVORITES;
+
+    /// 智能相簿：截屏
+    static const char *const SCREENSHOTS;
+
+    /// 智能相簿：视频
+    static const char *const VIDEOS;
+
+    /// 用户相簿键的前缀，后接相簿在数据库中的 ID
+    static const char *const ALBUM_PREFIX;
+
+    explicit PhotoLibrary(const QString &udid);
+    ~PhotoLibrary();
+
+    PhotoLibrary(const PhotoLibrary &) = delete;
+    PhotoLibrary &operator=(const PhotoLibrary &) = delete;
+
+    /**
+     * @brief 本地副本是否已打开且能识别其结构
+     */
+    bool isOpen() const { return m_open; }
+
+    /**
+     * @brief 与设备上的图库数据库同步
+     *
+     * 设备上大小或 st_mtime 变化的文件按块传输，未变化的从当前快照复制，组成新快照后切换；
+     * 设备上已不存在的 -wal 不进入新快照。中途失败或取消时仍使用上一个完整快照。
+     * @param afcClient AFC 客户端（afc_client_t）
+     * @param changed 是否复制了文件（输出，可为空）
+     * @param error 错误信息（输出，可为空）
+     * @param canceled 取消标志（可为空），每传输一块检查一次
+     * @return 同步后本地副本是否可用
+     */
+    bool sync(void *afcClient, bool *changed = nullptr, QString *error = nullptr,
+              const std::atomic<bool> *canceled = nullptr);
+
+    /**
+     * @brief 智能相簿（个人收藏、截屏、视频）和用户相簿，只包含 DCIM 中有文件的相簿
+     */
+    QVector<AlbumInfo> albums();
+
+    /**
+     * @brief 相簿中的照片（按拍摄时间排序）
+     *
+     * 大小取自数据库中记录的原始文件大小，修改时间为数据库中的修改时间，
+     * 与扫描得到的 st_mtime 可能不同，需要时由调用方用 PhotoCatalog::resolve 校正。
+     * @param albumKey 相簿键（AlbumInfo::path）
+     */
+    QVector<PhotoInfo> photos(const QString &albumKey);
+
+    /**
+     * @brief 相册路径是否为图库相簿键（而不是 DCIM 下的目录）
+     */
+    static bool isLibraryAlbum(const QString &path);
+
+    /**
+     * @brief 设备图库副本的本地目录（%appdata%/iPhonLinkC/library/<UDID>/，其中每个快照一个子目录）
+     */
+    static QString cacheDirectory(const QString &udid);
+
+private:
+    /**
+     * @brief 以只读方式打开本地副本并识别表结构
+     */
+    bool open();
+
+    /**
+     * @brief 关闭本地副本（复制文件前调用）
+     */
+    void close();
+
+    /**
+     * @brief 识别资源表、相簿关联表及可选列（不同 iOS 版本的表名和列名不同）
+     */
+    bool detectSchema();
+
+    /**
+     * @brief 资源的公共过滤条件：位于 DCIM、未删除、未隐藏
+     * @param alias 资源表别名
+     */
+    QString assetFilter(const QString &alias) const;
+
+    /**
+     * @brief 按条件查询资源
+     * @param join 额外的 JOIN 子句
+     * @param condition 额外的 WHERE 条件
+     */
+    QVector<PhotoInfo> queryPhotos(const QString &join, const QString &condition);
+
+    /**
+     * @brief 按条件统计资源数
+     */
+    int countPhotos(const QString &condition);
+
+    QString m_udid;                 ///< 设备 UDID
+    QString m_connectionName;       ///< 本实例的连接名
+    QSqlDatabase m_db;              ///< 数据库连接
+    bool m_open;                    ///< 是否可用
+
+    // 识别出的表结构
+    QString m_assetTable;           ///< 资源表（iOS 14 起为 ZASSET，之前为 ZGENERICASSET）
+    QString m_albumJoinTable;       ///< 相簿与资源的关联表（如 Z_26ASSETS）
+    QString m_albumJoinAlbum;       ///< 关联表中的相簿列（如 Z_26ALBUMS）
+    QString m_albumJoinAsset;       ///< 关联表中的资源列（如 Z_3ASSETS）
+    bool m_hasTrashedState;         ///< 资源表是否有 ZTRASHEDSTATE 列
+    bool m_hasHidden;               ///< 资源表是否有 ZHIDDEN 列
+    bool m_hasFileSize;             ///< 是否有 ZADDITIONALASSETATTRIBUTES.ZORIGINALFILESIZE
+};
+
+#endif // PHOTOLIBRARY_H
@@ -4,19 +4,110 @@
  */
 
 #include "photomanager.h"
+#include "photoscanner.h"
+#include "photocatalog.h"
+#include "photolibrary.h"
+#include "heifthumbnail.h"
+#include "core/device/devicesession.h"
 #include "platform/libimobiledevice_dynamic.h"
 #include <QDebug>
 #include <QFileInfo>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
 
 // DCIM 目录路径 - iOS 设备照片存储位置
 static const char* DCIM_PATH = "/DCIM";
 
+namespace {
+
+/**
+ * @brief 查询图库相簿中的照片，启用照片目录时按扫描记录校正大小和修改时间（可在任意线程调用）
+ */
+QVector<PhotoInfo> queryLibraryPhotos(const QString &udid, const QString &albumKey, bool useCatalog)
+{
+    PhotoLibrary library(udid);
+    QVector<PhotoInfo> photos = library.photos(albumKey);
+    if (useCatalog && !photos.isEmpty()) {
+        PhotoCatalog catalog(udid);
+        catalog.resolve(photos);
+    }
+    return photos;
+}
+
+/**
+ * @brief 扫描目录树
+ *
+ * 启用照片目录时先从本地数据库读取上次的目录状态，只重新读取 st_mtime 变化的目录；
+ * 扫描完整结束后把结果写回数据库。被回调中止的扫描不更新数据库。
+ */
+int scanLibrary(const std::shared_ptr<DeviceSession> &session, int connections, bool useCatalog,
+                const QString &rootPath, const PhotoScanner::BatchCallback &onBatch, QString *error)
+{
+    PhotoScanner scanner(session, connections);
+
+    std::unique_ptr<PhotoCatalog> catalog;
+    PhotoScanner::KnownDirectories known;
+    if (useCatalog) {
+        catalog.reset(new PhotoCatalog(session->udid()));
+        if (catalog->isOpen()) {
+            known = catalog->load(rootPath);
+            scanner.setKnownDirectories(&known);
+        } else {
+            catalog.reset();
+        }
+    }
+
+    QHash<QString, qint64> listedDirectories;
+    QHash<QString, QVector<PhotoInfo>> rescannedPhotos;
+    int reusedDirectories = 0;
+    bool stopped = false;
+    QString scanError;
+
+    const int total = scanner.scan(rootPath, [&](const PhotoScanner::Batch &batch) {
+        if (batch.directoryDone) {
+            listedDirectories.insert(batch.directory, batch.directoryMtimeNs);
+            if (batch.reused) {
+                ++reusedDirectories;
+            } else if (batch.directoryMtimeNs > 0) {
+                // 重新读取的目录即使没有照片也要记录，以清除数据库中的旧记录
+                rescannedPhotos[batch.directory];
+            }
+        }
+        if (!batch.reused && !batch.photos.isEmpty()) {
+            rescannedPhotos[batch.directory] += batch.photos;
+        }
+
+        if (!onBatch(batch)) {
+            stopped = true;
+            return false;
+        }
+        return true;
+    }, &scanError);
+
+    if (error) {
+        *error = scanError;
+    }
+
+    if (catalog && !stopped && scanError.isEmpty()) {
+        catalog->update(rootPath, listedDirectories, rescannedPhotos);
+        qDebug() << "[性能] PhotoManager 增量扫描" << rootPath << "目录:" << listedDirectories.size()
+                 << "未变化:" << reusedDirectories << "重新读取:" << rescannedPhotos.size();
+    }
+    return total;
+}
+
+} // namespace
+
 PhotoManager::PhotoManager(QObject *parent)
     : QObject(parent)
     , m_connected(false)
-    , m_device(nullptr)
-    , m_lockdown(nullptr)
     , m_afcClient(nullptr)
+    , m_scanConnections(PhotoScanner::DEFAULT_CONNECTIONS)
+    , m_catalogEnabled(true)
+    , m_scanGeneration(0)
+    , m_librarySyncCanceled(false)
+    , m_libraryQueryGeneration(0)
 {
 }
 
@@ -40,25 +131,12 @@ bool PhotoManager::connectToDevice(const QString &udid)
     
     m_udid = udid;
     
-    // 创建设备连接
-    idevice_t device = nullptr;
-    if (!loader.idevice_new || loader.idevice_new(&device, udid.toUtf8().constData()) != IDEVICE_E_SUCCESS) {
-        m_lastError = QString("无法连接到设备: %1").arg(udid);
+    // 获取共享的设备会话（同一设备的其他管理器已连接时无需再次握手）
+    m_session = DeviceSession::acquire(udid, &m_lastError);
+    if (!m_session) {
         emit errorOccurred(m_lastError);
         return false;
     }
-    m_device = device;
-    
-    // 创建 lockdown 客户端
-    lockdownd_client_t lockdown = nullptr;
-    if (!loader.lockdownd_client_new_with_handshake || 
-        loader.lockdownd_client_new_with_handshake(device, &lockdown, "phone-linkc-photo") != LOCKDOWN_E_SUCCESS) {
-        m_lastError = "无法创建 lockdown 客户端";
-        emit errorOccurred(m_lastError);
-        cleanup();
-        return false;
-    }
-    m_lockdown = lockdown;
     
     // 初始化 AFC 客户端
     if (!initAfcClient()) {
@@ -80,37 +158,8 @@ void PhotoManager::disconnect()
 
 bool PhotoManager::initAfcClient()
 {
-    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
-    
-    if (!loader.lockdownd_start_service || !loader.afc_client_new) {
-        m_lastError = "AFC 服务函数不可用";
-        emit errorOccurred(m_lastError);
-        return false;
-    }
-    
-    lockdownd_client_t lockdown = static_cast<lockdownd_client_t>(m_lockdown);
-    idevice_t device = static_cast<idevice_t>(m_device);
-    
-    // 启动 AFC 服务
-    lockdownd_service_descriptor_t service = nullptr;
-    lockdownd_error_t lockdown_ret = loader.lockdownd_start_service(lockdown, AFC_SERVICE_NAME, &service);
-    if (lockdown_ret != LOCKDOWN_E_SUCCESS || !service) {
-        m_lastError = QString("无法启动 AFC 服务，错误码: %1").arg(lockdown_ret);
-        emit errorOccurred(m_lastError);
-        return false;
-    }
-    
-    // 创建 AFC 客户端
-    afc_client_t afcClient = nullptr;
-    afc_error_t afc_ret = loader.afc_client_new(device, service, &afcClient);
-    
-    // 释放服务描述符
-    if (loader.lockdownd_service_descriptor_free && service) {
-        loader.lockdownd_service_descriptor_free(service);
-    }
-    
-    if (afc_ret != AFC_E_SUCCESS || !afcClient) {
-        m_lastError = QString("无法创建 AFC 客户端，错误码: %1").arg(afc_ret);
+    afc_client_t afcClient = m_session->createAfcClient(&m_lastError);
+    if (!afcClient) {
         emit errorOccurred(m_lastError);
         return false;
     }
@@ -122,6 +171,21 @@ bool PhotoManager::initAfcClient()
 
 void PhotoManager::cleanup()
 {
+    // 先停止后台扫描，它持有会话引用并会向本对象发信号
+    cancelPhotoScan();
+    for (QFuture<void> &future : m_scanFutures) {
+        future.waitForFinished();
+    }
+    m_scanFutures.clear();
+    // 图库同步在块之间检查取消标志，不必等整个数据库传输完成
+    m_librarySyncCanceled = true;
+    m_libraryFuture.waitForFinished();
+    ++m_libraryQueryGeneration;
+    for (QFuture<void> &future : m_libraryQueryFutures) {
+        future.waitForFinished();
+    }
+    m_libraryQueryFutures.clear();
+
     LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
     
     if (m_afcClient && loader.afc_client_free) {
@@ -129,15 +193,8 @@ void PhotoManager::cleanup()
         m_afcClient = nullptr;
     }
     
-    if (m_lockdown && loader.lockdownd_client_free) {
-        loader.lockdownd_client_free(static_cast<lockdownd_client_t>(m_lockdown));
-        m_lockdown = nullptr;
-    }
-    
-    if (m_device && loader.idevice_free) {
-        loader.idevice_free(static_cast<idevice_t>(m_device));
-        m_device = nullptr;
-    }
+    // 释放会话引用，最后一个持有者释放时关闭连接
+    m_session.reset();
 }
 
 QVector<AlbumInfo> PhotoManager::getAlbums()
@@ -176,9 +233,8 @@ QVector<AlbumInfo> PhotoManager::getAlbums()
         }
         
         // 检查是否是目录（相册通常是 100APPLE, 101APPLE 等格式）
-        // 注：iOS 系统相册的中文名称存储在 PhotoLibrary 数据库中，
-        // 通过 AFC 服务只能访问 DCIM 目录下的物理文件夹结构，
-        // 无法获取系统相册的元数据（如中文名称、智能相册等）
+        // 注：这里列出的是 DCIM 下的物理文件夹。系统相册的元数据（如中文名称、智能相册等）
+        // 存储在 /PhotoData 下的图库数据库中，预生成的缩略图在 /PhotoData/Thumbnails 下
         QString albumPath = QString("%1/%2").arg(DCIM_PATH, name);
         
         AlbumInfo album;
@@ -224,9 +280,7 @@ QVector<PhotoInfo> PhotoManager::getPhotos(const QString &albumPath)
     }
     
     QString path = albumPath.isEmpty() ? QString(DCIM_PATH) : albumPath;
-    scanDirectory(path, photos);
-    
-    return photos;
+    return collectPhotos(path);
 }
 
 QVector<PhotoInfo> PhotoManager::getAllPhotos()
@@ -238,110 +292,216 @@ QVector<PhotoInfo> PhotoManager::getAllPhotos()
         return photos;
     }
     
-    // 递归扫描整个 DCIM 目录
-    scanDirectory(DCIM_PATH, photos);
+    // 遍历整个 DCIM 目录
+    photos = collectPhotos(DCIM_PATH);
     
     qDebug() << "PhotoManager: 总共找到" << photos.size() << "个媒体文件";
     return photos;
 }
 
-void PhotoManager::scanDirectory(const QString &path, QVector<PhotoInfo> &photos)
+QVector<PhotoInfo> PhotoManager::collectPhotos(const QString &rootPath)
 {
-    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
-    if (!loader.afc_read_directory || !loader.afc_dictionary_free) {
-        return;
-    }
-    
-    afc_client_t afcClient = static_cast<afc_client_t>(m_afcClient);
+    QVector<PhotoInfo> photos;
+    QElapsedTimer timer;
+    timer.start();
     
-    // 读取目录内容
-    char **directory_info = nullptr;
-    afc_error_t ret = loader.afc_read_directory(afcClient, path.toUtf8().constData(), &directory_info);
+    scanLibrary(m_session, m_scanConnections, m_catalogEnabled, rootPath, [&photos](const PhotoScanner::Batch &batch) {
+        photos += batch.photos;
+        return true;
+    }, &m_lastError);
     
-    if (ret != AFC_E_SUCCESS || !directory_info) {
-        qDebug() << "PhotoManager: 无法读取目录" << path;
+    qDebug() << "[性能] PhotoManager 扫描" << rootPath << "连接数:" << m_scanConnections
+             << "文件:" << photos.size() << "耗时:" << timer.elapsed() << "ms";
+    return photos;
+}
+
+int PhotoManager::scanPhotosStreaming(const QString &rootPath)
+{
+    if (!m_connected || !m_session) {
+        m_lastError = "未连接到设备";
+        return 0;
+    }
+    return runPhotoScan(m_session, rootPath, ++m_scanGeneration, m_scanConnections, m_catalogEnabled);
+}
+
+quint64 PhotoManager::startPhotoScan(const QString &rootPath)
+{
+    // 递增 ID 的同时使之前的扫描失效
+    const quint64 scanId = ++m_scanGeneration;
+
+    if (!m_connected || !m_session) {
+        m_lastError = "未连接到设备";
+        emit photoScanFinished(scanId, 0, false);
+        return scanId;
+    }
+
+    // 之前的扫描已失效，但在结束前仍会访问本对象，全部保留到 cleanup() 中等待
+    m_scanFutures.erase(std::remove_if(m_scanFutures.begin(), m_scanFutures.end(),
+                                       [](const QFuture<void> &future) { return future.isFinished(); }),
+                        m_scanFutures.end());
+
+    // 会话和扫描参数在调用线程中取出，扫描期间修改设置只影响之后的扫描
+    std::shared_ptr<DeviceSession> session = m_session;
+    const int connections = m_scanConnections;
+    const bool useCatalog = m_catalogEnabled;
+    m_scanFutures.append(QtConcurrent::run([this, session, rootPath, scanId, connections, useCatalog]() {
+        runPhotoScan(session, rootPath, scanId, connections, useCatalog);
+    }));
+    return scanId;
+}
+
+void PhotoManager::cancelPhotoScan()
+{
+    ++m_scanGeneration;
+}
+
+void PhotoManager::startLibrarySync()
+{
+    if (!m_connected || !m_session) {
+        m_lastError = "未连接到设备";
+        emit libraryAlbumsReady(QVector<AlbumInfo>());
         return;
     }
-    
-    // 遍历目录项
-    for (int i = 0; directory_info[i]; i++) {
-        QString name = QString::fromUtf8(directory_info[i]);
-        
-        // 跳过 . 和 ..
-        if (name == "." || name == "..") {
-            continue;
-        }
-        
-        QString fullPath = QString("%1/%2").arg(path, name);
-        
-        // 检查是否为媒体文件
-        bool isVideo;
-        if (isMediaFile(name, isVideo)) {
-            PhotoInfo info = getFileInfo(fullPath);
-            info.name = name;
-            info.isVideo = isVideo;
-            photos.append(info);
-        } else {
-            // 可能是子目录，递归扫描
-            // 检查是否为目录
-            char **file_info = nullptr;
-            if (loader.afc_get_file_info && 
-                loader.afc_get_file_info(afcClient, fullPath.toUtf8().constData(), &file_info) == AFC_E_SUCCESS) {
-                
-                bool isDir = false;
-                for (int j = 0; file_info[j]; j += 2) {
-                    if (QString::fromUtf8(file_info[j]) == "st_ifmt" &&
-                        QString::fromUtf8(file_info[j + 1]) == "S_IFDIR") {
-                        isDir = true;
-                        break;
-                    }
-                }
-                loader.afc_dictionary_free(file_info);
-                
-                if (isDir) {
-                    scanDirectory(fullPath, photos);
-                }
+    // 进行中的同步结束时会发出信号
+    if (m_libraryFuture.isRunning()) {
+        return;
+    }
+
+    std::shared_ptr<DeviceSession> session = m_session;
+    m_librarySyncCanceled = false;
+    m_libraryFuture = QtConcurrent::run([this, session]() {
+        QElapsedTimer timer;
+        timer.start();
+
+        QString error;
+        QVector<AlbumInfo> albums;
+        bool changed = false;
+        afc_client_t afcClient = session->createAfcClient(&error);
+        if (afcClient) {
+            PhotoLibrary library(session->udid());
+            if (library.sync(afcClient, &changed, &error, &m_librarySyncCanceled) && !m_librarySyncCanceled.load()) {
+                albums = library.albums();
+            }
+            LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+            if (loader.afc_client_free) {
+                loader.afc_client_free(afcClient);
             }
         }
-    }
-    
-    loader.afc_dictionary_free(directory_info);
+
+        // 图库不可读时界面仍可按 DCIM 文件夹浏览，不作为错误上报
+        if (!error.isEmpty()) {
+            qDebug() << "PhotoManager: 无法读取图库数据库:" << error;
+        }
+        qDebug() << "[性能] PhotoManager 同步图库" << session->udid() << (changed ? "(已更新)" : "(未变化)")
+                 << "相簿:" << albums.size() << "耗时:" << timer.elapsed() << "ms";
+        emit libraryAlbumsReady(albums);
+    });
 }
 
-PhotoInfo PhotoManager::getFileInfo(const QString &path)
+QVector<PhotoInfo> PhotoManager::getLibraryPhotos(const QString &albumKey)
 {
-    PhotoInfo info;
-    info.path = path;
-    
-    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
-    if (!loader.afc_get_file_info || !loader.afc_dictionary_free) {
-        return info;
+    if (m_udid.isEmpty()) {
+        m_lastError = "未连接到设备";
+        return QVector<PhotoInfo>();
     }
-    
-    afc_client_t afcClient = static_cast<afc_client_t>(m_afcClient);
-    
-    char **file_info = nullptr;
-    if (loader.afc_get_file_info(afcClient, path.toUtf8().constData(), &file_info) != AFC_E_SUCCESS) {
-        return info;
+    return queryLibraryPhotos(m_udid, albumKey, m_catalogEnabled);
+}
+
+quint64 PhotoManager::startLibraryQuery(const QString &albumKey)
+{
+    const quint64 queryId = ++m_libraryQueryGeneration;
+
+    if (m_udid.isEmpty()) {
+        m_lastError = "未连接到设备";
+        // 与后台查询一致，在调用方拿到查询 ID 之后才发出
+        QMetaObject::invokeMethod(this, [this, queryId, albumKey]() {
+            emit libraryPhotosReady(queryId, albumKey, QVector<PhotoInfo>());
+        }, Qt::QueuedConnection);
+        return queryId;
     }
-    
-    // 解析文件信息
-    for (int i = 0; file_info[i]; i += 2) {
-        QString key = QString::fromUtf8(file_info[i]);
-        QString value = QString::fromUtf8(file_info[i + 1]);
-        
-        if (key == "st_size") {
-            info.size = value.toLongLong();
-        } else if (key == "st_mtime") {
-            // 时间戳（纳秒）
-            qint64 timestamp = value.toLongLong() / 1000000000LL;
-            info.modifiedTime = QDateTime::fromSecsSinceEpoch(timestamp);
+
+    m_libraryQueryFutures.erase(std::remove_if(m_libraryQueryFutures.begin(), m_libraryQueryFutures.end(),
+                                               [](const QFuture<void> &future) { return future.isFinished(); }),
+                                m_libraryQueryFutures.end());
+
+    // 打开数据库、识别表结构、查询和校正都在线程池中进行，参数在调用线程中取出
+    const QString udid = m_udid;
+    const bool useCatalog = m_catalogEnabled;
+    m_libraryQueryFutures.append(QtConcurrent::run([this, udid, albumKey, useCatalog, queryId]() {
+        QElapsedTimer timer;
+        timer.start();
+        const QVector<PhotoInfo> photos = queryLibraryPhotos(udid, albumKey, useCatalog);
+        if (m_libraryQueryGeneration.load() != queryId) {
+            return;
         }
+        qDebug() << "[性能] PhotoManager 查询图库相簿" << albumKey << "照片:" << photos.size()
+                 << "耗时:" << timer.elapsed() << "ms";
+        emit libraryPhotosReady(queryId, albumKey, photos);
+    }));
+    return queryId;
+}
+
+void PhotoManager::setScanConnections(int connections)
+{
+    m_scanConnections = qMax(1, connections);
+}
+
+void PhotoManager::setCatalogEnabled(bool enabled)
+{
+    m_catalogEnabled = enabled;
+}
+
+int PhotoManager::runPhotoScan(const std::shared_ptr<DeviceSession> &session, const QString &rootPath, quint64 scanId,
+                               int connections, bool useCatalog)
+{
+    QString root = rootPath.isEmpty() ? QString(DCIM_PATH) : rootPath;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    int total = 0;
+    int directories = 0;
+    qint64 firstBatchMs = -1;
+
+    // 回调在扫描线程中串行调用
+    QString error;
+    scanLibrary(session, connections, useCatalog, root, [&](const PhotoScanner::Batch &batch) {
+        if (m_scanGeneration.load() != scanId) {
+            return false;
+        }
+
+        if (batch.scannedDirectories != directories) {
+            directories = batch.scannedDirectories;
+            emit scanProgress(batch.scannedDirectories, batch.discoveredDirectories);
+        }
+
+        if (!batch.photos.isEmpty()) {
+            if (firstBatchMs < 0) {
+                firstBatchMs = timer.elapsed();
+            }
+            total += batch.photos.size();
+            emit photosBatchReady(scanId, batch.directory, batch.photos);
+        }
+        return true;
+    }, &error);
+
+    if (!error.isEmpty()) {
+        qWarning() << "PhotoManager: 扫描无法创建 AFC 客户端:" << error;
+        emit errorOccurred(error);
     }
-    
-    loader.afc_dictionary_free(file_info);
-    
-    return info;
+
+    const bool canceled = m_scanGeneration.load() != scanId;
+    qDebug() << "[性能] PhotoManager 流式扫描" << root << (canceled ? "(已取消)" : "")
+             << "连接数:" << connections << "目录:" << directories << "文件:" << total
+             << "首批:" << firstBatchMs << "ms, 总耗时:" << timer.elapsed() << "ms";
+
+    emit photoScanFinished(scanId, total, canceled);
+    return total;
+}
+
+PhotoInfo PhotoManager::getFileInfo(const QString &path)
+{
+    return PhotoScanner::statFile(m_afcClient, path);
 }
 
 QByteArray PhotoManager::readPhotoData(const QString &photoPath, qint64 maxSize)
@@ -398,6 +558,52 @@ QByteArray PhotoManager::readPhotoData(const QString &photoPath, qint64 maxSize)
     return data;
 }
 
+bool PhotoManager::hasDeviceThumbnails()
+{
+    if (!m_connected || !m_afcClient) {
+        m_lastError = "未连接到设备";
+        return false;
+    }
+    return DeviceThumbnail::isAvailable(m_afcClient);
+}
+
+DeviceThumbnail::Result PhotoManager::readDeviceThumbnail(const QString &photoPath, int minSize)
+{
+    if (!m_connected || !m_afcClient) {
+        m_lastError = "未连接到设备";
+        return DeviceThumbnail::Result();
+    }
+    return DeviceThumbnail::extract(m_afcClient, photoPath, minSize);
+}
+
+ExifThumbnail::Result PhotoManager::readEmbeddedThumbnail(const QString &photoPath, qint64 fileSize,
+                                                         bool readHevcItem)
+{
+    if (!m_connected || !m_afcClient) {
+        m_lastError = "未连接到设备";
+        return ExifThumbnail::Result();
+    }
+    if (HeifThumbnail::isSupported(photoPath)) {
+        return HeifThumbnail::extract(m_afcClient, photoPath, fileSize, readHevcItem);
+    }
+    return ExifThumbnail::extract(m_afcClient, photoPath, fileSize);
+}
+
+bool PhotoManager::hasEmbeddedThumbnail(const QString &photoPath)
+{
+    return ExifThumbnail::isSupported(photoPath) || HeifThumbnail::isSupported(photoPath);
+}
+
+VideoThumbnail::Result PhotoManager::readVideoThumbnail(const QString &videoPath, qint64 fileSize,
+                                                       bool readHevcFrame)
+{
+    if (!m_connected || !m_afcClient) {
+        m_lastError = "未连接到设备";
+        return VideoThumbnail::Result();
+    }
+    return VideoThumbnail::extract(m_afcClient, videoPath, fileSize, readHevcFrame);
+}
+
 bool PhotoManager::isMediaFile(const QString &filename, bool &isVideo)
 {
     // 获取文件扩展名
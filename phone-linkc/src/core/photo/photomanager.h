@@ -13,6 +13,15 @@
 #include <QStringList>
 #include <QDateTime>
 #include <QVector>
+#include <QFuture>
+#include <atomic>
+#include <memory>
+
+#include "exifthumbnail.h"
+#include "videothumbnail.h"
+#include "devicethumbnail.h"
+
+class DeviceSession;
 
 /**
  * @brief 照片信息结构体
@@ -89,6 +98,78 @@ public:
      */
     QVector<PhotoInfo> getAllPhotos();
 
+    /**
+     * @brief 流式扫描照片（同步，可在任意工作线程调用）
+     *
+     * 每读完一个目录或一组文件信息就发出 photosBatchReady，界面无需等待整个
+     * 图库扫描完成即可开始显示。扫描使用 scanConnections() 个独立的 AFC 客户端
+     * 并行进行，不会与 readPhotoData 等调用争用同一连接。
+     * @param rootPath 扫描根目录，空字符串表示整个 DCIM
+     * @return 找到的媒体文件数
+     */
+    int scanPhotosStreaming(const QString &rootPath = QString());
+
+    /**
+     * @brief 在后台线程启动流式扫描，并取消之前未完成的扫描
+     * @param rootPath 扫描根目录，空字符串表示整个 DCIM
+     * @return 本次扫描的 ID，随 photosBatchReady / photoScanFinished 一起发出
+     */
+    quint64 startPhotoScan(const QString &rootPath = QString());
+
+    /**
+     * @brief 取消正在进行的扫描（扫描线程在处理完当前目录项后退出）
+     */
+    void cancelPhotoScan();
+
+    /**
+     * @brief 设置扫描使用的 AFC 连接数（默认 PhotoScanner::DEFAULT_CONNECTIONS）
+     * @param connections 连接数，至少为 1
+     */
+    void setScanConnections(int connections);
+    int scanConnections() const { return m_scanConnections; }
+
+    /**
+     * @brief 设置是否使用本地照片目录（PhotoCatalog）进行增量扫描，默认启用
+     *
+     * 启用时只重新读取 st_mtime 变化的目录，其余目录的照片取自上次扫描保存的记录。
+     */
+    void setCatalogEnabled(bool enabled);
+    bool isCatalogEnabled() const { return m_catalogEnabled; }
+
+    /**
+     * @brief 在后台线程同步设备图库数据库，完成后发出 libraryAlbumsReady
+     *
+     * 数据库文件未变化时不重新复制；已有同步在进行时不重复启动。
+     */
+    void startLibrarySync();
+
+    /**
+     * @brief 查询图库相簿中的照片（同步，只查询本地副本，不访问设备）
+     *
+     * 启用照片目录时，大小和修改时间按扫描记录校正。
+     * 每次调用都要打开两个数据库并识别表结构，界面线程中应使用 startLibraryQuery()。
+     * @param albumKey 相簿键（libraryAlbumsReady 中 AlbumInfo::path）
+     * @return 照片信息列表
+     */
+    QVector<PhotoInfo> getLibraryPhotos(const QString &albumKey);
+
+    /**
+     * @brief 在后台线程查询图库相簿中的照片，完成后发出 libraryPhotosReady
+     *
+     * 新的查询使之前未完成的查询失效，失效的查询不发出信号。
+     * @param albumKey 相簿键
+     * @return 本次查询的 ID，随 libraryPhotosReady 一起发出
+     */
+    quint64 startLibraryQuery(const QString &albumKey);
+
+    /**
+     * @brief 判断是否为图片或视频文件
+     * @param filename 文件名
+     * @param isVideo 是否为视频（输出）
+     * @return 是否为媒体文件
+     */
+    static bool isMediaFile(const QString &filename, bool &isVideo);
+
     /**
      * @brief 读取照片缩略图数据
      * @param photoPath 照片路径
@@ -97,6 +178,46 @@ public:
      */
     QByteArray readPhotoData(const QString &photoPath, qint64 maxSize = 0);
 
+    /**
+     * @brief 设备上是否有系统预生成的缩略图目录（/PhotoData/Thumbnails/V2）
+     * @return 是否可用，不可用时 readDeviceThumbnail 总是返回空
+     */
+    bool hasDeviceThumbnails();
+
+    /**
+     * @brief 读取系统为该资源预生成的缩略图（照片和视频都有）
+     * @param photoPath 照片路径
+     * @param minSize 需要的最长边（像素）
+     * @return 读取结果，data 为空时需回退到 readEmbeddedThumbnail / readPhotoData
+     */
+    DeviceThumbnail::Result readDeviceThumbnail(const QString &photoPath, int minSize);
+
+    /**
+     * @brief 只读取文件中的元数据和缩略图范围，提取内嵌缩略图
+     * JPEG/RAW 为 EXIF IFD1 缩略图，HEIC/HEIF 为 iref 'thmb' 关联的缩略图项
+     * @param photoPath 照片路径
+     * @param fileSize 文件大小，未知时传 0
+     * @param readHevcItem 是否读取 HEIC 的 HEVC 缩略图项（没有 HEIF 插件时无法解码）
+     * @return 提取结果，data 为空时需回退到 readPhotoData
+     */
+    ExifThumbnail::Result readEmbeddedThumbnail(const QString &photoPath, qint64 fileSize = 0,
+                                                bool readHevcItem = true);
+
+    /**
+     * @brief 文件格式是否可能带有内嵌缩略图（按扩展名判断）
+     */
+    static bool hasEmbeddedThumbnail(const QString &photoPath);
+
+    /**
+     * @brief 只读取视频的 moov 盒和第一个关键帧，提取封面帧和时长
+     * @param videoPath 视频路径
+     * @param fileSize 文件大小，未知时传 0
+     * @param readHevcFrame 是否读取 HEVC 关键帧（没有 HEIF 插件时无法解码）
+     * @return 提取结果，data 为空时仍可能带有时长
+     */
+    VideoThumbnail::Result readVideoThumbnail(const QString &videoPath, qint64 fileSize = 0,
+                                              bool readHevcFrame = true);
+
     /**
      * @brief 获取最后的错误信息
      * @return 错误信息
@@ -106,11 +227,41 @@ public:
 signals:
     /**
      * @brief 扫描进度信号
-     * @param current 当前进度
-     * @param total 总数
+     * @param current 已扫描的目录数
+     * @param total 已发现的目录数（随扫描增长）
      */
     void scanProgress(int current, int total);
 
+    /**
+     * @brief 流式扫描产出一批照片
+     * @param scanId 扫描 ID
+     * @param directory 这批照片所在的目录
+     * @param photos 照片列表
+     */
+    void photosBatchReady(quint64 scanId, const QString &directory, const QVector<PhotoInfo> &photos);
+
+    /**
+     * @brief 流式扫描结束
+     * @param scanId 扫描 ID
+     * @param total 找到的媒体文件总数
+     * @param canceled 是否被取消
+     */
+    void photoScanFinished(quint64 scanId, int total, bool canceled);
+
+    /**
+     * @brief 图库数据库同步完成
+     * @param albums 智能相簿和用户相簿，设备图库不可读时为空
+     */
+    void libraryAlbumsReady(const QVector<AlbumInfo> &albums);
+
+    /**
+     * @brief 图库相簿查询完成
+     * @param queryId 查询 ID（startLibraryQuery 的返回值）
+     * @param albumKey 相簿键
+     * @param photos 照片列表
+     */
+    void libraryPhotosReady(quint64 queryId, const QString &albumKey, const QVector<PhotoInfo> &photos);
+
     /**
      * @brief 发生错误
      * @param error 错误信息
@@ -130,11 +281,17 @@ private:
     void cleanup();
 
     /**
-     * @brief 递归扫描目录获取照片
-     * @param path 目录路径
-     * @param photos 照片列表（输出）
+     * @brief 执行一次流式扫描并发出信号
+     *
+     * 在扫描线程中执行，不读取可变成员：连接数和是否使用照片目录由调用线程取出后传入。
+     */
+    int runPhotoScan(const std::shared_ptr<DeviceSession> &session, const QString &rootPath, quint64 scanId,
+                     int connections, bool useCatalog);
+
+    /**
+     * @brief 收集目录树中的所有照片（同步）
      */
-    void scanDirectory(const QString &path, QVector<PhotoInfo> &photos);
+    QVector<PhotoInfo> collectPhotos(const QString &rootPath);
 
     /**
      * @brief 获取文件信息
@@ -143,22 +300,22 @@ private:
      */
     PhotoInfo getFileInfo(const QString &path);
 
-    /**
-     * @brief 判断是否为图片或视频文件
-     * @param filename 文件名
-     * @param isVideo 是否为视频（输出）
-     * @return 是否为媒体文件
-     */
-    static bool isMediaFile(const QString &filename, bool &isVideo);
-
     QString m_udid;                 ///< 当前设备 UDID
     bool m_connected;               ///< 连接状态
     QString m_lastError;            ///< 最后的错误信息
     
     // libimobiledevice 句柄
-    void *m_device;                 ///< idevice_t
-    void *m_lockdown;               ///< lockdownd_client_t
+    std::shared_ptr<DeviceSession> m_session; ///< 共享的设备会话
     void *m_afcClient;              ///< afc_client_t
+
+    int m_scanConnections;          ///< 扫描使用的 AFC 连接数
+    bool m_catalogEnabled;          ///< 是否使用本地照片目录增量扫描
+    std::atomic<quint64> m_scanGeneration; ///< 当前扫描 ID，递增即取消之前的扫描
+    QVector<QFuture<void>> m_scanFutures; ///< 尚未结束的后台扫描任务（被取消的扫描可能仍阻塞在 AFC 请求中）
+    QFuture<void> m_libraryFuture;  ///< 后台图库同步任务
+    std::atomic<bool> m_librarySyncCanceled; ///< 取消图库同步（断开时设置，中止数据库传输）
+    std::atomic<quint64> m_libraryQueryGeneration; ///< 当前相簿查询 ID，递增即作废之前的查询
+    QVector<QFuture<void>> m_libraryQueryFutures;  ///< 尚未结束的后台相簿查询
 };
 
 #endif // PHOTOMANAGER_H
\ No newline at end of file
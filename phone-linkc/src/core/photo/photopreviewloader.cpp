@@ -0,0 +1,189 @@
+/**
+ * @file photopreviewloader.cpp
+ * @brief 全尺寸预览加载器实现
+ */
+
+#include "photopreviewloader.h"
+#include "exifthumbnail.h"
+#include "heifthumbnail.h"
+#include "scaleddecoder.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QImageReader>
+#include <QMetaObject>
+
+PhotoPreviewLoader::PhotoPreviewLoader(QObject *parent)
+    : QObject(parent)
+    , m_generation(0)
+    , m_maxWidth(0)
+    , m_maxHeight(0)
+{
+    // 单线程按顺序执行：当前照片先于预取完成；线程常驻，连接始终在同一线程中使用
+    m_pool.setMaxThreadCount(1);
+    m_pool.setExpiryTimeout(-1);
+}
+
+PhotoPreviewLoader::~PhotoPreviewLoader()
+{
+    clearDevice();
+}
+
+void PhotoPreviewLoader::setDevice(const QString &udid)
+{
+    if (udid == m_udid) {
+        return;
+    }
+    clearDevice();
+    m_udid = udid;
+}
+
+void PhotoPreviewLoader::clearDevice()
+{
+    cancelAll();
+    // 连接在线程池中创建，也在线程池中释放
+    m_pool.start([this]() { m_device.reset(); });
+    m_pool.waitForDone();
+    m_cache.clear();
+    m_udid.clear();
+}
+
+void PhotoPreviewLoader::setCacheLimit(qint64 maxBytes)
+{
+    m_cache.setMaxBytes(maxBytes);
+}
+
+void PhotoPreviewLoader::setMaxImageSize(const QSize &size)
+{
+    m_maxWidth = size.isValid() ? size.width() : 0;
+    m_maxHeight = size.isValid() ? size.height() : 0;
+}
+
+QImage PhotoPreviewLoader::cachedImage(const QString &path) const
+{
+    return m_cache.find(path);
+}
+
+void PhotoPreviewLoader::load(const PhotoInfo &photo, const QVector<PhotoInfo> &prefetch, bool needsPlaceholder)
+{
+    if (m_udid.isEmpty()) {
+        return;
+    }
+
+    // 翻页时之前的当前照片和预取都已无关，排队中的直接作废
+    cancelAll();
+    const quint64 generation = m_generation.load();
+
+    m_pool.start([this, photo, needsPlaceholder, generation]() {
+        loadPhoto(photo, true, needsPlaceholder, generation);
+    });
+    for (const PhotoInfo &next : prefetch) {
+        if (!m_cache.contains(next.path)) {
+            m_pool.start([this, next, generation]() {
+                loadPhoto(next, false, false, generation);
+            });
+        }
+    }
+}
+
+void PhotoPreviewLoader::cancelAll()
+{
+    ++m_generation;
+    m_pool.clear();
+}
+
+void PhotoPreviewLoader::loadPhoto(const PhotoInfo &photo, bool current, bool placeholder, quint64 generation)
+{
+    if (generation != m_generation.load()) {
+        return;
+    }
+
+    QImage image = m_cache.find(photo.path);
+    if (!image.isNull()) {
+        if (current) {
+            deliver(photo.path, image, true, generation);
+        }
+        return;
+    }
+
+    if (!m_device) {
+        m_device.reset(new PhotoManager);
+    }
+    if (!m_device->isConnected() && !m_device->connectToDevice(m_udid)) {
+        if (current) {
+            deliver(photo.path, QImage(), true, generation);
+        }
+        return;
+    }
+
+    // 没有 HEIF 插件时整个 HEIC 文件也无法解码，不必传输
+    const QList<QByteArray> formats = QImageReader::supportedImageFormats();
+    const bool canDecodeHeif = formats.contains("heic") || formats.contains("heif");
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 bytesRead = 0;
+
+    if (photo.isVideo) {
+        // 视频以第一个关键帧作为预览
+        VideoThumbnail::Result video = m_device->readVideoThumbnail(photo.path, photo.size, canDecodeHeif);
+        bytesRead = video.bytesRead;
+        image.loadFromData(video.data);
+        if (!image.isNull()) {
+            image = ExifThumbnail::applyOrientation(image, video.orientation);
+        }
+    } else {
+        if (current && placeholder && PhotoManager::hasEmbeddedThumbnail(photo.path)) {
+            ExifThumbnail::Result embedded = m_device->readEmbeddedThumbnail(photo.path, photo.size, canDecodeHeif);
+            QImage preview;
+            if (preview.loadFromData(embedded.data)) {
+                deliver(photo.path, ExifThumbnail::applyOrientation(preview, embedded.orientation), false, generation);
+            }
+            if (generation != m_generation.load()) {
+                return;
+            }
+        }
+        if (canDecodeHeif || !HeifThumbnail::isSupported(photo.path)) {
+            const QByteArray data = m_device->readPhotoData(photo.path);
+            bytesRead = data.size();
+            image = decode(data);
+        }
+    }
+
+    const qint64 elapsed = timer.elapsed();
+    if (image.isNull()) {
+        qDebug() << "PhotoPreviewLoader: 无法加载预览:" << photo.path;
+    } else {
+        m_cache.insert(photo.path, image);
+        qDebug() << "[性能] PhotoPreviewLoader" << (current ? "当前" : "预取") << photo.path
+                 << "尺寸:" << image.size() << "读取:" << bytesRead << "字节"
+                 << "耗时:" << elapsed << "ms"
+                 << "缓存:" << m_cache.totalBytes() / (1024 * 1024) << "MB";
+    }
+    if (current) {
+        deliver(photo.path, image, true, generation);
+    }
+}
+
+QImage PhotoPreviewLoader::decode(const QByteArray &data) const
+{
+    // 整个文件自带 EXIF 方向，交给 QImageReader 处理；超过屏幕分辨率一倍以上的 JPEG 按比例解码
+    const int maxWidth = m_maxWidth.load();
+    const int maxHeight = m_maxHeight.load();
+    const QSize bounds = maxWidth > 0 && maxHeight > 0 ? QSize(maxWidth, maxHeight) : QSize();
+    return ScaledDecoder::decode(data, bounds, true);
+}
+
+void PhotoPreviewLoader::deliver(const QString &path, const QImage &image, bool fullSize, quint64 generation)
+{
+    QMetaObject::invokeMethod(this, [this, path, image, fullSize, generation]() {
+        // 交付前再次检查，翻页后到达的旧结果只留在缓存中
+        if (generation != m_generation.load()) {
+            return;
+        }
+        if (image.isNull()) {
+            emit previewFailed(path);
+        } else {
+            emit previewReady(path, image, fullSize);
+        }
+    }, Qt::QueuedConnection);
+}
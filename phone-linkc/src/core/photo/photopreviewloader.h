@@ -0,0 +1,139 @@
+/**
+ * @file photopreviewloader.h
+ * @brief 全尺寸预览加载器头文件
+ *
+ * 预览分两步到达：没有可用的占位图时先读取文件中的内嵌缩略图（只读取元数据范围），
+ * 随后读取整个文件并解码为全尺寸图片。全尺寸结果放入按字节预算淘汰的 ImageCache，
+ * 再次打开或前后翻页时直接命中缓存。
+ *
+ * 当前照片之后按顺序预取相邻的照片，翻页时通常已在缓存中。
+ */
+
+#ifndef PHOTOPREVIEWLOADER_H
+#define PHOTOPREVIEWLOADER_H
+
+#include <QObject>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+#include "photomanager.h"
+#include "imagecache.h"
+
+/**
+ * @brief 全尺寸预览加载器
+ *
+ * 读取和解码在单线程的线程池中按请求顺序执行，使用独立的 AFC 连接，不与界面线程争用。
+ * 每次 load() 作废之前尚未开始的请求，已在处理中的当前照片仍会完成并放入缓存。
+ *
+ * 使用方法：
+ * @code
+ * PhotoPreviewLoader *loader = new PhotoPreviewLoader(this);
+ * connect(loader, &PhotoPreviewLoader::previewReady, this, &Viewer::onPreviewReady);
+ * loader->setDevice(udid);
+ * QImage cached = loader->cachedImage(photo.path);
+ * if (cached.isNull()) {
+ *     loader->load(photo, {next, previous}, !hasThumbnail);
+ * }
+ * @endcode
+ */
+class PhotoPreviewLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PhotoPreviewLoader(QObject *parent = nullptr);
+    ~PhotoPreviewLoader();
+
+    /**
+     * @brief 切换设备，丢弃之前设备的请求和缓存
+     * @param udid 设备 UDID
+     */
+    void setDevice(const QString &udid);
+
+    /**
+     * @brief 丢弃所有请求和缓存，断开设备连接
+     */
+    void clearDevice();
+
+    /**
+     * @brief 设置解码图片缓存的预算
+     * @param maxBytes 预算（字节），默认 ImageCache::DEFAULT_MAX_BYTES
+     */
+    void setCacheLimit(qint64 maxBytes);
+
+    /**
+     * @brief 设置解码结果的最大尺寸（通常为屏幕的物理像素尺寸），超过时按比例缩小
+     * @param size 最大尺寸，无效尺寸表示保持原始分辨率
+     */
+    void setMaxImageSize(const QSize &size);
+
+    /**
+     * @brief 缓存中的全尺寸图片
+     * @return 图片，未命中时为空
+     */
+    QImage cachedImage(const QString &path) const;
+
+    /**
+     * @brief 加载预览，并在之后预取相邻照片
+     * @param photo 当前照片
+     * @param prefetch 预取的照片（按列表顺序加载）
+     * @param needsPlaceholder 调用方没有占位图时先交付内嵌缩略图
+     */
+    void load(const PhotoInfo &photo, const QVector<PhotoInfo> &prefetch, bool needsPlaceholder);
+
+    /**
+     * @brief 丢弃尚未开始的请求
+     */
+    void cancelAll();
+
+signals:
+    /**
+     * @brief 预览图片到达（在本对象所在线程中发出，预取的结果不发出）
+     * @param path 照片路径
+     * @param image 图片
+     * @param fullSize 是否为全尺寸解码结果（否则为内嵌缩略图）
+     */
+    void previewReady(const QString &path, const QImage &image, bool fullSize);
+
+    /**
+     * @brief 预览加载失败（无法读取或解码）
+     * @param path 照片路径
+     */
+    void previewFailed(const QString &path);
+
+private:
+    /**
+     * @brief 读取并解码一张照片（线程池中执行）
+     * @param photo 照片
+     * @param current 是否为当前照片（预取的照片不交付结果）
+     * @param placeholder 是否先交付内嵌缩略图
+     * @param generation 请求所属的代
+     */
+    void loadPhoto(const PhotoInfo &photo, bool current, bool placeholder, quint64 generation);
+
+    /**
+     * @brief 解码为不超过最大尺寸的图片
+     */
+    QImage decode(const QByteArray &data) const;
+
+    /**
+     * @brief 把结果交给本对象所在线程（任意线程调用）
+     */
+    void deliver(const QString &path, const QImage &image, bool fullSize, quint64 generation);
+
+    QString m_udid;                             ///< 当前设备 UDID
+    ImageCache m_cache;                         ///< 全尺寸解码结果
+    std::atomic<quint64> m_generation;          ///< 递增即作废之前的请求
+    std::atomic<int> m_maxWidth;                ///< 解码结果最大宽度，0 表示不限
+    std::atomic<int> m_maxHeight;               ///< 解码结果最大高度，0 表示不限
+
+    std::unique_ptr<PhotoManager> m_device;     ///< 读取使用的连接，只在线程池中使用
+    QThreadPool m_pool;                         ///< 单线程读取和解码（最后声明，最先析构并等待任务结束）
+};
+
+#endif // PHOTOPREVIEWLOADER_H
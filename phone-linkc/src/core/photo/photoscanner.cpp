@@ -0,0 +1,355 @@
+/**
+ * @file photoscanner.cpp
+ * @brief DCIM 并行扫描器实现
+ */
+
+#include "photoscanner.h"
+#include "core/device/devicesession.h"
+#include "platform/libimobiledevice_dynamic.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QQueue>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QtConcurrent/QtConcurrent>
+
+// 每个文件信息任务包含的条目数：足够小以便大相册分摊到多个连接，
+// 也决定了流式扫描每批的最大照片数
+static const int STAT_CHUNK_SIZE = 32;
+
+namespace {
+
+/**
+ * @brief 扫描任务
+ */
+struct ScanTask {
+    enum Type {
+        ReadDirectory,  ///< 读取目录，拆分出后续任务
+        StatFiles,      ///< 查询一组媒体文件的大小和时间
+        ProbeEntries    ///< 查询一组无扩展名条目是否为子目录
+    };
+
+    Type type = ReadDirectory;
+    QString directory;
+    QStringList names;
+};
+
+/**
+ * @brief 各扫描线程共享的状态
+ */
+struct ScanState {
+    QMutex mutex;                   ///< 保护任务队列和计数
+    QWaitCondition wake;            ///< 有新任务或扫描结束
+    QQueue<ScanTask> tasks;         ///< 待执行任务
+    int active = 0;                 ///< 正在执行的任务数
+    int scannedDirectories = 0;
+    int discoveredDirectories = 0;
+    bool stopped = false;           ///< 回调要求停止
+
+    QMutex callbackMutex;           ///< 串行化批次回调
+    int total = 0;                  ///< 已交付的媒体文件数（受 callbackMutex 保护）
+};
+
+/**
+ * @brief 读取目录，按条目类型拆分为后续任务
+ */
+bool readDirectory(afc_client_t afcClient, const QString &path, QVector<ScanTask> &produced)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+
+    char **directory_info = nullptr;
+    afc_error_t ret = loader.afc_read_directory(afcClient, path.toUtf8().constData(), &directory_info);
+    if (ret != AFC_E_SUCCESS || !directory_info) {
+        qDebug() << "PhotoScanner: 无法读取目录" << path;
+        return false;
+    }
+
+    QStringList media;
+    QStringList probes;
+    for (int i = 0; directory_info[i]; i++) {
+        QString name = QString::fromUtf8(directory_info[i]);
+        if (name == "." || name == "..") {
+            continue;
+        }
+
+        bool isVideo;
+        if (PhotoManager::isMediaFile(name, isVideo)) {
+            media << name;
+        } else if (QFileInfo(name).suffix().isEmpty()) {
+            // 带其他扩展名的条目（.AAE、.PLIST 等）是附属文件，不必查询类型；
+            // 只有无扩展名的条目（100APPLE 等）才可能是子目录
+            probes << name;
+        }
+    }
+    loader.afc_dictionary_free(directory_info);
+
+    auto split = [&produced, &path](ScanTask::Type type, const QStringList &names) {
+        for (int i = 0; i < names.size(); i += STAT_CHUNK_SIZE) {
+            ScanTask task;
+            task.type = type;
+            task.directory = path;
+            task.names = names.mid(i, STAT_CHUNK_SIZE);
+            produced.append(task);
+        }
+    };
+    split(ScanTask::ProbeEntries, probes);
+    split(ScanTask::StatFiles, media);
+    return true;
+}
+
+} // namespace
+
+PhotoScanner::PhotoScanner(std::shared_ptr<DeviceSession> session, int connections)
+    : m_session(std::move(session))
+    , m_connections(qMax(1, connections))
+{
+}
+
+int PhotoScanner::scan(const QString &rootPath, const BatchCallback &onBatch, QString *error)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!m_session || !loader.afc_read_directory || !loader.afc_get_file_info || !loader.afc_dictionary_free) {
+        if (error) {
+            *error = "AFC 目录读取函数不可用";
+        }
+        return 0;
+    }
+
+    ScanState state;
+    ScanTask root;
+    root.type = ScanTask::ReadDirectory;
+    root.directory = rootPath;
+    state.tasks.enqueue(root);
+    state.discoveredDirectories = 1;
+
+    QMutex errorMutex;
+    QString firstError;
+    QAtomicInt workers = 0;
+
+    auto worker = [&]() {
+        QString clientError;
+        afc_client_t afcClient = m_session->createAfcClient(&clientError);
+        if (!afcClient) {
+            QMutexLocker locker(&errorMutex);
+            if (firstError.isEmpty()) {
+                firstError = clientError;
+            }
+            return;
+        }
+        workers.ref();
+
+        for (;;) {
+            ScanTask task;
+            {
+                QMutexLocker locker(&state.mutex);
+                while (!state.stopped && state.tasks.isEmpty() && state.active > 0) {
+                    state.wake.wait(&state.mutex);
+                }
+                if (state.stopped || state.tasks.isEmpty()) {
+                    state.wake.wakeAll();
+                    break;
+                }
+                task = state.tasks.dequeue();
+                ++state.active;
+            }
+
+            QVector<ScanTask> produced;
+            QVector<PhotoInfo> photos;
+            qint64 directoryMtimeNs = 0;
+            bool reused = false;
+
+            switch (task.type) {
+            case ScanTask::ReadDirectory:
+                if (m_known) {
+                    // 目录未变化时沿用上次的记录，省去读取目录和逐个查询文件信息
+                    directoryMtimeNs = directoryMtime(afcClient, task.directory);
+                    auto known = m_known->constFind(task.directory);
+                    if (directoryMtimeNs > 0 && known != m_known->constEnd() && known->mtimeNs == directoryMtimeNs) {
+                        reused = true;
+                        photos = known->photos;
+                        for (const QString &subdirectory : known->subdirectories) {
+                            ScanTask child;
+                            child.type = ScanTask::ReadDirectory;
+                            child.directory = subdirectory;
+                            produced.append(child);
+                        }
+                        break;
+                    }
+                }
+                if (!readDirectory(afcClient, task.directory, produced)) {
+                    // 读取失败的目录不记录时间，下次重新读取
+                    directoryMtimeNs = 0;
+                }
+                break;
+            case ScanTask::StatFiles:
+                for (const QString &name : task.names) {
+                    bool isVideo = false;
+                    PhotoManager::isMediaFile(name, isVideo);
+                    PhotoInfo info = statFile(afcClient, QString("%1/%2").arg(task.directory, name));
+                    info.name = name;
+                    info.isVideo = isVideo;
+                    photos.append(info);
+                }
+                break;
+            case ScanTask::ProbeEntries:
+                for (const QString &name : task.names) {
+                    const QString fullPath = QString("%1/%2").arg(task.directory, name);
+                    if (isDirectory(afcClient, fullPath)) {
+                        ScanTask child;
+                        child.type = ScanTask::ReadDirectory;
+                        child.directory = fullPath;
+                        produced.append(child);
+                    }
+                }
+                break;
+            }
+
+            Batch batch;
+            batch.directory = task.directory;
+            batch.photos = photos;
+            batch.directoryDone = task.type == ScanTask::ReadDirectory;
+            batch.directoryMtimeNs = directoryMtimeNs;
+            batch.reused = reused;
+            {
+                QMutexLocker locker(&state.mutex);
+                for (const ScanTask &next : produced) {
+                    // 目录类任务插到队首：尽早发现全部目录，让所有连接都有活干；
+                    // 文件信息任务排在队尾
+                    if (next.type == ScanTask::StatFiles) {
+                        state.tasks.enqueue(next);
+                    } else {
+                        state.tasks.prepend(next);
+                        if (next.type == ScanTask::ReadDirectory) {
+                            ++state.discoveredDirectories;
+                        }
+                    }
+                }
+                if (task.type == ScanTask::ReadDirectory) {
+                    ++state.scannedDirectories;
+                }
+                batch.scannedDirectories = state.scannedDirectories;
+                batch.discoveredDirectories = state.discoveredDirectories;
+                --state.active;
+                state.wake.wakeAll();
+            }
+
+            // 只有产出照片或完成一个目录时才回调
+            if (photos.isEmpty() && task.type != ScanTask::ReadDirectory) {
+                continue;
+            }
+
+            bool keepGoing;
+            {
+                QMutexLocker locker(&state.callbackMutex);
+                state.total += photos.size();
+                keepGoing = onBatch(batch);
+            }
+            if (!keepGoing) {
+                QMutexLocker locker(&state.mutex);
+                state.stopped = true;
+                state.wake.wakeAll();
+            }
+        }
+
+        if (loader.afc_client_free) {
+            loader.afc_client_free(afcClient);
+        }
+    };
+
+    // 调用线程本身也作为一个扫描线程，其余连接在临时线程池中运行
+    QThreadPool pool;
+    pool.setMaxThreadCount(m_connections - 1);
+    for (int i = 1; i < m_connections; ++i) {
+        QtConcurrent::run(&pool, worker);
+    }
+    worker();
+    pool.waitForDone();
+
+    if (workers.loadRelaxed() == 0 && error) {
+        *error = firstError;
+    }
+    return state.total;
+}
+
+PhotoInfo PhotoScanner::statFile(void *afcClient, const QString &path)
+{
+    PhotoInfo info;
+    info.path = path;
+
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!afcClient || !loader.afc_get_file_info || !loader.afc_dictionary_free) {
+        return info;
+    }
+
+    char **file_info = nullptr;
+    if (loader.afc_get_file_info(static_cast<afc_client_t>(afcClient), path.toUtf8().constData(), &file_info) != AFC_E_SUCCESS) {
+        return info;
+    }
+
+    // 解析文件信息
+    for (int i = 0; file_info[i]; i += 2) {
+        QString key = QString::fromUtf8(file_info[i]);
+        QString value = QString::fromUtf8(file_info[i + 1]);
+
+        if (key == "st_size") {
+            info.size = value.toLongLong();
+        } else if (key == "st_mtime") {
+            // 时间戳（纳秒）
+            qint64 timestamp = value.toLongLong() / 1000000000LL;
+            info.modifiedTime = QDateTime::fromSecsSinceEpoch(timestamp);
+        }
+    }
+
+    loader.afc_dictionary_free(file_info);
+
+    return info;
+}
+
+bool PhotoScanner::isDirectory(void *afcClient, const QString &path)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!afcClient || !loader.afc_get_file_info || !loader.afc_dictionary_free) {
+        return false;
+    }
+
+    char **file_info = nullptr;
+    if (loader.afc_get_file_info(static_cast<afc_client_t>(afcClient), path.toUtf8().constData(), &file_info) != AFC_E_SUCCESS) {
+        return false;
+    }
+
+    bool isDir = false;
+    for (int j = 0; file_info[j]; j += 2) {
+        if (QString::fromUtf8(file_info[j]) == "st_ifmt" &&
+            QString::fromUtf8(file_info[j + 1]) == "S_IFDIR") {
+            isDir = true;
+            break;
+        }
+    }
+    loader.afc_dictionary_free(file_info);
+    return isDir;
+}
+
+qint64 PhotoScanner::directoryMtime(void *afcClient, const QString &path)
+{
+    LibimobiledeviceDynamic& loader = LibimobiledeviceDynamic::instance();
+    if (!afcClient || !loader.afc_get_file_info || !loader.afc_dictionary_free) {
+        return 0;
+    }
+
+    char **file_info = nullptr;
+    if (loader.afc_get_file_info(static_cast<afc_client_t>(afcClient), path.toUtf8().constData(), &file_info) != AFC_E_SUCCESS) {
+        return 0;
+    }
+
+    qint64 mtimeNs = 0;
+    for (int j = 0; file_info[j]; j += 2) {
+        if (QString::fromUtf8(file_info[j]) == "st_mtime") {
+            mtimeNs = QString::fromUtf8(file_info[j + 1]).toLongLong();
+            break;
+        }
+    }
+    loader.afc_dictionary_free(file_info);
+    return mtimeNs;
+}
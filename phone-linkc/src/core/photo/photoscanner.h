@@ -0,0 +1,121 @@
+/**
+ * @file photoscanner.h
+ * @brief DCIM 并行扫描器头文件
+ *
+ * 单个 AFC 连接上的请求严格一问一答，扫描耗时取决于 USB 往返延迟而不是带宽。
+ * 扫描器对同一设备打开多个 AFC 客户端，由多个线程从共享任务队列中领取
+ * “读取目录”和“查询一组文件信息”任务，让往返延迟相互重叠。
+ *
+ * 提供上次扫描的目录状态时进行增量扫描：先查询目录的 st_mtime，未变化的目录
+ * 直接沿用上次的文件列表和子目录，不再读取目录和逐个查询文件信息。
+ */
+
+#ifndef PHOTOSCANNER_H
+#define PHOTOSCANNER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <functional>
+#include <memory>
+
+#include "photomanager.h"
+
+class DeviceSession;
+
+/**
+ * @brief DCIM 并行扫描器
+ *
+ * 使用方法：
+ * @code
+ * PhotoScanner scanner(session, 4);
+ * scanner.scan("/DCIM", [](const PhotoScanner::Batch &batch) {
+ *     qDebug() << batch.directory << batch.photos.size();
+ *     return true;   // 返回 false 停止扫描
+ * });
+ * @endcode
+ */
+class PhotoScanner
+{
+public:
+    /// 默认 AFC 连接数
+    static const int DEFAULT_CONNECTIONS = 4;
+
+    /**
+     * @brief 扫描产出的一批照片及当前进度
+     */
+    struct Batch {
+        QString directory;          ///< 照片所在目录
+        QVector<PhotoInfo> photos;  ///< 照片列表（可能为空，仅报告进度）
+        int scannedDirectories;     ///< 已读取的目录数
+        int discoveredDirectories;  ///< 已发现的目录数（随扫描增长）
+        bool directoryDone = false; ///< 目录本身已处理完（列表已读取或沿用）
+        qint64 directoryMtimeNs = 0; ///< 目录的 st_mtime（纳秒），未查询或读取失败时为 0
+        bool reused = false;        ///< 目录未变化，photos 来自上次扫描的记录
+    };
+
+    /**
+     * @brief 上次扫描记录的目录状态
+     */
+    struct KnownDirectory {
+        qint64 mtimeNs = 0;             ///< 目录的 st_mtime（纳秒）
+        QStringList subdirectories;     ///< 子目录完整路径
+        QVector<PhotoInfo> photos;      ///< 目录中的媒体文件
+    };
+    using KnownDirectories = QHash<QString, KnownDirectory>;
+
+    /**
+     * @brief 批次回调，在扫描线程中串行调用；返回 false 时停止扫描
+     */
+    using BatchCallback = std::function<bool(const Batch &batch)>;
+
+    /**
+     * @param session 设备会话
+     * @param connections AFC 连接数（即扫描线程数），至少为 1
+     */
+    PhotoScanner(std::shared_ptr<DeviceSession> session, int connections = DEFAULT_CONNECTIONS);
+
+    /**
+     * @brief 扫描目录树（阻塞直到完成或被回调停止）
+     * @param rootPath 根目录
+     * @param onBatch 批次回调
+     * @param error 错误信息（输出，可为空）
+     * @return 找到的媒体文件数
+     */
+    int scan(const QString &rootPath, const BatchCallback &onBatch, QString *error = nullptr);
+
+    /**
+     * @brief 启用增量扫描
+     *
+     * 目录内容的增删会更新目录的 st_mtime；原地修改文件不会，这类变化需要完整扫描才能发现。
+     * @param known 上次扫描记录的目录状态，扫描期间必须保持有效；nullptr 表示完整扫描
+     */
+    void setKnownDirectories(const KnownDirectories *known) { m_known = known; }
+
+    /**
+     * @brief 使用指定 AFC 客户端获取文件信息
+     * @param afcClient afc_client_t
+     * @param path 文件路径
+     * @return 文件信息（失败时仅填充 path）
+     */
+    static PhotoInfo statFile(void *afcClient, const QString &path);
+
+    /**
+     * @brief 查询路径是否为目录
+     */
+    static bool isDirectory(void *afcClient, const QString &path);
+
+    /**
+     * @brief 查询目录的 st_mtime
+     * @return 纳秒时间戳，失败时返回 0
+     */
+    static qint64 directoryMtime(void *afcClient, const QString &path);
+
+private:
+    std::shared_ptr<DeviceSession> m_session;  ///< 设备会话
+    int m_connections;                         ///< AFC 连接数
+    const KnownDirectories *m_known = nullptr; ///< 上次扫描的目录状态（增量扫描）
+};
+
+#endif // PHOTOSCANNER_H
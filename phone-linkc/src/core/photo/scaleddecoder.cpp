@@ -0,0 +1,123 @@
+/**
+ * @file scaleddecoder.cpp
+ * @brief 按目标尺寸解码图片实现
+ */
+
+#include "scaleddecoder.h"
+#include <QBuffer>
+#include <QImageIOHandler>
+#include <QImageReader>
+#include <vector>
+
+QImage ScaledDecoder::decode(const QByteArray &data, const QSize &bounds, bool autoTransform)
+{
+    if (data.isEmpty()) {
+        return QImage();
+    }
+
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    reader.setAutoTransform(autoTransform);
+
+    const QSize original = reader.size();
+    if (bounds.isValid() && original.isValid() && reader.format() == "jpeg") {
+        // 缩放发生在旋转之前，旋转 90 度的照片按转置的边界计算
+        QSize target = bounds;
+        if (autoTransform && (reader.transformation() & QImageIOHandler::TransformationRotate90)) {
+            target.transpose();
+        }
+        const int denominator = idctDenominator(original, original.scaled(target, Qt::KeepAspectRatio));
+        if (denominator > 1) {
+            // 向下取整：Qt 按原始尺寸与请求尺寸之比选择 scale_denom，
+            // 能整除时（如 4032x3024）IDCT 的输出即为请求尺寸，不再额外缩放
+            reader.setScaledSize(QSize(original.width() / denominator, original.height() / denominator));
+        }
+    }
+
+    const QImage image = reader.read();
+    if (image.isNull()) {
+        return image;
+    }
+    return bounds.isValid() ? fit(image, bounds) : image;
+}
+
+int ScaledDecoder::idctDenominator(const QSize &size, const QSize &target)
+{
+    for (int denominator : {8, 4, 2}) {
+        if (size.width() / denominator >= target.width() && size.height() / denominator >= target.height()) {
+            return denominator;
+        }
+    }
+    return 1;
+}
+
+QImage ScaledDecoder::fit(const QImage &image, const QSize &bounds)
+{
+    if (image.width() <= bounds.width() && image.height() <= bounds.height()) {
+        return image;
+    }
+
+    const QSize target = image.size().scaled(bounds, Qt::KeepAspectRatio).expandedTo(QSize(1, 1));
+    if (image.width() >= target.width() * 2 && image.height() >= target.height() * 2) {
+        return boxDownscale(image, target);
+    }
+    // 比例小于 2 时面积平均的锯齿明显，剩余像素不多，平滑缩放的开销可以接受
+    return image.scaled(target, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
+QImage ScaledDecoder::boxDownscale(const QImage &image, const QSize &size)
+{
+    if (image.isNull() || size.isEmpty()) {
+        return QImage();
+    }
+
+    const QImage::Format format = image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                          : QImage::Format_RGB32;
+    const QImage source = image.convertToFormat(format);
+    const int sourceWidth = source.width();
+    const int sourceHeight = source.height();
+    const int width = qMin(size.width(), sourceWidth);
+    const int height = qMin(size.height(), sourceHeight);
+
+    // 源列 -> 目标列，以及每个目标列覆盖的源列数
+    std::vector<int> columnOf(sourceWidth);
+    std::vector<quint32> columnSpan(width, 0);
+    for (int x = 0; x < sourceWidth; ++x) {
+        columnOf[x] = static_cast<int>(static_cast<qint64>(x) * width / sourceWidth);
+        ++columnSpan[columnOf[x]];
+    }
+
+    QImage result(width, height, format);
+    std::vector<quint32> sums(static_cast<size_t>(width) * 4);
+    int sourceY = 0;
+    for (int y = 0; y < height; ++y) {
+        const int rowEnd = static_cast<int>(static_cast<qint64>(y + 1) * sourceHeight / height);
+        const quint32 rows = static_cast<quint32>(rowEnd - sourceY);
+        std::fill(sums.begin(), sums.end(), 0);
+
+        // 逐行累加各通道，最坏情况（整张 4032x3024 图缩成一个像素）也不会溢出 32 位
+        for (; sourceY < rowEnd; ++sourceY) {
+            const QRgb *line = reinterpret_cast<const QRgb *>(source.constScanLine(sourceY));
+            for (int x = 0; x < sourceWidth; ++x) {
+                const QRgb pixel = line[x];
+                quint32 *sum = &sums[static_cast<size_t>(columnOf[x]) * 4];
+                sum[0] += pixel & 0xff;
+                sum[1] += (pixel >> 8) & 0xff;
+                sum[2] += (pixel >> 16) & 0xff;
+                sum[3] += pixel >> 24;
+            }
+        }
+
+        QRgb *out = reinterpret_cast<QRgb *>(result.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            const quint32 count = columnSpan[x] * rows;
+            const quint32 half = count / 2;
+            const quint32 *sum = &sums[static_cast<size_t>(x) * 4];
+            out[x] = (((sum[3] + half) / count) << 24) | (((sum[2] + half) / count) << 16)
+                     | (((sum[1] + half) / count) << 8) | ((sum[0] + half) / count);
+        }
+    }
+    return result;
+}
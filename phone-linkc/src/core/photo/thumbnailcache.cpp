@@ -0,0 +1,392 @@
+/**
+ * @file thumbnailcache.cpp
+ * @brief 持久化缩略图缓存实现
+ */
+
+#include "thumbnailcache.h"
+#include <QDebug>
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QStandardPaths>
+#include <QVector>
+#include <algorithm>
+#include <cstring>
+
+// 文件头魔数（8 字节），格式变化时修改版本号，旧文件会被重建
+static const char PACK_MAGIC[8] = {'P', 'L', 'T', 'P', 'A', 'C', 'K', '1'};
+static const char INDEX_MAGIC[8] = {'P', 'L', 'T', 'I', 'D', 'X', '0', '1'};
+static const qint64 HEADER_SIZE = 8;
+
+// 缩略图 JPEG 编码质量
+static const int JPEG_QUALITY = 85;
+
+// 每台设备缓存的总大小上限（约十万张 100px 缩略图），超过时打开时淘汰最早写入的条目
+static const qint64 MAX_CACHE_BYTES = 512LL * 1024 * 1024;
+
+// 淘汰后保留的大小占上限的比例，留出余量，避免之后每次打开都要整理
+static const double COMPACT_TARGET_RATIO = 0.75;
+
+// 失效数据同时超过此大小和数据文件的此比例时，打开时整理
+static const qint64 COMPACT_MIN_DEAD_BYTES = 16LL * 1024 * 1024;
+static const double COMPACT_DEAD_RATIO = 0.25;
+
+ThumbnailCache::Ptr ThumbnailCache::forDevice(const QString &udid)
+{
+    static QMutex registryMutex;
+    static QHash<QString, std::weak_ptr<ThumbnailCache>> registry;
+
+    QMutexLocker locker(&registryMutex);
+    Ptr cache = registry.value(udid).lock();
+    if (!cache) {
+        cache.reset(new ThumbnailCache(udid));
+        registry.insert(udid, cache);
+    }
+    return cache;
+}
+
+ThumbnailCache::ThumbnailCache(const QString &udid)
+    : m_udid(udid)
+    , m_directory(QDir(cacheDirectory()).filePath(udid))
+    , m_liveBytes(0)
+    , m_open(false)
+{
+    m_open = open();
+}
+
+ThumbnailCache::~ThumbnailCache()
+{
+    m_packFile.close();
+    m_indexFile.close();
+}
+
+QString ThumbnailCache::cacheDirectory()
+{
+    // 使用 %appdata%/iPhonLinkC/thumbnails/ 目录
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/iPhonLinkC/thumbnails";
+}
+
+bool ThumbnailCache::open()
+{
+    if (!QDir().mkpath(m_directory)) {
+        qWarning() << "ThumbnailCache: 无法创建目录" << m_directory;
+        return false;
+    }
+
+    m_packFile.setFileName(QDir(m_directory).filePath("thumbs.pack"));
+    m_indexFile.setFileName(QDir(m_directory).filePath("thumbs.idx"));
+    if (!m_packFile.open(QIODevice::ReadWrite) || !m_indexFile.open(QIODevice::ReadWrite)) {
+        qWarning() << "ThumbnailCache: 无法打开缓存文件" << m_directory;
+        return false;
+    }
+
+    auto hasMagic = [](QFile &file, const char *magic) {
+        if (file.size() < HEADER_SIZE) {
+            return false;
+        }
+        file.seek(0);
+        return file.read(HEADER_SIZE) == QByteArray(magic, HEADER_SIZE);
+    };
+
+    if (!hasMagic(m_packFile, PACK_MAGIC) || !hasMagic(m_indexFile, INDEX_MAGIC)) {
+        return reset();
+    }
+
+    loadIndex();
+    if (!compactIfNeeded()) {
+        return false;
+    }
+    qDebug() << "ThumbnailCache: 已加载" << m_udid << m_index.size() << "个缩略图,"
+             << m_packFile.size() / 1024 << "KB";
+    return true;
+}
+
+void ThumbnailCache::loadIndex()
+{
+    m_index.clear();
+    m_liveBytes = 0;
+
+    const qint64 recordCount = (m_indexFile.size() - HEADER_SIZE) / qint64(sizeof(IndexRecord));
+    const qint64 validSize = HEADER_SIZE + recordCount * qint64(sizeof(IndexRecord));
+    const qint64 packSize = m_packFile.size();
+
+    if (recordCount > 0) {
+        uchar *mapped = m_indexFile.map(0, validSize);
+        if (mapped) {
+            m_index.reserve(int(recordCount));
+            for (qint64 i = 0; i < recordCount; ++i) {
+                IndexRecord record;
+                std::memcpy(&record, mapped + HEADER_SIZE + i * qint64(sizeof(IndexRecord)), sizeof(IndexRecord));
+                // 数据未写完整就退出时，索引记录可能指向数据文件之外
+                if (record.offset >= quint64(HEADER_SIZE) && record.offset + record.length <= quint64(packSize)) {
+                    m_index.insert(record.keyHash, record);
+                }
+            }
+            m_indexFile.unmap(mapped);
+        } else {
+            qWarning() << "ThumbnailCache: 索引映射失败" << m_indexFile.errorString();
+        }
+    }
+
+    // 丢弃不完整的尾部记录，保证之后追加的记录对齐
+    if (m_indexFile.size() != validSize) {
+        m_indexFile.resize(validSize);
+    }
+
+    for (auto it = m_index.cbegin(); it != m_index.cend(); ++it) {
+        m_liveBytes += it->length;
+    }
+}
+
+bool ThumbnailCache::compactIfNeeded()
+{
+    const qint64 packSize = m_packFile.size();
+    const qint64 deadBytes = packSize - HEADER_SIZE - m_liveBytes;
+    const bool tooMuchDead = deadBytes >= COMPACT_MIN_DEAD_BYTES && deadBytes >= packSize * COMPACT_DEAD_RATIO;
+    if (!tooMuchDead && m_liveBytes <= MAX_CACHE_BYTES) {
+        return true;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 按写入顺序排列，超过上限时从最早的条目开始跳过
+    QVector<IndexRecord> records;
+    records.reserve(m_index.size());
+    for (auto it = m_index.cbegin(); it != m_index.cend(); ++it) {
+        records.append(it.value());
+    }
+    std::sort(records.begin(), records.end(), [](const IndexRecord &a, const IndexRecord &b) {
+        return a.offset < b.offset;
+    });
+    int first = 0;
+    qint64 keptBytes = m_liveBytes;
+    if (m_liveBytes > MAX_CACHE_BYTES) {
+        const qint64 target = static_cast<qint64>(MAX_CACHE_BYTES * COMPACT_TARGET_RATIO);
+        while (first < records.size() && keptBytes > target) {
+            keptBytes -= records.at(first++).length;
+        }
+    }
+
+    const QDir dir(m_directory);
+    QFile packTemp(dir.filePath("thumbs.pack.tmp"));
+    QFile indexTemp(dir.filePath("thumbs.idx.tmp"));
+    if (!packTemp.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || !indexTemp.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "ThumbnailCache: 无法创建整理用的临时文件" << m_directory;
+        return true;
+    }
+    packTemp.write(PACK_MAGIC, HEADER_SIZE);
+    indexTemp.write(INDEX_MAGIC, HEADER_SIZE);
+
+    bool ok = true;
+    for (int i = first; i < records.size() && ok; ++i) {
+        IndexRecord record = records.at(i);
+        const QByteArray entry = m_packFile.seek(qint64(record.offset)) ? m_packFile.read(record.length) : QByteArray();
+        if (entry.size() != int(record.length)) {
+            continue;
+        }
+        record.offset = quint64(packTemp.pos());
+        ok = packTemp.write(entry) == entry.size()
+             && indexTemp.write(reinterpret_cast<const char *>(&record), sizeof(record)) == qint64(sizeof(record));
+    }
+    packTemp.close();
+    indexTemp.close();
+    if (!ok) {
+        qWarning() << "ThumbnailCache: 整理缓存失败，保留原文件" << m_directory;
+        QFile::remove(packTemp.fileName());
+        QFile::remove(indexTemp.fileName());
+        return true;
+    }
+
+    // 先删除索引再替换数据文件：中途退出时没有可用的索引，下次打开直接重建
+    m_packFile.close();
+    m_indexFile.close();
+    const bool replaced = QFile::remove(m_indexFile.fileName())
+                          && QFile::remove(m_packFile.fileName())
+                          && QFile::rename(packTemp.fileName(), m_packFile.fileName())
+                          && QFile::rename(indexTemp.fileName(), m_indexFile.fileName());
+    if (!replaced) {
+        qWarning() << "ThumbnailCache: 无法替换缓存文件" << m_directory;
+    }
+    if (!m_packFile.open(QIODevice::ReadWrite) || !m_indexFile.open(QIODevice::ReadWrite)) {
+        qWarning() << "ThumbnailCache: 无法打开缓存文件" << m_directory;
+        return false;
+    }
+    if (!replaced) {
+        return reset();
+    }
+
+    const int before = m_index.size();
+    loadIndex();
+    qDebug() << "[性能] ThumbnailCache 整理" << m_udid << "失效数据:" << deadBytes / 1024 << "KB,"
+             << "淘汰:" << before - m_index.size() << "个," << "大小:" << packSize / 1024 << "KB ->"
+             << m_packFile.size() / 1024 << "KB, 耗时:" << timer.elapsed() << "ms";
+    return true;
+}
+
+bool ThumbnailCache::reset()
+{
+    m_index.clear();
+    m_liveBytes = 0;
+    if (!m_packFile.resize(0) || !m_indexFile.resize(0)) {
+        qWarning() << "ThumbnailCache: 无法重建缓存文件" << m_directory;
+        return false;
+    }
+
+    m_packFile.seek(0);
+    m_packFile.write(PACK_MAGIC, HEADER_SIZE);
+    m_packFile.flush();
+    m_indexFile.seek(0);
+    m_indexFile.write(INDEX_MAGIC, HEADER_SIZE);
+    m_indexFile.flush();
+    return true;
+}
+
+QByteArray ThumbnailCache::makeKey(const PhotoInfo &photo)
+{
+    return QString("%1\n%2\n%3")
+        .arg(photo.path)
+        .arg(photo.size)
+        .arg(photo.modifiedTime.isValid() ? photo.modifiedTime.toSecsSinceEpoch() : 0)
+        .toUtf8();
+}
+
+quint64 ThumbnailCache::hashKey(const QByteArray &key)
+{
+    QByteArray digest = QCryptographicHash::hash(key, QCryptographicHash::Md5);
+    quint64 hash = 0;
+    std::memcpy(&hash, digest.constData(), sizeof(hash));
+    return hash;
+}
+
+QByteArray ThumbnailCache::find(const PhotoInfo &photo)
+{
+    const QByteArray key = makeKey(photo);
+    const quint64 hash = hashKey(key);
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_open) {
+        return QByteArray();
+    }
+
+    auto it = m_index.constFind(hash);
+    if (it == m_index.constEnd()) {
+        return QByteArray();
+    }
+
+    if (!m_packFile.seek(qint64(it->offset))) {
+        return QByteArray();
+    }
+    const QByteArray entry = m_packFile.read(it->length);
+
+    // 条目格式：键长度（quint32）+ 键 + 缩略图数据；核对完整的键以排除哈希碰撞
+    quint32 keyLength = 0;
+    if (entry.size() < int(sizeof(keyLength))) {
+        return QByteArray();
+    }
+    std::memcpy(&keyLength, entry.constData(), sizeof(keyLength));
+    const int dataStart = int(sizeof(keyLength)) + int(keyLength);
+    if (dataStart > entry.size() || entry.mid(sizeof(keyLength), keyLength) != key) {
+        return QByteArray();
+    }
+    return entry.mid(dataStart);
+}
+
+bool ThumbnailCache::insert(const PhotoInfo &photo, const QByteArray &encoded)
+{
+    if (encoded.isEmpty()) {
+        return false;
+    }
+
+    const QByteArray key = makeKey(photo);
+    const quint32 keyLength = quint32(key.size());
+
+    QByteArray entry;
+    entry.reserve(int(sizeof(keyLength)) + key.size() + encoded.size());
+    entry.append(reinterpret_cast<const char *>(&keyLength), sizeof(keyLength));
+    entry.append(key);
+    entry.append(encoded);
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_open) {
+        return false;
+    }
+
+    // 先追加数据再追加索引：中途退出时只会留下无索引的数据，不会产生指向无效数据的索引
+    IndexRecord record;
+    record.keyHash = hashKey(key);
+    record.offset = quint64(m_packFile.size());
+    record.length = quint32(entry.size());
+    record.reserved = 0;
+
+    if (!m_packFile.seek(qint64(record.offset)) || m_packFile.write(entry) != entry.size()) {
+        qWarning() << "ThumbnailCache: 写入数据失败" << m_packFile.errorString();
+        return false;
+    }
+    m_packFile.flush();
+
+    if (!m_indexFile.seek(m_indexFile.size()) ||
+        m_indexFile.write(reinterpret_cast<const char *>(&record), sizeof(record)) != qint64(sizeof(record))) {
+        qWarning() << "ThumbnailCache: 写入索引失败" << m_indexFile.errorString();
+        return false;
+    }
+    m_indexFile.flush();
+
+    // 同一键的旧条目成为失效数据，下次打开时整理
+    auto previous = m_index.constFind(record.keyHash);
+    if (previous != m_index.constEnd()) {
+        m_liveBytes -= previous->length;
+    }
+    m_liveBytes += record.length;
+    m_index.insert(record.keyHash, record);
+    return true;
+}
+
+QImage ThumbnailCache::findImage(const PhotoInfo &photo)
+{
+    QImage image;
+    const QByteArray data = find(photo);
+    if (!data.isEmpty()) {
+        image.loadFromData(data, "JPG");
+    }
+    return image;
+}
+
+bool ThumbnailCache::insertImage(const PhotoInfo &photo, const QImage &image)
+{
+    if (image.isNull()) {
+        return false;
+    }
+
+    QByteArray encoded;
+    QBuffer buffer(&encoded);
+    buffer.open(QIODevice::WriteOnly);
+    if (!image.save(&buffer, "JPG", JPEG_QUALITY)) {
+        return false;
+    }
+    return insert(photo, encoded);
+}
+
+bool ThumbnailCache::contains(const PhotoInfo &photo) const
+{
+    const quint64 hash = hashKey(makeKey(photo));
+    QMutexLocker locker(&m_mutex);
+    return m_open && m_index.contains(hash);
+}
+
+int ThumbnailCache::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_index.size();
+}
+
+void ThumbnailCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_open) {
+        m_open = reset();
+    }
+}
@@ -0,0 +1,153 @@
+/**
+ * @file thumbnailcache.h
+ * @brief 持久化缩略图缓存头文件
+ *
+ * 缩略图按 (UDID, 设备路径, st_size, st_mtime) 缓存在本地磁盘，再次打开相册时
+ * 直接从本地读取，不再通过 USB 下载原图。每台设备只有两个文件：
+ * - thumbs.pack：只追加的数据文件，依次存放编码后的缩略图
+ * - thumbs.idx：定长索引记录，打开时以内存映射方式读取
+ * 避免在磁盘上产生成千上万个小文件。打开时若失效数据过多或总大小超过上限，
+ * 则整理两个文件：丢弃失效数据，超过上限时先丢弃最早写入的条目。
+ */
+
+#ifndef THUMBNAILCACHE_H
+#define THUMBNAILCACHE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QFile>
+#include <QImage>
+#include <memory>
+
+#include "photomanager.h"
+
+/**
+ * @brief 单台设备的持久化缩略图缓存（线程安全）
+ *
+ * 文件的大小或修改时间变化后键随之变化，旧条目不再命中；
+ * 被覆盖的条目在下次打开时整理掉，不再命中的旧条目随总大小上限按写入顺序淘汰。
+ *
+ * 使用方法：
+ * @code
+ * std::shared_ptr<ThumbnailCache> cache = ThumbnailCache::forDevice(udid);
+ * QImage image = cache->findImage(photo);
+ * if (image.isNull()) {
+ *     image = decodeAndScale(photoManager->readPhotoData(photo.path));
+ *     cache->insertImage(photo, image);
+ * }
+ * @endcode
+ */
+class ThumbnailCache
+{
+public:
+    using Ptr = std::shared_ptr<ThumbnailCache>;
+
+    /**
+     * @brief 获取设备的缓存（同一设备共享同一实例）
+     * @param udid 设备 UDID
+     * @return 缓存实例，文件无法打开时返回的实例不命中也不写入
+     */
+    static Ptr forDevice(const QString &udid);
+
+    ~ThumbnailCache();
+
+    /**
+     * @brief 查找编码后的缩略图数据
+     * @return 未命中时返回空数组
+     */
+    QByteArray find(const PhotoInfo &photo);
+
+    /**
+     * @brief 追加编码后的缩略图数据
+     * @return 是否写入成功
+     */
+    bool insert(const PhotoInfo &photo, const QByteArray &encoded);
+
+    /**
+     * @brief 查找并解码缩略图
+     * @return 未命中时返回空图像
+     */
+    QImage findImage(const PhotoInfo &photo);
+
+    /**
+     * @brief 以 JPEG 编码缩略图并追加
+     */
+    bool insertImage(const PhotoInfo &photo, const QImage &image);
+
+    /**
+     * @brief 是否已缓存
+     */
+    bool contains(const PhotoInfo &photo) const;
+
+    /**
+     * @brief 有效条目数
+     */
+    int count() const;
+
+    /**
+     * @brief 删除所有条目并重建文件
+     */
+    void clear();
+
+    /**
+     * @brief 缓存根目录（%appdata%/iPhonLinkC/thumbnails）
+     */
+    static QString cacheDirectory();
+
+private:
+    /**
+     * @brief 索引记录（定长，按文件顺序追加，同一键以最后一条为准）
+     */
+    struct IndexRecord {
+        quint64 keyHash;    ///< 键的哈希
+        quint64 offset;     ///< 数据文件中的偏移
+        quint32 length;     ///< 条目总长度（含键）
+        quint32 reserved;   ///< 保留，写 0
+    };
+
+    explicit ThumbnailCache(const QString &udid);
+
+    /**
+     * @brief 打开（必要时创建）数据文件和索引文件并加载索引
+     */
+    bool open();
+
+    /**
+     * @brief 以内存映射方式读取索引文件，丢弃超出数据文件末尾的记录
+     */
+    void loadIndex();
+
+    /**
+     * @brief 失效数据过多或总大小超过上限时整理数据文件和索引文件
+     *
+     * 有效条目按写入顺序复制到临时文件，超过上限时跳过最早的条目，再替换原文件。
+     * @return 文件是否仍可用
+     */
+    bool compactIfNeeded();
+
+    /**
+     * @brief 截断并重新写入文件头
+     */
+    bool reset();
+
+    /**
+     * @brief 生成缓存键：路径 + 大小 + 修改时间
+     */
+    static QByteArray makeKey(const PhotoInfo &photo);
+
+    static quint64 hashKey(const QByteArray &key);
+
+    QString m_udid;                         ///< 设备 UDID
+    QString m_directory;                    ///< 设备缓存目录
+
+    mutable QMutex m_mutex;                 ///< 保护以下成员
+    QFile m_packFile;                       ///< thumbs.pack
+    QFile m_indexFile;                      ///< thumbs.idx
+    QHash<quint64, IndexRecord> m_index;    ///< 键哈希 -> 记录
+    qint64 m_liveBytes;                     ///< 索引引用的条目总长度，数据文件中其余为失效数据
+    bool m_open;                            ///< 文件是否可用
+};
+
+#endif // THUMBNAILCACHE_H
@@ -0,0 +1,492 @@
+/**
+ * @file thumbnailpipeline.cpp
+ * @brief 缩略图流水线实现
+ */
+
+#include "thumbnailpipeline.h"
+#include "heifthumbnail.h"
+#include "scaleddecoder.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMetaObject>
+#include <QSet>
+#include <QThread>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrent>
+
+// 交付间隔（毫秒），约一帧
+static const int FLUSH_INTERVAL_MS = 16;
+
+// 每次交付给界面的最大数量，剩余的留到下一帧，避免单次占用界面线程过久
+static const int MAX_RESULTS_PER_FLUSH = 64;
+
+// 每个解码线程允许排队的已读取数据数：让读取线程领先解码一点，又不至于缓存过多原图
+static const int READ_AHEAD_PER_DECODER = 2;
+
+// 队列中的过期条目超过此数量时整理一次
+static const int QUEUE_COMPACT_SLACK = 1024;
+
+// 连续这么多个资源都没有系统缩略图（且此前一个也没有命中）时，认为本设备不提供，之后不再尝试
+static const int MAX_DEVICE_THUMBNAIL_MISSES = 32;
+
+// 视频时长写入缓存缩略图的文本键（JPEG 注释段），缓存命中时无需再读取 moov
+static const char *DURATION_TEXT_KEY = "DurationMs";
+
+ThumbnailPipeline::ThumbnailPipeline(QObject *parent)
+    : QObject(parent)
+    , m_reader(nullptr)
+    , m_flushTimer(new QTimer(this))
+    , m_pendingCount(0)
+    , m_stopping(false)
+    , m_generation(0)
+{
+    const int decoders = qMax(1, QThread::idealThreadCount());
+    m_decodePool.setMaxThreadCount(decoders);
+    m_inFlight.release(decoders * READ_AHEAD_PER_DECODER);
+
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(FLUSH_INTERVAL_MS);
+    connect(m_flushTimer, &QTimer::timeout, this, &ThumbnailPipeline::flushResults);
+}
+
+ThumbnailPipeline::~ThumbnailPipeline()
+{
+    stopReader();
+    ++m_generation;
+    m_decodePool.waitForDone();
+}
+
+void ThumbnailPipeline::setDevice(const QString &udid)
+{
+    if (udid == m_udid && m_reader) {
+        return;
+    }
+
+    clearDevice();
+    m_udid = udid;
+
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_stopping = false;
+    }
+
+    ThumbnailCache::Ptr cache = ThumbnailCache::forDevice(udid);
+    m_reader = QThread::create([this, udid, cache]() {
+        readerLoop(udid, cache);
+    });
+    m_reader->setObjectName(QString("ThumbReader-%1").arg(udid.right(8)));
+    m_reader->start();
+}
+
+void ThumbnailPipeline::clearDevice()
+{
+    cancelAll();
+    stopReader();
+    m_udid.clear();
+}
+
+void ThumbnailPipeline::stopReader()
+{
+    if (!m_reader) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_stopping = true;
+        clearQueues();
+    }
+    m_queueWake.wakeAll();
+
+    m_reader->wait();
+    delete m_reader;
+    m_reader = nullptr;
+}
+
+void ThumbnailPipeline::request(const QVector<PhotoInfo> &photos, Priority priority)
+{
+    {
+        QMutexLocker locker(&m_queueMutex);
+        for (const PhotoInfo &photo : photos) {
+            enqueue(photo, priority);
+        }
+    }
+    m_queueWake.wakeAll();
+}
+
+void ThumbnailPipeline::request(const PhotoIndex &photos, const QVector<int> &records, Priority priority)
+{
+    {
+        QMutexLocker locker(&m_queueMutex);
+        for (int record : records) {
+            enqueue(photos.photo(record), priority);
+        }
+    }
+    m_queueWake.wakeAll();
+}
+
+void ThumbnailPipeline::enqueue(const PhotoInfo &photo, Priority priority)
+{
+    // 被界面缓存淘汰后重新请求的照片沿用原记录，索引不随滚动增长
+    int record = m_photos.indexOf(photo.path);
+    if (record < 0) {
+        record = m_photos.append(photo);
+        m_priorities.append(NOT_PENDING);
+    }
+    if (m_priorities.at(record) == NOT_PENDING) {
+        ++m_pendingCount;
+    }
+    m_priorities[record] = static_cast<qint8>(priority);
+    m_queues[static_cast<int>(priority)].enqueue(record);
+    if (priority != Priority::Idle) {
+        m_boosted.append(record);
+    }
+}
+
+void ThumbnailPipeline::prioritize(const QVector<QString> &visible, const QVector<QString> &prefetch)
+{
+    {
+        QMutexLocker locker(&m_queueMutex);
+
+        // 可见项排在队首，按本次顺序重建前两档
+        m_queues[static_cast<int>(Priority::Visible)].clear();
+        m_queues[static_cast<int>(Priority::Prefetch)].clear();
+
+        QVector<int> boostedRecords;
+        boostedRecords.reserve(visible.size() + prefetch.size());
+        QSet<int> boosted;
+        boosted.reserve(visible.size() + prefetch.size());
+        for (const QString &path : visible) {
+            const int record = m_photos.indexOf(path);
+            if (record >= 0 && !boosted.contains(record)) {
+                setPriority(record, Priority::Visible);
+                boosted.insert(record);
+                boostedRecords.append(record);
+            }
+        }
+        for (const QString &path : prefetch) {
+            const int record = m_photos.indexOf(path);
+            if (record >= 0 && !boosted.contains(record)) {
+                setPriority(record, Priority::Prefetch);
+                boosted.insert(record);
+                boostedRecords.append(record);
+            }
+        }
+
+        // 滚出预取范围的请求退回空闲档，空闲队列中仍保留着它们原来的位置
+        for (int record : m_boosted) {
+            if (!boosted.contains(record)) {
+                setPriority(record, Priority::Idle);
+            }
+        }
+        m_boosted.swap(boostedRecords);
+
+        QQueue<int> &idle = m_queues[static_cast<int>(Priority::Idle)];
+        if (idle.size() > m_pendingCount + QUEUE_COMPACT_SLACK) {
+            QQueue<int> compacted;
+            QSet<int> seen;
+            for (int record : idle) {
+                if (m_priorities.at(record) == static_cast<qint8>(Priority::Idle) && !seen.contains(record)) {
+                    seen.insert(record);
+                    compacted.enqueue(record);
+                }
+            }
+            idle.swap(compacted);
+        }
+    }
+    m_queueWake.wakeAll();
+}
+
+void ThumbnailPipeline::setPriority(int record, Priority priority)
+{
+    const qint8 current = m_priorities.at(record);
+    if (current == NOT_PENDING) {
+        return;
+    }
+    // 退回空闲档时若队列中已有该记录（原来的位置）则不重复加入
+    const bool queued = current == static_cast<qint8>(Priority::Idle) && priority == Priority::Idle;
+    m_priorities[record] = static_cast<qint8>(priority);
+    if (!queued) {
+        m_queues[static_cast<int>(priority)].enqueue(record);
+    }
+}
+
+bool ThumbnailPipeline::takeNext(PhotoInfo &photo)
+{
+    for (int level = 0; level < 3; ++level) {
+        QQueue<int> &queue = m_queues[level];
+        while (!queue.isEmpty()) {
+            const int record = queue.dequeue();
+            if (m_priorities.at(record) == level) {
+                m_priorities[record] = NOT_PENDING;
+                --m_pendingCount;
+                photo = m_photos.photo(record);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ThumbnailPipeline::clearQueues()
+{
+    m_photos.clear();
+    m_priorities.clear();
+    m_pendingCount = 0;
+    for (QQueue<int> &queue : m_queues) {
+        queue.clear();
+    }
+    m_boosted.clear();
+}
+
+void ThumbnailPipeline::cancelAll()
+{
+    ++m_generation;
+    {
+        QMutexLocker locker(&m_queueMutex);
+        clearQueues();
+    }
+    {
+        QMutexLocker locker(&m_resultMutex);
+        m_results.clear();
+    }
+    m_flushTimer->stop();
+}
+
+int ThumbnailPipeline::pendingCount() const
+{
+    QMutexLocker locker(&m_queueMutex);
+    return m_pendingCount;
+}
+
+void ThumbnailPipeline::readerLoop(const QString &udid, ThumbnailCache::Ptr cache)
+{
+    // 读取线程使用自己的 PhotoManager（共享设备会话，独立 AFC 连接），不与界面线程争用连接
+    PhotoManager device;
+    bool connected = false;
+    bool deviceThumbnails = false;
+    int deviceThumbnailMisses = 0;
+    int fromDeviceThumbnail = 0;
+    int fromDevice = 0;
+    int fromEmbedded = 0;
+    int fromVideo = 0;
+    int fromCache = 0;
+    qint64 bytesFromDevice = 0;
+
+    // 没有 HEIF 插件时整个 HEIC 文件也无法解码，不必传输
+    const QList<QByteArray> formats = QImageReader::supportedImageFormats();
+    const bool canDecodeHeif = formats.contains("heic") || formats.contains("heif");
+
+    for (;;) {
+        // 解码跟不上时在此等待，避免读取线程把大量原图堆在内存中。
+        // 先等待再取请求，这样取到的总是此刻优先级最高的请求
+        m_inFlight.acquire();
+
+        PhotoInfo photo;
+        quint64 generation;
+        {
+            QMutexLocker locker(&m_queueMutex);
+            while (!m_stopping && m_pendingCount == 0) {
+                m_queueWake.wait(&m_queueMutex);
+            }
+            if (m_stopping) {
+                m_inFlight.release();
+                break;
+            }
+            if (!takeNext(photo)) {
+                // 待处理请求都应在其档位的队列中，缺失时按当前档位重新入队
+                for (int record = 0; record < m_priorities.size(); ++record) {
+                    if (m_priorities.at(record) != NOT_PENDING) {
+                        m_queues[m_priorities.at(record)].enqueue(record);
+                    }
+                }
+                takeNext(photo);
+            }
+            generation = m_generation.load();
+        }
+
+        Source source = Source::Cache;
+        int orientation = 1;
+        qint64 durationMs = 0;
+        QByteArray data = cache->find(photo);
+        if (data.isEmpty()) {
+            if (!connected) {
+                connected = device.connectToDevice(udid);
+                deviceThumbnails = connected && device.hasDeviceThumbnails();
+            }
+            if (connected && deviceThumbnails && generation == m_generation.load()) {
+                // 系统预生成的缩略图一次读取即可，视频另外只解析 moov 取得时长
+                DeviceThumbnail::Result thumbnail = device.readDeviceThumbnail(photo.path, THUMBNAIL_SIZE);
+                bytesFromDevice += thumbnail.bytesRead;
+                if (!thumbnail.data.isEmpty()) {
+                    data = thumbnail.data;
+                    source = Source::Device;
+                    deviceThumbnailMisses = -1;
+                    if (photo.isVideo) {
+                        VideoThumbnail::Result video = device.readVideoThumbnail(photo.path, photo.size, false);
+                        bytesFromDevice += video.bytesRead;
+                        durationMs = video.durationMs;
+                    }
+                } else if (deviceThumbnailMisses >= 0 && ++deviceThumbnailMisses >= MAX_DEVICE_THUMBNAIL_MISSES) {
+                    qDebug() << "ThumbnailPipeline: 设备上没有系统缩略图，改为读取原文件" << udid;
+                    deviceThumbnails = false;
+                }
+            }
+            if (data.isEmpty() && connected && generation == m_generation.load()) {
+                // 优先只读取文件中的内嵌缩略图，没有时才传输整个文件；视频从不整个传输
+                if (photo.isVideo) {
+                    VideoThumbnail::Result video = device.readVideoThumbnail(photo.path, photo.size, canDecodeHeif);
+                    bytesFromDevice += video.bytesRead;
+                    data = video.data;
+                    orientation = video.orientation;
+                    durationMs = video.durationMs;
+                    source = Source::VideoFrame;
+                } else if (PhotoManager::hasEmbeddedThumbnail(photo.path)) {
+                    ExifThumbnail::Result embedded = device.readEmbeddedThumbnail(photo.path, photo.size, canDecodeHeif);
+                    bytesFromDevice += embedded.bytesRead;
+                    data = embedded.data;
+                    orientation = embedded.orientation;
+                    source = Source::Embedded;
+                }
+                if (data.isEmpty() && !photo.isVideo
+                    && (canDecodeHeif || !HeifThumbnail::isSupported(photo.path))) {
+                    data = device.readPhotoData(photo.path);
+                    bytesFromDevice += data.size();
+                    source = Source::FullFile;
+                    if (data.isEmpty()) {
+                        qDebug() << "ThumbnailPipeline: 读取数据失败(空):" << photo.path << "错误:" << device.lastError();
+                    }
+                }
+            }
+        }
+
+        if (data.isEmpty() || generation != m_generation.load()) {
+            // 没有可解码的数据（读取失败、无 HEIF 插件的 HEIC、无封面帧的视频）也交付空结果，
+            // 界面据此结束该项的等待状态并保留占位图；视频仍带有时长
+            if (generation == m_generation.load()) {
+                ThumbnailResult result;
+                result.path = photo.path;
+                result.durationMs = durationMs;
+                deliver(result, generation);
+            }
+            m_inFlight.release();
+            continue;
+        }
+
+        switch (source) {
+        case Source::Cache: ++fromCache; break;
+        case Source::Device: ++fromDeviceThumbnail; break;
+        case Source::Embedded: ++fromEmbedded; break;
+        case Source::VideoFrame: ++fromVideo; break;
+        case Source::FullFile: ++fromDevice; break;
+        }
+        QtConcurrent::run(&m_decodePool, [this, photo, data, source, orientation, durationMs, cache, generation]() {
+            decode(photo, data, source, orientation, durationMs, cache, generation);
+            m_inFlight.release();
+        });
+    }
+
+    device.disconnect();
+    qDebug() << "[性能] ThumbnailPipeline 读取线程退出" << udid << "系统缩略图:" << fromDeviceThumbnail
+             << "内嵌缩略图:" << fromEmbedded
+             << "视频关键帧:" << fromVideo
+             << "整个文件:" << fromDevice << "缓存命中:" << fromCache
+             << "设备读取:" << bytesFromDevice << "字节";
+}
+
+void ThumbnailPipeline::decode(const PhotoInfo &photo, const QByteArray &data, Source source, int orientation,
+                               qint64 durationMs, ThumbnailCache::Ptr cache, quint64 generation)
+{
+    if (generation != m_generation.load()) {
+        return;
+    }
+
+    QImage image;
+    if (source == Source::Cache) {
+        image.loadFromData(data);
+    } else {
+        // JPEG 在 IDCT 阶段直接解码为接近目标的尺寸，再面积平均缩小；
+        // 整个文件自带 EXIF 方向，交给 QImageReader 处理，其余来源的方向在缩小后处理
+        image = ScaledDecoder::decode(data, QSize(THUMBNAIL_SIZE, THUMBNAIL_SIZE), source == Source::FullFile);
+    }
+
+    if (image.isNull()) {
+        const QString ext = QFileInfo(photo.path).suffix().toLower();
+        qDebug() << "ThumbnailPipeline: 图片解码失败:" << photo.path
+                 << "格式:" << ext << "数据大小:" << data.size();
+        if (ext == "heic" || ext == "heif") {
+            qDebug() << "ThumbnailPipeline: 提示: Qt 可能缺少 HEIC/HEIF 图像格式插件";
+        }
+        // 交付空结果，界面不再等待也不再重新请求
+        ThumbnailResult result;
+        result.path = photo.path;
+        result.durationMs = durationMs;
+        deliver(result, generation);
+        return;
+    }
+
+    // 缓存中的已是缩略图，其余已在解码时缩小，在此写回缓存
+    if (source != Source::Cache) {
+        if (source == Source::Embedded || source == Source::VideoFrame) {
+            image = ExifThumbnail::applyOrientation(image, orientation);
+        }
+        if (durationMs > 0) {
+            image.setText(DURATION_TEXT_KEY, QString::number(durationMs));
+        }
+        cache->insertImage(photo, image);
+    } else if (photo.isVideo) {
+        durationMs = image.text(DURATION_TEXT_KEY).toLongLong();
+    }
+
+    ThumbnailResult result;
+    result.path = photo.path;
+    result.image = image;
+    result.durationMs = durationMs;
+    deliver(result, generation);
+}
+
+void ThumbnailPipeline::deliver(const ThumbnailResult &result, quint64 generation)
+{
+    bool first;
+    {
+        QMutexLocker locker(&m_resultMutex);
+        first = m_results.isEmpty();
+        m_results.append(qMakePair(generation, result));
+    }
+
+    // 第一条结果到达时启动交付定时器，之后到达的结果合并到同一批
+    if (first) {
+        QMetaObject::invokeMethod(this, [this]() {
+            if (!m_flushTimer->isActive()) {
+                m_flushTimer->start();
+            }
+        }, Qt::QueuedConnection);
+    }
+}
+
+void ThumbnailPipeline::flushResults()
+{
+    QVector<ThumbnailResult> batch;
+    bool more;
+    {
+        QMutexLocker locker(&m_resultMutex);
+        const quint64 generation = m_generation.load();
+        int taken = 0;
+        while (taken < m_results.size() && batch.size() < MAX_RESULTS_PER_FLUSH) {
+            if (m_results.at(taken).first == generation) {
+                batch.append(m_results.at(taken).second);
+            }
+            ++taken;
+        }
+        m_results.erase(m_results.begin(), m_results.begin() + taken);
+        more = !m_results.isEmpty();
+    }
+
+    if (more) {
+        m_flushTimer->start();
+    }
+    if (!batch.isEmpty()) {
+        emit thumbnailsReady(batch);
+    }
+}
@@ -0,0 +1,222 @@
+/**
+ * @file thumbnailpipeline.h
+ * @brief 缩略图流水线头文件
+ *
+ * 缩略图生成分为三个阶段，界面线程只做最后一步：
+ * 1. 读取线程：依次从本地缩略图缓存或设备（独立 AFC 连接）读取图片数据，
+ *    优先读取系统在 /PhotoData/Thumbnails 下预生成的缩略图；没有时 JPEG/RAW/HEIC
+ *    只读取文件中的内嵌缩略图，视频只读取 moov 和第一个关键帧
+ * 2. 解码线程池：JPEG 直接按 1/2、1/4、1/8 比例解码（ScaledDecoder），缩小为 100px 的 QImage，
+ *    写回本地缓存，按 CPU 核数并行
+ * 3. 界面交付：结果攒批后按帧间隔交给界面线程，每次交付数量有上限
+ *
+ * 请求按优先级分三档：可见、预取、空闲。读取线程每次取优先级最高的请求，
+ * 界面滚动时重新划分档位，滚出预取范围的请求退回空闲档，不再抢占可见项。
+ * 请求的照片保存在流水线自己的 PhotoIndex 中，队列只存记录号，PhotoInfo 在取出时才生成。
+ */
+
+#ifndef THUMBNAILPIPELINE_H
+#define THUMBNAILPIPELINE_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QQueue>
+#include <QImage>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <atomic>
+
+#include "photomanager.h"
+#include "photoindex.h"
+#include "thumbnailcache.h"
+
+class QThread;
+class QTimer;
+
+/**
+ * @brief 一张生成好的缩略图
+ */
+struct ThumbnailResult {
+    QString path;   ///< 照片在设备上的路径
+    QImage image;   ///< 缩略图（最长边不超过 ThumbnailPipeline::THUMBNAIL_SIZE），无法读取或解码时为空
+    qint64 durationMs = 0;  ///< 视频时长（毫秒），照片或未知时为 0
+};
+
+/**
+ * @brief 缩略图流水线
+ *
+ * 使用方法：
+ * @code
+ * ThumbnailPipeline *pipeline = new ThumbnailPipeline(this);
+ * connect(pipeline, &ThumbnailPipeline::thumbnailsReady, this, &PhotoPage::onThumbnailsReady);
+ * pipeline->setDevice(udid);
+ * pipeline->request(model->photoIndex(), rows);
+ * pipeline->prioritize(visiblePaths, prefetchPaths);   // 滚动时
+ * @endcode
+ */
+class ThumbnailPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// 缩略图最长边（像素）
+    static const int THUMBNAIL_SIZE = 100;
+
+    /**
+     * @brief 请求优先级（数值越小越先处理）
+     */
+    enum class Priority {
+        Visible = 0,    ///< 视口内
+        Prefetch = 1,   ///< 视口上下的预取范围
+        Idle = 2        ///< 其余，前两档为空时才处理
+    };
+
+    explicit ThumbnailPipeline(QObject *parent = nullptr);
+    ~ThumbnailPipeline();
+
+    /**
+     * @brief 切换设备，丢弃之前设备的所有请求
+     * @param udid 设备 UDID
+     */
+    void setDevice(const QString &udid);
+
+    /**
+     * @brief 停止读取线程并丢弃所有请求
+     */
+    void clearDevice();
+
+    /**
+     * @brief 请求生成缩略图（同一优先级内按请求顺序处理）
+     * @param photos 照片列表
+     * @param priority 优先级
+     */
+    void request(const QVector<PhotoInfo> &photos, Priority priority = Priority::Idle);
+
+    /**
+     * @brief 按记录号请求生成缩略图，不必先为每一行生成 PhotoInfo
+     * @param photos 调用方的照片索引（如照片网格模型的索引）
+     * @param records 记录号列表
+     * @param priority 优先级
+     */
+    void request(const PhotoIndex &photos, const QVector<int> &records, Priority priority = Priority::Idle);
+
+    /**
+     * @brief 按视口重新划分尚未读取的请求
+     *
+     * 列表中的请求提升到对应档位（按列表顺序处理），
+     * 之前提升过但不在本次列表中的请求退回空闲档。未请求过的路径被忽略。
+     *
+     * @param visible 视口内的照片路径
+     * @param prefetch 预取范围内的照片路径
+     */
+    void prioritize(const QVector<QString> &visible, const QVector<QString> &prefetch);
+
+    /**
+     * @brief 丢弃尚未完成的请求，已在处理中的结果也不再交付
+     */
+    void cancelAll();
+
+    /**
+     * @brief 尚未开始读取的请求数
+     */
+    int pendingCount() const;
+
+signals:
+    /**
+     * @brief 一批缩略图已生成（在本对象所在线程中发出）
+     * @param results 缩略图列表
+     */
+    void thumbnailsReady(const QVector<ThumbnailResult> &results);
+
+private:
+    /**
+     * @brief 图片数据来源
+     */
+    enum class Source {
+        Cache,      ///< 本地缩略图缓存（已缩放）
+        Device,     ///< 系统预生成的缩略图（已按方向渲染）
+        Embedded,   ///< EXIF 内嵌缩略图（需按主图方向旋转）
+        VideoFrame, ///< 视频关键帧（需按轨道方向旋转）
+        FullFile    ///< 整个文件
+    };
+
+    /**
+     * @brief 读取线程主循环
+     */
+    void readerLoop(const QString &udid, ThumbnailCache::Ptr cache);
+
+    /**
+     * @brief 停止并等待读取线程
+     */
+    void stopReader();
+
+    /**
+     * @brief 取出优先级最高的请求（调用方持有 m_queueMutex）
+     * @return 是否有请求
+     */
+    bool takeNext(PhotoInfo &photo);
+
+    /**
+     * @brief 清空所有请求（调用方持有 m_queueMutex）
+     */
+    void clearQueues();
+
+    /**
+     * @brief 加入一个请求，已请求过的路径沿用原来的记录号（调用方持有 m_queueMutex）
+     */
+    void enqueue(const PhotoInfo &photo, Priority priority);
+
+    /**
+     * @brief 设置请求的优先级并加入对应队列（调用方持有 m_queueMutex）
+     * @param record m_photos 中的记录号
+     */
+    void setPriority(int record, Priority priority);
+
+    /**
+     * @brief 解码并缩放（解码线程池中执行）
+     */
+    void decode(const PhotoInfo &photo, const QByteArray &data, Source source, int orientation,
+                qint64 durationMs, ThumbnailCache::Ptr cache, quint64 generation);
+
+    /**
+     * @brief 把结果交给界面交付阶段（任意线程调用）
+     */
+    void deliver(const ThumbnailResult &result, quint64 generation);
+
+    /**
+     * @brief 向界面交付一批结果（本对象线程中执行）
+     */
+    void flushResults();
+
+    QString m_udid;                         ///< 当前设备 UDID
+    QThread *m_reader;                      ///< 读取线程
+    QTimer *m_flushTimer;                   ///< 交付定时器（帧间隔）
+
+    /// 记录没有待处理请求时的档位
+    static const qint8 NOT_PENDING = -1;
+
+    // 请求队列（读取线程消费）。各档队列只存记录号，调整优先级时不从旧队列中删除，
+    // 取出时与 m_priorities 中的当前档位不符即跳过
+    mutable QMutex m_queueMutex;
+    QWaitCondition m_queueWake;
+    PhotoIndex m_photos;                    ///< 请求过的照片，记录号即请求 ID
+    QVector<qint8> m_priorities;            ///< 记录号 -> 当前档位，NOT_PENDING 表示不在等待中
+    int m_pendingCount;                     ///< 尚未读取的请求数
+    QQueue<int> m_queues[3];
+    QVector<int> m_boosted;                 ///< 上次 prioritize 提升的记录号
+    bool m_stopping;
+
+    std::atomic<quint64> m_generation;      ///< 递增即作废之前的请求
+    QSemaphore m_inFlight;                  ///< 已读取但未解码完的数量上限，限制内存占用
+
+    // 待交付结果
+    QMutex m_resultMutex;
+    QVector<QPair<quint64, ThumbnailResult>> m_results;
+
+    QThreadPool m_decodePool;               ///< 解码线程池（最后声明，最先析构并等待任务结束）
+};
+
+#endif // THUMBNAILPIPELINE_H
@@ -0,0 +1,394 @@
+/**
+ * @file videothumbnail.cpp
+ * @brief MOV/MP4 视频封面帧提取实现
+ */
+
+#include "videothumbnail.h"
+#include "afcrangereader.h"
+#include "heifthumbnail.h"
+#include "isobmff.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <QStringList>
+
+// moov 盒大小上限（几十分钟的视频也只有几百 KB 的样本表）
+static const qint64 MAX_MOOV_SIZE = 4 * 1024 * 1024;
+
+// 关键帧大小上限，4K HEVC 的 IDR 帧通常在 1MB 以内
+static const qint64 MAX_FRAME_SIZE = 4 * 1024 * 1024;
+
+// VisualSampleEntry 中子盒之前的固定字段长度
+static const int VISUAL_SAMPLE_ENTRY_SIZE = 78;
+
+// 在同一 chunk 中向前累加样本大小的上限，第一个关键帧通常位于 chunk 开头
+static const quint32 MAX_CHUNK_WALK = 4096;
+
+namespace {
+
+/**
+ * @brief 视频轨的解析结果
+ */
+struct VideoTrack {
+    QByteArray codec;           ///< 样本描述类型
+    QByteArray config;          ///< hvcC 盒（含盒头）
+    quint32 width = 0;
+    quint32 height = 0;
+    int orientation = 1;
+    qint64 frameOffset = 0;     ///< 第一个同步样本在文件中的偏移
+    qint64 frameSize = 0;       ///< 第一个同步样本的大小，0 表示未能定位
+};
+
+bool isJpegCodec(const QByteArray &codec)
+{
+    return codec == "jpeg" || codec == "mjpa";
+}
+
+bool isHevcCodec(const QByteArray &codec)
+{
+    return codec == "hvc1" || codec == "hev1";
+}
+
+/**
+ * @brief 从 mvhd 读取时长（毫秒）
+ */
+qint64 parseDuration(const QByteArray &data, int begin, int end)
+{
+    IsoBox mvhd;
+    if (!IsoBmff::findChild(data, begin, end, "mvhd", mvhd)) {
+        return 0;
+    }
+    IsoByteReader r(data, mvhd.payload, mvhd.end);
+    const int version = IsoBmff::fullBoxVersion(r);
+    r.skip(version == 1 ? 16 : 8); // creation_time, modification_time
+    const quint32 timescale = r.u32();
+    const quint64 duration = version == 1 ? r.u64() : r.u32();
+    // 全 1 表示时长未知
+    const quint64 unknown = version == 1 ? ~0ULL : 0xFFFFFFFFULL;
+    if (!r.ok() || timescale == 0 || duration == unknown) {
+        return 0;
+    }
+    return static_cast<qint64>(duration * 1000 / timescale);
+}
+
+/**
+ * @brief 把 tkhd 中的显示矩阵换算为 EXIF 方向值
+ *
+ * 矩阵为 16.16 定点数 {a, b, u, c, d, v, x, y, w}，竖拍的 iPhone 视频为顺时针旋转 90 度。
+ */
+int parseOrientation(const QByteArray &data, const IsoBox &tkhd)
+{
+    IsoByteReader r(data, tkhd.payload, tkhd.end);
+    const int version = IsoBmff::fullBoxVersion(r);
+    // 时间、track_ID、时长，以及 reserved、layer、alternate_group、volume
+    r.skip((version == 1 ? 32 : 20) + 16);
+    const qint32 a = static_cast<qint32>(r.u32());
+    const qint32 b = static_cast<qint32>(r.u32());
+    r.u32();
+    const qint32 c = static_cast<qint32>(r.u32());
+    const qint32 d = static_cast<qint32>(r.u32());
+    if (!r.ok()) {
+        return 1;
+    }
+
+    if (a == 0 && b > 0 && c < 0 && d == 0) {
+        return 6;
+    }
+    if (a < 0 && b == 0 && c == 0 && d < 0) {
+        return 3;
+    }
+    if (a == 0 && b < 0 && c > 0 && d == 0) {
+        return 8;
+    }
+    return 1;
+}
+
+/**
+ * @brief 读取 stsd 中第一个样本描述的编码、尺寸和解码配置
+ */
+bool parseSampleEntry(const QByteArray &data, const IsoBox &stbl, VideoTrack &track)
+{
+    IsoBox stsd;
+    if (!IsoBmff::findChild(data, stbl.payload, stbl.end, "stsd", stsd)) {
+        return false;
+    }
+    IsoByteReader r(data, stsd.payload, stsd.end);
+    IsoBmff::fullBoxVersion(r);
+    r.u32(); // entry_count，只看第一个
+    const QVector<IsoBox> entries = IsoBmff::childBoxes(data, r.pos(), stsd.end);
+    if (!r.ok() || entries.isEmpty()) {
+        return false;
+    }
+
+    const IsoBox &entry = entries.first();
+    track.codec = entry.type;
+
+    // reserved(6) + data_reference_index(2) + pre_defined/reserved(16) 之后是宽高
+    IsoByteReader e(data, entry.payload, entry.end);
+    e.skip(24);
+    track.width = e.u16();
+    track.height = e.u16();
+
+    const int children = entry.payload + VISUAL_SAMPLE_ENTRY_SIZE;
+    IsoBox config;
+    if (children <= entry.end && IsoBmff::findChild(data, children, entry.end, "hvcC", config)) {
+        track.config = data.mid(config.begin, config.end - config.begin);
+    }
+    return e.ok();
+}
+
+/**
+ * @brief 第一个同步样本的序号（从 1 开始），没有 stss 时所有样本都是同步样本
+ */
+quint32 firstSyncSample(const QByteArray &data, const IsoBox &stbl)
+{
+    IsoBox stss;
+    if (!IsoBmff::findChild(data, stbl.payload, stbl.end, "stss", stss)) {
+        return 1;
+    }
+    IsoByteReader r(data, stss.payload, stss.end);
+    IsoBmff::fullBoxVersion(r);
+    const quint32 count = r.u32();
+    const quint32 sample = r.u32();
+    return (r.ok() && count > 0) ? sample : 0;
+}
+
+/**
+ * @brief 样本大小表（stsz 或 stz2）
+ */
+class SampleSizes
+{
+public:
+    bool parse(const QByteArray &data, const IsoBox &stbl)
+    {
+        IsoBox box;
+        if (IsoBmff::findChild(data, stbl.payload, stbl.end, "stsz", box)) {
+            IsoByteReader r(data, box.payload, box.end);
+            IsoBmff::fullBoxVersion(r);
+            m_fixed = r.u32();
+            m_count = r.u32();
+            m_fieldBits = 32;
+            m_entries = r.pos();
+            return r.ok();
+        }
+        if (IsoBmff::findChild(data, stbl.payload, stbl.end, "stz2", box)) {
+            IsoByteReader r(data, box.payload, box.end);
+            IsoBmff::fullBoxVersion(r);
+            r.skip(3); // reserved
+            m_fieldBits = static_cast<int>(r.u8());
+            m_count = r.u32();
+            m_entries = r.pos();
+            return r.ok() && (m_fieldBits == 4 || m_fieldBits == 8 || m_fieldBits == 16);
+        }
+        return false;
+    }
+
+    /**
+     * @brief 第 sample 个样本（从 1 开始）的大小，越界返回 -1
+     */
+    qint64 size(const QByteArray &data, quint32 sample) const
+    {
+        if (sample == 0 || sample > m_count) {
+            return -1;
+        }
+        if (m_fixed != 0) {
+            return m_fixed;
+        }
+        const quint64 index = sample - 1;
+        const quint64 bitOffset = index * static_cast<quint64>(m_fieldBits);
+        IsoByteReader r(data, static_cast<int>(qMin<quint64>(m_entries + bitOffset / 8, data.size())));
+        if (m_fieldBits == 4) {
+            const quint32 value = r.u8();
+            return r.ok() ? static_cast<qint64>((index & 1) ? (value & 0x0F) : (value >> 4)) : -1;
+        }
+        const quint64 value = r.read(m_fieldBits / 8);
+        return r.ok() ? static_cast<qint64>(value) : -1;
+    }
+
+private:
+    quint32 m_fixed = 0;
+    quint32 m_count = 0;
+    int m_fieldBits = 32;
+    int m_entries = 0;
+};
+
+/**
+ * @brief 通过 stsc、stco/co64 和样本大小表计算样本在文件中的偏移和大小
+ */
+bool locateSample(const QByteArray &data, const IsoBox &stbl, quint32 sample, VideoTrack &track)
+{
+    SampleSizes sizes;
+    IsoBox stsc;
+    IsoBox chunks;
+    int offsetBytes = 4;
+    if (!sizes.parse(data, stbl) || !IsoBmff::findChild(data, stbl.payload, stbl.end, "stsc", stsc)) {
+        return false;
+    }
+    if (!IsoBmff::findChild(data, stbl.payload, stbl.end, "stco", chunks)) {
+        if (!IsoBmff::findChild(data, stbl.payload, stbl.end, "co64", chunks)) {
+            return false;
+        }
+        offsetBytes = 8;
+    }
+
+    IsoByteReader c(data, chunks.payload, chunks.end);
+    IsoBmff::fullBoxVersion(c);
+    const quint32 chunkCount = c.u32();
+    const int chunkTable = c.pos();
+    // chunk 数来自文件，必须与偏移表的实际长度一致，否则后面的偏移计算会越界
+    if (!c.ok() || chunkCount > static_cast<quint32>((chunks.end - chunkTable) / offsetBytes)) {
+        return false;
+    }
+
+    IsoByteReader r(data, stsc.payload, stsc.end);
+    IsoBmff::fullBoxVersion(r);
+    const quint32 runCount = r.u32();
+    if (!c.ok() || !r.ok()) {
+        return false;
+    }
+
+    // stsc 中每一项描述从 first_chunk 开始、每个 chunk 样本数相同的一段
+    quint64 runStart = 1;
+    quint32 firstChunk = r.u32();
+    quint32 samplesPerChunk = r.u32();
+    r.u32(); // sample_description_index
+    for (quint32 i = 0; i < runCount && r.ok(); ++i) {
+        quint32 nextChunk = chunkCount + 1;
+        quint32 nextSamples = 0;
+        if (i + 1 < runCount) {
+            nextChunk = r.u32();
+            nextSamples = r.u32();
+            r.u32();
+        }
+        if (firstChunk == 0 || samplesPerChunk == 0 || nextChunk <= firstChunk || nextChunk > chunkCount + 1) {
+            return false;
+        }
+
+        const quint64 runSamples = static_cast<quint64>(nextChunk - firstChunk) * samplesPerChunk;
+        if (sample < runStart + runSamples) {
+            const quint64 chunkIndex = (sample - runStart) / samplesPerChunk;
+            const quint32 chunk = firstChunk + static_cast<quint32>(chunkIndex);
+            const quint32 firstInChunk = static_cast<quint32>(runStart + chunkIndex * samplesPerChunk);
+            if (sample - firstInChunk > MAX_CHUNK_WALK) {
+                return false;
+            }
+
+            // chunk 不超过 chunkCount，位置落在偏移表内
+            const qint64 position = chunkTable + static_cast<qint64>(chunk - 1) * offsetBytes;
+            IsoByteReader o(data, static_cast<int>(position), chunks.end);
+            qint64 offset = static_cast<qint64>(o.read(offsetBytes));
+            if (!o.ok()) {
+                return false;
+            }
+            // 同一 chunk 中的样本紧密排列
+            for (quint32 s = firstInChunk; s < sample; ++s) {
+                const qint64 size = sizes.size(data, s);
+                if (size < 0) {
+                    return false;
+                }
+                offset += size;
+            }
+            track.frameOffset = offset;
+            track.frameSize = qMax<qint64>(0, sizes.size(data, sample));
+            return track.frameSize > 0;
+        }
+
+        runStart += runSamples;
+        firstChunk = nextChunk;
+        samplesPerChunk = nextSamples;
+    }
+    return false;
+}
+
+/**
+ * @brief 解析 trak，是视频轨时返回 true
+ */
+bool parseTrack(const QByteArray &data, const IsoBox &trak, VideoTrack &track)
+{
+    IsoBox mdia;
+    IsoBox hdlr;
+    if (!IsoBmff::findChild(data, trak.payload, trak.end, "mdia", mdia)
+        || !IsoBmff::findChild(data, mdia.payload, mdia.end, "hdlr", hdlr)) {
+        return false;
+    }
+    IsoByteReader h(data, hdlr.payload, hdlr.end);
+    IsoBmff::fullBoxVersion(h);
+    h.u32(); // pre_defined
+    if (h.fourcc() != "vide") {
+        return false;
+    }
+
+    IsoBox minf;
+    IsoBox stbl;
+    if (!IsoBmff::findChild(data, mdia.payload, mdia.end, "minf", minf)
+        || !IsoBmff::findChild(data, minf.payload, minf.end, "stbl", stbl)
+        || !parseSampleEntry(data, stbl, track)) {
+        return false;
+    }
+
+    IsoBox tkhd;
+    if (IsoBmff::findChild(data, trak.payload, trak.end, "tkhd", tkhd)) {
+        track.orientation = parseOrientation(data, tkhd);
+    }
+
+    const quint32 sync = firstSyncSample(data, stbl);
+    if (sync != 0) {
+        locateSample(data, stbl, sync, track);
+    }
+    return true;
+}
+
+} // namespace
+
+bool VideoThumbnail::isSupported(const QString &path)
+{
+    static const QStringList extensions = {"mov", "mp4", "m4v", "3gp"};
+    return extensions.contains(QFileInfo(path).suffix().toLower());
+}
+
+VideoThumbnail::Result VideoThumbnail::extract(void *afcClient, const QString &path, qint64 fileSize,
+                                               bool readHevcFrame)
+{
+    Result result;
+
+    AfcRangeReader reader(afcClient, path, fileSize);
+    if (!reader.isOpen()) {
+        return result;
+    }
+
+    QByteArray moov;
+    int payload = 0;
+    if (!IsoBmff::readTopLevelBox(reader, "moov", MAX_MOOV_SIZE, moov, payload)) {
+        result.bytesRead = reader.bytesRead();
+        qDebug() << "VideoThumbnail: 未找到 moov" << path << "已读取:" << result.bytesRead;
+        return result;
+    }
+
+    result.durationMs = parseDuration(moov, payload, moov.size());
+
+    VideoTrack track;
+    for (const IsoBox &trak : IsoBmff::childBoxes(moov, payload, moov.size())) {
+        if (trak.type == "trak" && parseTrack(moov, trak, track)) {
+            break;
+        }
+        track = VideoTrack();
+    }
+    result.codec = track.codec;
+    result.orientation = track.orientation;
+
+    // 只有能解码的编码才读取关键帧
+    const bool jpeg = isJpegCodec(track.codec);
+    const bool hevc = isHevcCodec(track.codec) && readHevcFrame && !track.config.isEmpty()
+                      && track.width > 0 && track.height > 0;
+    QByteArray frame;
+    if ((jpeg || hevc) && track.frameSize > 0 && track.frameSize <= MAX_FRAME_SIZE
+        && reader.read(track.frameOffset, track.frameSize, frame)) {
+        result.data = jpeg ? frame : HeifThumbnail::wrapHevcImage(track.config, track.width, track.height, frame);
+    }
+    result.bytesRead = reader.bytesRead();
+
+    if (result.data.isEmpty()) {
+        qDebug() << "VideoThumbnail: 未提取封面帧" << path << "编码:" << track.codec
+                 << "时长(ms):" << result.durationMs << "已读取:" << result.bytesRead;
+    }
+    return result;
+}
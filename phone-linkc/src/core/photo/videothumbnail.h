@@ -0,0 +1,69 @@
+/**
+ * @file videothumbnail.h
+ * @brief MOV/MP4 视频封面帧提取头文件
+ *
+ * 视频文件动辄几百 MB，不能为了一张 100px 的缩略图整个传输。
+ * MOV/MP4 的 moov 盒记录了时长和每个样本（帧）在文件中的位置，通常只有几十到几百 KB，
+ * iPhone 拍摄的文件中它可能位于开头，也可能位于 mdat 之后。这里只读取：
+ * - 顶层盒头和 moov 盒；
+ * - 视频轨第一个同步样本（关键帧）的字节范围。
+ * 单个视频的读取量不超过 moov 与一帧之和（各有上限，合计几 MB）。
+ */
+
+#ifndef VIDEOTHUMBNAIL_H
+#define VIDEOTHUMBNAIL_H
+
+#include <QString>
+#include <QByteArray>
+
+/**
+ * @brief 视频封面帧提取器
+ *
+ * 项目中没有 H.264/HEVC 解码器，关键帧按编码处理：
+ * - Motion JPEG（jpeg/mjpa）：帧本身就是 JPEG；
+ * - HEVC（hvc1/hev1）：与样本描述中的 hvcC 一起封装为最小 HEIF 文件，有 HEIF 插件时可解码；
+ * - 其他编码（如 H.264）：不读取帧数据，只返回时长，界面显示占位图和时长。
+ *
+ * 使用方法：
+ * @code
+ * if (VideoThumbnail::isSupported(path)) {
+ *     VideoThumbnail::Result result = VideoThumbnail::extract(afcClient, path, size, canDecodeHeif);
+ *     if (!result.data.isEmpty()) {
+ *         QImage image = ExifThumbnail::applyOrientation(QImage::fromData(result.data), result.orientation);
+ *     }
+ *     showDuration(result.durationMs);
+ * }
+ * @endcode
+ */
+class VideoThumbnail
+{
+public:
+    /**
+     * @brief 提取结果
+     */
+    struct Result {
+        QByteArray data;            ///< 可用 QImage 解码的帧（JPEG 或最小 HEIF 文件），为空表示无法提取
+        QByteArray codec;           ///< 视频轨的编码（样本描述类型，如 avc1、hvc1、jpeg）
+        int orientation = 1;        ///< 轨道矩阵换算的 EXIF 方向值
+        qint64 durationMs = 0;      ///< 视频时长（毫秒），0 表示未知
+        qint64 bytesRead = 0;       ///< 从设备读取的字节数
+    };
+
+    /**
+     * @brief 是否为 MOV/MP4 系列格式（按扩展名判断）
+     */
+    static bool isSupported(const QString &path);
+
+    /**
+     * @brief 通过 AFC 范围读取提取视频时长和第一个关键帧
+     * @param afcClient AFC 客户端（afc_client_t）
+     * @param path 设备上的文件路径
+     * @param fileSize 文件大小，未知时传 0（将先查询文件信息）
+     * @param readHevcFrame 是否读取 HEVC 关键帧（没有 HEIF 插件时传 false，只解析时长）
+     * @return 提取结果
+     */
+    static Result extract(void *afcClient, const QString &path, qint64 fileSize = 0,
+                          bool readHevcFrame = true);
+};
+
+#endif // VIDEOTHUMBNAIL_H
@@ -70,6 +70,18 @@ typedef afc_error_t (*afc_file_close_func)(afc_client_t client, uint64_t handle)
  */
 typedef afc_error_t (*afc_file_read_func)(afc_client_t client, uint64_t handle, char *data, uint32_t length, uint32_t *bytes_read);
 
+/**
+ * 移动文件读写位置
+ * @原型 afc_error_t afc_file_seek(afc_client_t client, uint64_t handle, int64_t offset, int whence);
+ */
+typedef afc_error_t (*afc_file_seek_func)(afc_client_t client, uint64_t handle, int64_t offset, int whence);
+
+/**
+ * 获取文件读写位置
+ * @原型 afc_error_t afc_file_tell(afc_client_t client, uint64_t handle, uint64_t *position);
+ */
+typedef afc_error_t (*afc_file_tell_func)(afc_client_t client, uint64_t handle, uint64_t *position);
+
 /**
  * 写入文件内容
  * @原型 afc_error_t afc_file_write(afc_client_t client, uint64_t handle, const char *data, uint32_t length, uint32_t *bytes_written);
@@ -1,10 +1,14 @@
 #include "libimobiledevice_dynamic.h"
+#ifdef PHONELINKC_WITH_SIMULATOR
+#include "simulated_backend.h"
+#endif
 #include <QDir>
 #include <QCoreApplication>
 #include <QStandardPaths>
 
 LibimobiledeviceDynamic::LibimobiledeviceDynamic()
     : m_initialized(false)
+    , m_simulated(false)
 #ifdef _WIN32
     , m_imobiledeviceLib(nullptr)
     , m_plistLib(nullptr)
@@ -75,6 +79,8 @@ LibimobiledeviceDynamic::LibimobiledeviceDynamic()
     afc_file_open = nullptr;
     afc_file_close = nullptr;
     afc_file_read = nullptr;
+    afc_file_seek = nullptr;
+    afc_file_tell = nullptr;
     afc_file_write = nullptr;
     afc_make_directory = nullptr;
     afc_remove_path = nullptr;
@@ -126,6 +132,86 @@ bool LibimobiledeviceDynamic::initialize()
         return true;
     }
 
+#ifdef PHONELINKC_WITH_SIMULATOR
+    if (SimulatedBackend::isRequested()) {
+        qDebug() << "检测到 PHONELINKC_SIMULATOR，使用模拟设备后端";
+        return initializeSimulated(SimulatedBackendConfig::fromEnvironment());
+    }
+#endif
+
+    return loadNativeLibraries();
+}
+
+bool LibimobiledeviceDynamic::initializeSimulated(const SimulatedBackendConfig& config)
+{
+#ifndef PHONELINKC_WITH_SIMULATOR
+    Q_UNUSED(config);
+    qWarning() << "此构建未包含模拟设备后端";
+    return false;
+#else
+    if (m_initialized && !m_simulated) {
+        qWarning() << "已加载真实设备库，无法切换到模拟后端";
+        return false;
+    }
+
+    if (!m_initialized) {
+#ifdef _WIN32
+        // plist 函数仍使用真实的 libplist，这里复用原生加载流程
+        if (!loadNativeLibraries()) {
+            return false;
+        }
+#elif defined(HAVE_LIBIMOBILEDEVICE)
+        bindLinkedPlistFunctions();
+#else
+        qWarning() << "模拟后端需要 libplist 支持";
+        return false;
+#endif
+    }
+
+    SimulatedBackend::configure(config);
+    SimulatedBackend::install(*this);
+
+    m_simulated = true;
+    m_initialized = true;
+    qDebug() << "模拟设备后端已启用";
+    return true;
+#endif
+}
+
+#if !defined(_WIN32) && defined(HAVE_LIBIMOBILEDEVICE)
+void LibimobiledeviceDynamic::bindLinkedPlistFunctions()
+{
+    // 非 Windows 平台在链接期即引入 libplist，直接取函数地址
+    plist_free = &::plist_free;
+    plist_get_node_type = &::plist_get_node_type;
+    plist_get_string_val = &::plist_get_string_val;
+    plist_get_string_ptr = &::plist_get_string_ptr;
+    plist_get_bool_val = &::plist_get_bool_val;
+    plist_get_uint_val = &::plist_get_uint_val;
+    plist_get_data_val = &::plist_get_data_val;
+    plist_new_dict = &::plist_new_dict;
+    plist_new_string = &::plist_new_string;
+    plist_new_bool = &::plist_new_bool;
+    plist_dict_set_item = &::plist_dict_set_item;
+    plist_array_get_size = &::plist_array_get_size;
+    plist_array_get_item = &::plist_array_get_item;
+    plist_dict_get_item = &::plist_dict_get_item;
+    plist_dict_new_iter = &::plist_dict_new_iter;
+    plist_dict_next_item = &::plist_dict_next_item;
+    plist_new_array = &::plist_new_array;
+    plist_array_append_item = &::plist_array_append_item;
+    plist_new_uint = &::plist_new_uint;
+    plist_new_int = &::plist_new_int;
+    plist_new_date = &::plist_new_date;
+    // 与 Windows 上 GetProcAddress 的处理一致：返回值类型与 typedef 不同（plist_err_t），按地址转换
+    plist_to_xml = reinterpret_cast<plist_to_xml_func>(&::plist_to_xml);
+    plist_to_bin = reinterpret_cast<plist_to_bin_func>(&::plist_to_bin);
+    plist_mem_free = &::plist_mem_free;
+}
+#endif
+
+bool LibimobiledeviceDynamic::loadNativeLibraries()
+{
 #ifdef _WIN32
     qDebug() << "开始初始化动态库加载器...";
     
@@ -250,6 +336,8 @@ bool LibimobiledeviceDynamic::initialize()
     success &= loadAndTrack("afc_file_open", afc_file_open, m_imobiledeviceLib);
     success &= loadAndTrack("afc_file_close", afc_file_close, m_imobiledeviceLib);
     success &= loadAndTrack("afc_file_read", afc_file_read, m_imobiledeviceLib);
+    success &= loadAndTrack("afc_file_seek", afc_file_seek, m_imobiledeviceLib);
+    success &= loadAndTrack("afc_file_tell", afc_file_tell, m_imobiledeviceLib);
     success &= loadAndTrack("afc_file_write", afc_file_write, m_imobiledeviceLib);
     success &= loadAndTrack("afc_make_directory", afc_make_directory, m_imobiledeviceLib);
     success &= loadAndTrack("afc_remove_path", afc_remove_path, m_imobiledeviceLib);
@@ -452,6 +540,8 @@ void LibimobiledeviceDynamic::cleanup()
     afc_file_open = nullptr;
     afc_file_close = nullptr;
     afc_file_read = nullptr;
+    afc_file_seek = nullptr;
+    afc_file_tell = nullptr;
     afc_file_write = nullptr;
     afc_make_directory = nullptr;
     afc_remove_path = nullptr;
@@ -459,13 +549,14 @@ void LibimobiledeviceDynamic::cleanup()
     afc_dictionary_free = nullptr;
     
     m_initialized = false;
+    m_simulated = false;
     qDebug() << "动态库加载器已清理";
 }
 
+#ifdef _WIN32
 template<typename T>
 bool LibimobiledeviceDynamic::loadFunction(const QString& functionName, T& functionPtr, HMODULE library)
 {
-#ifdef _WIN32
     FARPROC proc = GetProcAddress(library, functionName.toLocal8Bit().constData());
     if (!proc) {
         qWarning() << "无法加载函数:" << functionName;
@@ -475,10 +566,5 @@ bool LibimobiledeviceDynamic::loadFunction(const QString& functionName, T& funct
     functionPtr = reinterpret_cast<T>(proc);
     qDebug() << "成功加载函数:" << functionName;
     return true;
-#else
-    Q_UNUSED(functionName)
-    Q_UNUSED(functionPtr)
-    Q_UNUSED(library)
-    return false;
-#endif
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
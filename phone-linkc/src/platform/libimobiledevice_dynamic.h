@@ -55,6 +55,8 @@
 #include "mobilesync_dynamic.h"
 #include "mobilebackup2_dynamic.h"
 
+struct SimulatedBackendConfig;
+
 /* ============================================================================
  * idevice 函数指针类型定义
  *
@@ -281,6 +283,27 @@ public:
      */
     bool isInitialized() const { return m_initialized; }
     
+    /**
+     * @brief 使用进程内模拟设备后端初始化
+     *
+     * plist 函数仍指向真实的 libplist，其余设备相关函数指针由 SimulatedBackend 填充。
+     * 设置环境变量 PHONELINKC_SIMULATOR 后 initialize() 会自动走此路径。
+     * 只有定义了 PHONELINKC_WITH_SIMULATOR 的构建（phone-linkc-bench）包含模拟后端。
+     *
+     * @param config 模拟后端配置
+     * @return true 初始化成功
+     * @return false 未包含模拟后端、libplist 不可用，或已加载真实设备库
+     *
+     * @note 已处于模拟模式时再次调用会按新配置重建模拟数据
+     * @see SimulatedBackend
+     */
+    bool initializeSimulated(const SimulatedBackendConfig& config);
+    
+    /**
+     * @brief 是否运行在模拟设备后端上
+     */
+    bool isSimulated() const { return m_simulated; }
+    
     /* ========================================================================
      * libimobiledevice 库函数指针
      *
@@ -372,6 +395,8 @@ public:
     afc_file_open_func afc_file_open;                     ///< 打开文件
     afc_file_close_func afc_file_close;                   ///< 关闭文件
     afc_file_read_func afc_file_read;                     ///< 读取文件
+    afc_file_seek_func afc_file_seek;                     ///< 移动读写位置
+    afc_file_tell_func afc_file_tell;                     ///< 获取读写位置
     afc_file_write_func afc_file_write;                   ///< 写入文件
     afc_make_directory_func afc_make_directory;           ///< 创建目录
     afc_remove_path_func afc_remove_path;                 ///< 删除路径
@@ -456,6 +481,21 @@ private:
      */
     bool loadLibrary(const QString& path);
     
+    /**
+     * @brief 加载真实的 libimobiledevice 和 plist 动态库
+     *
+     * @return true 全部函数加载成功
+     * @return false 库文件缺失或函数解析失败（非 Windows 平台始终返回 false）
+     */
+    bool loadNativeLibraries();
+    
+#if !defined(_WIN32) && defined(HAVE_LIBIMOBILEDEVICE)
+    /**
+     * @brief 将 plist 函数指针绑定到链接期引入的 libplist
+     */
+    void bindLinkedPlistFunctions();
+#endif
+    
     /**
      * @brief 从动态库加载函数
      *
@@ -466,14 +506,17 @@ private:
      * @return true 加载成功
      * @return false 加载失败（函数不存在）
      */
+#ifdef _WIN32
     template<typename T>
     bool loadFunction(const QString& functionName, T& functionPtr, HMODULE library);
+#endif
     
     /* ========================================================================
      * 私有成员变量
      * ======================================================================== */
     
     bool m_initialized;  ///< 初始化状态标志
+    bool m_simulated;    ///< 是否使用模拟设备后端
     
 #ifdef _WIN32
     HMODULE m_imobiledeviceLib;  ///< libimobiledevice 动态库句柄
@@ -0,0 +1,2165 @@
+#include "simulated_backend.h"
+#include "libimobiledevice_dynamic.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QImage>
+#include <QBuffer>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+static const char* SIMULATOR_ENV = "PHONELINKC_SIMULATOR";
+static const char* DEFAULT_UDID = "00008110-000A1B2C3D4E5F60";
+
+namespace {
+
+/* ============================================================================
+ * 内部数据结构
+ * ============================================================================ */
+
+struct SimNode {
+    bool isDir = false;
+    bool synthetic = false;     ///< 内容按需生成
+    qint64 size = 0;
+    qint64 mtimeNs = 0;
+    QByteArray data;
+    QStringList children;       ///< 目录项（按创建顺序）
+};
+
+struct SimOpenFile {
+    QString path;
+    qint64 position = 0;
+    bool writable = false;
+    std::shared_ptr<QFile> localFile;   ///< 本地目录模式下的文件
+};
+
+// 以下句柄结构体通过 reinterpret_cast 转换为库的不透明指针类型
+struct SimDevice { QString udid; };
+struct SimLockdown { QString udid; };
+struct SimAfcClient { QString udid; };
+struct SimInstproxy { QString udid; };
+struct SimMobilesync { QString udid; int cursor = 0; };
+struct SimSubscription { idevice_event_cb_t callback; void *userData; };
+
+struct SimApp {
+    QString bundleId;
+    QString name;
+    QString version;
+    quint64 staticSize;
+    quint64 dynamicSize;
+};
+
+struct SimState {
+    QMutex mutex;                               ///< 保护以下所有容器
+    SimulatedBackendConfig config;
+    QStringList attachedDevices;
+    QHash<QString, SimNode> nodes;
+    QHash<quint64, std::shared_ptr<SimOpenFile>> openFiles;
+    quint64 nextHandle = 1;
+    QVector<SimApp> apps;
+    QList<SimSubscription*> subscriptions;
+    QByteArray jpegTemplate;
+    QByteArray heicTemplate;
+    QByteArray movTemplate;
+
+    std::mutex linkMutex;                       ///< 共享链路占用时间
+    std::chrono::steady_clock::time_point linkFreeAt;
+
+    std::atomic<qint64> latencyUs{0};
+    std::atomic<qint64> handshakeLatencyUs{0};
+    std::atomic<qint64> bandwidth{0};
+
+    std::atomic<quint64> roundTrips{0};
+    std::atomic<quint64> handshakes{0};
+    std::atomic<quint64> bytesRead{0};
+    std::atomic<quint64> bytesWritten{0};
+};
+
+SimState &state()
+{
+    static SimState s;
+    return s;
+}
+
+/* ============================================================================
+ * 时延与带宽模拟
+ * ============================================================================ */
+
+void sleepMicroseconds(qint64 us)
+{
+    if (us > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+}
+
+void roundTrip()
+{
+    SimState &s = state();
+    s.roundTrips++;
+    sleepMicroseconds(s.latencyUs.load());
+}
+
+void handshake()
+{
+    SimState &s = state();
+    s.handshakes++;
+    roundTrip();
+    sleepMicroseconds(s.handshakeLatencyUs.load());
+}
+
+// 所有客户端共享同一条链路：传输按到达顺序排队占用带宽
+void transfer(qint64 bytes)
+{
+    SimState &s = state();
+    const qint64 bandwidth = s.bandwidth.load();
+    if (bandwidth <= 0 || bytes <= 0) {
+        return;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto cost = std::chrono::nanoseconds(bytes * 1000000000LL / bandwidth);
+    Clock::time_point until;
+    {
+        std::lock_guard<std::mutex> lock(s.linkMutex);
+        const Clock::time_point start = std::max(Clock::now(), s.linkFreeAt);
+        s.linkFreeAt = std::chrono::time_point_cast<Clock::duration>(start + cost);
+        until = s.linkFreeAt;
+    }
+    std::this_thread::sleep_until(until);
+}
+
+/* ============================================================================
+ * 路径与内存文件系统辅助函数（调用者需持有 state().mutex）
+ * ============================================================================ */
+
+QString normalizePath(const char *path)
+{
+    QString p = QString::fromUtf8(path ? path : "/");
+    if (!p.startsWith('/')) {
+        p.prepend('/');
+    }
+    p = QDir::cleanPath(p);
+    return p.isEmpty() ? QStringLiteral("/") : p;
+}
+
+QString parentPath(const QString &path)
+{
+    const int index = path.lastIndexOf('/');
+    return index <= 0 ? QStringLiteral("/") : path.left(index);
+}
+
+QString baseName(const QString &path)
+{
+    return path.mid(path.lastIndexOf('/') + 1);
+}
+
+qint64 nowNs()
+{
+    return QDateTime::currentMSecsSinceEpoch() * 1000000LL;
+}
+
+bool isJpegName(const QString &path)
+{
+    return path.endsWith(".JPG", Qt::CaseInsensitive) || path.endsWith(".JPEG", Qt::CaseInsensitive);
+}
+
+bool isHeicName(const QString &path)
+{
+    return path.endsWith(".HEIC", Qt::CaseInsensitive) || path.endsWith(".HEIF", Qt::CaseInsensitive);
+}
+
+bool isMovName(const QString &path)
+{
+    return path.endsWith(".MOV", Qt::CaseInsensitive) || path.endsWith(".MP4", Qt::CaseInsensitive);
+}
+
+bool useLocalRoot()
+{
+    return !state().config.afcRoot.isEmpty();
+}
+
+// 将 AFC 路径映射到本地目录，越界时返回空字符串
+QString localPathFor(const QString &afcPath)
+{
+    const QString root = QDir::cleanPath(state().config.afcRoot);
+    const QString local = QDir::cleanPath(root + afcPath);
+    if (local != root && !local.startsWith(root + '/')) {
+        return QString();
+    }
+    return local;
+}
+
+void touchDirectory(const QString &path, qint64 mtimeNs)
+{
+    auto it = state().nodes.find(path);
+    if (it != state().nodes.end() && it->mtimeNs < mtimeNs) {
+        it->mtimeNs = mtimeNs;
+    }
+}
+
+void ensureDirectory(const QString &path, qint64 mtimeNs)
+{
+    SimState &s = state();
+    if (s.nodes.contains(path)) {
+        return;
+    }
+    const QString parent = parentPath(path);
+    ensureDirectory(parent, mtimeNs);
+
+    SimNode node;
+    node.isDir = true;
+    node.mtimeNs = mtimeNs;
+    s.nodes.insert(path, node);
+    s.nodes[parent].children << baseName(path);
+    touchDirectory(parent, mtimeNs);
+}
+
+void insertFileNode(const QString &path, SimNode node)
+{
+    SimState &s = state();
+    const QString parent = parentPath(path);
+    ensureDirectory(parent, node.mtimeNs);
+    if (!s.nodes.contains(path)) {
+        s.nodes[parent].children << baseName(path);
+    }
+    touchDirectory(parent, node.mtimeNs);
+    s.nodes.insert(path, node);
+}
+
+void resetFileSystem()
+{
+    SimState &s = state();
+    s.nodes.clear();
+    s.openFiles.clear();
+    SimNode root;
+    root.isDir = true;
+    root.mtimeNs = nowNs();
+    s.nodes.insert(QStringLiteral("/"), root);
+}
+
+QByteArray encodeJpeg(const QImage &image, int quality)
+{
+    QByteArray bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "JPG", quality);
+    return bytes;
+}
+
+void appendLe16(QByteArray &out, quint16 value)
+{
+    out.append(static_cast<char>(value & 0xFF));
+    out.append(static_cast<char>(value >> 8));
+}
+
+void appendLe32(QByteArray &out, quint32 value)
+{
+    appendLe16(out, static_cast<quint16>(value & 0xFFFF));
+    appendLe16(out, static_cast<quint16>(value >> 16));
+}
+
+void appendIfdEntry(QByteArray &out, quint16 tag, quint16 type, quint32 value)
+{
+    appendLe16(out, tag);
+    appendLe16(out, type);
+    appendLe32(out, 1);
+    appendLe32(out, value);
+}
+
+// 与相机一样在 APP1/EXIF 中嵌入 160x120 的 IFD1 缩略图
+QByteArray buildExifSegment(const QImage &image)
+{
+    const QByteArray thumbnail = encodeJpeg(image.scaled(160, 120), 80);
+
+    // TIFF 头(8) + IFD0(2 + 1*12 + 4) + IFD1(2 + 2*12 + 4)，缩略图紧随其后
+    const quint32 ifd0Offset = 8;
+    const quint32 ifd1Offset = ifd0Offset + 18;
+    const quint32 thumbnailOffset = ifd1Offset + 30;
+
+    QByteArray tiff("II*\0", 4);
+    appendLe32(tiff, ifd0Offset);
+    appendLe16(tiff, 1);
+    appendIfdEntry(tiff, 0x0112, 3, 1);                                 // Orientation
+    appendLe32(tiff, ifd1Offset);
+    appendLe16(tiff, 2);
+    appendIfdEntry(tiff, 0x0201, 4, thumbnailOffset);                   // JPEGInterchangeFormat
+    appendIfdEntry(tiff, 0x0202, 4, static_cast<quint32>(thumbnail.size())); // JPEGInterchangeFormatLength
+    appendLe32(tiff, 0);
+    tiff.append(thumbnail);
+
+    QByteArray payload("Exif\0\0", 6);
+    payload.append(tiff);
+
+    QByteArray segment("\xFF\xE1", 2);
+    const int length = payload.size() + 2;
+    segment.append(static_cast<char>(length >> 8));
+    segment.append(static_cast<char>(length & 0xFF));
+    segment.append(payload);
+    return segment;
+}
+
+// 生成一张可解码的 JPEG 作为合成照片的文件头（含 EXIF 缩略图）
+QByteArray buildJpegTemplate()
+{
+    QImage image(640, 480, QImage::Format_RGB32);
+    for (int y = 0; y < image.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb*>(image.scanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            line[x] = qRgb(x * 255 / image.width(), y * 255 / image.height(), 160);
+        }
+    }
+    QByteArray bytes = encodeJpeg(image, 85);
+    bytes.insert(2, buildExifSegment(image)); // 紧跟 SOI 之后
+    return bytes;
+}
+
+void appendBe16(QByteArray &out, quint16 value)
+{
+    out.append(static_cast<char>(value >> 8));
+    out.append(static_cast<char>(value & 0xFF));
+}
+
+void appendBe32(QByteArray &out, quint32 value)
+{
+    appendBe16(out, static_cast<quint16>(value >> 16));
+    appendBe16(out, static_cast<quint16>(value & 0xFFFF));
+}
+
+QByteArray isoBox(const char *type, const QByteArray &payload)
+{
+    QByteArray box;
+    appendBe32(box, static_cast<quint32>(payload.size() + 8));
+    box.append(type, 4);
+    box.append(payload);
+    return box;
+}
+
+QByteArray isoFullBox(const char *type, quint8 version, const QByteArray &payload)
+{
+    QByteArray body;
+    appendBe32(body, static_cast<quint32>(version) << 24);
+    body.append(payload);
+    return isoBox(type, body);
+}
+
+// 与 iPhone（“高效”格式）一致的 HEVC 解码配置：Main profile、4:2:0、8 位、NAL 长度 4 字节，
+// 不带参数集数组。封装出的 HEIF 不能真正解码，只用于走通与真机相同的读取路径
+QByteArray buildHvcConfig()
+{
+    QByteArray config;
+    config.append('\x01');                  // configurationVersion
+    config.append('\x01');                  // general_profile_space/tier/profile_idc = Main
+    appendBe32(config, 0x60000000);         // general_profile_compatibility_flags
+    config.append(QByteArray(6, '\0'));     // general_constraint_indicator_flags
+    config.append(static_cast<char>(153));  // general_level_idc = 5.1
+    appendBe16(config, 0xF000);             // min_spatial_segmentation_idc
+    config.append('\xFC');                  // parallelismType
+    config.append('\xFD');                  // chromaFormat = 4:2:0
+    config.append('\xF8');                  // bitDepthLumaMinus8 = 0
+    config.append('\xF8');                  // bitDepthChromaMinus8 = 0
+    appendBe16(config, 0);                  // avgFrameRate
+    config.append('\x0F');                  // numTemporalLayers = 1, temporalIdNested, lengthSizeMinusOne = 3
+    config.append('\0');                    // numOfArrays
+    return config;
+}
+
+// 合成的 HEVC 图像数据：一个长度前缀的 IDR_W_RADL NAL 单元
+QByteArray buildHevcSample(int size)
+{
+    QByteArray frame;
+    appendBe32(frame, static_cast<quint32>(size - 4));
+    frame.append('\x26');                   // nal_unit_type = 19 (IDR_W_RADL)
+    frame.append('\x01');
+    for (int i = frame.size(); i < size; ++i) {
+        frame.append(static_cast<char>((static_cast<quint32>(i) * 2654435761u) >> 24));
+    }
+    return frame;
+}
+
+// 生成 HEIF 文件头：主图（hvc1，数据为合成内容）+ 通过 iref 'thmb' 关联的缩略图项。
+// 与 iPhone 拍摄的 HEIC 一样，缩略图项是带 hvcC 属性的 HEVC 图像（320x240），
+// 没有 HEIF 插件时无法解码，基准测试反映的是真机上的读取量和结果。
+QByteArray buildHeicTemplate()
+{
+    const QSize image(320, 240);
+    const QByteArray thumbnail = buildHevcSample(12 * 1024);
+
+    QByteArray ftyp("heic", 4);
+    appendBe32(ftyp, 0);
+    ftyp.append("mif1heic", 8);
+
+    QByteArray hdlr;
+    appendBe32(hdlr, 0);
+    hdlr.append("pict", 4);
+    hdlr.append(QByteArray(13, '\0')); // reserved[3] + 空名称
+
+    QByteArray pitm;
+    appendBe16(pitm, 1);
+
+    QByteArray iinf;
+    appendBe16(iinf, 2);
+    for (quint16 id = 1; id <= 2; ++id) {
+        QByteArray infe;
+        appendBe16(infe, id);
+        appendBe16(infe, 0);
+        infe.append("hvc1", 4);
+        infe.append('\0');
+        iinf.append(isoFullBox("infe", 2, infe));
+    }
+
+    QByteArray thmb;
+    appendBe16(thmb, 2);    // from: 缩略图
+    appendBe16(thmb, 1);
+    appendBe16(thmb, 1);    // to: 主图
+    const QByteArray iref = isoFullBox("iref", 0, isoBox("thmb", thmb));
+
+    QByteArray ispe;
+    appendBe32(ispe, 0);
+    appendBe32(ispe, static_cast<quint32>(image.width()));
+    appendBe32(ispe, static_cast<quint32>(image.height()));
+    QByteArray ipma;
+    appendBe32(ipma, 1);
+    appendBe16(ipma, 2);        // 缩略图项：hvcC（必需，索引 2）+ ispe（索引 1）
+    ipma.append('\x02');
+    ipma.append('\x82');
+    ipma.append('\x01');
+    const QByteArray ipco = isoBox("ispe", ispe) + isoBox("hvcC", buildHvcConfig());
+    const QByteArray iprp = isoBox("iprp", isoBox("ipco", ipco) + isoFullBox("ipma", 0, ipma));
+
+    // iloc 中的偏移依赖 meta 自身大小，先按 0 生成以确定长度，再填入实际偏移
+    auto buildMeta = [&](quint32 thumbnailOffset) {
+        QByteArray iloc;
+        iloc.append('\x44');   // offset_size = 4, length_size = 4
+        iloc.append('\0');     // base_offset_size = 0
+        appendBe16(iloc, 2);
+        appendBe16(iloc, 1);    // 主图：缩略图之后直到文件末尾
+        appendBe16(iloc, 0);
+        appendBe16(iloc, 1);
+        appendBe32(iloc, thumbnailOffset + static_cast<quint32>(thumbnail.size()));
+        appendBe32(iloc, 0);
+        appendBe16(iloc, 2);    // 缩略图
+        appendBe16(iloc, 0);
+        appendBe16(iloc, 1);
+        appendBe32(iloc, thumbnailOffset);
+        appendBe32(iloc, static_cast<quint32>(thumbnail.size()));
+
+        return isoFullBox("meta", 0, isoFullBox("hdlr", 0, hdlr) + isoFullBox("pitm", 0, pitm)
+                          + isoFullBox("iloc", 0, iloc) + isoFullBox("iinf", 0, iinf) + iref + iprp);
+    };
+
+    const QByteArray header = isoBox("ftyp", ftyp);
+    const quint32 mdatPayload = static_cast<quint32>(header.size() + buildMeta(0).size() + 8);
+
+    QByteArray bytes = header + buildMeta(mdatPayload);
+    appendBe32(bytes, 0);       // size = 0：mdat 延伸到文件末尾
+    bytes.append("mdat", 4);
+    bytes.append(thumbnail);
+    return bytes;
+}
+
+// 生成 QuickTime 文件头：moov（15 秒、竖拍旋转 90 度、单帧样本表）+ 以关键帧开头的 mdat。
+// 与 iPhone 拍摄的视频一样使用 HEVC（hvc1 + hvcC）样本描述：没有 HEIF 插件时只能得到时长，
+// 基准测试反映的是真机上的读取量和结果，而不是项目本身就能解码的 Motion JPEG。
+QByteArray buildMovTemplate()
+{
+    const QSize size(1920, 1080);
+    const QByteArray frame = buildHevcSample(96 * 1024);   // 接近真机 1080p 视频的 I 帧
+    const quint32 timescale = 600;
+    const quint32 duration = 15 * timescale;
+
+    QByteArray ftyp("qt  ", 4);
+    appendBe32(ftyp, 0);
+    ftyp.append("qt  ", 4);
+
+    QByteArray mvhd;
+    appendBe32(mvhd, 0);        // creation_time
+    appendBe32(mvhd, 0);        // modification_time
+    appendBe32(mvhd, timescale);
+    appendBe32(mvhd, duration);
+    mvhd.append(QByteArray(80, '\0'));  // rate、volume、matrix 等（解析时不使用）
+
+    QByteArray tkhd;
+    appendBe32(tkhd, 0);
+    appendBe32(tkhd, 0);
+    appendBe32(tkhd, 1);        // track_ID
+    appendBe32(tkhd, 0);
+    appendBe32(tkhd, duration);
+    tkhd.append(QByteArray(16, '\0'));
+    const quint32 matrix[9] = {0, 0x00010000, 0, 0xFFFF0000, 0, 0, 0, 0, 0x40000000};
+    for (quint32 value : matrix) {
+        appendBe32(tkhd, value);
+    }
+    appendBe32(tkhd, static_cast<quint32>(size.width()) << 16);
+    appendBe32(tkhd, static_cast<quint32>(size.height()) << 16);
+
+    QByteArray hdlr;
+    appendBe32(hdlr, 0);
+    hdlr.append("vide", 4);
+    hdlr.append(QByteArray(13, '\0'));
+
+    QByteArray entry(24, '\0');
+    entry[7] = 1;               // data_reference_index
+    appendBe16(entry, static_cast<quint16>(size.width()));
+    appendBe16(entry, static_cast<quint16>(size.height()));
+    entry.append(QByteArray(50, '\0'));
+    entry.append(isoBox("hvcC", buildHvcConfig()));
+    QByteArray stsd;
+    appendBe32(stsd, 1);
+    stsd.append(isoBox("hvc1", entry));
+
+    QByteArray stts;
+    appendBe32(stts, 1);
+    appendBe32(stts, 1);
+    appendBe32(stts, duration);
+    QByteArray stss;
+    appendBe32(stss, 1);
+    appendBe32(stss, 1);
+    QByteArray stsc;
+    appendBe32(stsc, 1);
+    appendBe32(stsc, 1);
+    appendBe32(stsc, 1);
+    appendBe32(stsc, 1);
+    QByteArray stsz;
+    appendBe32(stsz, 0);
+    appendBe32(stsz, 1);
+    appendBe32(stsz, static_cast<quint32>(frame.size()));
+
+    // stco 中的偏移依赖 moov 自身大小，先按 0 生成以确定长度，再填入实际偏移
+    auto buildMoov = [&](quint32 frameOffset) {
+        QByteArray stco;
+        appendBe32(stco, 1);
+        appendBe32(stco, frameOffset);
+        const QByteArray stbl = isoBox("stbl", isoFullBox("stsd", 0, stsd) + isoFullBox("stts", 0, stts)
+                                       + isoFullBox("stss", 0, stss) + isoFullBox("stsc", 0, stsc)
+                                       + isoFullBox("stsz", 0, stsz) + isoFullBox("stco", 0, stco));
+        const QByteArray mdia = isoBox("mdia", isoFullBox("hdlr", 0, hdlr) + isoBox("minf", stbl));
+        return isoBox("moov", isoFullBox("mvhd", 0, mvhd) + isoBox("trak", isoFullBox("tkhd", 0, tkhd) + mdia));
+    };
+
+    const QByteArray header = isoBox("ftyp", ftyp);
+    const quint32 mdatPayload = static_cast<quint32>(header.size() + buildMoov(0).size() + 8);
+
+    QByteArray bytes = header + buildMoov(mdatPayload);
+    appendBe32(bytes, 0);       // size = 0：mdat 延伸到文件末尾
+    bytes.append("mdat", 4);
+    bytes.append(frame);
+    return bytes;
+}
+
+void fillSynthetic(const QString &path, qint64 offset, char *out, qint64 length)
+{
+    const QByteArray &prefix = isJpegName(path) ? state().jpegTemplate
+                             : isHeicName(path) ? state().heicTemplate
+                             : isMovName(path) ? state().movTemplate : QByteArray();
+    qint64 written = 0;
+    if (offset < prefix.size()) {
+        written = qMin(length, prefix.size() - offset);
+        memcpy(out, prefix.constData() + offset, static_cast<size_t>(written));
+    }
+    const quint32 seed = static_cast<quint32>(qHash(path));
+    for (qint64 i = written; i < length; ++i) {
+        out[i] = static_cast<char>((static_cast<quint32>(offset + i) * 2654435761u + seed) >> 24);
+    }
+}
+
+void buildSyntheticDcim()
+{
+    const SimulatedBackendConfig &config = state().config;
+    // 2024-01-01 00:00:00 UTC 起，每个文件间隔一分钟
+    const qint64 baseNs = 1704067200LL * 1000000000LL;
+    int fileIndex = 0;
+
+    ensureDirectory(QStringLiteral("/Downloads"), baseNs);
+    ensureDirectory(QStringLiteral("/PhotoData"), baseNs);
+
+    for (int album = 0; album < config.albumCount; ++album) {
+        const QString albumPath = QString("/DCIM/%1APPLE").arg(100 + album);
+        ensureDirectory(albumPath, baseNs);
+        for (int i = 0; i < config.photosPerAlbum; ++i) {
+            ++fileIndex;
+            const qint64 mtime = baseNs + fileIndex * 60LL * 1000000000LL;
+            const bool isVideo = config.videoEvery > 0 && fileIndex % config.videoEvery == 0;
+            const QString stem = QString("%1/IMG_%2").arg(albumPath).arg(fileIndex, 4, 10, QChar('0'));
+
+            SimNode node;
+            node.synthetic = true;
+            node.mtimeNs = mtime;
+            if (isVideo) {
+                node.size = qMax<qint64>(config.photoSize * 4, state().movTemplate.size());
+                insertFileNode(stem + ".MOV", node);
+            } else {
+                node.size = qMax<qint64>(config.photoSize, state().jpegTemplate.size());
+                insertFileNode(stem + ".JPG", node);
+                if (config.sidecarEvery > 0 && fileIndex % config.sidecarEvery == 0) {
+                    SimNode sidecar;
+                    sidecar.synthetic = true;
+                    sidecar.size = 812;
+                    sidecar.mtimeNs = mtime;
+                    insertFileNode(stem + ".AAE", sidecar);
+                }
+            }
+        }
+    }
+}
+
+void buildApps(int count)
+{
+    QVector<SimApp> apps;
+    apps.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        SimApp app;
+        app.bundleId = QString("com.phonelinkc.sim.app%1").arg(i + 1, 3, 10, QChar('0'));
+        app.name = QString("模拟应用 %1").arg(i + 1);
+        app.version = QString("%1.%2.0").arg(1 + i % 5).arg(i % 10);
+        app.staticSize = 20ULL * 1024 * 1024 + static_cast<quint64>(i) * 3 * 1024 * 1024;
+        app.dynamicSize = 4ULL * 1024 * 1024 + static_cast<quint64>(i % 7) * 11 * 1024 * 1024;
+        apps.append(app);
+    }
+    state().apps = apps;
+}
+
+/* ============================================================================
+ * lockdown 属性
+ * ============================================================================ */
+
+QVariantMap domainValues(const QString &udid, const QString &domain)
+{
+    SimState &s = state();
+    QVariantMap values;
+    const int index = qMax(0, s.config.udids.indexOf(udid));
+
+    if (domain.isEmpty()) {
+        values["DeviceName"] = QString("模拟 iPhone %1").arg(index + 1);
+        values["UniqueDeviceID"] = udid;
+        values["SerialNumber"] = QString("SIMF%1").arg(index + 1, 8, 10, QChar('0'));
+        values["DeviceClass"] = "iPhone";
+        values["ProductType"] = "iPhone15,2";
+        values["ProductName"] = "iPhone OS";
+        values["ProductVersion"] = "17.1.1";
+        values["BuildVersion"] = "21B91";
+        values["ModelNumber"] = "MQ0G3";
+        values["RegionInfo"] = "CH/A";
+        values["HardwareModel"] = "D73AP";
+        values["HardwarePlatform"] = "t8120";
+        values["CPUArchitecture"] = "arm64e";
+        values["ChipID"] = 33040;
+        values["BoardId"] = 12;
+        values["UniqueChipID"] = 4660ULL + static_cast<quint64>(index);
+        values["DieID"] = 9029ULL + static_cast<quint64>(index);
+        values["FirmwareVersion"] = 10151;
+        values["BasebandVersion"] = "2.20.03";
+        values["FirmwareRevision"] = "iBoot-10151.42.12";
+        values["DeviceColor"] = "1";
+        values["EnclosureColor"] = "1";
+        values["WiFiAddress"] = "f0:5c:77:00:00:01";
+        values["BluetoothAddress"] = "f0:5c:77:00:00:02";
+        values["EthernetAddress"] = "f0:5c:77:00:00:03";
+        values["PhoneNumber"] = "+86 138 0000 0000";
+        values["InternationalMobileEquipmentIdentity"] = "356000000000001";
+        values["IntegratedCircuitCardIdentity"] = "89860000000000000001";
+        values["CarrierBundleInfoVersion"] = "54.0";
+        values["ActivationState"] = "Activated";
+        values["PasswordProtected"] = true;
+        values["DeviceSupportsLockdown"] = true;
+        values["HostAttached"] = true;
+        values["HasSiMLock"] = false;
+        values["iTunesHasConnected"] = true;
+        values["TimeZone"] = "Asia/Shanghai";
+        values["TimeIntervalSince1970"] = QDateTime::currentSecsSinceEpoch();
+        values["TrustedHostAttached"] = true;
+        values["PairingState"] = "Paired";
+        values["MLBSerialNumber"] = "SIMMLB0000000001";
+        values["ProtocolVersion"] = "2";
+        values["SupportsWirelessSync"] = true;
+        values["WirelessBuddyID"] = "";
+    } else if (domain == "com.apple.disk_usage") {
+        values["TotalDiskCapacity"] = 128000000000LL;
+        values["TotalSystemCapacity"] = 10000000000LL;
+        values["TotalSystemAvailable"] = 2000000000LL;
+        values["TotalDataCapacity"] = 118000000000LL;
+        values["TotalDataAvailable"] = 64000000000LL;
+        values["AmountDataReserved"] = 1000000000LL;
+        values["AmountDataAvailable"] = 63000000000LL;
+    } else if (domain == "com.apple.mobile.battery") {
+        values["BatteryCurrentCapacity"] = 87;
+        values["BatteryIsCharging"] = true;
+        values["ExternalChargeCapable"] = true;
+        values["ExternalConnected"] = true;
+        values["FullyCharged"] = false;
+        values["GasGaugeBatteryCapacity"] = 87;
+        values["GasGaugeCapability"] = true;
+    }
+
+    // 应用配置中的覆盖值
+    for (auto it = s.config.lockdownValues.constBegin(); it != s.config.lockdownValues.constEnd(); ++it) {
+        const int slash = it.key().lastIndexOf('/');
+        const QString keyDomain = slash < 0 ? QString() : it.key().left(slash);
+        if (keyDomain == domain) {
+            values[it.key().mid(slash + 1)] = it.value();
+        }
+    }
+    return values;
+}
+
+plist_t toPlist(const QVariant &value)
+{
+    LibimobiledeviceDynamic &lib = LibimobiledeviceDynamic::instance();
+    switch (value.typeId()) {
+    case QMetaType::Bool:
+        return lib.plist_new_bool(value.toBool() ? 1 : 0);
+    case QMetaType::Int:
+    case QMetaType::LongLong:
+        if (value.toLongLong() < 0) {
+            return lib.plist_new_int(value.toLongLong());
+        }
+        return lib.plist_new_uint(static_cast<uint64_t>(value.toLongLong()));
+    case QMetaType::UInt:
+    case QMetaType::ULongLong:
+        return lib.plist_new_uint(value.toULongLong());
+    case QMetaType::QVariantMap: {
+        plist_t dict = lib.plist_new_dict();
+        const QVariantMap map = value.toMap();
+        for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+            lib.plist_dict_set_item(dict, it.key().toUtf8().constData(), toPlist(it.value()));
+        }
+        return dict;
+    }
+    case QMetaType::QVariantList:
+    case QMetaType::QStringList: {
+        plist_t array = lib.plist_new_array();
+        for (const QVariant &item : value.toList()) {
+            lib.plist_array_append_item(array, toPlist(item));
+        }
+        return array;
+    }
+    default:
+        return lib.plist_new_string(value.toString().toUtf8().constData());
+    }
+}
+
+QString plistString(plist_t node)
+{
+    LibimobiledeviceDynamic &lib = LibimobiledeviceDynamic::instance();
+    if (!node || lib.plist_get_node_type(node) != PLIST_STRING) {
+        return QString();
+    }
+    const char *value = lib.plist_get_string_ptr(node, nullptr);
+    return value ? QString::fromUtf8(value) : QString();
+}
+
+char **toStringList(const QList<QByteArray> &items)
+{
+    char **list = static_cast<char**>(calloc(static_cast<size_t>(items.size()) + 1, sizeof(char*)));
+    for (int i = 0; i < items.size(); ++i) {
+        list[i] = strdup(items[i].constData());
+    }
+    return list;
+}
+
+bool isAttached(const QString &udid)
+{
+    QMutexLocker locker(&state().mutex);
+    return state().attachedDevices.contains(udid);
+}
+
+/* ============================================================================
+ * idevice
+ * ============================================================================ */
+
+idevice_error_t sim_idevice_get_device_list(char ***devices, int *count)
+{
+    if (!devices || !count) {
+        return IDEVICE_E_INVALID_ARG;
+    }
+    QList<QByteArray> udids;
+    {
+        QMutexLocker locker(&state().mutex);
+        for (const QString &udid : state().attachedDevices) {
+            udids << udid.toUtf8();
+        }
+    }
+    *devices = toStringList(udids);
+    *count = udids.size();
+    return IDEVICE_E_SUCCESS;
+}
+
+idevice_error_t sim_idevice_device_list_free(char **devices)
+{
+    if (devices) {
+        for (char **p = devices; *p; ++p) {
+            free(*p);
+        }
+        free(devices);
+    }
+    return IDEVICE_E_SUCCESS;
+}
+
+idevice_error_t sim_idevice_new(idevice_t *device, const char *udid)
+{
+    if (!device) {
+        return IDEVICE_E_INVALID_ARG;
+    }
+    QString target = udid ? QString::fromUtf8(udid) : QString();
+    {
+        QMutexLocker locker(&state().mutex);
+        if (target.isEmpty() && !state().attachedDevices.isEmpty()) {
+            target = state().attachedDevices.first();
+        }
+        if (!state().attachedDevices.contains(target)) {
+            return IDEVICE_E_NO_DEVICE;
+        }
+    }
+    *device = reinterpret_cast<idevice_t>(new SimDevice{target});
+    return IDEVICE_E_SUCCESS;
+}
+
+idevice_error_t sim_idevice_new_with_options(idevice_t *device, const char *udid, enum idevice_options options)
+{
+    Q_UNUSED(options)
+    return sim_idevice_new(device, udid);
+}
+
+idevice_error_t sim_idevice_free(idevice_t device)
+{
+    delete reinterpret_cast<SimDevice*>(device);
+    return IDEVICE_E_SUCCESS;
+}
+
+idevice_error_t sim_idevice_get_device_list_extended(idevice_info_t **devices, int *count)
+{
+    if (!devices || !count) {
+        return IDEVICE_E_INVALID_ARG;
+    }
+    QStringList udids;
+    {
+        QMutexLocker locker(&state().mutex);
+        udids = state().attachedDevices;
+    }
+    idevice_info_t *list = static_cast<idevice_info_t*>(calloc(static_cast<size_t>(udids.size()) + 1, sizeof(idevice_info_t)));
+    for (int i = 0; i < udids.size(); ++i) {
+        list[i] = static_cast<idevice_info_t>(calloc(1, sizeof(struct idevice_info)));
+        list[i]->udid = strdup(udids[i].toUtf8().constData());
+        list[i]->conn_type = CONNECTION_USBMUXD;
+        list[i]->conn_data = nullptr;
+    }
+    *devices = list;
+    *count = udids.size();
+    return IDEVICE_E_SUCCESS;
+}
+
+idevice_error_t sim_idevice_device_list_extended_free(idevice_info_t *devices)
+{
+    if (devices) {
+        for (idevice_info_t *p = devices; *p; ++p) {
+            free((*p)->udid);
+            free(*p);
+        }
+        free(devices);
+    }
+    return IDEVICE_E_SUCCESS;
+}
+
+void dispatchEvent(const QString &udid, enum idevice_event_type type)
+{
+    QList<SimSubscription> targets;
+    {
+        QMutexLocker locker(&state().mutex);
+        for (SimSubscription *subscription : state().subscriptions) {
+            targets << *subscription;
+        }
+    }
+    const QByteArray udidBytes = udid.toUtf8();
+    idevice_event_t event;
+    event.event = type;
+    event.udid = udidBytes.constData();
+    event.conn_type = CONNECTION_USBMUXD;
+    for (const SimSubscription &subscription : targets) {
+        subscription.callback(&event, subscription.userData);
+    }
+}
+
+idevice_error_t sim_idevice_events_subscribe(idevice_subscription_context_t *context,
+                                             idevice_event_cb_t callback, void *user_data)
+{
+    if (!context || !callback) {
+        return IDEVICE_E_INVALID_ARG;
+    }
+    SimSubscription *subscription = new SimSubscription{callback, user_data};
+    QStringList attached;
+    {
+        QMutexLocker locker(&state().mutex);
+        state().subscriptions << subscription;
+        attached = state().attachedDevices;
+    }
+    *context = reinterpret_cast<idevice_subscription_context_t>(subscription);
+
+    // 与 usbmuxd 一致：订阅后立即为已连接设备发送 ADD 事件
+    for (const QString &udid : attached) {
+        QByteArray udidBytes = udid.toUtf8();
+        idevice_event_t event;
+        event.event = IDEVICE_DEVICE_ADD;
+        event.udid = udidBytes.constData();
+        event.conn_type = CONNECTION_USBMUXD;
+        callback(&event, user_data);
+    }
+    return IDEVICE_E_SUCCESS;
+}
+
+idevice_error_t sim_idevice_events_unsubscribe(idevice_subscription_context_t context)
+{
+    SimSubscription *subscription = reinterpret_cast<SimSubscription*>(context);
+    {
+        QMutexLocker locker(&state().mutex);
+        if (!state().subscriptions.removeOne(subscription)) {
+            return IDEVICE_E_INVALID_ARG;
+        }
+    }
+    delete subscription;
+    return IDEVICE_E_SUCCESS;
+}
+
+/* ============================================================================
+ * lockdownd
+ * ============================================================================ */
+
+lockdownd_error_t sim_lockdownd_client_new_with_handshake(idevice_t device, lockdownd_client_t *client, const char *label)
+{
+    Q_UNUSED(label)
+    SimDevice *simDevice = reinterpret_cast<SimDevice*>(device);
+    if (!simDevice || !client) {
+        return LOCKDOWN_E_INVALID_ARG;
+    }
+    if (!isAttached(simDevice->udid)) {
+        return LOCKDOWN_E_MUX_ERROR;
+    }
+    handshake();
+    *client = reinterpret_cast<lockdownd_client_t>(new SimLockdown{simDevice->udid});
+    return LOCKDOWN_E_SUCCESS;
+}
+
+lockdownd_error_t sim_lockdownd_client_free(lockdownd_client_t client)
+{
+    delete reinterpret_cast<SimLockdown*>(client);
+    return LOCKDOWN_E_SUCCESS;
+}
+
+lockdownd_error_t sim_lockdownd_get_value(lockdownd_client_t client, const char *domain, const char *key, plist_t *value)
+{
+    SimLockdown *lockdown = reinterpret_cast<SimLockdown*>(client);
+    if (!lockdown || !value) {
+        return LOCKDOWN_E_INVALID_ARG;
+    }
+    roundTrip();
+
+    QVariantMap values;
+    {
+        QMutexLocker locker(&state().mutex);
+        values = domainValues(lockdown->udid, domain ? QString::fromUtf8(domain) : QString());
+    }
+
+    // key 为 NULL 时返回整个域
+    if (!key) {
+        *value = toPlist(values);
+        return LOCKDOWN_E_SUCCESS;
+    }
+
+    const QString name = QString::fromUtf8(key);
+    if (!values.contains(name)) {
+        *value = nullptr;
+        return LOCKDOWN_E_MISSING_VALUE;
+    }
+    *value = toPlist(values.value(name));
+    return LOCKDOWN_E_SUCCESS;
+}
+
+lockdownd_error_t sim_lockdownd_start_service(lockdownd_client_t client, const char *identifier,
+                                              lockdownd_service_descriptor_t *service)
+{
+    if (!client || !identifier || !service) {
+        return LOCKDOWN_E_INVALID_ARG;
+    }
+    static const char *SUPPORTED[] = {
+        "com.apple.afc",
+        "com.apple.mobile.installation_proxy",
+        "com.apple.mobilesync",
+    };
+    const bool supported = std::any_of(std::begin(SUPPORTED), std::end(SUPPORTED),
+                                       [identifier](const char *name) { return strcmp(name, identifier) == 0; });
+    roundTrip();
+    if (!supported) {
+        return LOCKDOWN_E_INVALID_SERVICE;
+    }
+
+    lockdownd_service_descriptor_t descriptor = static_cast<lockdownd_service_descriptor_t>(
+        calloc(1, sizeof(struct lockdownd_service_descriptor)));
+    descriptor->port = 49152;
+    descriptor->ssl_enabled = 0;
+    descriptor->identifier = strdup(identifier);
+    *service = descriptor;
+    return LOCKDOWN_E_SUCCESS;
+}
+
+lockdownd_error_t sim_lockdownd_service_descriptor_free(lockdownd_service_descriptor_t service)
+{
+    if (service) {
+        free(service->identifier);
+        free(service);
+    }
+    return LOCKDOWN_E_SUCCESS;
+}
+
+/* ============================================================================
+ * AFC
+ * ============================================================================ */
+
+afc_error_t sim_afc_client_new(idevice_t device, lockdownd_service_descriptor_t service, afc_client_t *client)
+{
+    SimDevice *simDevice = reinterpret_cast<SimDevice*>(device);
+    if (!simDevice || !service || !client) {
+        return AFC_E_INVALID_ARG;
+    }
+    roundTrip();
+    *client = reinterpret_cast<afc_client_t>(new SimAfcClient{simDevice->udid});
+    return AFC_E_SUCCESS;
+}
+
+afc_error_t sim_afc_client_start_service(idevice_t device, afc_client_t *client, const char *label)
+{
+    Q_UNUSED(label)
+    SimDevice *simDevice = reinterpret_cast<SimDevice*>(device);
+    if (!simDevice || !client) {
+        return AFC_E_INVALID_ARG;
+    }
+    if (!isAttached(simDevice->udid)) {
+        return AFC_E_MUX_ERROR;
+    }
+    // 与真实库一致：内部建立一次 lockdown 握手并启动服务
+    handshake();
+    roundTrip();
+    roundTrip();
+    *client = reinterpret_cast<afc_client_t>(new SimAfcClient{simDevice->udid});
+    return AFC_E_SUCCESS;
+}
+
+afc_error_t sim_afc_client_free(afc_client_t client)
+{
+    delete reinterpret_cast<SimAfcClient*>(client);
+    return AFC_E_SUCCESS;
+}
+
+afc_error_t sim_afc_dictionary_free(char **dictionary)
+{
+    if (dictionary) {
+        for (char **p = dictionary; *p; ++p) {
+            free(*p);
+        }
+        free(dictionary);
+    }
+    return AFC_E_SUCCESS;
+}
+
+afc_error_t sim_afc_get_device_info(afc_client_t client, char ***device_information)
+{
+    if (!client || !device_information) {
+        return AFC_E_INVALID_ARG;
+    }
+    roundTrip();
+    QList<QByteArray> items = {
+        "Model", "iPhone15,2",
+        "FSTotalBytes", "118000000000",
+        "FSFreeBytes", "64000000000",
+        "FSBlockSize", "4096",
+    };
+    *device_information = toStringList(items);
+    return AFC_E_SUCCESS;
+}
+
+afc_error_t sim_afc_read_directory(afc_client_t client, const char *path, char ***directory_information)
+{
+    if (!client || !path || !directory_information) {
+        return AFC_E_INVALID_ARG;
+    }
+    roundTrip();
+
+    const QString afcPath = normalizePath(path);
+    QList<QByteArray> names = {".", ".."};
+    qint64 payload = 0;
+    {
+        QMutexLocker locker(&state().mutex);
+        if (useLocalRoot()) {
+            const QString local = localPathFor(afcPath);
+            QFileInfo info(local);
+            if (local.isEmpty() || !info.exists()) {
+                return AFC_E_OBJECT_NOT_FOUND;
+            }
+            if (!info.isDir()) {
+                return AFC_E_READ_ERROR;
+            }
+            const QStringList entries = QDir(local).entryList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot,
+                                                              QDir::Unsorted);
+            for (const QString &entry : entries) {
+                names << entry.toUtf8();
+            }
+        } else {
+            auto it = state().nodes.constFind(afcPath);
+            if (it == state().nodes.constEnd()) {
+                return AFC_E_OBJECT_NOT_FOUND;
+            }
+            if (!it->isDir) {
+                return AFC_E_READ_ERROR;
+            }
+            for (const QString &child : it->children) {
+                names << child.toUtf8();
+            }
+        }
+    }
+    for (const QByteArray &name : names) {
+        payload += name.size() + 1;
+    }
+    transfer(payload);
+    *directory_information = toStringList(names);
+    return AFC_E_SUCCESS;
+}
+
+afc_error_t sim_afc_get_file_info(afc_client_t client, const char *path, char ***file_information)
+{
+    if (!client || !path || !file_information) {
+        return AFC_E_INVALID_ARG;
+    }
+    roundTrip();
+
+    const QString afcPath = normalizePath(path);
+    bool isDir = false;
+    qint64 size = 0;
+    qint64 mtimeNs = 0;
+    int childCount = 0;
+    {
+        QMutexLocker locker(&state().mutex);
+        if (useLocalRoot()) {
+            const QString local = localPathFor(afcPath);
+            QFileInfo info(local);
+            if (local.isEmpty() || !info.exists()) {
+                return AFC_E_OBJECT_NOT_FOUND;
+            }
+            isDir = info.isDir();
+            size = isDir ? 0 : info.size();
+            mtimeNs = info.lastModified().toMSecsSinceEpoch() * 1000000LL;
+        } else {
+            auto it = state().nodes.constFind(afcPath);
+            if (it == state().nodes.constEnd()) {
+                return AFC_E_OBJECT_NOT_FOUND;
+            }
+            isDir = it->isDir;
+            size = it->isDir ? static_cast<qint64>(it->children.size()) * 32 : it->size;
+            mtimeNs = it->mtimeNs;
+            childCount = it->children.size();
+        }
+    }
+
+    QList<QByteArray> items = {
+        "st_size", QByteArray::number(size),
+        "st_blocks", QByteArray::number((size + 511) / 512),
+        "st_nlink", QByteArray::number(isDir ? childCount + 2 : 1),
+        "st_ifmt", isDir ? QByteArray("S_IFDIR") : QByteArray("S_IFREG"),
+        "st_mtime", QByteArray::number(mtimeNs),
+        "st_birthtime", QByteArray::number(mtimeNs),
+    };
+    *file_information = toStringList(items);
+    return AFC_E_SUCCESS;
+}
+
+afc_error_t sim_afc_file_open(afc_client_t client, const char *filename, afc_file_mode_t file_mode, uint64_t *handle)
+{
+    if (!client || !filename || !handle) {
+        return AFC_E_INVALID_ARG;
+    }
+    roundTrip();
+
+    const QString afcPath = normalizePath(filename);
+    const bool writable = file_mode != AFC_FOPEN_RDONLY;
+    const bool truncate = file_mode == AFC_FOPEN_WRONLY || file_mode == AFC_FOPEN_WR;
+    const bool append = file_mode == AFC_FOPEN_APPEND || file_mode == AFC_FOPEN_RDAPPEND;
+
+    auto openFile = std::make_shared<SimOpenFile>();
+    openFile->path = afcPath;
+    openFile->writable = writable;
+
+    QMutexLocker locker(&state().mutex);
+    SimState &s = state();
+    if (useLocalRoot()) {
+        const QString local = localPathFor(afcPath);
+        if (local.isEmpty()) {
+            return AFC_E_PERM_DENIED;
+        }
+        if (QFileInfo(local).isDir()) {
+            return AFC_E_OBJECT_IS_DIR;
+        }
+        QIODevice::OpenMode mode = QIODevice::ReadOnly;
+        if (writable) {
+            mode = QIODevice::ReadWrite;
+            if (truncate) mode |= QIODevice::Truncate;
+            if (append) mode |= QIODevice::Append;
+        }
+        auto file = std::make_shared<QFile>(local);
+        if (!file->open(mode)) {
+            return file->exists() ? AFC_E_PERM_DENIED : AFC_E_OBJECT_NOT_FOUND;
+        }
+        if (append) {
+            openFile->position = file->size();
+        }
+        openFile->localFile = file;
+    } else {
+        auto it = s.nodes.find(afcPath);
+        if (it == s.nodes.end()) {
+            if (!writable) {
+                return AFC_E_OBJECT_NOT_FOUND;
+            }
+            if (!s.nodes.contains(parentPath(afcPath))) {
+                return AFC_E_OBJECT_NOT_FOUND;
+            }
+            SimNode node;
+            node.mtimeNs = nowNs();
+            insertFileNode(afcPath, node);
+            it = s.nodes.find(afcPath);
+        }
+        if (it->isDir) {
+            return AFC_E_OBJECT_IS_DIR;
+        }
+        if (truncate) {
+            it->data.clear();
+            it->size = 0;
+            it->synthetic = false;
+            it->mtimeNs = nowNs();
+        }
+        if (append) {
+            openFile->position = it->size;
+        }
+    }
+
+    *handle = s.nextHandle++;
+    s.openFiles.insert(*handle, openFile);
+    return AFC_E_SUCCESS;
+}
+
+afc_error_t sim_afc_file_close(afc_client_t client, uint64_t handle)
+{
+    if (!client) {
+        return AFC_E_INVALID_ARG;
+    }
+    roundTrip();
+    QMutexLocker locker(&state().mutex);
+    return state().openFiles.remove(handle) > 0 ? AFC_E_SUCCESS : AFC_E_INVALID_ARG;
+}
+
+afc_error_t sim_afc_file_read(afc_client_t client, uint64_t handle, char *data, uint32_t length, uint32_t *bytes_read)
+{
+    if (!client || !data || !bytes_read) {
+        return AFC_E_INVALID_ARG;
+    }
+    *bytes_read = 0;
+    roundTrip();
+
+    qint64 count = 0;
+    {
+        QMutexLocker locker(&state().mutex);
+        auto fileIt = state().openFiles.constFind(handle);
+        if (fileIt == state().openFiles.constEnd()) {
+            return AFC_E_INVALID_ARG;
+        }
+        SimOpenFile &file = *fileIt.value();
+        if (file.localFile) {
+            file.localFile->seek(file.position);
+            count = file.localFile->read(data, length);
+            if (count < 0) {
+                return AFC_E_READ_ERROR;
+            }
+        } else {
+            auto it = state().nodes.constFind(file.path);
+            if (it == state().nodes.constEnd()) {
+                return AFC_E_OBJECT_NOT_FOUND;
+            }
+            count = qBound<qint64>(0, it->size - file.position, length);
+            if (it->synthetic) {
+                fillSynthetic(file.path, file.position, data, count);
+            } else if (count > 0) {
+                memcpy(data, it->data.constData() + file.position, static_cast<size_t>(count));
+            }
+        }
+        file.position += count;
+    }
+
+    transfer(count);
+    state().bytesRead += static_cast<quint64>(count);
+    *bytes_read = static_cast<uint32_t>(count);
+    return AFC_E_SUCCESS;
+}
+
+afc_error_t sim_afc_file_seek(afc_client_t client, uint64_t handle, int64_t offset, int whence)
+{
+    if (!client) {
+        return AFC_E_INVALID_ARG;
+    }
+    roundTrip();
+
+    QMutexLocker locker(&state().mutex);
+    auto fileIt = state().openFiles.constFind(handle);
+    if (fileIt == state().openFiles.constEnd()) {
+        return AFC_E_INVALID_ARG;
+    }
+    SimOpenFile &file = *fileIt.value();
+
+    qint64 base = 0;
+    if (whence == SEEK_CUR) {
+        base = file.position;
+    } else if (whence == SEEK_END) {
+        if (file.localFile) {
+            base = file.localFile->size();
+        } else {
+            auto it = state().nodes.constFind(file.path);
+            if (it == state().nodes.constEnd()) {
+                return AFC_E_OBJECT_NOT_FOUND;
+            }
+            base = it->size;
+        }
+    } else if (whence != SEEK_SET) {
+        return AFC_E_INVALID_ARG;
+    }
+
+    if (base + offset < 0) {
+        return AFC_E_INVALID_ARG;
+    }
+    file.position = base + offset;
+    return AFC_E_SUCCESS;
+}
+
+afc_error_t sim_afc_file_tell(afc_client_t client, uint64_t handle, uint64_t *position)
+{
+    if (!client || !position) {
+        return AFC_E_INVALID_ARG;
+    }
+    roundTrip();
+
+    QMutexLocker locker(&state().mutex);
+    auto fileIt = state().openFiles.constFind(handle);
+    if (fileIt == state().openFiles.constEnd()) {
+        return AFC_E_INVALID_ARG;
+    }
+    *position = static_cast<uint64_t>(fileIt.value()->position);
+    return AFC_E_SUCCESS;
+}
+
+afc_error_t sim_afc_file_write(afc_client_t client, uint64_t handle, const char *data, uint32_t length, uint32_t *bytes_written)
+{
+    if (!client || !data || !bytes_written) {
+        return AFC_E_INVALID_ARG;
+    }
+    *bytes_written = 0;
+    roundTrip();
+    transfer(length);
+
+    {
+        QMutexLocker locker(&state().mutex);
+        auto fileIt = state().openFiles.constFind(handle);
+        if (fileIt == state().openFiles.constEnd()) {
+            return AFC_E_INVALID_ARG;
+        }
+        SimOpenFile &file = *fileIt.value();
+        if (!file.writable) {
+            return AFC_E_PERM_DENIED;
+        }
+        if (file.localFile) {
+            file.localFile->seek(file.position);
+            if (file.localFile->write(data, length) != length) {
+                return AFC_E_WRITE_ERROR;
+            }
+        } else {
+            auto it = state().nodes.find(file.path);
+            if (it == state().nodes.end()) {
+                return AFC_E_OBJECT_NOT_FOUND;
+            }
+            if (it->synthetic) {
+                // 首次写入合成文件时先物化其内容
+                it->data.resize(it->size);
+                fillSynthetic(file.path, 0, it->data.data(), it->size);
+                it->synthetic = false;
+            }
+            const qint64 end = file.position + length;
+            if (end > it->data.size()) {
+                it->data.resize(end);
+            }
+            memcpy(it->data.data() + file.position, data, length);
+            it->size = it->data.size();
+            it->mtimeNs = nowNs();
+        }
+        file.position += length;
+    }
+
+    state().bytesWritten += length;
+    *bytes_written = length;
+    return AFC_E_SUCCESS;
+}
+
+afc_error_t sim_afc_make_directory(afc_client_t client, const char *path)
+{
+    if (!client || !path) {
+        return AFC_E_INVALID_ARG;
+    }
+    roundTrip();
+    const QString afcPath = normalizePath(path);
+    QMutexLocker locker(&state().mutex);
+    if (useLocalRoot()) {
+        const QString local = localPathFor(afcPath);
+        return !local.isEmpty() && QDir().mkpath(local) ? AFC_E_SUCCESS : AFC_E_PERM_DENIED;
+    }
+    auto it = state().nodes.constFind(afcPath);
+    if (it != state().nodes.constEnd()) {
+        return it->isDir ? AFC_E_SUCCESS : AFC_E_OBJECT_EXISTS;
+    }
+    ensureDirectory(afcPath, nowNs());
+    return AFC_E_SUCCESS;
+}
+
+afc_error_t sim_afc_remove_path(afc_client_t client, const char *path)
+{
+    if (!client || !path) {
+        return AFC_E_INVALID_ARG;
+    }
+    roundTrip();
+    const QString afcPath = normalizePath(path);
+    if (afcPath == "/") {
+        return AFC_E_PERM_DENIED;
+    }
+    QMutexLocker locker(&state().mutex);
+    if (useLocalRoot()) {
+        const QString local = localPathFor(afcPath);
+        QFileInfo info(local);
+        if (local.isEmpty() || !info.exists()) {
+            return AFC_E_OBJECT_NOT_FOUND;
+        }
+        if (info.isDir()) {
+            if (!QDir(local).isEmpty()) {
+                return AFC_E_DIR_NOT_EMPTY;
+            }
+            return QDir().rmdir(local) ? AFC_E_SUCCESS : AFC_E_PERM_DENIED;
+        }
+        return QFile::remove(local) ? AFC_E_SUCCESS : AFC_E_PERM_DENIED;
+    }
+
+    auto it = state().nodes.find(afcPath);
+    if (it == state().nodes.end()) {
+        return AFC_E_OBJECT_NOT_FOUND;
+    }
+    if (it->isDir && !it->children.isEmpty()) {
+        return AFC_E_DIR_NOT_EMPTY;
+    }
+    state().nodes.erase(it);
+    const QString parent = parentPath(afcPath);
+    state().nodes[parent].children.removeOne(baseName(afcPath));
+    touchDirectory(parent, nowNs());
+    return AFC_E_SUCCESS;
+}
+
+// 递归移动内存文件系统中的节点
+void moveNode(const QString &from, const QString &to)
+{
+    SimState &s = state();
+    SimNode node = s.nodes.take(from);
+    for (const QString &child : node.children) {
+        moveNode(from + '/' + child, to + '/' + child);
+    }
+    s.nodes.insert(to, node);
+}
+
+afc_error_t sim_afc_rename_path(afc_client_t client, const char *from, const char *to)
+{
+    if (!client || !from || !to) {
+        return AFC_E_INVALID_ARG;
+    }
+    roundTrip();
+    const QString source = normalizePath(from);
+    const QString target = normalizePath(to);
+    QMutexLocker locker(&state().mutex);
+    if (useLocalRoot()) {
+        const QString localSource = localPathFor(source);
+        const QString localTarget = localPathFor(target);
+        if (localSource.isEmpty() || localTarget.isEmpty()) {
+            return AFC_E_PERM_DENIED;
+        }
+        if (!QFileInfo::exists(localSource)) {
+            return AFC_E_OBJECT_NOT_FOUND;
+        }
+        return QDir().rename(localSource, localTarget) ? AFC_E_SUCCESS : AFC_E_PERM_DENIED;
+    }
+
+    SimState &s = state();
+    if (!s.nodes.contains(source)) {
+        return AFC_E_OBJECT_NOT_FOUND;
+    }
+    if (s.nodes.contains(target) || !s.nodes.contains(parentPath(target))
+        || target.startsWith(source + '/')) {
+        return AFC_E_OBJECT_EXISTS;
+    }
+    const qint64 now = nowNs();
+    s.nodes[parentPath(source)].children.removeOne(baseName(source));
+    touchDirectory(parentPath(source), now);
+    moveNode(source, target);
+    s.nodes[parentPath(target)].children << baseName(target);
+    touchDirectory(parentPath(target), now);
+    return AFC_E_SUCCESS;
+}
+
+/* ============================================================================
+ * installation_proxy
+ * ============================================================================ */
+
+instproxy_error_t sim_instproxy_client_new(idevice_t device, lockdownd_service_descriptor_t service, instproxy_client_t *client)
+{
+    SimDevice *simDevice = reinterpret_cast<SimDevice*>(device);
+    if (!simDevice || !service || !client) {
+        return INSTPROXY_E_INVALID_ARG;
+    }
+    roundTrip();
+    *client = reinterpret_cast<instproxy_client_t>(new SimInstproxy{simDevice->udid});
+    return INSTPROXY_E_SUCCESS;
+}
+
+instproxy_error_t sim_instproxy_client_free(instproxy_client_t client)
+{
+    delete reinterpret_cast<SimInstproxy*>(client);
+    return INSTPROXY_E_SUCCESS;
+}
+
+QVariantMap appAttributes(const SimApp &app, const QStringList &returnAttributes)
+{
+    QVariantMap attributes;
+    attributes["CFBundleIdentifier"] = app.bundleId;
+    attributes["CFBundleDisplayName"] = app.name;
+    attributes["CFBundleName"] = app.name;
+    attributes["CFBundleShortVersionString"] = app.version;
+    attributes["CFBundleVersion"] = app.version;
+    attributes["ApplicationType"] = "User";
+    attributes["Path"] = QString("/private/var/containers/Bundle/Application/%1/App.app").arg(app.bundleId);
+    attributes["StaticDiskUsage"] = app.staticSize;
+    attributes["DynamicDiskUsage"] = app.dynamicSize;
+
+    if (returnAttributes.isEmpty()) {
+        return attributes;
+    }
+    QVariantMap filtered;
+    for (const QString &key : returnAttributes) {
+        if (attributes.contains(key)) {
+            filtered[key] = attributes.value(key);
+        }
+    }
+    return filtered;
+}
+
+QStringList stringArray(plist_t node)
+{
+    LibimobiledeviceDynamic &lib = LibimobiledeviceDynamic::instance();
+    QStringList result;
+    if (!node || lib.plist_get_node_type(node) != PLIST_ARRAY) {
+        return result;
+    }
+    const uint32_t count = lib.plist_array_get_size(node);
+    for (uint32_t i = 0; i < count; ++i) {
+        result << plistString(lib.plist_array_get_item(node, i));
+    }
+    return result;
+}
+
+instproxy_error_t sim_instproxy_browse(instproxy_client_t client, plist_t client_options, plist_t *result)
+{
+    if (!client || !result) {
+        return INSTPROXY_E_INVALID_ARG;
+    }
+    LibimobiledeviceDynamic &lib = LibimobiledeviceDynamic::instance();
+    QStringList returnAttributes;
+    QStringList bundleIds;
+    if (client_options) {
+        returnAttributes = stringArray(lib.plist_dict_get_item(client_options, "ReturnAttributes"));
+        bundleIds = stringArray(lib.plist_dict_get_item(client_options, "BundleIDs"));
+    }
+
+    roundTrip();
+    QVector<SimApp> apps;
+    {
+        QMutexLocker locker(&state().mutex);
+        apps = state().apps;
+    }
+
+    plist_t array = lib.plist_new_array();
+    qint64 payload = 0;
+    for (const SimApp &app : apps) {
+        if (!bundleIds.isEmpty() && !bundleIds.contains(app.bundleId)) {
+            continue;
+        }
+        lib.plist_array_append_item(array, toPlist(appAttributes(app, returnAttributes)));
+        payload += 512;
+    }
+    transfer(payload);
+    *result = array;
+    return INSTPROXY_E_SUCCESS;
+}
+
+instproxy_error_t sim_instproxy_lookup(instproxy_client_t client, const char **appids, plist_t client_options, plist_t *result)
+{
+    if (!client || !result) {
+        return INSTPROXY_E_INVALID_ARG;
+    }
+    LibimobiledeviceDynamic &lib = LibimobiledeviceDynamic::instance();
+    QStringList bundleIds;
+    for (const char **p = appids; p && *p; ++p) {
+        bundleIds << QString::fromUtf8(*p);
+    }
+    const QStringList returnAttributes = client_options
+        ? stringArray(lib.plist_dict_get_item(client_options, "ReturnAttributes"))
+        : QStringList();
+
+    roundTrip();
+    QVector<SimApp> apps;
+    {
+        QMutexLocker locker(&state().mutex);
+        apps = state().apps;
+    }
+    plist_t dict = lib.plist_new_dict();
+    for (const SimApp &app : apps) {
+        if (bundleIds.isEmpty() || bundleIds.contains(app.bundleId)) {
+            lib.plist_dict_set_item(dict, app.bundleId.toUtf8().constData(),
+                                    toPlist(appAttributes(app, returnAttributes)));
+        }
+    }
+    *result = dict;
+    return INSTPROXY_E_SUCCESS;
+}
+
+void reportStatus(instproxy_status_cb_t status_cb, void *user_data, const char *command, const QString &status, int percent)
+{
+    if (!status_cb) {
+        return;
+    }
+    LibimobiledeviceDynamic &lib = LibimobiledeviceDynamic::instance();
+    plist_t commandNode = lib.plist_new_dict();
+    lib.plist_dict_set_item(commandNode, "Command", lib.plist_new_string(command));
+    plist_t statusNode = lib.plist_new_dict();
+    lib.plist_dict_set_item(statusNode, "Status", lib.plist_new_string(status.toUtf8().constData()));
+    lib.plist_dict_set_item(statusNode, "PercentComplete", lib.plist_new_uint(static_cast<uint64_t>(percent)));
+    status_cb(commandNode, statusNode, user_data);
+    lib.plist_free(statusNode);
+    lib.plist_free(commandNode);
+}
+
+instproxy_error_t sim_instproxy_install(instproxy_client_t client, const char *pkg_path, plist_t client_options,
+                                       instproxy_status_cb_t status_cb, void *user_data)
+{
+    Q_UNUSED(client_options)
+    if (!client || !pkg_path) {
+        return INSTPROXY_E_INVALID_ARG;
+    }
+    const QString afcPath = normalizePath(pkg_path);
+    {
+        QMutexLocker locker(&state().mutex);
+        const bool exists = useLocalRoot() ? QFileInfo::exists(localPathFor(afcPath))
+                                           : state().nodes.contains(afcPath);
+        if (!exists) {
+            return INSTPROXY_E_OP_FAILED;
+        }
+    }
+
+    static const char *STAGES[] = {
+        "CreatingStagingDirectory", "ExtractingPackage", "InspectingPackage",
+        "PreflightingApplication", "VerifyingApplication", "CreatingContainer",
+        "InstallingApplication", "PostflightingApplication", "Complete",
+    };
+    const int stageCount = static_cast<int>(std::size(STAGES));
+    for (int i = 0; i < stageCount; ++i) {
+        roundTrip();
+        reportStatus(status_cb, user_data, "Install", QString::fromLatin1(STAGES[i]), (i + 1) * 100 / stageCount);
+    }
+
+    SimApp app;
+    app.bundleId = QString("com.phonelinkc.sim.%1").arg(QFileInfo(afcPath).completeBaseName().toLower());
+    app.name = QFileInfo(afcPath).completeBaseName();
+    app.version = "1.0";
+    app.staticSize = 30ULL * 1024 * 1024;
+    app.dynamicSize = 1ULL * 1024 * 1024;
+    QMutexLocker locker(&state().mutex);
+    state().apps.append(app);
+    return INSTPROXY_E_SUCCESS;
+}
+
+instproxy_error_t sim_instproxy_uninstall(instproxy_client_t client, const char *appid, plist_t client_options,
+                                         instproxy_status_cb_t status_cb, void *user_data)
+{
+    Q_UNUSED(client_options)
+    if (!client || !appid) {
+        return INSTPROXY_E_INVALID_ARG;
+    }
+    roundTrip();
+    const QString bundleId = QString::fromUtf8(appid);
+    bool removed = false;
+    {
+        QMutexLocker locker(&state().mutex);
+        QVector<SimApp> &apps = state().apps;
+        auto it = std::find_if(apps.begin(), apps.end(), [&bundleId](const SimApp &app) { return app.bundleId == bundleId; });
+        if (it != apps.end()) {
+            apps.erase(it);
+            removed = true;
+        }
+    }
+    if (!removed) {
+        return INSTPROXY_E_OP_FAILED;
+    }
+    reportStatus(status_cb, user_data, "Uninstall", QStringLiteral("Complete"), 100);
+    return INSTPROXY_E_SUCCESS;
+}
+
+/* ============================================================================
+ * mobilesync
+ * ============================================================================ */
+
+mobilesync_error_t sim_mobilesync_client_new(idevice_t device, lockdownd_service_descriptor_t service, mobilesync_client_t *client)
+{
+    SimDevice *simDevice = reinterpret_cast<SimDevice*>(device);
+    if (!simDevice || !service || !client) {
+        return MOBILESYNC_E_INVALID_ARG;
+    }
+    roundTrip();
+    *client = reinterpret_cast<mobilesync_client_t>(new SimMobilesync{simDevice->udid, 0});
+    return MOBILESYNC_E_SUCCESS;
+}
+
+mobilesync_error_t sim_mobilesync_client_start_service(idevice_t device, mobilesync_client_t *client, const char *label)
+{
+    Q_UNUSED(label)
+    SimDevice *simDevice = reinterpret_cast<SimDevice*>(device);
+    if (!simDevice || !client) {
+        return MOBILESYNC_E_INVALID_ARG;
+    }
+    if (!isAttached(simDevice->udid)) {
+        return MOBILESYNC_E_MUX_ERROR;
+    }
+    handshake();
+    roundTrip();
+    roundTrip();
+    *client = reinterpret_cast<mobilesync_client_t>(new SimMobilesync{simDevice->udid, 0});
+    return MOBILESYNC_E_SUCCESS;
+}
+
+mobilesync_error_t sim_mobilesync_client_free(mobilesync_client_t client)
+{
+    delete reinterpret_cast<SimMobilesync*>(client);
+    return MOBILESYNC_E_SUCCESS;
+}
+
+mobilesync_error_t sim_mobilesync_receive(mobilesync_client_t client, plist_t *plist)
+{
+    if (!client || !plist) {
+        return MOBILESYNC_E_INVALID_ARG;
+    }
+    roundTrip();
+    *plist = nullptr;
+    return MOBILESYNC_E_RECEIVE_TIMEOUT;
+}
+
+mobilesync_error_t sim_mobilesync_send(mobilesync_client_t client, plist_t plist)
+{
+    if (!client || !plist) {
+        return MOBILESYNC_E_INVALID_ARG;
+    }
+    roundTrip();
+    return MOBILESYNC_E_SUCCESS;
+}
+
+mobilesync_error_t sim_mobilesync_start(mobilesync_client_t client, const char *data_class, mobilesync_anchors_t anchors,
+                                        uint64_t computer_data_class_version, mobilesync_sync_type_t *sync_type,
+                                        uint64_t *device_data_class_version, char **error_description)
+{
+    Q_UNUSED(data_class)
+    Q_UNUSED(computer_data_class_version)
+    if (!client || !anchors || !sync_type || !device_data_class_version) {
+        return MOBILESYNC_E_INVALID_ARG;
+    }
+    roundTrip();
+    if (error_description) {
+        *error_description = nullptr;
+    }
+    *sync_type = anchors->device_anchor ? MOBILESYNC_SYNC_TYPE_FAST : MOBILESYNC_SYNC_TYPE_SLOW;
+    *device_data_class_version = 106;
+    return MOBILESYNC_E_SUCCESS;
+}
+
+mobilesync_error_t sim_mobilesync_finish(mobilesync_client_t client)
+{
+    if (!client) {
+        return MOBILESYNC_E_INVALID_ARG;
+    }
+    roundTrip();
+    return MOBILESYNC_E_SUCCESS;
+}
+
+mobilesync_error_t sim_mobilesync_get_all_records_from_device(mobilesync_client_t client)
+{
+    SimMobilesync *sync = reinterpret_cast<SimMobilesync*>(client);
+    if (!sync) {
+        return MOBILESYNC_E_INVALID_ARG;
+    }
+    roundTrip();
+    sync->cursor = 0;
+    return MOBILESYNC_E_SUCCESS;
+}
+
+plist_t buildContact(int index)
+{
+    static const char *LAST_NAMES[] = {"张", "王", "李", "赵", "陈", "刘", "杨", "黄"};
+    static const char *FIRST_NAMES[] = {"伟", "芳", "娜", "敏", "静", "磊", "洋", "勇", "艳", "杰"};
+
+    QVariantMap contact;
+    contact["com.apple.syncservices.RecordEntityName"] = "com.apple.contacts.Contact";
+    contact["first name"] = QString::fromUtf8(FIRST_NAMES[index % 10]) + QString::number(index);
+    contact["last name"] = QString::fromUtf8(LAST_NAMES[index % 8]);
+    if (index % 3 == 0) {
+        contact["organization"] = QString("模拟公司 %1").arg(index % 17);
+    }
+    contact["phone numbers"] = QStringList{QString("+86 139 %1").arg(index, 8, 10, QChar('0'))};
+    if (index % 2 == 0) {
+        contact["email addresses"] = QStringList{QString("user%1@example.com").arg(index)};
+    }
+    return toPlist(contact);
+}
+
+mobilesync_error_t sim_mobilesync_receive_changes(mobilesync_client_t client, plist_t *entities, uint8_t *is_last_record, plist_t *actions)
+{
+    SimMobilesync *sync = reinterpret_cast<SimMobilesync*>(client);
+    if (!sync || !entities) {
+        return MOBILESYNC_E_INVALID_ARG;
+    }
+    roundTrip();
+
+    int total = 0;
+    int batchSize = 0;
+    {
+        QMutexLocker locker(&state().mutex);
+        total = state().config.contactCount;
+        batchSize = qMax(1, state().config.contactBatchSize);
+    }
+
+    LibimobiledeviceDynamic &lib = LibimobiledeviceDynamic::instance();
+    plist_t dict = lib.plist_new_dict();
+    const int end = qMin(total, sync->cursor + batchSize);
+    for (int i = sync->cursor; i < end; ++i) {
+        lib.plist_dict_set_item(dict, QByteArray::number(i + 1).constData(), buildContact(i));
+    }
+    transfer(static_cast<qint64>(end - sync->cursor) * 256);
+    sync->cursor = end;
+
+    *entities = dict;
+    if (is_last_record) {
+        *is_last_record = sync->cursor >= total ? 1 : 0;
+    }
+    if (actions) {
+        *actions = nullptr;
+    }
+    return MOBILESYNC_E_SUCCESS;
+}
+
+mobilesync_error_t sim_mobilesync_acknowledge_changes_from_device(mobilesync_client_t client)
+{
+    if (!client) {
+        return MOBILESYNC_E_INVALID_ARG;
+    }
+    roundTrip();
+    return MOBILESYNC_E_SUCCESS;
+}
+
+mobilesync_anchors_t sim_mobilesync_anchors_new(const char *device_anchor, const char *computer_anchor)
+{
+    mobilesync_anchors_t anchors = static_cast<mobilesync_anchors_t>(calloc(1, sizeof(mobilesync_anchors)));
+    anchors->device_anchor = device_anchor ? strdup(device_anchor) : nullptr;
+    anchors->computer_anchor = computer_anchor ? strdup(computer_anchor) : nullptr;
+    return anchors;
+}
+
+void sim_mobilesync_anchors_free(mobilesync_anchors_t anchors)
+{
+    if (anchors) {
+        free(anchors->device_anchor);
+        free(anchors->computer_anchor);
+        free(anchors);
+    }
+}
+
+mobilesync_error_t sim_mobilesync_cancel(mobilesync_client_t client, const char *reason)
+{
+    Q_UNUSED(reason)
+    if (!client) {
+        return MOBILESYNC_E_INVALID_ARG;
+    }
+    roundTrip();
+    return MOBILESYNC_E_SUCCESS;
+}
+
+} // namespace
+
+/* ============================================================================
+ * SimulatedBackendConfig
+ * ============================================================================ */
+
+SimulatedBackendConfig SimulatedBackendConfig::fromEnvironment()
+{
+    const QString value = qEnvironmentVariable(SIMULATOR_ENV);
+    if (value.isEmpty() || value == "1") {
+        return SimulatedBackendConfig();
+    }
+    return fromJsonFile(value);
+}
+
+SimulatedBackendConfig SimulatedBackendConfig::fromJsonFile(const QString &path)
+{
+    SimulatedBackendConfig config;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "SimulatedBackend: 无法读取配置文件" << path << "，使用默认配置";
+        return config;
+    }
+    const QJsonObject obj = QJsonDocument::fromJson(file.readAll()).object();
+
+    for (const QJsonValue &udid : obj.value("udids").toArray()) {
+        config.udids << udid.toString();
+    }
+    config.latencyUs = obj.value("latencyUs").toInteger(config.latencyUs);
+    config.handshakeLatencyUs = obj.value("handshakeLatencyUs").toInteger(config.handshakeLatencyUs);
+    config.bandwidthBytesPerSec = obj.value("bandwidthBytesPerSec").toInteger(config.bandwidthBytesPerSec);
+    config.afcRoot = obj.value("afcRoot").toString(config.afcRoot);
+    config.albumCount = obj.value("albumCount").toInt(config.albumCount);
+    config.photosPerAlbum = obj.value("photosPerAlbum").toInt(config.photosPerAlbum);
+    config.photoSize = obj.value("photoSize").toInteger(config.photoSize);
+    config.videoEvery = obj.value("videoEvery").toInt(config.videoEvery);
+    config.sidecarEvery = obj.value("sidecarEvery").toInt(config.sidecarEvery);
+    config.appCount = obj.value("appCount").toInt(config.appCount);
+    config.contactCount = obj.value("contactCount").toInt(config.contactCount);
+    config.contactBatchSize = obj.value("contactBatchSize").toInt(config.contactBatchSize);
+    config.lockdownValues = obj.value("lockdownValues").toObject().toVariantMap();
+    return config;
+}
+
+/* ============================================================================
+ * SimulatedBackend
+ * ============================================================================ */
+
+bool SimulatedBackend::isRequested()
+{
+    const QString value = qEnvironmentVariable(SIMULATOR_ENV);
+    return !value.isEmpty() && value != "0";
+}
+
+void SimulatedBackend::configure(const SimulatedBackendConfig &config)
+{
+    SimState &s = state();
+    QMutexLocker locker(&s.mutex);
+
+    s.config = config;
+    if (s.config.udids.isEmpty()) {
+        s.config.udids << QString::fromLatin1(DEFAULT_UDID);
+    }
+    s.attachedDevices = s.config.udids;
+    s.latencyUs = config.latencyUs;
+    s.handshakeLatencyUs = config.handshakeLatencyUs;
+    s.bandwidth = config.bandwidthBytesPerSec;
+
+    if (s.jpegTemplate.isEmpty()) {
+        s.jpegTemplate = buildJpegTemplate();
+        s.heicTemplate = buildHeicTemplate();
+        s.movTemplate = buildMovTemplate();
+    }
+
+    resetFileSystem();
+    if (s.config.afcRoot.isEmpty()) {
+        buildSyntheticDcim();
+    }
+    buildApps(config.appCount);
+
+    qDebug() << "SimulatedBackend: 已配置" << s.config.udids.size() << "台模拟设备"
+             << "延迟:" << config.latencyUs << "us"
+             << "带宽:" << config.bandwidthBytesPerSec << "B/s"
+             << "文件系统:" << (s.config.afcRoot.isEmpty() ? QStringLiteral("内存") : s.config.afcRoot);
+}
+
+SimulatedBackendConfig SimulatedBackend::config()
+{
+    QMutexLocker locker(&state().mutex);
+    return state().config;
+}
+
+void SimulatedBackend::install(LibimobiledeviceDynamic &lib)
+{
+    lib.idevice_get_device_list = sim_idevice_get_device_list;
+    lib.idevice_device_list_free = sim_idevice_device_list_free;
+    lib.idevice_new = sim_idevice_new;
+    lib.idevice_free = sim_idevice_free;
+    lib.idevice_events_subscribe = sim_idevice_events_subscribe;
+    lib.idevice_events_unsubscribe = sim_idevice_events_unsubscribe;
+    lib.idevice_get_device_list_extended = sim_idevice_get_device_list_extended;
+    lib.idevice_device_list_extended_free = sim_idevice_device_list_extended_free;
+    lib.idevice_new_with_options = sim_idevice_new_with_options;
+
+    lib.lockdownd_client_new_with_handshake = sim_lockdownd_client_new_with_handshake;
+    lib.lockdownd_client_free = sim_lockdownd_client_free;
+    lib.lockdownd_get_value = sim_lockdownd_get_value;
+    lib.lockdownd_start_service = sim_lockdownd_start_service;
+    lib.lockdownd_service_descriptor_free = sim_lockdownd_service_descriptor_free;
+
+    lib.instproxy_client_new = sim_instproxy_client_new;
+    lib.instproxy_client_free = sim_instproxy_client_free;
+    lib.instproxy_browse = sim_instproxy_browse;
+    lib.instproxy_install = sim_instproxy_install;
+    lib.instproxy_uninstall = sim_instproxy_uninstall;
+    lib.instproxy_lookup = sim_instproxy_lookup;
+
+    lib.afc_client_new = sim_afc_client_new;
+    lib.afc_client_start_service = sim_afc_client_start_service;
+    lib.afc_client_free = sim_afc_client_free;
+    lib.afc_get_device_info = sim_afc_get_device_info;
+    lib.afc_read_directory = sim_afc_read_directory;
+    lib.afc_get_file_info = sim_afc_get_file_info;
+    lib.afc_file_open = sim_afc_file_open;
+    lib.afc_file_close = sim_afc_file_close;
+    lib.afc_file_read = sim_afc_file_read;
+    lib.afc_file_seek = sim_afc_file_seek;
+    lib.afc_file_tell = sim_afc_file_tell;
+    lib.afc_file_write = sim_afc_file_write;
+    lib.afc_make_directory = sim_afc_make_directory;
+    lib.afc_remove_path = sim_afc_remove_path;
+    lib.afc_rename_path = sim_afc_rename_path;
+    lib.afc_dictionary_free = sim_afc_dictionary_free;
+
+    lib.mobilesync_client_start_service = sim_mobilesync_client_start_service;
+    lib.mobilesync_client_new = sim_mobilesync_client_new;
+    lib.mobilesync_client_free = sim_mobilesync_client_free;
+    lib.mobilesync_receive = sim_mobilesync_receive;
+    lib.mobilesync_send = sim_mobilesync_send;
+    lib.mobilesync_start = sim_mobilesync_start;
+    lib.mobilesync_finish = sim_mobilesync_finish;
+    lib.mobilesync_get_all_records_from_device = sim_mobilesync_get_all_records_from_device;
+    lib.mobilesync_receive_changes = sim_mobilesync_receive_changes;
+    lib.mobilesync_acknowledge_changes_from_device = sim_mobilesync_acknowledge_changes_from_device;
+    lib.mobilesync_anchors_new = sim_mobilesync_anchors_new;
+    lib.mobilesync_anchors_free = sim_mobilesync_anchors_free;
+    lib.mobilesync_cancel = sim_mobilesync_cancel;
+}
+
+void SimulatedBackend::setLatency(qint64 latencyUs, qint64 handshakeLatencyUs)
+{
+    SimState &s = state();
+    s.latencyUs = latencyUs;
+    s.handshakeLatencyUs = handshakeLatencyUs;
+    QMutexLocker locker(&s.mutex);
+    s.config.latencyUs = latencyUs;
+    s.config.handshakeLatencyUs = handshakeLatencyUs;
+}
+
+void SimulatedBackend::setBandwidth(qint64 bytesPerSec)
+{
+    SimState &s = state();
+    s.bandwidth = bytesPerSec;
+    QMutexLocker locker(&s.mutex);
+    s.config.bandwidthBytesPerSec = bytesPerSec;
+}
+
+void SimulatedBackend::setAppCount(int count)
+{
+    QMutexLocker locker(&state().mutex);
+    state().config.appCount = count;
+    buildApps(count);
+}
+
+void SimulatedBackend::setContactCount(int count, int batchSize)
+{
+    QMutexLocker locker(&state().mutex);
+    state().config.contactCount = count;
+    state().config.contactBatchSize = batchSize;
+}
+
+void SimulatedBackend::clearFileSystem()
+{
+    QMutexLocker locker(&state().mutex);
+    resetFileSystem();
+}
+
+void SimulatedBackend::addDirectory(const QString &path, qint64 mtimeNs)
+{
+    QMutexLocker locker(&state().mutex);
+    ensureDirectory(normalizePath(path.toUtf8().constData()), mtimeNs > 0 ? mtimeNs : nowNs());
+}
+
+void SimulatedBackend::addFile(const QString &path, const QByteArray &data, qint64 mtimeNs)
+{
+    SimNode node;
+    node.data = data;
+    node.size = data.size();
+    node.mtimeNs = mtimeNs > 0 ? mtimeNs : nowNs();
+    QMutexLocker locker(&state().mutex);
+    insertFileNode(normalizePath(path.toUtf8().constData()), node);
+}
+
+void SimulatedBackend::addSyntheticFile(const QString &path, qint64 size, qint64 mtimeNs)
+{
+    SimNode node;
+    node.synthetic = true;
+    node.size = size;
+    node.mtimeNs = mtimeNs > 0 ? mtimeNs : nowNs();
+    QMutexLocker locker(&state().mutex);
+    insertFileNode(normalizePath(path.toUtf8().constData()), node);
+}
+
+void SimulatedBackend::emitDeviceEvent(const QString &udid, int eventType)
+{
+    const enum idevice_event_type type = static_cast<enum idevice_event_type>(eventType);
+    {
+        QMutexLocker locker(&state().mutex);
+        if (type == IDEVICE_DEVICE_REMOVE) {
+            state().attachedDevices.removeAll(udid);
+        } else if (!state().attachedDevices.contains(udid)) {
+            state().attachedDevices << udid;
+        }
+    }
+    dispatchEvent(udid, type);
+}
+
+SimulatedBackend::Stats SimulatedBackend::stats()
+{
+    SimState &s = state();
+    Stats result;
+    result.roundTrips = s.roundTrips.load();
+    result.handshakes = s.handshakes.load();
+    result.bytesRead = s.bytesRead.load();
+    result.bytesWritten = s.bytesWritten.load();
+    return result;
+}
+
+void SimulatedBackend::resetStats()
+{
+    SimState &s = state();
+    s.roundTrips = 0;
+    s.handshakes = 0;
+    s.bytesRead = 0;
+    s.bytesWritten = 0;
+}
@@ -0,0 +1,184 @@
+/**
+ * @file simulated_backend.h
+ * @brief 进程内模拟设备后端
+ *
+ * 本文件定义了一个不依赖真实 iPhone 的模拟后端。它实现了 LibimobiledeviceDynamic
+ * 函数指针表中 idevice / lockdownd / AFC / installation_proxy / mobilesync 部分，
+ * 上层管理器（PhotoManager、FileManager、AppManager、ContactManager 等）无需任何修改
+ * 即可在模拟设备上运行，便于基准测试与无设备环境下的调试。
+ *
+ * 模拟后端提供：
+ * - 内存文件系统或映射到本地目录的 AFC 文件系统
+ * - 合成的 installation_proxy 应用列表
+ * - 可配置的 lockdown 属性值（支持按域整体查询）
+ * - mobilesync 通讯录数据源
+ * - 每次调用的往返延迟和共享链路带宽模拟
+ *
+ * 启用方式：
+ * - 设置环境变量 PHONELINKC_SIMULATOR=1 使用默认配置
+ * - 或设置为 JSON 配置文件路径，字段与 SimulatedBackendConfig 成员同名
+ * - 代码中直接调用 LibimobiledeviceDynamic::initializeSimulated()
+ *
+ * @note plist 函数仍由真实的 libplist 提供（Windows 上动态加载，其他平台链接）
+ */
+
+#ifndef SIMULATED_BACKEND_H
+#define SIMULATED_BACKEND_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <QByteArray>
+
+class LibimobiledeviceDynamic;
+
+/**
+ * @brief 模拟后端配置
+ */
+struct SimulatedBackendConfig {
+    QStringList udids;                  ///< 模拟设备 UDID 列表（默认一台）
+
+    // ===== 时延与带宽 =====
+    qint64 latencyUs = 0;               ///< 每次服务调用的往返延迟（微秒）
+    qint64 handshakeLatencyUs = 0;      ///< lockdown 握手的额外延迟（微秒）
+    qint64 bandwidthBytesPerSec = 0;    ///< 共享链路带宽（字节/秒，0 表示不限速）
+
+    // ===== AFC 文件系统 =====
+    QString afcRoot;                    ///< 非空时以该本地目录作为 AFC 根目录，否则使用内存文件系统
+    int albumCount = 4;                 ///< 合成 DCIM 相册目录数（仅内存文件系统）
+    int photosPerAlbum = 100;           ///< 每个相册目录的媒体文件数
+    qint64 photoSize = 2 * 1024 * 1024; ///< 合成照片大小（字节）
+    int videoEvery = 10;                ///< 每 N 个媒体文件中有一个视频（0 表示没有视频）
+    int sidecarEvery = 5;               ///< 每 N 张照片附带一个 .AAE 文件（0 表示没有）
+
+    // ===== 服务数据 =====
+    int appCount = 40;                  ///< installation_proxy 返回的用户应用数
+    int contactCount = 200;             ///< mobilesync 返回的联系人数
+    int contactBatchSize = 100;         ///< mobilesync 每批返回的联系人数
+    QVariantMap lockdownValues;         ///< 覆盖 lockdown 属性，键格式为 "域/键"，全局域直接写键名
+
+    /**
+     * @brief 从环境变量 PHONELINKC_SIMULATOR 读取配置
+     * @return 环境变量为 "1" 时返回默认配置，为文件路径时读取 JSON 配置
+     */
+    static SimulatedBackendConfig fromEnvironment();
+
+    /**
+     * @brief 从 JSON 文件读取配置
+     * @param path 配置文件路径
+     * @return 配置（读取失败的字段保持默认值）
+     */
+    static SimulatedBackendConfig fromJsonFile(const QString &path);
+};
+
+/**
+ * @brief 进程内模拟设备后端
+ *
+ * 全部为静态方法，内部状态是进程级单例，可在多个线程中并发调用。
+ * 延迟在锁外等待，因此多个客户端的往返可以重叠；带宽为全部客户端共享，
+ * 与真实设备通过同一条 USB 链路传输的情况一致。
+ *
+ * 使用方法：
+ * @code
+ * SimulatedBackendConfig config;
+ * config.latencyUs = 2000;
+ * LibimobiledeviceDynamic::instance().initializeSimulated(config);
+ * SimulatedBackend::clearFileSystem();
+ * SimulatedBackend::addSyntheticFile("/DCIM/100APPLE/IMG_0001.JPG", 3 * 1024 * 1024);
+ * @endcode
+ */
+class SimulatedBackend
+{
+public:
+    /**
+     * @brief 调用统计
+     */
+    struct Stats {
+        quint64 roundTrips = 0;     ///< 服务调用往返次数
+        quint64 handshakes = 0;     ///< lockdown 握手次数
+        quint64 bytesRead = 0;      ///< 从设备读取的字节数
+        quint64 bytesWritten = 0;   ///< 写入设备的字节数
+    };
+
+    /**
+     * @brief 是否通过环境变量请求了模拟后端
+     */
+    static bool isRequested();
+
+    /**
+     * @brief 应用配置并重建设备数据
+     *
+     * 内存文件系统会按配置重新生成合成的 DCIM 目录。
+     */
+    static void configure(const SimulatedBackendConfig &config);
+
+    /**
+     * @brief 获取当前配置
+     */
+    static SimulatedBackendConfig config();
+
+    /**
+     * @brief 将模拟实现填入函数指针表
+     *
+     * 覆盖 idevice、lockdownd、AFC、installation_proxy 和 mobilesync 函数指针，
+     * plist 与 mobilebackup2 函数指针保持不变。
+     */
+    static void install(LibimobiledeviceDynamic &lib);
+
+    /* ========================================================================
+     * 运行时调整
+     * ======================================================================== */
+
+    static void setLatency(qint64 latencyUs, qint64 handshakeLatencyUs = 0);
+    static void setBandwidth(qint64 bytesPerSec);
+    static void setAppCount(int count);
+    static void setContactCount(int count, int batchSize = 100);
+
+    /* ========================================================================
+     * 内存文件系统（afcRoot 为空时有效）
+     * ======================================================================== */
+
+    /**
+     * @brief 清空内存文件系统（仅保留根目录）
+     */
+    static void clearFileSystem();
+
+    /**
+     * @brief 创建目录（自动创建父目录）
+     * @param mtimeNs 修改时间（纳秒，0 表示当前时间）
+     */
+    static void addDirectory(const QString &path, qint64 mtimeNs = 0);
+
+    /**
+     * @brief 添加带实际内容的文件
+     */
+    static void addFile(const QString &path, const QByteArray &data, qint64 mtimeNs = 0);
+
+    /**
+     * @brief 添加合成文件，内容在读取时按需生成
+     *
+     * .JPG/.JPEG 文件以一张可解码的 JPEG 开头，其余字节为确定性的填充数据。
+     */
+    static void addSyntheticFile(const QString &path, qint64 size, qint64 mtimeNs = 0);
+
+    /* ========================================================================
+     * 设备事件与统计
+     * ======================================================================== */
+
+    /**
+     * @brief 模拟设备插拔事件
+     * @param udid 设备 UDID
+     * @param eventType idevice_event_type 取值（IDEVICE_DEVICE_ADD 等）
+     *
+     * 回调在调用线程中同步执行，与 usbmuxd 事件线程回调的行为一致。
+     */
+    static void emitDeviceEvent(const QString &udid, int eventType);
+
+    static Stats stats();
+    static void resetStats();
+
+private:
+    SimulatedBackend() = delete;
+};
+
+#endif // SIMULATED_BACKEND_H
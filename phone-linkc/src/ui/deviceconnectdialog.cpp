@@ -54,6 +54,10 @@ void DeviceConnectDialog::setupConnections()
     connect(m_deviceManager, &DeviceManager::noDevicesFound,
             this, &DeviceConnectDialog::onNoDevicesFound);
     
+    // 后台刷新到新的设备名称/型号时更新列表项
+    connect(&DeviceMetadataCache::instance(), &DeviceMetadataCache::metadataUpdated,
+            this, &DeviceConnectDialog::onDeviceMetadataUpdated);
+    
     // 连接UI信号
     connect(ui->refreshButton, &QPushButton::clicked,
             this, &DeviceConnectDialog::onRefreshClicked);
@@ -78,17 +82,12 @@ void DeviceConnectDialog::refreshDeviceList()
     updateStatus(tr("正在搜索设备..."), true);
     
     // 手动填充已知设备列表（不调用 refreshDevices 避免重复信号）
+    // 名称取自元数据缓存，过期条目在后台刷新，完成后通过 onDeviceMetadataUpdated 更新
     const QStringList& devices = m_deviceManager->getConnectedDevices();
     for (const QString& udid : devices) {
-        QString deviceName = m_deviceManager->getDeviceName(udid);
-        if (deviceName.isEmpty() || deviceName == "Unknown Device") {
-            deviceName = "iOS Device";
-        }
-        QListWidgetItem *item = new QListWidgetItem(QString("%1\n%2").arg(deviceName, udid));
-        item->setData(Qt::UserRole, udid);
-        item->setData(Qt::UserRole + 1, deviceName);
-        ui->deviceListWidget->addItem(item);
+        addDeviceItem(udid, m_deviceManager->cachedDeviceName(udid));
     }
+    DeviceMetadataCache::instance().refresh(devices);
     
     if (devices.isEmpty()) {
         // 只有在没有设备时才刷新（可能是第一次打开）
@@ -97,23 +96,8 @@ void DeviceConnectDialog::refreshDeviceList()
         // 刷新后再次检查
         const QStringList& devicesAfterRefresh = m_deviceManager->getConnectedDevices();
         for (const QString& udid : devicesAfterRefresh) {
-            // 检查是否已存在
-            bool exists = false;
-            for (int i = 0; i < ui->deviceListWidget->count(); ++i) {
-                if (ui->deviceListWidget->item(i)->data(Qt::UserRole).toString() == udid) {
-                    exists = true;
-                    break;
-                }
-            }
-            if (!exists) {
-                QString deviceName = m_deviceManager->getDeviceName(udid);
-                if (deviceName.isEmpty() || deviceName == "Unknown Device") {
-                    deviceName = "iOS Device";
-                }
-                QListWidgetItem *item = new QListWidgetItem(QString("%1\n%2").arg(deviceName, udid));
-                item->setData(Qt::UserRole, udid);
-                item->setData(Qt::UserRole + 1, deviceName);
-                ui->deviceListWidget->addItem(item);
+            if (!findDeviceItem(udid)) {
+                addDeviceItem(udid, m_deviceManager->cachedDeviceName(udid));
             }
         }
         
@@ -129,6 +113,54 @@ void DeviceConnectDialog::refreshDeviceList()
     updateButtonState();
 }
 
+QListWidgetItem *DeviceConnectDialog::findDeviceItem(const QString &udid) const
+{
+    for (int i = 0; i < ui->deviceListWidget->count(); ++i) {
+        QListWidgetItem *item = ui->deviceListWidget->item(i);
+        if (item && item->data(Qt::UserRole).toString() == udid) {
+            return item;
+        }
+    }
+    return nullptr;
+}
+
+void DeviceConnectDialog::addDeviceItem(const QString &udid, const QString &name)
+{
+    QListWidgetItem *item = new QListWidgetItem();
+    item->setData(Qt::UserRole, udid);
+    updateDeviceItem(item, name);
+    ui->deviceListWidget->addItem(item);
+}
+
+void DeviceConnectDialog::updateDeviceItem(QListWidgetItem *item, const QString &name)
+{
+    QString udid = item->data(Qt::UserRole).toString();
+    DeviceMetadata metadata = DeviceMetadataCache::instance().lookup(udid);
+    
+    // 有缓存的型号和系统版本时一并显示
+    QString title = name;
+    if (!metadata.productType.isEmpty() && !metadata.productVersion.isEmpty()) {
+        title = QString("%1  (%2, iOS %3)").arg(name, metadata.productType, metadata.productVersion);
+    }
+    item->setText(QString("%1\n%2").arg(title, udid));
+    item->setData(Qt::UserRole + 1, name);
+}
+
+void DeviceConnectDialog::onDeviceMetadataUpdated(const QString &udid, const DeviceMetadata &metadata)
+{
+    QListWidgetItem *item = findDeviceItem(udid);
+    if (!item || metadata.name.isEmpty()) {
+        return;
+    }
+    
+    updateDeviceItem(item, metadata.name);
+    
+    // 当前选中项的名称同步更新
+    if (item == ui->deviceListWidget->currentItem()) {
+        m_selectedName = metadata.name;
+    }
+}
+
 void DeviceConnectDialog::updateStatus(const QString &message, bool showProgress)
 {
     ui->statusLabel->setText(message);
@@ -146,16 +178,11 @@ void DeviceConnectDialog::onDeviceFound(const QString &udid, const QString &name
     qDebug() << "Dialog: 发现设备" << udid << name;
     
     // 检查是否已存在
-    for (int i = 0; i < ui->deviceListWidget->count(); ++i) {
-        if (ui->deviceListWidget->item(i)->data(Qt::UserRole).toString() == udid) {
-            return;
-        }
+    if (findDeviceItem(udid)) {
+        return;
     }
     
-    QListWidgetItem *item = new QListWidgetItem(QString("%1\n%2").arg(name, udid));
-    item->setData(Qt::UserRole, udid);
-    item->setData(Qt::UserRole + 1, name);
-    ui->deviceListWidget->addItem(item);
+    addDeviceItem(udid, name);
     
     updateStatus(tr("找到 %1 台设备").arg(ui->deviceListWidget->count()));
     updateButtonState();
@@ -4,6 +4,8 @@
 #include <QDialog>
 #include <QListWidgetItem>
 
+#include "core/device/devicemetadatacache.h"
+
 class DeviceManager;
 
 QT_BEGIN_NAMESPACE
@@ -49,6 +51,7 @@ private slots:
     void onDeviceDisconnected();
     void onDeviceError(const QString &error);
     void onNoDevicesFound();
+    void onDeviceMetadataUpdated(const QString &udid, const DeviceMetadata &metadata);
     
     void onRefreshClicked();
     void onDeviceSelectionChanged();
@@ -59,6 +62,11 @@ private:
     void refreshDeviceList();
     void updateStatus(const QString &message, bool showProgress = false);
     void updateButtonState();
+    
+    // 设备列表项
+    QListWidgetItem *findDeviceItem(const QString &udid) const;
+    void addDeviceItem(const QString &udid, const QString &name);
+    void updateDeviceItem(QListWidgetItem *item, const QString &name);
 
     Ui::DeviceConnectDialog *ui;
     DeviceManager *m_deviceManager;
@@ -3,19 +3,23 @@
 #include "debugwindow.h"
 #include "deviceconnectdialog.h"
 #include "platform/libimobiledevice_dynamic.h"
+#include "core/device/devicemetadatacache.h"
 #include <QDebug>
 #include <QMessageBox>
-#include <QApplication>
+#include <QFileDialog>
+#include <QStandardPaths>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , m_deviceManager(new DeviceManager(this))
     , m_infoManager(new DeviceInfoManager(this))
+    , m_infoWatcher(new QFutureWatcher<DeviceInfo>(this))
     , m_photoManager(new PhotoManager(this))
     , m_fileManager(new FileManager(this))
     , m_appManager(new AppManager(this))
     , m_contactManager(new ContactManager(this))
+    , m_fleet(new DeviceFleet(this))
     , m_debugWindow(nullptr)
 {
     ui->setupUi(this);
@@ -42,12 +46,22 @@ MainWindow::MainWindow(QWidget *parent)
     connect(m_deviceManager, &DeviceManager::errorOccurred,
             this, &MainWindow::onDeviceError);
     
+    // 多设备工作区随设备发现/断开自动创建和关闭
+    m_fleet->attach(m_deviceManager);
+    
+    // 设备信息分阶段到达时刷新显示
+    connect(m_infoWatcher, &QFutureWatcher<DeviceInfo>::resultReadyAt,
+            this, &MainWindow::onDeviceInfoStageReady);
+    connect(m_infoWatcher, &QFutureWatcher<DeviceInfo>::finished,
+            this, &MainWindow::onDeviceInfoFinished);
+    
     setWindowTitle("iOS 设备管理器 - libimobiledevice 示例");
     resize(1160, 780);
 }
 
 MainWindow::~MainWindow()
 {
+    m_infoWatcher->cancel();
     if (m_deviceManager) {
         m_deviceManager->stopDiscovery();
     }
@@ -66,6 +80,12 @@ void MainWindow::setupUI()
     connect(ui->actionOpenDebugWindow, &QAction::triggered,
             this, &MainWindow::onOpenDebugWindow);
     
+    // 连接批量菜单动作
+    connect(ui->actionListAppsOnAll, &QAction::triggered,
+            this, &MainWindow::onListAppsOnAll);
+    connect(ui->actionPullDcimFromAll, &QAction::triggered,
+            this, &MainWindow::onPullDcimFromAll);
+    
     // 连接菜单列表选择信号
     connect(ui->menuList, &QListWidget::currentRowChanged,
             this, &MainWindow::onMenuItemSelected);
@@ -120,6 +140,10 @@ void MainWindow::onDeviceDisconnected()
     m_connectedDeviceName.clear();
     m_currentUdid.clear();
     
+    // 停止尚未完成的设备信息获取
+    m_infoWatcher->cancel();
+    m_infoWatcher->setFuture(QFuture<DeviceInfo>());
+    
     // 断开照片管理器连接
     m_photoManager->disconnect();
     
@@ -197,15 +221,87 @@ void MainWindow::updateDeviceInfo(const QString &udid)
 {
     ui->infoDisplay->setPlainText("正在获取设备信息...");
     
-    // 在后台线程获取设备信息
-    QApplication::processEvents();
+    // 取消上一次未完成的获取，切换后旧任务的结果不会再送达
+    m_infoWatcher->cancel();
     
-    DeviceInfo info = m_infoManager->getDeviceInfo(udid);
+    // 在后台线程获取设备信息，标识、存储、电池信息依次到达
+    m_infoWatcher->setFuture(m_infoManager->getDeviceInfoAsync(udid));
+}
+
+void MainWindow::onDeviceInfoStageReady(int stage)
+{
+    DeviceInfo info = m_infoWatcher->resultAt(stage);
+    if (info.udid != m_currentUdid) {
+        return;
+    }
     
-    // 直接使用 DeviceInfo::toString() 方法获取格式化的设备信息
+    // 直接使用 DeviceInfo::toString() 方法获取格式化的设备信息，未到达的部分显示为正在获取
     ui->infoDisplay->setPlainText(info.toString());
 }
 
+void MainWindow::onDeviceInfoFinished()
+{
+    if (m_infoWatcher->isCanceled() || m_currentUdid.isEmpty()) {
+        return;
+    }
+    
+    if (m_infoWatcher->future().resultCount() == 0) {
+        ui->infoDisplay->setPlainText("获取设备信息失败\n\n"
+                                      "请确认设备已解锁并信任此电脑，然后重新连接");
+    }
+}
+
+void MainWindow::onListAppsOnAll()
+{
+    // 先刷新设备列表，新发现的设备会自动创建工作区
+    m_deviceManager->refreshDevices();
+    if (m_fleet->udids().isEmpty()) {
+        QMessageBox::information(this, "批量操作", "未发现 iOS 设备");
+        return;
+    }
+    
+    updateDisplayText(QString(), QString("正在 %1 台设备上并行列出应用...").arg(m_fleet->udids().size()));
+    
+    m_fleet->listAppsOnAll().then(this, [this](const QMap<QString, QVector<AppInfo>> &results) {
+        QStringList lines;
+        for (auto it = results.constBegin(); it != results.constEnd(); ++it) {
+            QString name = DeviceMetadataCache::instance().lookup(it.key()).name;
+            lines << QString("%1 (%2): %3 个应用")
+                         .arg(name.isEmpty() ? "iOS Device" : name, it.key())
+                         .arg(it.value().size());
+        }
+        updateDisplayText(QString(), QString("已完成 %1 台设备的应用列表").arg(results.size()));
+        QMessageBox::information(this, "所有设备的应用", lines.join('\n'));
+    });
+}
+
+void MainWindow::onPullDcimFromAll()
+{
+    m_deviceManager->refreshDevices();
+    if (m_fleet->udids().isEmpty()) {
+        QMessageBox::information(this, "批量操作", "未发现 iOS 设备");
+        return;
+    }
+    
+    QString dir = QFileDialog::getExistingDirectory(this, "选择导出目录",
+        QStandardPaths::writableLocation(QStandardPaths::PicturesLocation));
+    if (dir.isEmpty()) {
+        return;
+    }
+    
+    updateDisplayText(QString(), QString("正在从 %1 台设备并行导出照片...").arg(m_fleet->udids().size()));
+    
+    m_fleet->pullDcimFromAll(dir).then(this, [this, dir](const QMap<QString, int> &results) {
+        int total = 0;
+        for (int count : results) {
+            total += count;
+        }
+        updateDisplayText(QString(), QString("已从 %1 台设备导出 %2 个文件").arg(results.size()).arg(total));
+        QMessageBox::information(this, "导出完成",
+            QString("已从 %1 台设备导出 %2 个文件到:\n%3").arg(results.size()).arg(total).arg(dir));
+    });
+}
+
 void MainWindow::updateConnectionStatus()
 {
     bool isConnected = m_deviceManager->isConnected();
@@ -2,6 +2,7 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QFutureWatcher>
 
 #include "core/device/devicemanager.h"
 #include "core/device/deviceinfo.h"
@@ -9,6 +10,7 @@
 #include "core/file/filemanager.h"
 #include "core/app/appmanager.h"
 #include "core/contact/contactmanager.h"
+#include "core/device/devicefleet.h"
 #include "ui/apppage.h"
 
 class DebugWindow;
@@ -36,6 +38,10 @@ private slots:
     void onDisconnectButtonClicked();
     void onMenuItemSelected(int index);
     void onOpenDebugWindow();
+    void onDeviceInfoStageReady(int stage);
+    void onDeviceInfoFinished();
+    void onListAppsOnAll();
+    void onPullDcimFromAll();
 
 private:
     void setupUI();
@@ -63,10 +69,12 @@ private:
     // 业务逻辑
     DeviceManager *m_deviceManager;
     DeviceInfoManager *m_infoManager;
+    QFutureWatcher<DeviceInfo> *m_infoWatcher;  // 异步设备信息获取
     PhotoManager *m_photoManager;
     FileManager *m_fileManager;
     AppManager *m_appManager;
     ContactManager *m_contactManager;
+    DeviceFleet *m_fleet;  // 每台已连接设备一个工作区，用于多设备并行作业
     
     // UI Pages
     AppPage *m_appPage;
@@ -0,0 +1,105 @@
+/**
+ * @file photogriddelegate.cpp
+ * @brief 照片网格格子绘制代理实现
+ */
+
+#include "photogriddelegate.h"
+#include "photogridmodel.h"
+
+#include <QPainter>
+#include <QPixmap>
+
+PhotoGridDelegate::PhotoGridDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+void PhotoGridDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const QRect cell = option.rect;
+    const bool selected = option.state & QStyle::State_Selected;
+    const bool hovered = option.state & QStyle::State_MouseOver;
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    // 背景
+    QRect bgRect = cell.adjusted(2, 2, -2, -2);
+    if (selected) {
+        painter->fillRect(bgRect, QColor("#e3f2fd"));
+        painter->setPen(QPen(QColor("#1976d2"), 2));
+        painter->drawRect(bgRect);
+    } else if (hovered) {
+        painter->fillRect(bgRect, QColor("#f5f5f5"));
+        painter->setPen(QPen(QColor("#e0e0e0"), 1));
+        painter->drawRect(bgRect);
+    } else {
+        painter->fillRect(bgRect, Qt::white);
+        painter->setPen(QPen(QColor("#e8e8e8"), 1));
+        painter->drawRect(bgRect);
+    }
+
+    // 缩略图，尚未加载时为占位符
+    const QPixmap pixmap = index.data(Qt::DecorationRole).value<QPixmap>();
+    const QSize imageSize = pixmap.isNull() ? QSize(THUMBNAIL_SIZE, THUMBNAIL_SIZE) : pixmap.size();
+    const QRect imageRect(cell.x() + (cell.width() - imageSize.width()) / 2,
+                          cell.y() + (cell.height() - imageSize.height()) / 2 - 8,
+                          imageSize.width(), imageSize.height());
+    if (pixmap.isNull()) {
+        painter->fillRect(imageRect, Qt::lightGray);
+    } else {
+        painter->drawPixmap(imageRect.topLeft(), pixmap);
+    }
+
+    // 文件名
+    QRect textRect(cell.x() + 4, cell.bottom() + 1 - 24, cell.width() - 8, 20);
+    painter->setPen(Qt::black);
+    QFont font = option.font;
+    font.setPointSize(8);
+    painter->setFont(font);
+    QString elidedText = painter->fontMetrics().elidedText(
+        index.data(Qt::DisplayRole).toString(), Qt::ElideMiddle, textRect.width());
+    painter->drawText(textRect, Qt::AlignCenter, elidedText);
+
+    // 视频标识
+    if (index.data(PhotoGridModel::IsVideoRole).toBool()) {
+        QRect videoRect(cell.right() + 1 - 24, cell.y() + 6, 18, 18);
+        painter->fillRect(videoRect, QColor(0, 0, 0, 128));
+        painter->setPen(Qt::white);
+        painter->drawText(videoRect, Qt::AlignCenter, "▶");
+
+        // 时长（叠加在缩略图右下角）
+        const qint64 durationMs = index.data(PhotoGridModel::DurationRole).toLongLong();
+        if (durationMs > 0) {
+            const qint64 seconds = (durationMs + 500) / 1000;
+            QString duration = QString("%1:%2").arg(seconds / 60 % 60).arg(seconds % 60, 2, 10, QChar('0'));
+            if (seconds >= 3600) {
+                duration = QString("%1:%2").arg(seconds / 3600).arg(duration.rightJustified(5, '0'));
+            }
+            QFont durationFont = font;
+            durationFont.setPointSize(7);
+            painter->setFont(durationFont);
+            const int textWidth = painter->fontMetrics().horizontalAdvance(duration) + 6;
+            QRect durationRect(imageRect.right() + 1 - textWidth - 2, imageRect.bottom() + 1 - 16, textWidth, 14);
+            painter->fillRect(durationRect, QColor(0, 0, 0, 128));
+            painter->drawText(durationRect, Qt::AlignCenter, duration);
+        }
+    }
+
+    // 选中标记（心形图标）
+    if (selected || hovered) {
+        QRect heartRect(cell.x() + 8, cell.bottom() + 1 - 32, 16, 16);
+        painter->setPen(selected ? QColor("#e65100") : QColor("#999999"));
+        painter->setFont(QFont("Arial", 12));
+        painter->drawText(heartRect, Qt::AlignCenter, selected ? "♥" : "♡");
+    }
+
+    painter->restore();
+}
+
+QSize PhotoGridDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    Q_UNUSED(option)
+    Q_UNUSED(index)
+    return QSize(CELL_SIZE, CELL_SIZE);
+}
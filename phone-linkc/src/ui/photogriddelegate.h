@@ -0,0 +1,34 @@
+/**
+ * @file photogriddelegate.h
+ * @brief 照片网格格子绘制代理头文件
+ */
+
+#ifndef PHOTOGRIDDELEGATE_H
+#define PHOTOGRIDDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+/**
+ * @brief 照片网格格子绘制代理
+ *
+ * 绘制一个 120x120 的格子：背景（选中/悬停）、居中的缩略图或占位图、文件名、
+ * 视频标识和时长、选中标记（心形图标）。
+ */
+class PhotoGridDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    /// 格子边长（像素）
+    static const int CELL_SIZE = 120;
+
+    /// 缩略图区域边长（像素）
+    static const int THUMBNAIL_SIZE = 100;
+
+    explicit PhotoGridDelegate(QObject *parent = nullptr);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+};
+
+#endif // PHOTOGRIDDELEGATE_H
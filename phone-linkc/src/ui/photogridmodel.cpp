@@ -0,0 +1,121 @@
+/**
+ * @file photogridmodel.cpp
+ * @brief 照片网格数据模型实现
+ */
+
+#include "photogridmodel.h"
+
+// 缩略图缓存上限（KB），100px 缩略图约 40KB，可容纳一千多张
+static const int PIXMAP_CACHE_KB = 48 * 1024;
+
+PhotoGridModel::PhotoGridModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_pendingCount(0)
+    , m_pixmaps(PIXMAP_CACHE_KB)
+    , m_residentFirst(0)
+    , m_residentLast(-1)
+{
+}
+
+int PhotoGridModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_index.count();
+}
+
+QVariant PhotoGridModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_index.count()) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return m_index.name(index.row());
+    case Qt::ToolTipRole:
+        return m_index.path(index.row());
+    case Qt::DecorationRole: {
+        // object() 同时刷新 LRU 顺序，绘制中的缩略图不会先被淘汰
+        const QPixmap *pixmap = m_pixmaps.object(index.row());
+        return pixmap ? QVariant(*pixmap) : QVariant();
+    }
+    case PathRole:
+        return m_index.path(index.row());
+    case IsVideoRole:
+        return m_index.isVideo(index.row());
+    case DurationRole:
+        return m_durations.value(index.row(), 0);
+    default:
+        return QVariant();
+    }
+}
+
+void PhotoGridModel::appendPhotos(const QVector<PhotoInfo> &photos)
+{
+    if (photos.isEmpty()) {
+        return;
+    }
+
+    const int first = m_index.count();
+    beginInsertRows(QModelIndex(), first, first + photos.size() - 1);
+    m_index.append(photos);
+    m_pending.resize(m_index.count());
+    m_noImage.resize(m_index.count());
+    endInsertRows();
+}
+
+void PhotoGridModel::clear()
+{
+    beginResetModel();
+    m_index.clear();
+    m_durations.clear();
+    m_pending.clear();
+    m_noImage.clear();
+    m_pendingCount = 0;
+    m_pixmaps.clear();
+    m_residentFirst = 0;
+    m_residentLast = -1;
+    endResetModel();
+}
+
+void PhotoGridModel::setThumbnailPending(int row)
+{
+    if (row >= 0 && row < m_index.count() && !m_pending.testBit(row)) {
+        m_pending.setBit(row);
+        ++m_pendingCount;
+    }
+}
+
+void PhotoGridModel::setResidentRows(int first, int last)
+{
+    m_residentFirst = first;
+    m_residentLast = last;
+}
+
+void PhotoGridModel::setThumbnail(int row, const QImage &image, qint64 durationMs)
+{
+    if (row < 0 || row >= m_index.count()) {
+        return;
+    }
+
+    if (m_pending.testBit(row)) {
+        m_pending.clearBit(row);
+        --m_pendingCount;
+    }
+    if (durationMs > 0) {
+        m_durations.insert(row, durationMs);
+    }
+
+    if (image.isNull()) {
+        m_noImage.setBit(row);
+    } else {
+        // 驻留范围外的结果已写入本地缩略图缓存，缓存满时不必为它淘汰别的缩略图
+        const int cost = qMax(1, static_cast<int>(image.sizeInBytes() / 1024));
+        const bool resident = row >= m_residentFirst && row <= m_residentLast;
+        if (resident || m_pixmaps.totalCost() + cost <= m_pixmaps.maxCost()) {
+            m_pixmaps.insert(row, new QPixmap(QPixmap::fromImage(image)), cost);
+        }
+    }
+
+    const QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, {Qt::DecorationRole, DurationRole});
+}
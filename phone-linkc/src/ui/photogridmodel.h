@@ -0,0 +1,143 @@
+/**
+ * @file photogridmodel.h
+ * @brief 照片网格数据模型头文件
+ *
+ * 照片网格只为可见的格子绘制内容，模型保存照片索引、缩略图加载状态和有限数量的缩略图，
+ * 缩略图占用的内存与图库大小无关。照片保存在紧凑的 PhotoIndex 中，行号即记录号，
+ * PhotoInfo 只在请求缩略图或导出时临时生成。
+ */
+
+#ifndef PHOTOGRIDMODEL_H
+#define PHOTOGRIDMODEL_H
+
+#include <QAbstractListModel>
+#include <QBitArray>
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include <QVector>
+
+#include "core/photo/photomanager.h"
+#include "core/photo/photoindex.h"
+
+/**
+ * @brief 照片网格数据模型
+ *
+ * 缩略图保存在按字节计费的 LRU 缓存中：驻留范围（视口及预取范围）内的结果总会放入缓存，
+ * 范围外的结果只在缓存未满时放入。被淘汰的缩略图重新滚入视口时由 PhotoPage 再次请求，
+ * 届时命中本地缩略图缓存，不再访问设备。
+ *
+ * 使用方法：
+ * @code
+ * PhotoGridModel *model = new PhotoGridModel(this);
+ * view->setModel(model);
+ * model->appendPhotos(photos);
+ * model->setThumbnail(model->rowForPath(path), image, durationMs);
+ * @endcode
+ */
+class PhotoGridModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 自定义数据角色
+     */
+    enum Roles {
+        PathRole = Qt::UserRole + 1,    ///< 设备上的路径（QString）
+        IsVideoRole,                    ///< 是否为视频（bool）
+        DurationRole                    ///< 视频时长，毫秒（qint64），0 表示未知
+    };
+
+    explicit PhotoGridModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief 追加照片
+     * @param photos 照片列表
+     */
+    void appendPhotos(const QVector<PhotoInfo> &photos);
+
+    /**
+     * @brief 清空所有照片和缩略图
+     */
+    void clear();
+
+    /**
+     * @brief 获取照片信息（由索引临时生成）
+     * @param row 行号（须有效）
+     */
+    PhotoInfo photoAt(int row) const { return m_index.photo(row); }
+
+    /**
+     * @brief 照片索引（行号即记录号）
+     */
+    const PhotoIndex &photoIndex() const { return m_index; }
+
+    /**
+     * @brief 获取照片在设备上的路径
+     * @param row 行号（须有效）
+     */
+    QString pathAt(int row) const { return m_index.path(row); }
+
+    /**
+     * @brief 根据路径查找行号
+     * @return 行号，不存在时返回 -1
+     */
+    int rowForPath(const QString &path) const { return m_index.indexOf(path); }
+
+    /**
+     * @brief 是否需要（重新）请求缩略图：未请求过，或已被缓存淘汰
+     * 已请求但尚未到达的、以及无法读取或解码（结果中没有图片）的不需要
+     */
+    bool needsThumbnail(int row) const
+    {
+        return !m_pending.testBit(row) && !m_noImage.testBit(row) && !m_pixmaps.contains(row);
+    }
+
+    /**
+     * @brief 缩略图是否已请求但尚未到达
+     */
+    bool isThumbnailPending(int row) const { return m_pending.testBit(row); }
+
+    /**
+     * @brief 标记缩略图已请求
+     */
+    void setThumbnailPending(int row);
+
+    /**
+     * @brief 已请求但尚未到达的缩略图数
+     */
+    int pendingCount() const { return m_pendingCount; }
+
+    /**
+     * @brief 设置驻留范围，范围内的缩略图到达时总会放入缓存
+     * @param first 第一行
+     * @param last 最后一行（含）
+     */
+    void setResidentRows(int first, int last);
+
+    /**
+     * @brief 缩略图到达
+     * @param row 行号
+     * @param image 缩略图，为空时只更新时长
+     * @param durationMs 视频时长（毫秒），0 表示未知
+     */
+    void setThumbnail(int row, const QImage &image, qint64 durationMs);
+
+private:
+    PhotoIndex m_index;                     ///< 照片索引（行号即记录号）
+    QHash<int, qint64> m_durations;         ///< 行号 -> 视频时长（只有视频）
+    QBitArray m_pending;                    ///< 已请求但尚未到达的缩略图
+    QBitArray m_noImage;                    ///< 结果中没有图片的行（无法读取或解码，如缺少 HEIF 插件的 HEIC）
+    int m_pendingCount;
+
+    mutable QCache<int, QPixmap> m_pixmaps; ///< 行号 -> 缩略图（按 KB 计费）
+    int m_residentFirst;
+    int m_residentLast;
+};
+
+#endif // PHOTOGRIDMODEL_H
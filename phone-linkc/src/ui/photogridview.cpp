@@ -0,0 +1,330 @@
+/**
+ * @file photogridview.cpp
+ * @brief 虚拟化照片网格视图实现
+ */
+
+#include "photogridview.h"
+#include "photogriddelegate.h"
+
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+
+// 相邻格子左上角之间的距离
+static const int PITCH = PhotoGridDelegate::CELL_SIZE + PhotoGridView::SPACING;
+
+// 滚轮/方向键的单步滚动距离
+static const int SCROLL_STEP = PITCH / 3;
+
+PhotoGridView::PhotoGridView(QWidget *parent)
+    : QAbstractItemView(parent)
+    , m_hoverRow(-1)
+{
+    setItemDelegate(new PhotoGridDelegate(this));
+    setSelectionMode(QAbstractItemView::MultiSelection);
+    setSelectionBehavior(QAbstractItemView::SelectItems);
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setMouseTracking(true);
+}
+
+int PhotoGridView::columnCount() const
+{
+    const int usable = viewport()->width() - 2 * MARGIN;
+    return qMax(1, (usable + SPACING) / PITCH);
+}
+
+int PhotoGridView::contentHeight() const
+{
+    const int rows = model() ? model()->rowCount(rootIndex()) : 0;
+    if (rows == 0) {
+        return 0;
+    }
+    const int lines = (rows + columnCount() - 1) / columnCount();
+    return 2 * MARGIN + lines * PITCH - SPACING;
+}
+
+QRect PhotoGridView::itemRect(int row) const
+{
+    const int columns = columnCount();
+    return QRect(MARGIN + (row % columns) * PITCH, MARGIN + (row / columns) * PITCH,
+                 PhotoGridDelegate::CELL_SIZE, PhotoGridDelegate::CELL_SIZE);
+}
+
+int PhotoGridView::rowAt(const QPoint &contentPos) const
+{
+    const int x = contentPos.x() - MARGIN;
+    const int y = contentPos.y() - MARGIN;
+    if (!model() || x < 0 || y < 0 || x % PITCH >= PhotoGridDelegate::CELL_SIZE
+        || y % PITCH >= PhotoGridDelegate::CELL_SIZE) {
+        return -1;
+    }
+    const int column = x / PITCH;
+    const int columns = columnCount();
+    if (column >= columns) {
+        return -1;
+    }
+    const int row = (y / PITCH) * columns + column;
+    return row < model()->rowCount(rootIndex()) ? row : -1;
+}
+
+bool PhotoGridView::visibleRows(int marginScreens, int &first, int &last) const
+{
+    const int rows = model() ? model()->rowCount(rootIndex()) : 0;
+    const int height = viewport()->height();
+    const int top = verticalOffset() - marginScreens * height;
+    const int bottom = verticalOffset() + height + marginScreens * height;
+
+    const int columns = columnCount();
+    const int firstLine = qMax(0, (top - MARGIN) / PITCH);
+    const int lastLine = qMax(0, (bottom - MARGIN) / PITCH);
+    first = firstLine * columns;
+    last = qMin(rows - 1, (lastLine + 1) * columns - 1);
+    return rows > 0 && first <= last;
+}
+
+QRect PhotoGridView::visualRect(const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return QRect();
+    }
+    return itemRect(index.row()).translated(-horizontalOffset(), -verticalOffset());
+}
+
+void PhotoGridView::scrollTo(const QModelIndex &index, ScrollHint hint)
+{
+    if (!index.isValid()) {
+        return;
+    }
+
+    const QRect rect = itemRect(index.row());
+    const int height = viewport()->height();
+    int value = verticalScrollBar()->value();
+    switch (hint) {
+    case PositionAtTop:
+        value = rect.top() - SPACING;
+        break;
+    case PositionAtBottom:
+        value = rect.bottom() + SPACING - height;
+        break;
+    case PositionAtCenter:
+        value = rect.center().y() - height / 2;
+        break;
+    case EnsureVisible:
+        if (rect.top() < value) {
+            value = rect.top() - SPACING;
+        } else if (rect.bottom() > value + height) {
+            value = rect.bottom() + SPACING - height;
+        }
+        break;
+    }
+    verticalScrollBar()->setValue(value);
+}
+
+QModelIndex PhotoGridView::indexAt(const QPoint &point) const
+{
+    const int row = rowAt(point + QPoint(horizontalOffset(), verticalOffset()));
+    return row < 0 ? QModelIndex() : model()->index(row, 0, rootIndex());
+}
+
+void PhotoGridView::reset()
+{
+    m_hoverRow = -1;
+    QAbstractItemView::reset();
+    updateGeometries();
+    viewport()->update();
+}
+
+QModelIndex PhotoGridView::moveCursor(CursorAction cursorAction, Qt::KeyboardModifiers modifiers)
+{
+    Q_UNUSED(modifiers)
+
+    const int rows = model() ? model()->rowCount(rootIndex()) : 0;
+    if (rows == 0) {
+        return QModelIndex();
+    }
+
+    const int columns = columnCount();
+    const int pageRows = qMax(1, viewport()->height() / PITCH) * columns;
+    const QModelIndex current = currentIndex();
+    int row = current.isValid() ? current.row() : 0;
+    switch (cursorAction) {
+    case MoveLeft:
+    case MovePrevious:
+        row -= 1;
+        break;
+    case MoveRight:
+    case MoveNext:
+        row += 1;
+        break;
+    case MoveUp:
+        row -= columns;
+        break;
+    case MoveDown:
+        row += columns;
+        break;
+    case MovePageUp:
+        row -= pageRows;
+        break;
+    case MovePageDown:
+        row += pageRows;
+        break;
+    case MoveHome:
+        row = 0;
+        break;
+    case MoveEnd:
+        row = rows - 1;
+        break;
+    }
+    return model()->index(qBound(0, row, rows - 1), 0, rootIndex());
+}
+
+int PhotoGridView::horizontalOffset() const
+{
+    return 0;
+}
+
+int PhotoGridView::verticalOffset() const
+{
+    return verticalScrollBar()->value();
+}
+
+bool PhotoGridView::isIndexHidden(const QModelIndex &index) const
+{
+    Q_UNUSED(index)
+    return false;
+}
+
+void PhotoGridView::setSelection(const QRect &rect, QItemSelectionModel::SelectionFlags command)
+{
+    QItemSelection selection;
+    const int rows = model() ? model()->rowCount(rootIndex()) : 0;
+    const QRect content = rect.normalized().translated(horizontalOffset(), verticalOffset());
+    const int columns = columnCount();
+
+    const int firstLine = qMax(0, (content.top() - MARGIN) / PITCH);
+    const int lastLine = qMax(0, (content.bottom() - MARGIN) / PITCH);
+    const int firstColumn = qMax(0, (content.left() - MARGIN) / PITCH);
+    const int lastColumn = qMin(columns - 1, qMax(0, (content.right() - MARGIN) / PITCH));
+
+    // 每一行中相交的格子是连续的，合并为一个选择范围
+    for (int line = firstLine; line <= lastLine; ++line) {
+        int begin = -1;
+        int end = -1;
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const int row = line * columns + column;
+            if (row >= rows) {
+                break;
+            }
+            if (itemRect(row).intersects(content)) {
+                if (begin < 0) {
+                    begin = row;
+                }
+                end = row;
+            }
+        }
+        if (begin >= 0) {
+            selection.select(model()->index(begin, 0, rootIndex()), model()->index(end, 0, rootIndex()));
+        }
+        if ((line + 1) * columns >= rows) {
+            break;
+        }
+    }
+    selectionModel()->select(selection, command);
+}
+
+QRegion PhotoGridView::visualRegionForSelection(const QItemSelection &selection) const
+{
+    // 只需要可见部分，选择范围再大也只遍历可见的格子
+    QRegion region;
+    int first;
+    int last;
+    if (!visibleRows(0, first, last)) {
+        return region;
+    }
+    for (const QItemSelectionRange &range : selection) {
+        const int top = qMax(range.top(), first);
+        const int bottom = qMin(range.bottom(), last);
+        for (int row = top; row <= bottom; ++row) {
+            region += itemRect(row).translated(-horizontalOffset(), -verticalOffset());
+        }
+    }
+    return region;
+}
+
+void PhotoGridView::updateGeometries()
+{
+    const int height = viewport()->height();
+    verticalScrollBar()->setSingleStep(SCROLL_STEP);
+    verticalScrollBar()->setPageStep(height);
+    verticalScrollBar()->setRange(0, qMax(0, contentHeight() - height));
+    QAbstractItemView::updateGeometries();
+}
+
+void PhotoGridView::paintEvent(QPaintEvent *event)
+{
+    int first;
+    int last;
+    if (!visibleRows(0, first, last)) {
+        return;
+    }
+
+    QPainter painter(viewport());
+    QStyleOptionViewItem option;
+    initViewItemOption(&option);
+    const QItemSelectionModel *selection = selectionModel();
+    const QModelIndex current = currentIndex();
+
+    for (int row = first; row <= last; ++row) {
+        const QModelIndex index = model()->index(row, 0, rootIndex());
+        QStyleOptionViewItem cell = option;
+        cell.rect = visualRect(index);
+        if (!cell.rect.intersects(event->rect())) {
+            continue;
+        }
+        if (selection && selection->isSelected(index)) {
+            cell.state |= QStyle::State_Selected;
+        }
+        if (row == m_hoverRow) {
+            cell.state |= QStyle::State_MouseOver;
+        }
+        if (index == current && hasFocus()) {
+            cell.state |= QStyle::State_HasFocus;
+        }
+        itemDelegateForIndex(index)->paint(&painter, cell, index);
+    }
+}
+
+void PhotoGridView::mouseMoveEvent(QMouseEvent *event)
+{
+    QAbstractItemView::mouseMoveEvent(event);
+    setHoverRow(rowAt(event->position().toPoint() + QPoint(horizontalOffset(), verticalOffset())));
+}
+
+void PhotoGridView::leaveEvent(QEvent *event)
+{
+    setHoverRow(-1);
+    QAbstractItemView::leaveEvent(event);
+}
+
+void PhotoGridView::setHoverRow(int row)
+{
+    if (row == m_hoverRow) {
+        return;
+    }
+    const QPoint offset(horizontalOffset(), verticalOffset());
+    if (m_hoverRow >= 0) {
+        viewport()->update(itemRect(m_hoverRow).translated(-offset));
+    }
+    m_hoverRow = row;
+    if (m_hoverRow >= 0) {
+        viewport()->update(itemRect(m_hoverRow).translated(-offset));
+    }
+}
+
+void PhotoGridView::rowsInserted(const QModelIndex &parent, int start, int end)
+{
+    QAbstractItemView::rowsInserted(parent, start, end);
+    updateGeometries();
+    viewport()->update();
+}
@@ -0,0 +1,103 @@
+/**
+ * @file photogridview.h
+ * @brief 虚拟化照片网格视图头文件
+ *
+ * 所有格子大小相同，位置由行号直接算出：布局不保存逐项几何信息，
+ * 绘制、命中测试和滚动范围计算只与可见格子数有关，与图库大小无关。
+ */
+
+#ifndef PHOTOGRIDVIEW_H
+#define PHOTOGRIDVIEW_H
+
+#include <QAbstractItemView>
+
+/**
+ * @brief 虚拟化照片网格视图
+ *
+ * 配合 PhotoGridModel 与 PhotoGridDelegate 使用。点击切换选中状态（多选），
+ * 双击发出 doubleClicked 信号。
+ *
+ * 使用方法：
+ * @code
+ * PhotoGridView *view = new PhotoGridView(this);
+ * view->setModel(model);
+ * int first, last;
+ * if (view->visibleRows(1, first, last)) {
+ *     // 加载 [first, last] 的缩略图
+ * }
+ * @endcode
+ */
+class PhotoGridView : public QAbstractItemView
+{
+    Q_OBJECT
+
+public:
+    /// 格子间距（像素）
+    static const int SPACING = 8;
+
+    /// 网格四周边距（像素）
+    static const int MARGIN = 16;
+
+    explicit PhotoGridView(QWidget *parent = nullptr);
+
+    QRect visualRect(const QModelIndex &index) const override;
+    void scrollTo(const QModelIndex &index, ScrollHint hint = EnsureVisible) override;
+    QModelIndex indexAt(const QPoint &point) const override;
+
+    /**
+     * @brief 每行的格子数（随视口宽度变化）
+     */
+    int columnCount() const;
+
+    /**
+     * @brief 视口内（可选上下扩展）的行号范围
+     * @param marginScreens 上下各扩展几屏
+     * @param first 第一行
+     * @param last 最后一行（含）
+     * @return 范围内是否有格子
+     */
+    bool visibleRows(int marginScreens, int &first, int &last) const;
+
+    void reset() override;
+
+protected:
+    QModelIndex moveCursor(CursorAction cursorAction, Qt::KeyboardModifiers modifiers) override;
+    int horizontalOffset() const override;
+    int verticalOffset() const override;
+    bool isIndexHidden(const QModelIndex &index) const override;
+    void setSelection(const QRect &rect, QItemSelectionModel::SelectionFlags command) override;
+    QRegion visualRegionForSelection(const QItemSelection &selection) const override;
+    void updateGeometries() override;
+
+    void paintEvent(QPaintEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void leaveEvent(QEvent *event) override;
+
+protected slots:
+    void rowsInserted(const QModelIndex &parent, int start, int end) override;
+
+private:
+    /**
+     * @brief 格子在内容坐标系中的位置
+     */
+    QRect itemRect(int row) const;
+
+    /**
+     * @brief 内容坐标系中某点所在的行号，落在间距或空白处时返回 -1
+     */
+    int rowAt(const QPoint &contentPos) const;
+
+    /**
+     * @brief 内容总高度
+     */
+    int contentHeight() const;
+
+    /**
+     * @brief 更新悬停的格子
+     */
+    void setHoverRow(int row);
+
+    int m_hoverRow;     ///< 悬停的行号，-1 表示无
+};
+
+#endif // PHOTOGRIDVIEW_H
@@ -5,140 +5,47 @@
 
 #include "photopage.h"
 #include "ui_photopage.h"
-#include "flowlayout.h"
+#include "photogridmodel.h"
+#include "photogridview.h"
+#include "photopreviewdialog.h"
+#include "core/photo/thumbnailpipeline.h"
+#include "core/photo/photolibrary.h"
+#include "core/photo/photopreviewloader.h"
 
 #include <QTreeWidgetItem>
-#include <QPainter>
-#include <QMouseEvent>
 #include <QFileDialog>
 #include <QMessageBox>
-#include <QApplication>
-#include <QVBoxLayout>
 #include <QDebug>
 #include <QTimer>
+#include <QScrollBar>
+#include <QScreen>
 #include <QProgressDialog>
-#include <QFile>
-#include <QDir>
+#include <QFutureWatcher>
+#include <QPromise>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
 
-/* ============================================================================
- * PhotoThumbnail 实现
- * ============================================================================ */
+// 滚动停顿多久后更新缩略图优先级（毫秒）
+static const int PRIORITY_UPDATE_DELAY_MS = 50;
 
-PhotoThumbnail::PhotoThumbnail(const PhotoInfo &info, QWidget *parent)
-    : QWidget(parent)
-    , m_photoInfo(info)
-    , m_selected(false)
-    , m_hovered(false)
-{
-    setFixedSize(120, 120);
-    setCursor(Qt::PointingHandCursor);
-    
-    // 设置默认缩略图（占位符）
-    m_thumbnail = QPixmap(100, 100);
-    m_thumbnail.fill(Qt::lightGray);
-}
+// 视口上下各预取几屏
+static const int PREFETCH_SCREENS = 1;
 
-void PhotoThumbnail::setSelected(bool selected)
-{
-    if (m_selected != selected) {
-        m_selected = selected;
-        update();
-        emit selectionChanged(selected);
-    }
-}
-
-void PhotoThumbnail::setThumbnail(const QPixmap &pixmap)
-{
-    if (!pixmap.isNull()) {
-        m_thumbnail = pixmap.scaled(100, 100, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        update();
-    }
-}
+// 导出进度条的刻度数（按字节计算进度）
+static const int EXPORT_PROGRESS_STEPS = 1000;
 
-void PhotoThumbnail::paintEvent(QPaintEvent *event)
+// 导出进度文字：文件数、速度和预计剩余时间
+static QString exportProgressText(const PhotoExporter::Progress &progress)
 {
-    Q_UNUSED(event)
-    
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
-    
-    // 背景
-    QRect bgRect = rect().adjusted(2, 2, -2, -2);
-    if (m_selected) {
-        painter.fillRect(bgRect, QColor("#e3f2fd"));
-        painter.setPen(QPen(QColor("#1976d2"), 2));
-        painter.drawRect(bgRect);
-    } else if (m_hovered) {
-        painter.fillRect(bgRect, QColor("#f5f5f5"));
-        painter.setPen(QPen(QColor("#e0e0e0"), 1));
-        painter.drawRect(bgRect);
-    } else {
-        painter.fillRect(bgRect, Qt::white);
-        painter.setPen(QPen(QColor("#e8e8e8"), 1));
-        painter.drawRect(bgRect);
+    QString text = QString("正在导出 (%1/%2)").arg(progress.filesDone).arg(progress.filesTotal);
+    if (progress.bytesPerSecond > 0) {
+        text += QString("  %1 MB/s").arg(progress.bytesPerSecond / (1024.0 * 1024.0), 0, 'f', 1);
     }
-    
-    // 缩略图
-    int imgX = (width() - m_thumbnail.width()) / 2;
-    int imgY = (height() - m_thumbnail.height()) / 2 - 8;
-    painter.drawPixmap(imgX, imgY, m_thumbnail);
-    
-    // 文件名
-    QRect textRect(4, height() - 24, width() - 8, 20);
-    painter.setPen(Qt::black);
-    QFont font = painter.font();
-    font.setPointSize(8);
-    painter.setFont(font);
-    QString elidedText = painter.fontMetrics().elidedText(
-        m_photoInfo.name, Qt::ElideMiddle, textRect.width());
-    painter.drawText(textRect, Qt::AlignCenter, elidedText);
-    
-    // 视频标识
-    if (m_photoInfo.isVideo) {
-        QRect videoRect(width() - 24, 6, 18, 18);
-        painter.fillRect(videoRect, QColor(0, 0, 0, 128));
-        painter.setPen(Qt::white);
-        painter.drawText(videoRect, Qt::AlignCenter, "▶");
+    if (progress.etaMs >= 0) {
+        const qint64 seconds = progress.etaMs / 1000;
+        text += QString("  剩余约 %1:%2").arg(seconds / 60).arg(seconds % 60, 2, 10, QChar('0'));
     }
-    
-    // 选中标记（心形图标）
-    if (m_selected || m_hovered) {
-        QRect heartRect(8, height() - 32, 16, 16);
-        painter.setPen(m_selected ? QColor("#e65100") : QColor("#999999"));
-        painter.setFont(QFont("Arial", 12));
-        painter.drawText(heartRect, Qt::AlignCenter, m_selected ? "♥" : "♡");
-    }
-}
-
-void PhotoThumbnail::mousePressEvent(QMouseEvent *event)
-{
-    if (event->button() == Qt::LeftButton) {
-        setSelected(!m_selected);
-        emit clicked();
-    }
-    QWidget::mousePressEvent(event);
-}
-
-void PhotoThumbnail::mouseDoubleClickEvent(QMouseEvent *event)
-{
-    if (event->button() == Qt::LeftButton) {
-        emit doubleClicked();
-    }
-    QWidget::mouseDoubleClickEvent(event);
-}
-
-void PhotoThumbnail::enterEvent(QEnterEvent *event)
-{
-    m_hovered = true;
-    update();
-    QWidget::enterEvent(event);
-}
-
-void PhotoThumbnail::leaveEvent(QEvent *event)
-{
-    m_hovered = false;
-    update();
-    QWidget::leaveEvent(event);
+    return text;
 }
 
 /* ============================================================================
@@ -149,7 +56,10 @@ PhotoPage::PhotoPage(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::PhotoPage)
     , m_photoManager(nullptr)
-    , m_flowLayout(nullptr)
+    , m_gridModel(new PhotoGridModel(this))
+    , m_thumbnailPipeline(new ThumbnailPipeline(this))
+    , m_priorityTimer(new QTimer(this))
+    , m_previewLoader(new PhotoPreviewLoader(this))
     , m_libraryItem(nullptr)
     , m_albumsItem(nullptr)
 {
@@ -160,35 +70,34 @@ PhotoPage::PhotoPage(QWidget *parent)
 
 PhotoPage::~PhotoPage()
 {
+    // 导出线程在处理完当前块后退出
+    if (m_exportCanceled) {
+        m_exportCanceled->store(true);
+        m_exportFuture.waitForFinished();
+    }
     clearPhotoGrid();
     delete ui;
 }
 
 void PhotoPage::setupUI()
 {
-    // 创建流式布局用于照片网格
-    // 注意: UI 文件中 photoGridContainer 已经有 QVBoxLayout (photoGridLayout)
-    // 这里将 FlowLayout 作为子布局追加到该 QVBoxLayout 中，避免 setLayout 失败导致 FlowLayout 未被安装
-    {
-        QLayout* containerLayout = ui->photoGridContainer->layout();
-        if (auto vbox = qobject_cast<QVBoxLayout*>(containerLayout)) {
-            m_flowLayout = new FlowLayout(nullptr, 8, 8, 8);
-            vbox->addLayout(m_flowLayout);
-            qDebug() << "[PhotoPage] setupUI: 使用已有的 QVBoxLayout 作为容器"
-                     << "vbox=" << vbox << "flow=" << m_flowLayout;
-        } else {
-            // 兜底: 若无布局则直接设置 FlowLayout
-            m_flowLayout = new FlowLayout(ui->photoGridContainer, 8, 8, 8);
-            ui->photoGridContainer->setLayout(m_flowLayout);
-            qDebug() << "[PhotoPage] setupUI: 直接设置 FlowLayout 为容器布局"
-                     << "flow=" << m_flowLayout;
-        }
-    }
+    // 照片网格只为可见格子绘制，布局由视图按行号计算
+    ui->photoGridView->setModel(m_gridModel);
     
     // 连接信号
     connect(ui->refreshButton, &QPushButton::clicked, this, &PhotoPage::onRefreshClicked);
     connect(ui->exportButton, &QPushButton::clicked, this, &PhotoPage::onExportClicked);
     connect(ui->albumTree, &QTreeWidget::currentItemChanged, this, &PhotoPage::onAlbumSelectionChanged);
+    connect(m_thumbnailPipeline, &ThumbnailPipeline::thumbnailsReady, this, &PhotoPage::onThumbnailsReady);
+    connect(ui->photoGridView, &QAbstractItemView::doubleClicked, this, &PhotoPage::onPhotoDoubleClicked);
+    
+    // 滚动、网格增长和窗口缩放都会改变可见范围
+    m_priorityTimer->setSingleShot(true);
+    m_priorityTimer->setInterval(PRIORITY_UPDATE_DELAY_MS);
+    connect(m_priorityTimer, &QTimer::timeout, this, &PhotoPage::updateThumbnailPriorities);
+    QScrollBar *scrollBar = ui->photoGridView->verticalScrollBar();
+    connect(scrollBar, &QScrollBar::valueChanged, this, &PhotoPage::scheduleThumbnailPriorities);
+    connect(scrollBar, &QScrollBar::rangeChanged, this, &PhotoPage::scheduleThumbnailPriorities);
 }
 
 void PhotoPage::setupAlbumTree()
@@ -227,6 +136,10 @@ void PhotoPage::setPhotoManager(PhotoManager *manager)
     
     if (m_photoManager) {
         connect(m_photoManager, &PhotoManager::scanProgress, this, &PhotoPage::onScanProgress);
+        connect(m_photoManager, &PhotoManager::photosBatchReady, this, &PhotoPage::onPhotosBatchReady);
+        connect(m_photoManager, &PhotoManager::photoScanFinished, this, &PhotoPage::onPhotoScanFinished);
+        connect(m_photoManager, &PhotoManager::libraryAlbumsReady, this, &PhotoPage::onLibraryAlbumsReady);
+        connect(m_photoManager, &PhotoManager::libraryPhotosReady, this, &PhotoPage::onLibraryPhotosReady);
         connect(m_photoManager, &PhotoManager::errorOccurred, this, &PhotoPage::onPhotoError);
     }
 }
@@ -234,22 +147,32 @@ void PhotoPage::setPhotoManager(PhotoManager *manager)
 void PhotoPage::setCurrentDevice(const QString &udid)
 {
     m_currentUdid = udid;
+    m_thumbnailPipeline->setDevice(udid);
+    m_previewLoader->setDevice(udid);
     ui->statusLabel->setText("设备已连接，点击刷新按钮加载照片");
 }
 
 void PhotoPage::clearDevice()
 {
+    if (m_photoManager && m_scanId != 0) {
+        m_photoManager->cancelPhotoScan();
+    }
+    m_scanId = 0;
+    m_libraryQueryId = 0;
+    ui->refreshButton->setEnabled(true);
+    
     m_currentUdid.clear();
     m_currentAlbumPath.clear();
     clearPhotoGrid();
+    m_thumbnailPipeline->clearDevice();
+    m_previewLoader->clearDevice();
     updateStats(0, 0);
     ui->albumTitleLabel->setText("全部照片");
     ui->statusLabel->setText("请先连接设备以查看照片");
     
     // 清除相册树中的动态相册
-    while (m_albumsItem->childCount() > 0) {
-        delete m_albumsItem->takeChild(0);
-    }
+    clearAlbumItems();
+    clearLibraryAlbumItems();
 }
 
 void PhotoPage::refreshPhotos()
@@ -269,39 +192,20 @@ void PhotoPage::onRefreshClicked()
         return;
     }
     
-    ui->statusLabel->setText("正在加载照片列表...");
-    ui->refreshButton->setEnabled(false);
-    QApplication::processEvents();
-    
     // 连接到设备
     if (!m_photoManager->isConnected()) {
         if (!m_photoManager->connectToDevice(m_currentUdid)) {
             ui->statusLabel->setText(QString("连接失败: %1").arg(m_photoManager->lastError()));
-            ui->refreshButton->setEnabled(true);
             return;
         }
     }
     
-    // 获取相册列表
-    QVector<AlbumInfo> albums = m_photoManager->getAlbums();
-    updateAlbumTree(albums);
-    
-    // 获取当前相册的照片
-    QVector<PhotoInfo> photos;
-    if (m_currentAlbumPath.isEmpty()) {
-        photos = m_photoManager->getAllPhotos();
-    } else {
-        photos = m_photoManager->getPhotos(m_currentAlbumPath);
-    }
+    // 扫描整个 DCIM：相册树和当前相册的照片都由扫描批次逐步填充
+    startPhotoScan(QString(), true);
     
-    if (photos.isEmpty() && !m_photoManager->lastError().isEmpty()) {
-        ui->statusLabel->setText(QString("加载失败: %1").arg(m_photoManager->lastError()));
-    } else {
-        displayPhotos(photos);
-        ui->statusLabel->setText("如要删除此目录内照片，请到设备上操作。");
-    }
-    
-    ui->refreshButton->setEnabled(true);
+    // 同时同步图库数据库（未变化时不重新复制），完成后加入智能相簿和用户相簿；
+    // 当前是图库相簿时网格不由扫描填充，同步完成后再查询
+    m_photoManager->startLibrarySync();
 }
 
 void PhotoPage::onExportClicked()
@@ -323,74 +227,60 @@ void PhotoPage::onExportClicked()
         return;
     }
 
-    // 创建进度对话框
-    QProgressDialog progress("正在导出照片...", "取消", 0, selected.size(), this);
-    progress.setWindowModality(Qt::WindowModal);
-    progress.setMinimumDuration(0); // 立即显示
-    progress.setValue(0);
-
-    int successCount = 0;
-    int failCount = 0;
-    QString lastError;
-
-    for (int i = 0; i < selected.size(); ++i) {
-        if (progress.wasCanceled()) {
-            break;
+    // 目标文件名在开始前一次分配好，多个文件同时导出时不会相互覆盖
+    const QVector<PhotoExporter::Job> jobs = PhotoExporter::jobsForDirectory(selected, dir);
+
+    // 导出在后台线程中进行，界面线程只接收进度
+    QProgressDialog *progress = new QProgressDialog("正在导出照片...", "取消", 0, EXPORT_PROGRESS_STEPS, this);
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(0); // 立即显示
+    progress->setAutoClose(false);
+    progress->setAutoReset(false);
+    progress->setValue(0);
+    ui->exportButton->setEnabled(false);
+
+    auto canceled = std::make_shared<std::atomic<bool>>(false);
+    connect(progress, &QProgressDialog::canceled, this, [canceled]() {
+        canceled->store(true);
+    });
+
+    auto *watcher = new QFutureWatcher<PhotoExporter::Result>(this);
+    connect(watcher, &QFutureWatcher<PhotoExporter::Result>::progressValueChanged,
+            progress, &QProgressDialog::setValue);
+    connect(watcher, &QFutureWatcher<PhotoExporter::Result>::progressTextChanged,
+            progress, &QProgressDialog::setLabelText);
+    connect(watcher, &QFutureWatcher<PhotoExporter::Result>::finished, this, [this, watcher, progress]() {
+        const PhotoExporter::Result result = watcher->result();
+        watcher->deleteLater();
+        progress->close();
+        progress->deleteLater();
+        m_exportCanceled.reset();
+        ui->exportButton->setEnabled(true);
+
+        QString resultMsg = QString("%1\n成功: %2\n失败: %3")
+            .arg(result.canceled ? "导出已取消" : "导出完成")
+            .arg(result.exported)
+            .arg(result.failed);
+        if (result.failed > 0 && !result.lastError.isEmpty()) {
+            resultMsg += QString("\n\n最后一次错误: %1").arg(result.lastError);
         }
 
-        const PhotoInfo& photo = selected[i];
-        progress.setLabelText(QString("正在导出 (%1/%2): %3").arg(i + 1).arg(selected.size()).arg(photo.name));
-        
-        // 读取照片数据
-        QByteArray data = m_photoManager->readPhotoData(photo.path);
-        if (data.isEmpty()) {
-            failCount++;
-            lastError = m_photoManager->lastError();
-            qDebug() << "[PhotoPage] 导出失败(读取错误):" << photo.path << lastError;
-        } else {
-            // 写入本地文件
-            QString targetPath = QDir(dir).filePath(photo.name);
-            // 如果文件已存在，自动重命名: name_1.jpg, name_2.jpg
-            if (QFile::exists(targetPath)) {
-                QFileInfo fi(targetPath);
-                int counter = 1;
-                while (QFile::exists(targetPath)) {
-                    targetPath = QDir(dir).filePath(QString("%1_%2.%3")
-                        .arg(fi.baseName())
-                        .arg(counter++)
-                        .arg(fi.suffix()));
-                }
-            }
-
-            QFile file(targetPath);
-            if (file.open(QIODevice::WriteOnly)) {
-                if (file.write(data) == data.size()) {
-                    successCount++;
-                } else {
-                    failCount++;
-                    lastError = "写入文件失败";
-                    qDebug() << "[PhotoPage] 导出失败(写入错误):" << targetPath;
-                }
-                file.close();
-            } else {
-                failCount++;
-                lastError = "无法创建目标文件";
-                qDebug() << "[PhotoPage] 导出失败(创建文件错误):" << targetPath;
-            }
-        }
-
-        progress.setValue(i + 1);
-        QApplication::processEvents(); // 保持界面响应
-    }
-
-    progress.close();
-
-    QString resultMsg = QString("导出完成\n成功: %1\n失败: %2").arg(successCount).arg(failCount);
-    if (failCount > 0 && !lastError.isEmpty()) {
-        resultMsg += QString("\n\n最后一次错误: %1").arg(lastError);
-    }
-
-    QMessageBox::information(this, "导出结果", resultMsg);
+        QMessageBox::information(this, "导出结果", resultMsg);
+    });
+
+    const QString udid = m_currentUdid;
+    m_exportCanceled = canceled;
+    m_exportFuture = QtConcurrent::run([udid, jobs, canceled](QPromise<PhotoExporter::Result> &promise) {
+        promise.setProgressRange(0, EXPORT_PROGRESS_STEPS);
+        PhotoExporter exporter(udid);
+        promise.addResult(exporter.run(jobs, [&promise, canceled](const PhotoExporter::Progress &state) {
+            const qint64 steps = state.bytesTotal > 0 ? state.bytesDone * EXPORT_PROGRESS_STEPS / state.bytesTotal : 0;
+            promise.setProgressValueAndText(static_cast<int>(qMin<qint64>(steps, EXPORT_PROGRESS_STEPS)),
+                                            exportProgressText(state));
+            return !canceled->load();
+        }));
+    });
+    watcher->setFuture(m_exportFuture);
 }
 
 void PhotoPage::onAlbumSelectionChanged(QTreeWidgetItem *current, QTreeWidgetItem *previous)
@@ -417,7 +307,7 @@ void PhotoPage::onAlbumSelectionChanged(QTreeWidgetItem *current, QTreeWidgetIte
     if (albumType == "library" || albumType == "albums") {
         m_currentAlbumPath.clear(); // 显示全部
         qDebug() << "[PhotoPage] -> 显示全部照片 (m_currentAlbumPath cleared)";
-    } else if (albumType == "album") {
+    } else if (albumType == "album" || albumType == "libraryAlbum") {
         m_currentAlbumPath = albumPath;
         qDebug() << "[PhotoPage] -> 显示相册:" << m_currentAlbumPath;
     } else {
@@ -445,35 +335,52 @@ void PhotoPage::loadPhotosForCurrentAlbum()
         return;
     }
     
-    ui->statusLabel->setText("正在加载照片列表...");
-    QApplication::processEvents();
-    
-    // 获取当前相册的照片
-    QVector<PhotoInfo> photos;
-    if (m_currentAlbumPath.isEmpty()) {
-        qDebug() << "[PhotoPage] 调用 getAllPhotos()";
-        photos = m_photoManager->getAllPhotos();
-    } else {
-        qDebug() << "[PhotoPage] 调用 getPhotos(" << m_currentAlbumPath << ")";
-        photos = m_photoManager->getPhotos(m_currentAlbumPath);
+    if (PhotoLibrary::isLibraryAlbum(m_currentAlbumPath)) {
+        loadLibraryAlbum();
+        return;
+    }
+    startPhotoScan(m_currentAlbumPath, false);
+}
+
+void PhotoPage::loadLibraryAlbum()
+{
+    // 只切换相册的扫描不再需要；刷新时的全量扫描继续进行，以便更新文件夹相册
+    if (m_scanId != 0 && !m_rebuildingAlbums) {
+        m_photoManager->cancelPhotoScan();
+        m_scanId = 0;
+        ui->refreshButton->setEnabled(true);
     }
     
-    qDebug() << "[PhotoPage] 获取到照片数量:" << photos.size()
-             << "lastError:" << m_photoManager->lastError();
+    clearPhotoGrid();
+    updateStats(0, 0);
+    // 打开图库副本和照片目录、查询并校正都在后台进行，完成后一次加入网格
+    m_libraryQueryId = m_photoManager->startLibraryQuery(m_currentAlbumPath);
+    if (m_scanId == 0) {
+        ui->statusLabel->setText("正在读取相簿...");
+    }
+}
+
+void PhotoPage::onLibraryPhotosReady(quint64 queryId, const QString &albumKey, const QVector<PhotoInfo> &photos)
+{
+    // 查询期间已切换到其他相册或断开设备
+    if (queryId != m_libraryQueryId || albumKey != m_currentAlbumPath) {
+        return;
+    }
+    m_libraryQueryId = 0;
     
-    if (photos.isEmpty() && !m_photoManager->lastError().isEmpty()) {
-        ui->statusLabel->setText(QString("加载失败: %1").arg(m_photoManager->lastError()));
-    } else {
-        displayPhotos(photos);
+    appendPhotos(photos);
+    if (m_scanId == 0) {
         ui->statusLabel->setText("如要删除此目录内照片，请到设备上操作。");
     }
 }
 
 void PhotoPage::onScanProgress(int current, int total)
 {
-    ui->statusLabel->setText(QString("正在扫描: %1 / %2").arg(current).arg(total));
+    if (m_scanId == 0) {
+        return;
+    }
+    ui->statusLabel->setText(QString("正在扫描目录: %1 / %2").arg(current).arg(total));
     emit loadProgress(current, total);
-    QApplication::processEvents();
 }
 
 void PhotoPage::onPhotoError(const QString &error)
@@ -482,189 +389,300 @@ void PhotoPage::onPhotoError(const QString &error)
     emit errorOccurred(error);
 }
 
-void PhotoPage::updateAlbumTree(const QVector<AlbumInfo> &albums)
+void PhotoPage::clearAlbumItems()
 {
-    // 保存当前选中的相册路径，以便刷新后恢复选中
-    QString currentPath = m_currentAlbumPath;
-    QTreeWidgetItem *itemToSelect = nullptr;
-
-    // 暂时屏蔽信号，防止在重建树的过程中触发不必要的 selectionChanged
-    // 从而导致 m_currentAlbumPath 被错误重置
+    // 屏蔽信号，防止删除选中项时触发 selectionChanged 导致 m_currentAlbumPath 被重置
     const bool wasBlocked = ui->albumTree->blockSignals(true);
-
-    // 清除现有相册
+    
     while (m_albumsItem->childCount() > 0) {
         delete m_albumsItem->takeChild(0);
     }
+    m_albumItems.clear();
+    m_albumCounts.clear();
     
-    // 添加相册
+    ui->albumTree->blockSignals(wasBlocked);
+}
+
+void PhotoPage::clearLibraryAlbumItems()
+{
+    const bool wasBlocked = ui->albumTree->blockSignals(true);
+    qDeleteAll(m_libraryAlbumItems);
+    m_libraryAlbumItems.clear();
+    ui->albumTree->blockSignals(wasBlocked);
+}
+
+void PhotoPage::onLibraryAlbumsReady(const QVector<AlbumInfo> &albums)
+{
+    if (m_currentUdid.isEmpty()) {
+        return;
+    }
+    clearLibraryAlbumItems();
+    
+    // 智能相簿排在图库之后，用户相簿放在单独的容器中
+    const bool wasBlocked = ui->albumTree->blockSignals(true);
+    QTreeWidgetItem *userAlbums = nullptr;
+    int smartIndex = ui->albumTree->indexOfTopLevelItem(m_libraryItem) + 1;
     for (const AlbumInfo &album : albums) {
-        QTreeWidgetItem *item = new QTreeWidgetItem(m_albumsItem);
-        item->setText(0, album.name);
-        item->setData(0, Qt::UserRole, "album");
+        QTreeWidgetItem *item = new QTreeWidgetItem();
+        item->setData(0, Qt::UserRole, "libraryAlbum");
         item->setData(0, Qt::UserRole + 1, album.path);
         
-        // 如果有照片数量，显示在名称后
-        if (album.photoCount > 0) {
+        if (album.path == QLatin1String(PhotoLibrary::FAVORITES)) {
+            item->setText(0, QString("⭐ %1 (%2)").arg(album.name).arg(album.photoCount));
+        } else if (album.path == QLatin1String(PhotoLibrary::SCREENSHOTS)) {
+            item->setText(0, QString("📱 %1 (%2)").arg(album.name).arg(album.photoCount));
+        } else if (album.path == QLatin1String(PhotoLibrary::VIDEOS)) {
+            item->setText(0, QString("🎬 %1 (%2)").arg(album.name).arg(album.photoCount));
+        } else {
             item->setText(0, QString("%1 (%2)").arg(album.name).arg(album.photoCount));
+            if (!userAlbums) {
+                userAlbums = new QTreeWidgetItem();
+                userAlbums->setText(0, "🗂 相簿");
+                userAlbums->setData(0, Qt::UserRole, "albums");
+                ui->albumTree->insertTopLevelItem(smartIndex++, userAlbums);
+                m_libraryAlbumItems.append(userAlbums);
+            }
+            userAlbums->addChild(item);
         }
-
-        // 检查是否是之前选中的相册
-        if (!currentPath.isEmpty() && album.path == currentPath) {
-            itemToSelect = item;
+        if (!item->parent()) {
+            ui->albumTree->insertTopLevelItem(smartIndex++, item);
+            m_libraryAlbumItems.append(item);
+        }
+        
+        // 恢复刷新前选中的相簿
+        if (album.path == m_currentAlbumPath) {
+            ui->albumTree->setCurrentItem(item);
         }
     }
-    
-    // 展开相簿
-    m_albumsItem->setExpanded(true);
-
-    // 恢复选中状态
-    if (itemToSelect) {
-        ui->albumTree->setCurrentItem(itemToSelect);
+    if (userAlbums) {
+        userAlbums->setExpanded(true);
     }
-
-    // 恢复信号
     ui->albumTree->blockSignals(wasBlocked);
+    
+    if (PhotoLibrary::isLibraryAlbum(m_currentAlbumPath) && m_photoManager) {
+        loadLibraryAlbum();
+    }
 }
 
-void PhotoPage::displayPhotos(const QVector<PhotoInfo> &photos)
+void PhotoPage::addToAlbumCount(const QString &directory, int count)
 {
-    qDebug() << "[PhotoPage] displayPhotos: 收到" << photos.size() << "张照片";
+    // 相册为 /DCIM 下的第一级目录（100APPLE 等），更深的子目录计入所属相册
+    static const QString dcimPrefix = QStringLiteral("/DCIM/");
+    if (count <= 0 || !directory.startsWith(dcimPrefix)) {
+        return;
+    }
+    const QString albumName = directory.mid(dcimPrefix.size()).section('/', 0, 0);
+    if (albumName.isEmpty()) {
+        return;
+    }
+    const QString albumPath = dcimPrefix + albumName;
     
+    int &albumCount = m_albumCounts[albumPath];
+    albumCount += count;
+    
+    QTreeWidgetItem *item = m_albumItems.value(albumPath);
+    if (!item) {
+        item = new QTreeWidgetItem(m_albumsItem);
+        item->setData(0, Qt::UserRole, "album");
+        item->setData(0, Qt::UserRole + 1, albumPath);
+        m_albumItems.insert(albumPath, item);
+        m_albumsItem->setExpanded(true);
+        
+        // 恢复刷新前选中的相册
+        if (albumPath == m_currentAlbumPath) {
+            const bool wasBlocked = ui->albumTree->blockSignals(true);
+            ui->albumTree->setCurrentItem(item);
+            ui->albumTree->blockSignals(wasBlocked);
+        }
+    }
+    item->setText(0, QString("%1 (%2)").arg(albumName).arg(albumCount));
+}
+
+void PhotoPage::startPhotoScan(const QString &rootPath, bool rebuildAlbums)
+{
     clearPhotoGrid();
+    updateStats(0, 0);
     
-    qDebug() << "[PhotoPage] displayPhotos: flowLayout=" << m_flowLayout
-             << "parent=" << (m_flowLayout ? m_flowLayout->parentWidget() : nullptr)
-             << "container=" << ui->photoGridContainer
-             << "container.layout=" << (ui->photoGridContainer ? ui->photoGridContainer->layout() : nullptr)
-             << "container.visible=" << (ui->photoGridContainer ? ui->photoGridContainer->isVisible() : false)
-             << "container.size=" << (ui->photoGridContainer ? ui->photoGridContainer->size() : QSize());
+    m_rebuildingAlbums = rebuildAlbums;
+    if (rebuildAlbums) {
+        clearAlbumItems();
+    }
     
-    int photoCount = 0;
-    int videoCount = 0;
+    ui->statusLabel->setText("正在加载照片列表...");
+    ui->refreshButton->setEnabled(false);
     
-    for (const PhotoInfo &photo : photos) {
-        PhotoThumbnail *thumbnail = new PhotoThumbnail(photo, ui->photoGridContainer);
-        m_flowLayout->addWidget(thumbnail);
-        thumbnail->show(); // 确保可见
-        m_thumbnails.append(thumbnail);
-        
-        if (photo.isVideo) {
-            videoCount++;
-        } else {
-            photoCount++;
-        }
-        
-        // TODO: 异步加载缩略图
-        // 目前使用占位符
+    // 新扫描会使之前未完成的扫描失效，旧批次按 ID 丢弃
+    m_scanId = m_photoManager->startPhotoScan(rootPath);
+    qDebug() << "[PhotoPage] 开始流式扫描:" << (rootPath.isEmpty() ? "DCIM" : rootPath) << "scanId=" << m_scanId;
+}
+
+void PhotoPage::onPhotosBatchReady(quint64 scanId, const QString &directory, const QVector<PhotoInfo> &photos)
+{
+    if (scanId != m_scanId) {
+        return;
     }
     
-    // 激活容器布局，强制执行子布局几何更新
-    if (ui->photoGridContainer->layout()) {
-        ui->photoGridContainer->layout()->activate();
+    if (m_rebuildingAlbums) {
+        addToAlbumCount(directory, photos.size());
+    }
+    
+    // 刷新时扫描整个 DCIM，只显示属于当前相册的批次
+    if (!m_currentAlbumPath.isEmpty() && directory != m_currentAlbumPath &&
+        !directory.startsWith(m_currentAlbumPath + '/')) {
+        return;
+    }
+    
+    appendPhotos(photos);
+}
+
+void PhotoPage::onPhotoScanFinished(quint64 scanId, int total, bool canceled)
+{
+    if (scanId != m_scanId) {
+        return;
     }
-    ui->photoGridContainer->updateGeometry();
-    ui->photoGridContainer->update();
     
-    qDebug() << "[PhotoPage] displayPhotos: 添加了" << m_thumbnails.size() << "个缩略图"
-             << "layoutCount=" << m_flowLayout->count();
+    m_scanId = 0;
+    ui->refreshButton->setEnabled(true);
     
-    // 检查第一个缩略图状态
-    if (!m_thumbnails.isEmpty()) {
-        PhotoThumbnail *first = m_thumbnails.first();
-        qDebug() << "[PhotoPage] 第一个缩略图: parent=" << first->parentWidget()
-                 << "visible=" << first->isVisible()
-                 << "geometry=" << first->geometry();
+    qDebug() << "[PhotoPage] 流式扫描结束: total=" << total << "canceled=" << canceled
+             << "显示:" << m_gridModel->rowCount();
+    
+    if (total == 0 && !m_photoManager->lastError().isEmpty()) {
+        ui->statusLabel->setText(QString("加载失败: %1").arg(m_photoManager->lastError()));
+    } else {
+        ui->statusLabel->setText("如要删除此目录内照片，请到设备上操作。");
+    }
+}
+
+void PhotoPage::appendPhotos(const QVector<PhotoInfo> &photos)
+{
+    if (photos.isEmpty()) {
+        return;
     }
     
-    updateStats(photoCount, videoCount);
+    for (const PhotoInfo &photo : photos) {
+        if (photo.isVideo) {
+            m_videoCount++;
+        } else {
+            m_photoCount++;
+        }
+    }
+    
+    const int first = m_gridModel->rowCount();
+    m_gridModel->appendPhotos(photos);
+    updateStats(m_photoCount, m_videoCount);
 
-    // 开始异步加载缩略图
-    startThumbnailLoading();
+    // 新增项加入缩略图加载队列
+    queueThumbnails(first, m_gridModel->rowCount() - 1);
 }
 
 void PhotoPage::clearPhotoGrid()
 {
-    // 清空待加载队列，防止访问已删除的对象
-    m_pendingThumbnails.clear();
-    m_isLoadingThumbnails = false;
+    // 丢弃未完成的缩略图请求，防止旧结果按路径交付给新的网格
+    m_thumbnailPipeline->cancelAll();
+    m_gridModel->clear();
+    m_photoCount = 0;
+    m_videoCount = 0;
+}
 
-    for (PhotoThumbnail *thumbnail : m_thumbnails) {
-        m_flowLayout->removeWidget(thumbnail);
-        thumbnail->deleteLater();
+void PhotoPage::queueThumbnails(int first, int last)
+{
+    // 只传行号，流水线从模型的照片索引中复制紧凑记录
+    QVector<int> rows;
+    rows.reserve(last - first + 1);
+    for (int row = first; row <= last; ++row) {
+        m_gridModel->setThumbnailPending(row);
+        rows.append(row);
+    }
+    
+    // 先按空闲优先级排队，再按视口提升
+    if (!rows.isEmpty()) {
+        m_thumbnailPipeline->request(m_gridModel->photoIndex(), rows);
+        scheduleThumbnailPriorities();
     }
-    m_thumbnails.clear();
 }
 
-void PhotoPage::startThumbnailLoading()
+void PhotoPage::scheduleThumbnailPriorities()
 {
-    // 停止当前的加载（如果有）
-    m_pendingThumbnails.clear();
-    m_isLoadingThumbnails = false;
-    
-    // 将所有需要加载缩略图的项目加入队列
-    // 暂时跳过视频文件，因为读取大文件会阻塞，且 QImage 无法解码视频
-    for (PhotoThumbnail *thumbnail : m_thumbnails) {
-        if (!thumbnail->photoInfo().isVideo) {
-            m_pendingThumbnails.append(thumbnail);
+    if (!m_priorityTimer->isActive()) {
+        m_priorityTimer->start();
+    }
+}
+
+void PhotoPage::updateThumbnailPriorities()
+{
+    // 网格按行号排布，可见范围和预取范围都是连续的行
+    int first;
+    int last;
+    int prefetchFirst;
+    int prefetchLast;
+    if (!ui->photoGridView->visibleRows(0, first, last)
+        || !ui->photoGridView->visibleRows(PREFETCH_SCREENS, prefetchFirst, prefetchLast)) {
+        return;
+    }
+    m_gridModel->setResidentRows(prefetchFirst, prefetchLast);
+    
+    QVector<QString> visible;
+    QVector<QString> above;
+    QVector<QString> below;
+    QVector<int> reloads;
+    for (int row = prefetchFirst; row <= prefetchLast; ++row) {
+        if (m_gridModel->needsThumbnail(row)) {
+            // 已被缓存淘汰，重新请求时命中本地缩略图缓存
+            m_gridModel->setThumbnailPending(row);
+            reloads.append(row);
+        } else if (!m_gridModel->isThumbnailPending(row)) {
+            continue;
+        }
+        const QString path = m_gridModel->pathAt(row);
+        if (row >= first && row <= last) {
+            visible.append(path);
+        } else if (row < first) {
+            above.append(path);
+        } else {
+            below.append(path);
         }
     }
     
-    if (!m_pendingThumbnails.isEmpty()) {
-        m_isLoadingThumbnails = true;
-        // 使用 0ms 定时器在下一次事件循环开始加载，避免阻塞当前操作
-        QTimer::singleShot(0, this, &PhotoPage::loadNextThumbnail);
+    if (!reloads.isEmpty()) {
+        m_thumbnailPipeline->request(m_gridModel->photoIndex(), reloads);
     }
+    if (m_gridModel->pendingCount() == 0) {
+        return;
+    }
+    
+    // 预取范围先向下（常见的滚动方向），上方由近及远
+    std::reverse(above.begin(), above.end());
+    m_thumbnailPipeline->prioritize(visible, below + above);
 }
 
-void PhotoPage::loadNextThumbnail()
+void PhotoPage::onThumbnailsReady(const QVector<ThumbnailResult> &results)
 {
-    if (m_pendingThumbnails.isEmpty()) {
-        m_isLoadingThumbnails = false;
+    // 结果已是缩放好的小图，界面线程只做 QImage -> QPixmap 的转换，且只转换驻留范围内的
+    // 无法读取或解码时结果中没有图片（视频可能只有时长），模型结束等待并保留占位图
+    for (const ThumbnailResult &result : results) {
+        m_gridModel->setThumbnail(m_gridModel->rowForPath(result.path), result.image, result.durationMs);
+    }
+    
+    if (m_gridModel->pendingCount() == 0) {
         qDebug() << "[PhotoPage] 缩略图加载完成";
-        return;
     }
+}
 
-    // 取出下一个要加载的缩略图
-    // 注意：这里需要使用 QPointer 或者确保 clearPhotoGrid 时清空了队列
-    // 我们已经在 clearPhotoGrid 中处理了清空，所以这里应该是安全的
-    PhotoThumbnail *thumbnail = m_pendingThumbnails.takeFirst();
-    
-    // 双重检查：确保 thumbnail 仍然有效（虽然我们清空了队列，但在某些极端情况下为了安全）
-    if (thumbnail && m_thumbnails.contains(thumbnail)) {
-        QString path = thumbnail->photoInfo().path;
-        QString ext = QFileInfo(path).suffix().toLower();
-        
-        // 读取照片数据
-        // 注意：这是同步读取，对于大文件可能会有轻微卡顿
-        QByteArray data = m_photoManager->readPhotoData(path);
-        
-        if (!data.isEmpty()) {
-            QImage image;
-            // 尝试从数据加载图片
-            if (image.loadFromData(data)) {
-                // 缩放图片以节省内存
-                QPixmap pixmap = QPixmap::fromImage(image);
-                thumbnail->setThumbnail(pixmap);
-            } else {
-                qDebug() << "[PhotoPage] 图片解码失败:" << path
-                         << "格式:" << ext
-                         << "数据大小:" << formatFileSize(data.size());
-                
-                if (ext == "heic" || ext == "heif") {
-                    qDebug() << "[PhotoPage] 提示: Qt 可能缺少 HEIC/HEIF 图像格式插件";
-                }
-            }
-        } else {
-             qDebug() << "[PhotoPage] 读取数据失败(空):" << path << "错误:" << m_photoManager->lastError();
-        }
+void PhotoPage::onPhotoDoubleClicked(const QModelIndex &index)
+{
+    if (!index.isValid() || m_currentUdid.isEmpty()) {
+        return;
     }
     
-    // 继续加载下一个
-    // 使用 1ms 延迟给 UI 线程喘息的机会，保持界面响应
-    if (m_isLoadingThumbnails) {
-        QTimer::singleShot(1, this, &PhotoPage::loadNextThumbnail);
+    // 解码结果不必超过屏幕的物理分辨率
+    if (QScreen *screen = this->screen()) {
+        m_previewLoader->setMaxImageSize(screen->size() * screen->devicePixelRatio());
     }
+    
+    PhotoPreviewDialog *dialog = new PhotoPreviewDialog(m_gridModel, m_previewLoader, index.row(), this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->showFullScreen();
 }
 
 void PhotoPage::updateStats(int photoCount, int videoCount)
@@ -675,11 +693,16 @@ void PhotoPage::updateStats(int photoCount, int videoCount)
 
 QVector<PhotoInfo> PhotoPage::getSelectedPhotos() const
 {
+    // 按网格顺序导出
+    QModelIndexList indexes = ui->photoGridView->selectionModel()->selectedIndexes();
+    std::sort(indexes.begin(), indexes.end(), [](const QModelIndex &a, const QModelIndex &b) {
+        return a.row() < b.row();
+    });
+    
     QVector<PhotoInfo> selected;
-    for (PhotoThumbnail *thumbnail : m_thumbnails) {
-        if (thumbnail->isSelected()) {
-            selected.append(thumbnail->photoInfo());
-        }
+    selected.reserve(indexes.size());
+    for (const QModelIndex &index : indexes) {
+        selected.append(m_gridModel->photoAt(index.row()));
     }
     return selected;
 }
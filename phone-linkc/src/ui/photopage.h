@@ -12,12 +12,22 @@
 #include <QWidget>
 #include <QVector>
 #include <QMap>
+#include <QHash>
+#include <QFuture>
+#include <atomic>
+#include <memory>
 
 #include "core/photo/photomanager.h"
+#include "core/photo/photoexporter.h"
 
 // 前向声明
 class QTreeWidgetItem;
-class FlowLayout;
+class PhotoGridModel;
+class ThumbnailPipeline;
+class PhotoPreviewLoader;
+class QTimer;
+class QModelIndex;
+struct ThumbnailResult;
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -25,73 +35,6 @@ class PhotoPage;
 }
 QT_END_NAMESPACE
 
-/**
- * @brief 照片缩略图组件类
- *
- * 用于显示单张照片的缩略图，支持选择状态和悬停效果。
- */
-class PhotoThumbnail : public QWidget
-{
-    Q_OBJECT
-
-public:
-    explicit PhotoThumbnail(const PhotoInfo &info, QWidget *parent = nullptr);
-    
-    /**
-     * @brief 获取照片信息
-     * @return 照片信息结构
-     */
-    const PhotoInfo& photoInfo() const { return m_photoInfo; }
-    
-    /**
-     * @brief 设置选中状态
-     * @param selected 是否选中
-     */
-    void setSelected(bool selected);
-    
-    /**
-     * @brief 获取选中状态
-     * @return 是否选中
-     */
-    bool isSelected() const { return m_selected; }
-    
-    /**
-     * @brief 设置缩略图
-     * @param pixmap 缩略图图像
-     */
-    void setThumbnail(const QPixmap &pixmap);
-
-signals:
-    /**
-     * @brief 点击信号
-     */
-    void clicked();
-    
-    /**
-     * @brief 双击信号
-     */
-    void doubleClicked();
-    
-    /**
-     * @brief 选择状态改变信号
-     * @param selected 新的选择状态
-     */
-    void selectionChanged(bool selected);
-
-protected:
-    void paintEvent(QPaintEvent *event) override;
-    void mousePressEvent(QMouseEvent *event) override;
-    void mouseDoubleClickEvent(QMouseEvent *event) override;
-    void enterEvent(QEnterEvent *event) override;
-    void leaveEvent(QEvent *event) override;
-
-private:
-    PhotoInfo m_photoInfo;     ///< 照片信息
-    QPixmap m_thumbnail;       ///< 缩略图
-    bool m_selected;           ///< 是否选中
-    bool m_hovered;            ///< 是否悬停
-};
-
 /**
  * @brief 照片页面类
  *
@@ -170,6 +113,54 @@ private slots:
      */
     void onScanProgress(int current, int total);
     
+    /**
+     * @brief 流式扫描批次到达槽
+     * @param scanId 扫描 ID
+     * @param directory 批次所在目录
+     * @param photos 照片列表
+     */
+    void onPhotosBatchReady(quint64 scanId, const QString &directory, const QVector<PhotoInfo> &photos);
+    
+    /**
+     * @brief 流式扫描结束槽
+     * @param scanId 扫描 ID
+     * @param total 媒体文件总数
+     * @param canceled 是否被取消
+     */
+    void onPhotoScanFinished(quint64 scanId, int total, bool canceled);
+    
+    /**
+     * @brief 图库数据库同步完成槽，重建智能相簿和用户相簿
+     * @param albums 相簿列表
+     */
+    void onLibraryAlbumsReady(const QVector<AlbumInfo> &albums);
+    
+    /**
+     * @brief 图库相簿查询完成槽
+     * @param queryId 查询 ID
+     * @param albumKey 相簿键
+     * @param photos 照片列表
+     */
+    void onLibraryPhotosReady(quint64 queryId, const QString &albumKey, const QVector<PhotoInfo> &photos);
+    
+    /**
+     * @brief 一批缩略图生成完成槽
+     * @param results 缩略图列表
+     */
+    void onThumbnailsReady(const QVector<ThumbnailResult> &results);
+    
+    /**
+     * @brief 按当前视口重新划分缩略图请求的优先级
+     * 视口内的先加载，其次是上下各一屏的预取范围，其余在空闲时加载
+     */
+    void updateThumbnailPriorities();
+    
+    /**
+     * @brief 照片双击槽，打开全屏预览
+     * @param index 被双击的格子
+     */
+    void onPhotoDoubleClicked(const QModelIndex &index);
+    
     /**
      * @brief 照片错误槽
      * @param error 错误信息
@@ -188,16 +179,34 @@ private:
     void setupAlbumTree();
     
     /**
-     * @brief 更新相册树
-     * @param albums 相册列表
+     * @brief 清除相册树中的动态相册
+     */
+    void clearAlbumItems();
+    
+    /**
+     * @brief 清除相册树中来自图库数据库的相簿
+     */
+    void clearLibraryAlbumItems();
+    
+    /**
+     * @brief 根据扫描批次累加相册照片数（相册项在首次出现时创建）
+     * @param directory 批次所在目录
+     * @param count 批次中的照片数
+     */
+    void addToAlbumCount(const QString &directory, int count);
+    
+    /**
+     * @brief 启动流式扫描，清空网格后随批次逐步填充
+     * @param rootPath 扫描根目录，空字符串表示整个 DCIM
+     * @param rebuildAlbums 是否根据扫描结果重建相册树
      */
-    void updateAlbumTree(const QVector<AlbumInfo> &albums);
+    void startPhotoScan(const QString &rootPath, bool rebuildAlbums);
     
     /**
-     * @brief 显示照片列表
+     * @brief 追加一批照片到网格
      * @param photos 照片列表
      */
-    void displayPhotos(const QVector<PhotoInfo> &photos);
+    void appendPhotos(const QVector<PhotoInfo> &photos);
     
     /**
      * @brief 清空照片网格
@@ -208,18 +217,24 @@ private:
      * @brief 加载当前相册的照片（不重新加载相册树）
      */
     void loadPhotosForCurrentAlbum();
-
+    
     /**
-     * @brief 启动缩略图加载队列
-     * 将当前显示的缩略图加入待加载队列并开始逐个加载，避免一次性阻塞UI
+     * @brief 从本地图库副本查询当前相簿的照片并填充网格（不访问设备）
      */
-    void startThumbnailLoading();
+    void loadLibraryAlbum();
 
     /**
-     * @brief 加载队列中的下一个缩略图
-     * 读取设备上的图片数据并设置到对应的 PhotoThumbnail
+     * @brief 将缩略图交给缩略图流水线
+     * 读取、解码和缩放都在后台线程完成，界面线程只接收成批的结果
+     * @param first 第一行
+     * @param last 最后一行（含）
      */
-    void loadNextThumbnail();
+    void queueThumbnails(int first, int last);
+    
+    /**
+     * @brief 滚动或布局变化后延迟更新缩略图优先级（合并连续的滚动事件）
+     */
+    void scheduleThumbnailPriorities();
     
     /**
      * @brief 更新统计信息
@@ -246,12 +261,28 @@ private:
     QString m_currentUdid;                  ///< 当前设备UDID
     QString m_currentAlbumPath;             ///< 当前相册路径
     
-    FlowLayout *m_flowLayout;               ///< 照片网格布局
-    QVector<PhotoThumbnail*> m_thumbnails;  ///< 缩略图列表
+    PhotoGridModel *m_gridModel;            ///< 照片网格数据模型
 
-    // 缩略图加载队列与状态
-    QVector<PhotoThumbnail*> m_pendingThumbnails; ///< 待加载缩略图队列
-    bool m_isLoadingThumbnails = false;            ///< 是否正在加载缩略图
+    // 缩略图加载
+    ThumbnailPipeline *m_thumbnailPipeline;  ///< 缩略图流水线
+    QTimer *m_priorityTimer;                 ///< 优先级更新定时器
+    
+    // 全屏预览
+    PhotoPreviewLoader *m_previewLoader;     ///< 全尺寸预览加载器（带解码图片缓存）
+    
+    // 导出
+    QFuture<PhotoExporter::Result> m_exportFuture;      ///< 进行中的导出
+    std::shared_ptr<std::atomic<bool>> m_exportCanceled; ///< 导出取消标志，没有进行中的导出时为空
+    
+    // 流式扫描状态
+    quint64 m_scanId = 0;                   ///< 当前扫描 ID，0 表示没有进行中的扫描
+    bool m_rebuildingAlbums = false;        ///< 当前扫描是否在重建相册树
+    quint64 m_libraryQueryId = 0;           ///< 当前图库相簿查询 ID，0 表示没有进行中的查询
+    int m_photoCount = 0;                   ///< 网格中的照片数
+    int m_videoCount = 0;                   ///< 网格中的视频数
+    QHash<QString, QTreeWidgetItem*> m_albumItems; ///< 相册路径 -> 相册项
+    QHash<QString, int> m_albumCounts;      ///< 相册路径 -> 照片数
+    QVector<QTreeWidgetItem*> m_libraryAlbumItems; ///< 图库相簿的顶层项（智能相簿和用户相簿容器）
     
     // 相册树项
     QTreeWidgetItem *m_libraryItem;         ///< 图库（显示所有照片）
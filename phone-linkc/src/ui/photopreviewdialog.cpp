@@ -0,0 +1,158 @@
+/**
+ * @file photopreviewdialog.cpp
+ * @brief 全屏照片预览实现
+ */
+
+#include "photopreviewdialog.h"
+#include "photogridmodel.h"
+#include "core/photo/photopreviewloader.h"
+
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPalette>
+#include <QPixmap>
+
+// 底部说明文字区域的高度
+static const int CAPTION_HEIGHT = 40;
+
+PhotoPreviewDialog::PhotoPreviewDialog(PhotoGridModel *model, PhotoPreviewLoader *loader, int row, QWidget *parent)
+    : QDialog(parent)
+    , m_model(model)
+    , m_loader(loader)
+    , m_row(-1)
+    , m_step(1)
+    , m_fullSize(false)
+    , m_failed(false)
+{
+    setWindowTitle("照片预览");
+    setWindowFlags(windowFlags() | Qt::FramelessWindowHint);
+    setAutoFillBackground(true);
+    QPalette darkPalette = palette();
+    darkPalette.setColor(QPalette::Window, Qt::black);
+    setPalette(darkPalette);
+
+    connect(m_loader, &PhotoPreviewLoader::previewReady, this, &PhotoPreviewDialog::onPreviewReady);
+    connect(m_loader, &PhotoPreviewLoader::previewFailed, this, &PhotoPreviewDialog::onPreviewFailed);
+    // 切换相册或断开设备时行号失效
+    connect(m_model, &QAbstractItemModel::modelReset, this, &QDialog::close);
+
+    showRow(row);
+}
+
+void PhotoPreviewDialog::showRow(int row)
+{
+    if (row < 0 || row >= m_model->rowCount() || row == m_row) {
+        return;
+    }
+    if (m_row >= 0) {
+        m_step = row > m_row ? 1 : -1;
+    }
+    m_row = row;
+
+    const PhotoInfo photo = m_model->photoAt(row);
+    m_path = photo.path;
+    m_failed = false;
+
+    // 先显示已有的图片：缓存中的全尺寸图片，其次是网格中的缩略图
+    m_image = m_loader->cachedImage(photo.path);
+    m_fullSize = !m_image.isNull();
+    if (m_image.isNull()) {
+        const QPixmap thumbnail = m_model->data(m_model->index(row), Qt::DecorationRole).value<QPixmap>();
+        if (!thumbnail.isNull()) {
+            m_image = thumbnail.toImage();
+        }
+    }
+
+    // 按翻页方向先预取下一张
+    QVector<PhotoInfo> prefetch;
+    for (int next : {row + m_step, row - m_step}) {
+        if (next >= 0 && next < m_model->rowCount()) {
+            prefetch.append(m_model->photoAt(next));
+        }
+    }
+    // 当前照片已在缓存中时加载器直接交付缓存结果，只需预取
+    m_loader->load(photo, prefetch, m_image.isNull());
+    update();
+}
+
+void PhotoPreviewDialog::onPreviewReady(const QString &path, const QImage &image, bool fullSize)
+{
+    // 内嵌缩略图晚于全尺寸图片到达时不替换
+    if (path != m_path || (m_fullSize && !fullSize)) {
+        return;
+    }
+    m_image = image;
+    m_fullSize = fullSize;
+    update();
+}
+
+void PhotoPreviewDialog::onPreviewFailed(const QString &path)
+{
+    if (path == m_path) {
+        m_failed = true;
+        update();
+    }
+}
+
+void PhotoPreviewDialog::paintEvent(QPaintEvent *event)
+{
+    QDialog::paintEvent(event);
+
+    QPainter painter(this);
+    const QRect area = rect().adjusted(0, 0, 0, -CAPTION_HEIGHT);
+    if (!m_image.isNull()) {
+        // 缩略图放大显示，全尺寸图片缩小到窗口大小
+        QSize size = m_image.size();
+        size.scale(area.size(), Qt::KeepAspectRatio);
+        const QRect target(area.x() + (area.width() - size.width()) / 2,
+                           area.y() + (area.height() - size.height()) / 2,
+                           size.width(), size.height());
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        painter.drawImage(target, m_image);
+    }
+
+    QString caption = QString("%1  (%2/%3)").arg(m_path.section('/', -1)).arg(m_row + 1).arg(m_model->rowCount());
+    if (m_failed) {
+        caption += "  无法加载原图";
+    } else if (!m_fullSize) {
+        caption += "  正在加载原图…";
+    }
+    painter.setPen(Qt::white);
+    painter.drawText(QRect(0, height() - CAPTION_HEIGHT, width(), CAPTION_HEIGHT), Qt::AlignCenter, caption);
+}
+
+void PhotoPreviewDialog::keyPressEvent(QKeyEvent *event)
+{
+    switch (event->key()) {
+    case Qt::Key_Right:
+    case Qt::Key_Down:
+    case Qt::Key_PageDown:
+        showRow(m_row + 1);
+        break;
+    case Qt::Key_Left:
+    case Qt::Key_Up:
+    case Qt::Key_PageUp:
+        showRow(m_row - 1);
+        break;
+    case Qt::Key_Home:
+        showRow(0);
+        break;
+    case Qt::Key_End:
+        showRow(m_model->rowCount() - 1);
+        break;
+    case Qt::Key_Space:
+        close();
+        break;
+    default:
+        // Esc 由 QDialog 处理（reject 并关闭）
+        QDialog::keyPressEvent(event);
+        break;
+    }
+}
+
+void PhotoPreviewDialog::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event);
+    close();
+}
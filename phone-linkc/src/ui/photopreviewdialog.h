@@ -0,0 +1,77 @@
+/**
+ * @file photopreviewdialog.h
+ * @brief 全屏照片预览头文件
+ *
+ * 打开时立即显示已缓存的全尺寸图片，或网格中的缩略图；都没有时显示内嵌缩略图。
+ * 全尺寸解码完成后替换，同时预取前后两张，翻页时通常已在缓存中。
+ */
+
+#ifndef PHOTOPREVIEWDIALOG_H
+#define PHOTOPREVIEWDIALOG_H
+
+#include <QDialog>
+#include <QImage>
+#include <QString>
+
+class PhotoGridModel;
+class PhotoPreviewLoader;
+
+/**
+ * @brief 全屏照片预览对话框
+ *
+ * 左右方向键（或 PageUp/PageDown、Home/End）切换照片，Esc、空格或双击关闭。
+ *
+ * 使用方法：
+ * @code
+ * PhotoPreviewDialog *dialog = new PhotoPreviewDialog(model, loader, row, this);
+ * dialog->setAttribute(Qt::WA_DeleteOnClose);
+ * dialog->showFullScreen();
+ * @endcode
+ */
+class PhotoPreviewDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param model 照片网格模型（提供照片列表和缩略图）
+     * @param loader 预览加载器
+     * @param row 初始显示的行号
+     * @param parent 父窗口
+     */
+    PhotoPreviewDialog(PhotoGridModel *model, PhotoPreviewLoader *loader, int row, QWidget *parent = nullptr);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private slots:
+    /**
+     * @brief 预览图片到达槽
+     */
+    void onPreviewReady(const QString &path, const QImage &image, bool fullSize);
+
+    /**
+     * @brief 预览加载失败槽
+     */
+    void onPreviewFailed(const QString &path);
+
+private:
+    /**
+     * @brief 显示指定行的照片，并预取前后两张
+     * @param row 行号
+     */
+    void showRow(int row);
+
+    PhotoGridModel *m_model;        ///< 照片网格模型
+    PhotoPreviewLoader *m_loader;   ///< 预览加载器
+    int m_row;                      ///< 当前行号
+    int m_step;                     ///< 上次翻页方向（1 向后，-1 向前），决定预取顺序
+    QString m_path;                 ///< 当前照片路径
+    QImage m_image;                 ///< 当前显示的图片
+    bool m_fullSize;                ///< 当前图片是否为全尺寸
+    bool m_failed;                  ///< 全尺寸加载是否失败
+};
+
+#endif // PHOTOPREVIEWDIALOG_H